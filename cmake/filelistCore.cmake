@@ -1,7 +1,11 @@
 set( core_sources
     Animation/Animation.cpp
+    Animation/BakedClip.cpp
+    Animation/BlendTree.cpp
     Animation/BulgeCorrection.cpp
     Animation/Cage.cpp
+    Animation/CageDeformation.cpp
+    Animation/CompressedClip.cpp
     Animation/DualQuaternionSkinning.cpp
     Animation/HandleArray.cpp
     Animation/HandleWeightOperation.cpp
@@ -10,6 +14,7 @@ set( core_sources
     Animation/RotationCenterSkinning.cpp
     Animation/Sequence.cpp
     Animation/Skeleton.cpp
+    Animation/SkinningScheduler.cpp
     Animation/StretchableTwistableBoneSkinning.cpp
     Asset/AnimationData.cpp
     Asset/BlinnPhongMaterialData.cpp
@@ -25,17 +30,29 @@ set( core_sources
     Geometry/Area.cpp
     Geometry/CatmullClarkSubdivider.cpp
     Geometry/HeatDiffusion.cpp
+    Geometry/Incidence.cpp
+    Geometry/IsoSurface.cpp
     Geometry/Laplacian.cpp
     Geometry/LoopSubdivider.cpp
+    Geometry/MeshCleanup.cpp
+    Geometry/MeshOptimization.cpp
     Geometry/MeshPrimitives.cpp
+    Geometry/MeshSampling.cpp
     Geometry/Normal.cpp
+    Geometry/OperatorPattern.cpp
+    Geometry/PointCloudOctree.cpp
+    Geometry/PointCloudProcessing.cpp
+    Geometry/PointGrid.cpp
     Geometry/PolyLine.cpp
+    Geometry/Quantization.cpp
     Geometry/RayCast.cpp
+    Geometry/SignedDistance.cpp
     Geometry/TopologicalMesh.cpp
     Geometry/TriangleMesh.cpp
     Geometry/TriangleOperation.cpp
     Geometry/VertexDistance.cpp
     Geometry/Volume.cpp
+    Geometry/Voxelization.cpp
     Resources/Resources.cpp
     Tasks/TaskQueue.cpp
     Utils/Attribs.cpp
@@ -46,8 +63,12 @@ set( core_sources
 set( core_headers
     Animation/Animation.hpp
     Animation/AnimationTime.hpp
+    Animation/BakedClip.hpp
+    Animation/BlendTree.hpp
     Animation/BulgeCorrection.hpp
     Animation/Cage.hpp
+    Animation/CageDeformation.hpp
+    Animation/CompressedClip.hpp
     Animation/DualQuaternionSkinning.hpp
     Animation/HandleArray.hpp
     Animation/HandleWeight.hpp
@@ -66,6 +87,7 @@ set( core_headers
     Animation/Sequence.hpp
     Animation/Skeleton.hpp
     Animation/SkinningData.hpp
+    Animation/SkinningScheduler.hpp
     Animation/StretchableTwistableBoneSkinning.hpp
     Asset/AnimationData.hpp
     Asset/AssetData.hpp
@@ -99,20 +121,32 @@ set( core_headers
     Geometry/DistanceQueries.hpp
     Geometry/Frustum.hpp
     Geometry/HeatDiffusion.hpp
+    Geometry/Incidence.hpp
+    Geometry/IsoSurface.hpp
     Geometry/Laplacian.hpp
     Geometry/LoopSubdivider.hpp
+    Geometry/MeshCleanup.hpp
+    Geometry/MeshOptimization.hpp
     Geometry/MeshPrimitives.hpp
+    Geometry/MeshSampling.hpp
     Geometry/Normal.hpp
     Geometry/Obb.hpp
     Geometry/OpenMesh.hpp
+    Geometry/OperatorPattern.hpp
+    Geometry/PointCloudOctree.hpp
+    Geometry/PointCloudProcessing.hpp
+    Geometry/PointGrid.hpp
     Geometry/PolyLine.hpp
+    Geometry/Quantization.hpp
     Geometry/RayCast.hpp
+    Geometry/SignedDistance.hpp
     Geometry/Spline.hpp
     Geometry/TopologicalMesh.hpp
     Geometry/TriangleMesh.hpp
     Geometry/TriangleOperation.hpp
     Geometry/VertexDistance.hpp
     Geometry/Volume.hpp
+    Geometry/Voxelization.hpp
     Math/DualQuaternion.hpp
     Math/GlmAdapters.hpp
     Math/LinearAlgebra.hpp
@@ -1,6 +1,8 @@
 set( engine_sources
     Component/Component.cpp
     Component/GeometryComponent.cpp
+    Component/PointCloudStreamComponent.cpp
+    Component/StaticBatchComponent.cpp
     Entity/Entity.cpp
     ItemModel/ItemEntry.cpp
     Managers/CameraManager/CameraManager.cpp
@@ -26,6 +28,7 @@ set( engine_sources
     Renderer/Material/SimpleMaterial.cpp
     Renderer/Material/VolumetricMaterial.cpp
     Renderer/Mesh/Mesh.cpp
+    Renderer/Mesh/StaticBatchMesh.cpp
     Renderer/Renderer.cpp
     Renderer/Renderers/DebugRender.cpp
     Renderer/Renderers/ForwardRenderer.cpp
@@ -48,6 +51,8 @@ set( engine_sources
 set( engine_headers
     Component/Component.hpp
     Component/GeometryComponent.hpp
+    Component/PointCloudStreamComponent.hpp
+    Component/StaticBatchComponent.hpp
     Entity/Entity.hpp
     FrameInfo.hpp
     ItemModel/ItemEntry.hpp
@@ -79,6 +84,7 @@ set( engine_headers
     Renderer/Material/SimpleMaterial.hpp
     Renderer/Material/VolumetricMaterial.hpp
     Renderer/Mesh/Mesh.hpp
+    Renderer/Mesh/StaticBatchMesh.hpp
     Renderer/OpenGL/OpenGL.hpp
     Renderer/Renderer.hpp
     Renderer/Renderers/DebugRender.hpp
@@ -1,9 +1,11 @@
 set( io_sources
     CameraLoader/CameraLoader.cpp
+    PlyPointSource/PlyPointSource.cpp
 )
 
 set( io_headers
     CameraLoader/CameraLoader.hpp
+    PlyPointSource/PlyPointSource.hpp
     RaIO.hpp
 )
 
@@ -0,0 +1,146 @@
+#include <Core/Animation/BakedClip.hpp>
+
+#include <algorithm>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+uint BakedClip::addTrack( const KeyTransform& keys ) {
+    std::vector<Transform> frames;
+    frames.reserve( keys.size() );
+    for ( uint i = 0; i < keys.size(); ++i )
+    {
+        frames.push_back( keys.getKeyFrame( i ) );
+    }
+    return addTrack( keys.timeSchedule(), frames );
+}
+
+uint BakedClip::addTrack( const std::vector<Time>& times, const std::vector<Transform>& frames ) {
+    CORE_ASSERT( times.size() == frames.size(), "Times and frames mismatch" );
+    CORE_ASSERT( std::is_sorted( times.begin(), times.end() ), "Times are not sorted" );
+    if ( times.empty() )
+    {
+        // a single identity key
+        m_times.push_back( 0 );
+        m_translations.push_back( Vector3::Zero() );
+        m_rotations.push_back( Quaternion::Identity() );
+        m_scales.push_back( Vector3::Ones() );
+    }
+    for ( size_t i = 0; i < times.size(); ++i )
+    {
+        // same decomposition as the interpolation of transforms
+        Matrix3 rotation;
+        Matrix3 scale;
+        frames[i].computeRotationScaling( &rotation, &scale );
+        m_times.push_back( times[i] );
+        m_translations.push_back( frames[i].translation() );
+        m_rotations.push_back( Quaternion( rotation ) );
+        m_scales.push_back( scale.diagonal() );
+        if ( times[i] < m_time.getStart() ) { m_time.setStart( times[i] ); }
+        if ( times[i] > m_time.getEnd() ) { m_time.setEnd( times[i] ); }
+    }
+    m_offsets.push_back( uint( m_times.size() ) );
+    return getTrackCount() - 1;
+}
+
+void BakedClip::clear() {
+    m_offsets = {0};
+    m_times.clear();
+    m_translations.clear();
+    m_rotations.clear();
+    m_scales.clear();
+    m_time = AnimationTime();
+}
+
+uint BakedClip::findKey( const uint track, const Time& t, uint& key ) const {
+    const uint begin = m_offsets[track];
+    const uint last  = m_offsets[track + 1] - 1;
+    uint k           = std::min( begin + key, last );
+    if ( t < m_times[k] )
+    {
+        // going backward, e.g. when looping: binary search of the last key not after t
+        const auto it = std::upper_bound( m_times.begin() + begin, m_times.begin() + k, t );
+        k             = it == m_times.begin() + begin ? begin : uint( it - m_times.begin() ) - 1;
+    }
+    else
+    {
+        // playing forward: the next key is usually the current one or the following one
+        while ( k < last && m_times[k + 1] <= t )
+        {
+            ++k;
+        }
+    }
+    key = k - begin;
+    return k;
+}
+
+Transform BakedClip::sample( const uint track, const Time& t, uint& key ) const {
+    CORE_ASSERT( track < getTrackCount(), "Invalid track" );
+    const uint k0 = findKey( track, t, key );
+    const uint k1 = std::min( k0 + 1, m_offsets[track + 1] - 1 );
+    Transform result;
+    // before the first key, after the last one, or on a key
+    if ( k0 == k1 || t <= m_times[k0] )
+    {
+        result.fromPositionOrientationScale( m_translations[k0], m_rotations[k0], m_scales[k0] );
+        return result;
+    }
+    const Scalar dt = ( t - m_times[k0] ) / ( m_times[k1] - m_times[k0] );
+    result.fromPositionOrientationScale(
+        ( 1 - dt ) * m_translations[k0] + dt * m_translations[k1],
+        m_rotations[k0].slerp( dt, m_rotations[k1] ),
+        ( 1 - dt ) * m_scales[k0] + dt * m_scales[k1] );
+    return result;
+}
+
+void BakedClip::sample( const Time& t, ClipCursor& cursor, Pose& pose ) const {
+    const uint size = getTrackCount();
+    cursor.m_keys.resize( size, 0 );
+    pose.resize( size );
+    for ( uint track = 0; track < size; ++track )
+    {
+        pose[track] = sample( track, t, cursor.m_keys[track] );
+    }
+}
+
+void BakedClip::sample( const Time& t, ClipCursor& cursor, PoseBuffer& pose ) const {
+    const uint size = getTrackCount();
+    CORE_ASSERT( pose.size() == size, "Pose size mismatch" );
+    cursor.m_keys.resize( size, 0 );
+    for ( uint track = 0; track < size; ++track )
+    {
+        const uint k0 = findKey( track, t, cursor.m_keys[track] );
+        const uint k1 = std::min( k0 + 1, m_offsets[track + 1] - 1 );
+        Vector3 translation;
+        Quaternion rotation;
+        Vector3 scale;
+        if ( k0 == k1 || t <= m_times[k0] )
+        {
+            translation = m_translations[k0];
+            rotation    = m_rotations[k0];
+            scale       = m_scales[k0];
+        }
+        else
+        {
+            const Scalar dt = ( t - m_times[k0] ) / ( m_times[k1] - m_times[k0] );
+            translation     = ( 1 - dt ) * m_translations[k0] + dt * m_translations[k1];
+            rotation        = m_rotations[k0].slerp( dt, m_rotations[k1] );
+            scale           = ( 1 - dt ) * m_scales[k0] + dt * m_scales[k1];
+        }
+        pose.m_tx[track] = translation( 0 );
+        pose.m_ty[track] = translation( 1 );
+        pose.m_tz[track] = translation( 2 );
+        pose.m_qx[track] = rotation.x();
+        pose.m_qy[track] = rotation.y();
+        pose.m_qz[track] = rotation.z();
+        pose.m_qw[track] = rotation.w();
+        pose.m_sx[track] = scale( 0 );
+        pose.m_sy[track] = scale( 1 );
+        pose.m_sz[track] = scale( 2 );
+    }
+}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
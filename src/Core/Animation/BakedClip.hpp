@@ -0,0 +1,89 @@
+#ifndef RADIUMENGINE_BAKED_CLIP_HPP
+#define RADIUMENGINE_BAKED_CLIP_HPP
+
+#include <Core/Animation/AnimationTime.hpp>
+#include <Core/Animation/KeyTransform.hpp>
+#include <Core/Animation/Pose.hpp>
+#include <Core/Containers/AlignedStdVector.hpp>
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+/**
+ * A BakedClip stores the keyframes of the transforms of several handles, e.g.
+ * the bones of a skeleton, one track per handle, for fast playback.
+ *
+ * The keys of all the tracks are stored in contiguous arrays of times,
+ * translations, rotations and scales, the transforms being decomposed when
+ * baking so that sampling only interpolates them, as KeyTransform::at() does.
+ * A ClipCursor stores the last key used in each track by a player, so that
+ * sampling at increasing times, as in playback, finds the keys in constant
+ * time. Sampling at a time before the cursor falls back to a binary search.
+ */
+class RA_CORE_API BakedClip
+{
+  public:
+    /// The keys used by a player of the clip, one per track, to be reused
+    /// from a sample to the next one. A cursor can be used with one clip only.
+    struct ClipCursor {
+        std::vector<uint> m_keys;
+    };
+
+    /// Add a track with the keyframes of \p keys, the identity if empty.
+    /// \return the index of the track.
+    uint addTrack( const KeyTransform& keys );
+
+    /// Add a track with the transforms \p frames at the increasing \p times.
+    /// \return the index of the track.
+    uint addTrack( const std::vector<Time>& times, const std::vector<Transform>& frames );
+
+    /// Remove all the tracks.
+    void clear();
+
+    inline uint getTrackCount() const { return uint( m_offsets.size() - 1 ); }
+
+    /// Number of keys of the track \p track.
+    inline uint getKeyCount( const uint track ) const {
+        return m_offsets[track + 1] - m_offsets[track];
+    }
+
+    /// Time span of the keys of all the tracks.
+    inline const AnimationTime& getAnimationTime() const { return m_time; }
+
+    /// Sample the track \p track at time \p t, starting the search from the key
+    /// \p key of the track, which is updated.
+    Transform sample( const uint track, const Time& t, uint& key ) const;
+
+    /// Sample all the tracks at time \p t into \p pose, using and updating
+    /// \p cursor.
+    void sample( const Time& t, ClipCursor& cursor, Pose& pose ) const;
+
+    /// Same as above, without composing the transforms, into \p pose which
+    /// must already have a transform per track.
+    void sample( const Time& t, ClipCursor& cursor, PoseBuffer& pose ) const;
+
+  private:
+    /// Index, in the key arrays, of the key of \p track at or before \p t, the
+    /// first one if none, starting the search from the key \p key of the track.
+    uint findKey( const uint track, const Time& t, uint& key ) const;
+
+    /// First key of each track, followed by the number of keys.
+    std::vector<uint> m_offsets{0};
+    std::vector<Time> m_times;
+    Vector3Array m_translations;
+    AlignedStdVector<Quaternion> m_rotations;
+    Vector3Array m_scales;
+    AnimationTime m_time;
+};
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_BAKED_CLIP_HPP
@@ -0,0 +1,192 @@
+#include <Core/Animation/BlendTree.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+namespace {
+
+// Above this cosine, the quaternions are nlerped instead of slerped, as in Eigen.
+constexpr Scalar SlerpThreshold = 1 - 1e-5_ra;
+
+// Interpolate the poses a and b by the weights w * mask[i] (w if no mask).
+void blendPoses( const PoseBuffer& a,
+                 const PoseBuffer& b,
+                 const Scalar w,
+                 const Scalar* mask,
+                 const bool slerp,
+                 PoseBuffer& out ) {
+    const int size = int( a.size() );
+#pragma omp simd
+    for ( int i = 0; i < size; ++i )
+    {
+        const Scalar t  = mask ? w * mask[i] : w;
+        const Scalar u  = 1 - t;
+        out.m_tx[i]     = u * a.m_tx[i] + t * b.m_tx[i];
+        out.m_ty[i]     = u * a.m_ty[i] + t * b.m_ty[i];
+        out.m_tz[i]     = u * a.m_tz[i] + t * b.m_tz[i];
+        out.m_sx[i]     = u * a.m_sx[i] + t * b.m_sx[i];
+        out.m_sy[i]     = u * a.m_sy[i] + t * b.m_sy[i];
+        out.m_sz[i]     = u * a.m_sz[i] + t * b.m_sz[i];
+        const Scalar d  = a.m_qx[i] * b.m_qx[i] + a.m_qy[i] * b.m_qy[i] +
+                         a.m_qz[i] * b.m_qz[i] + a.m_qw[i] * b.m_qw[i];
+        // shortest path
+        const Scalar sign = d < 0 ? -1_ra : 1_ra;
+        const Scalar c    = std::min( d * sign, 1_ra );
+        Scalar k0         = u;
+        Scalar k1         = t;
+        if ( slerp && c < SlerpThreshold )
+        {
+            const Scalar theta = std::acos( c );
+            const Scalar s     = 1 / std::sin( theta );
+            k0                 = std::sin( u * theta ) * s;
+            k1                 = std::sin( t * theta ) * s;
+        }
+        k1 *= sign;
+        const Scalar qx = k0 * a.m_qx[i] + k1 * b.m_qx[i];
+        const Scalar qy = k0 * a.m_qy[i] + k1 * b.m_qy[i];
+        const Scalar qz = k0 * a.m_qz[i] + k1 * b.m_qz[i];
+        const Scalar qw = k0 * a.m_qw[i] + k1 * b.m_qw[i];
+        const Scalar n  = 1 / std::sqrt( qx * qx + qy * qy + qz * qz + qw * qw );
+        out.m_qx[i]     = qx * n;
+        out.m_qy[i]     = qy * n;
+        out.m_qz[i]     = qz * n;
+        out.m_qw[i]     = qw * n;
+    }
+}
+
+// Apply the pose additive over the pose base by the weights w * mask[i].
+void addPoses( const PoseBuffer& base,
+               const PoseBuffer& additive,
+               const Scalar w,
+               const Scalar* mask,
+               PoseBuffer& out ) {
+    const int size = int( base.size() );
+#pragma omp simd
+    for ( int i = 0; i < size; ++i )
+    {
+        const Scalar t = mask ? w * mask[i] : w;
+        out.m_tx[i]    = base.m_tx[i] + t * additive.m_tx[i];
+        out.m_ty[i]    = base.m_ty[i] + t * additive.m_ty[i];
+        out.m_tz[i]    = base.m_tz[i] + t * additive.m_tz[i];
+        out.m_sx[i]    = base.m_sx[i] * ( 1 + t * ( additive.m_sx[i] - 1 ) );
+        out.m_sy[i]    = base.m_sy[i] * ( 1 + t * ( additive.m_sy[i] - 1 ) );
+        out.m_sz[i]    = base.m_sz[i] * ( 1 + t * ( additive.m_sz[i] - 1 ) );
+        // weighted additive rotation: nlerp from the identity, on the shortest path
+        const Scalar sign = additive.m_qw[i] < 0 ? -1_ra : 1_ra;
+        const Scalar ax   = t * sign * additive.m_qx[i];
+        const Scalar ay   = t * sign * additive.m_qy[i];
+        const Scalar az   = t * sign * additive.m_qz[i];
+        const Scalar aw   = 1 - t + t * sign * additive.m_qw[i];
+        const Scalar n    = 1 / std::sqrt( ax * ax + ay * ay + az * az + aw * aw );
+        // base * additive
+        const Scalar bx = base.m_qx[i];
+        const Scalar by = base.m_qy[i];
+        const Scalar bz = base.m_qz[i];
+        const Scalar bw = base.m_qw[i];
+        out.m_qx[i]     = ( bw * ax + bx * aw + by * az - bz * ay ) * n;
+        out.m_qy[i]     = ( bw * ay - bx * az + by * aw + bz * ax ) * n;
+        out.m_qz[i]     = ( bw * az + bx * ay - by * ax + bz * aw ) * n;
+        out.m_qw[i]     = ( bw * aw - bx * ax - by * ay - bz * az ) * n;
+    }
+}
+
+} // namespace
+
+BlendTree::BlendTree( uint nbBones ) : m_nbBones( nbBones ) {}
+
+BlendTree::NodeId BlendTree::addInput() {
+    m_nodes.push_back( {NodeType::Input, m_nbInputs++, 0, 0, -1, Interpolation::Nlerp} );
+    return NodeId( m_nodes.size() - 1 );
+}
+
+uint BlendTree::addParameter() {
+    return m_nbParameters++;
+}
+
+uint BlendTree::addMask( const std::vector<Scalar>& weights ) {
+    CORE_ASSERT( weights.size() == m_nbBones, "Mask size mismatch" );
+    m_masks.push_back( weights );
+    return uint( m_masks.size() - 1 );
+}
+
+BlendTree::NodeId BlendTree::addBlend( NodeId a,
+                                       NodeId b,
+                                       uint parameter,
+                                       Interpolation interpolation,
+                                       int mask ) {
+    CORE_ASSERT( a < m_nodes.size() && b < m_nodes.size(), "Invalid node" );
+    CORE_ASSERT( parameter < m_nbParameters, "Invalid parameter" );
+    CORE_ASSERT( mask < int( m_masks.size() ), "Invalid mask" );
+    m_nodes.push_back( {NodeType::Blend, a, b, parameter, mask, interpolation} );
+    return NodeId( m_nodes.size() - 1 );
+}
+
+BlendTree::NodeId BlendTree::addAdditive( NodeId base, NodeId additive, uint parameter, int mask ) {
+    CORE_ASSERT( base < m_nodes.size() && additive < m_nodes.size(), "Invalid node" );
+    CORE_ASSERT( parameter < m_nbParameters, "Invalid parameter" );
+    CORE_ASSERT( mask < int( m_masks.size() ), "Invalid mask" );
+    m_nodes.push_back(
+        {NodeType::Additive, base, additive, parameter, mask, Interpolation::Nlerp} );
+    return NodeId( m_nodes.size() - 1 );
+}
+
+void BlendTree::initContext( Context& context ) const {
+    context.m_inputs.resize( m_nbInputs );
+    for ( auto& input : context.m_inputs )
+    {
+        input.resize( m_nbBones );
+    }
+    context.m_parameters.resize( m_nbParameters, 0_ra );
+    context.m_buffers.resize( m_nodes.size() );
+    for ( size_t n = 0; n < m_nodes.size(); ++n )
+    {
+        context.m_buffers[n].resize( m_nodes[n].type == NodeType::Input ? 0 : m_nbBones );
+    }
+}
+
+const PoseBuffer& BlendTree::getBuffer( const Context& context, NodeId node ) const {
+    const Node& n = m_nodes[node];
+    return n.type == NodeType::Input ? context.m_inputs[n.a] : context.m_buffers[node];
+}
+
+const PoseBuffer& BlendTree::evaluate( Context& context ) const {
+    CORE_ASSERT( !m_nodes.empty(), "Empty blend tree" );
+    CORE_ASSERT( context.m_buffers.size() == m_nodes.size(), "Context not initialized" );
+    for ( size_t i = 0; i < m_nodes.size(); ++i )
+    {
+        const Node& node = m_nodes[i];
+        if ( node.type == NodeType::Input ) { continue; }
+        const Scalar w     = context.m_parameters[node.parameter];
+        const Scalar* mask = node.mask < 0 ? nullptr : m_masks[size_t( node.mask )].data();
+        const auto& a      = getBuffer( context, node.a );
+        const auto& b      = getBuffer( context, node.b );
+        if ( node.type == NodeType::Blend )
+        {
+            blendPoses(
+                a, b, w, mask, node.interpolation == Interpolation::Slerp, context.m_buffers[i] );
+        }
+        else
+        { addPoses( a, b, w, mask, context.m_buffers[i] ); }
+    }
+    return getOutput( context );
+}
+
+void BlendTree::evaluate( std::vector<Context>& contexts ) const {
+#pragma omp parallel for
+    for ( int c = 0; c < int( contexts.size() ); ++c )
+    {
+        evaluate( contexts[c] );
+    }
+}
+
+const PoseBuffer& BlendTree::getOutput( const Context& context ) const {
+    return getBuffer( context, NodeId( m_nodes.size() - 1 ) );
+}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,120 @@
+#ifndef RADIUMENGINE_BLEND_TREE_HPP
+#define RADIUMENGINE_BLEND_TREE_HPP
+
+#include <Core/Animation/Pose.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+/**
+ * A BlendTree combines input poses, e.g. sampled from clips, into an output
+ * pose, through blend nodes (locomotion blend spaces, transitions) and
+ * additive nodes (additive layers), each weighted by a parameter and
+ * optionally by a per-bone mask.
+ *
+ * The tree only describes the nodes, shared by all the characters using it.
+ * Each character has a Context holding its inputs, parameters, and a
+ * PoseBuffer per node, which are allocated once by initContext(), so that
+ * evaluating the tree allocates nothing. The nodes are evaluated in the order
+ * of their creation, the children being created before their parents, and
+ * the last node is the output. Each node processes all the bones in
+ * vectorized loops over the components of the poses.
+ */
+class RA_CORE_API BlendTree
+{
+  public:
+    using NodeId = uint;
+
+    enum class Interpolation {
+        /// Normalized linear interpolation of the rotations, fast and close
+        /// to slerp for close rotations.
+        Nlerp,
+        /// Spherical linear interpolation of the rotations.
+        Slerp
+    };
+
+    /// The inputs, parameters and buffers of a character.
+    struct Context {
+        /// The input poses, to be set before each evaluation.
+        std::vector<PoseBuffer> m_inputs;
+        /// The values of the parameters, to be set before each evaluation.
+        std::vector<Scalar> m_parameters;
+        /// The result of each node, unused for the inputs.
+        std::vector<PoseBuffer> m_buffers;
+    };
+
+    /// Create a tree for poses of \p nbBones bones.
+    explicit BlendTree( uint nbBones );
+
+    inline uint getBoneCount() const { return m_nbBones; }
+
+    /// Add an input node, whose pose is the next input of the contexts.
+    NodeId addInput();
+
+    /// Add a parameter, the next one of the contexts.
+    /// \return the index of the parameter.
+    uint addParameter();
+
+    /// Add a mask, giving a weight in [0, 1] to each bone.
+    /// \return the index of the mask.
+    uint addMask( const std::vector<Scalar>& weights );
+
+    /// Add a node interpolating the poses of \p a and \p b by the value of
+    /// \p parameter, times the weights of \p mask if not negative.
+    NodeId addBlend( NodeId a,
+                     NodeId b,
+                     uint parameter,
+                     Interpolation interpolation = Interpolation::Nlerp,
+                     int mask                    = -1 );
+
+    /// Add a node applying the pose \p additive, relative to the rest pose,
+    /// over the pose \p base, weighted by the value of \p parameter times the
+    /// weights of \p mask if not negative:
+    /// translations are added, rotations and scales are multiplied.
+    NodeId addAdditive( NodeId base, NodeId additive, uint parameter, int mask = -1 );
+
+    /// Allocate the inputs, parameters and buffers of \p context.
+    void initContext( Context& context ) const;
+
+    /// Evaluate the tree for \p context, which must have been initialized.
+    /// \return the output pose.
+    const PoseBuffer& evaluate( Context& context ) const;
+
+    /// Evaluate the tree for all the \p contexts, in parallel.
+    void evaluate( std::vector<Context>& contexts ) const;
+
+    /// The output pose of \p context, once evaluated.
+    const PoseBuffer& getOutput( const Context& context ) const;
+
+  private:
+    enum class NodeType { Input, Blend, Additive };
+
+    struct Node {
+        NodeType type;
+        /// Input index, or children.
+        uint a;
+        uint b;
+        uint parameter;
+        int mask;
+        Interpolation interpolation;
+    };
+
+    const PoseBuffer& getBuffer( const Context& context, NodeId node ) const;
+
+    uint m_nbBones;
+    uint m_nbInputs{0};
+    uint m_nbParameters{0};
+    std::vector<Node> m_nodes;
+    std::vector<std::vector<Scalar>> m_masks;
+};
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_BLEND_TREE_HPP
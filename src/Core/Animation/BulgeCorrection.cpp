@@ -1,11 +1,25 @@
 #include <Core/Animation/BulgeCorrection.hpp>
 
+#include <Core/Animation/LinearBlendSkinning.hpp>
 #include <Core/Geometry/DistanceQueries.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace Ra {
 namespace Core {
 namespace Animation {
 
+namespace {
+
+// Number of vertices corrected together.
+constexpr int BulgeBlockSize = 64;
+
+// Number of vertices of each parallel task.
+constexpr int TaskSize = 1024;
+
+} // namespace
+
 BulgeCorrectionData::BulgeCorrectionData() : m_prj(), m_dv() {}
 
 BulgeCorrectionData::BulgeCorrectionData( const uint size ) : m_prj( size ), m_dv( size ) {}
@@ -58,6 +72,133 @@ void findCorrectionData( const Vector3Array& mesh,
     }
 }
 
+void BoneSegments::compute( const AdjacencyList& graph, const Pose& pose ) {
+    const uint n = pose.size();
+    m_start.resize( n );
+    m_seg.resize( n );
+    m_invSqLength.resize( n );
+    for ( uint j = 0; j < n; ++j )
+    {
+        Vector3 end = Vector3::Zero();
+        for ( const auto& c : graph.children()[j] )
+        {
+            end += pose[c].translation();
+        }
+        m_start[j]       = pose[j].translation();
+        m_seg[j]         = end - m_start[j];
+        const Scalar sq  = m_seg[j].squaredNorm();
+        m_invSqLength[j] = sq > 0 ? 1 / sq : 0_ra;
+    }
+}
+
+void bulgeCorrection( const Dv& restDv,
+                      const MaxWeightID& wID,
+                      const BoneSegments& segments,
+                      const int begin,
+                      const int end,
+                      Vector3Array& currMesh ) {
+    CORE_ASSERT( 0 <= begin && begin <= end && end <= int( currMesh.size() ), "Invalid range" );
+    // The vertices of each block and the segments of their bones are gathered
+    // in fixed size Eigen arrays, so that all the computations are vectorized,
+    // with selects instead of branches. The end of the last block is padded.
+    using BlockArray = Eigen::Array<Scalar, BulgeBlockSize, 1>;
+    BlockArray x, y, z, rest, ax, ay, az, sx, sy, sz, inv;
+    for ( auto* a : {&x, &y, &z, &rest, &ax, &ay, &az, &sx, &sy, &sz, &inv} )
+    {
+        a->setZero();
+    }
+    for ( int first = begin; first < end; first += BulgeBlockSize )
+    {
+        const int count = std::min( BulgeBlockSize, end - first );
+        for ( int i = 0; i < count; ++i )
+        {
+            const Vector3& p = currMesh[first + i];
+            const uint b     = wID[first + i];
+            x( i )           = p.x();
+            y( i )           = p.y();
+            z( i )           = p.z();
+            rest( i )        = restDv[first + i];
+            ax( i )          = segments.m_start[b].x();
+            ay( i )          = segments.m_start[b].y();
+            az( i )          = segments.m_start[b].z();
+            sx( i )          = segments.m_seg[b].x();
+            sy( i )          = segments.m_seg[b].y();
+            sz( i )          = segments.m_seg[b].z();
+            inv( i )         = segments.m_invSqLength[b];
+        }
+
+        // projection on the segment, as projectOnSegment()
+        const BlockArray dot = ( x - ax ) * sx + ( y - ay ) * sy + ( z - az ) * sz;
+        const BlockArray t   = ( dot * inv ).max( 0_ra ).min( 1_ra );
+        const BlockArray dx  = x - ( ax + t * sx );
+        const BlockArray dy  = y - ( ay + t * sy );
+        const BlockArray dz  = z - ( az + t * sz );
+        const BlockArray dv  = dx.square() + dy.square() + dz.square();
+        // the bulging vertices are moved towards their projection
+        const BlockArray factor =
+            ( rest / dv.max( std::numeric_limits<Scalar>::min() ) ).sqrt() - 1_ra;
+        const BlockArray k = ( rest < dv ).select( factor, BlockArray::Zero() );
+        x += k * dx;
+        y += k * dy;
+        z += k * dz;
+
+        for ( int i = 0; i < count; ++i )
+        {
+            currMesh[first + i] = Vector3( x( i ), y( i ), z( i ) );
+        }
+    }
+}
+
+void bulgeCorrection( const Dv& restDv,
+                      const MaxWeightID& wID,
+                      const BoneSegments& segments,
+                      Vector3Array& currMesh ) {
+    CORE_ASSERT( restDv.size() == currMesh.size() && wID.size() == currMesh.size(),
+                 "Correction data don't match the mesh" );
+    const int size    = int( currMesh.size() );
+    const int nbTasks = ( size + TaskSize - 1 ) / TaskSize;
+#pragma omp parallel for
+    for ( int task = 0; task < nbTasks; ++task )
+    {
+        const int begin = task * TaskSize;
+        const int end   = std::min( begin + TaskSize, size );
+        bulgeCorrection( restDv, wID, segments, begin, end, currMesh );
+    }
+}
+
+void linearBlendSkinning( const Vector3Array& inMesh,
+                          const Pose& pose,
+                          const PackedWeights& weight,
+                          const Dv& restDv,
+                          const MaxWeightID& wID,
+                          const AdjacencyList& graph,
+                          const Pose& modelPose,
+                          Vector3Array& outMesh ) {
+    CORE_ASSERT( inMesh.size() == weight.m_size, "Weights do not match the mesh" );
+    CORE_ASSERT( restDv.size() == inMesh.size() && wID.size() == inMesh.size(),
+                 "Correction data don't match the mesh" );
+    outMesh.resize( inMesh.size() );
+    if ( inMesh.empty() ) { return; }
+    PoseMatrices matrices;
+    computePoseMatrices( pose, matrices );
+    BoneSegments segments;
+    segments.compute( graph, modelPose );
+    const Vector3Array none;
+    Vector3Array noneOut;
+    // each task corrects its vertices while they are still in the cache
+    const int size    = int( inMesh.size() );
+    const int nbTasks = ( size + TaskSize - 1 ) / TaskSize;
+#pragma omp parallel for
+    for ( int task = 0; task < nbTasks; ++task )
+    {
+        const int begin = task * TaskSize;
+        const int end   = std::min( begin + TaskSize, size );
+        linearBlendSkinning(
+            inMesh, none, none, matrices, weight, begin, end, outMesh, noneOut, noneOut );
+        bulgeCorrection( restDv, wID, segments, begin, end, outMesh );
+    }
+}
+
 } // namespace Animation
 } // namespace Core
 } // namespace Ra
@@ -1,6 +1,7 @@
 #ifndef RADIUMENGINE_BULGE_CORRECTION_DEFINITION_HPP
 #define RADIUMENGINE_BULGE_CORRECTION_DEFINITION_HPP
 
+#include <Core/Animation/HandleWeight.hpp>
 #include <Core/Animation/Pose.hpp>
 #include <Core/Containers/AdjacencyList.hpp>
 #include <Core/Containers/VectorArray.hpp>
@@ -36,6 +37,49 @@ void findCorrectionData( const Vector3Array& mesh,
                          const Pose& pose,
                          BulgeCorrectionData& data );
 
+/// The bone segments of a pose, as used by findCorrectionData(): each bone
+/// goes from its translation to the sum of the translations of its children.
+struct RA_CORE_API BoneSegments {
+    void compute( const AdjacencyList& graph, const Pose& pose );
+
+    Vector3Array m_start;
+    Vector3Array m_seg;
+    /// Inverse of the squared length of the segments, 0 for empty ones.
+    Vector1Array m_invSqLength;
+};
+
+/// Bulge correction of the vertices [\p begin, \p end[ of the skinned mesh
+/// \p currMesh, in place, equivalent to findCorrectionData() on \p currMesh
+/// followed by bulgeCorrection() with \p restDv the m_dv of the rest data,
+/// without storing the current projections. The vertices are processed
+/// sequentially, by vectorized blocks, so that skinning kernels can call it
+/// on the block of vertices they just wrote.
+void RA_CORE_API bulgeCorrection( const Dv& restDv,
+                                  const MaxWeightID& wID,
+                                  const BoneSegments& segments,
+                                  const int begin,
+                                  const int end,
+                                  Vector3Array& currMesh );
+
+/// Same as above for all the vertices, in parallel.
+void RA_CORE_API bulgeCorrection( const Dv& restDv,
+                                  const MaxWeightID& wID,
+                                  const BoneSegments& segments,
+                                  Vector3Array& currMesh );
+
+/// Packed linear blend skinning of \p inMesh by \p pose, followed by the
+/// bulge correction of the skinned vertices relative to the bones of
+/// \p modelPose, the two passes being fused by blocks of vertices processed
+/// in parallel, so that the output is written once.
+void RA_CORE_API linearBlendSkinning( const Vector3Array& inMesh,
+                                      const Pose& pose,
+                                      const PackedWeights& weight,
+                                      const Dv& restDv,
+                                      const MaxWeightID& wID,
+                                      const AdjacencyList& graph,
+                                      const Pose& modelPose,
+                                      Vector3Array& outMesh );
+
 } // namespace Animation
 } // namespace Core
 } // namespace Ra
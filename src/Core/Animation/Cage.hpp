@@ -14,8 +14,7 @@ namespace Animation {
  *
  * The Cage handle is a variation of a triangular mesh.
  * Instead of a list of vertices, it owns a list of transforms.
- *
- * \warning This class is probably unused
+ * See CageDeformation.hpp to deform a mesh with a cage.
  */
 class RA_CORE_API Cage : public HandleArray
 {
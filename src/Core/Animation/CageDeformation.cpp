@@ -0,0 +1,200 @@
+#include <Core/Animation/CageDeformation.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+namespace {
+
+// The coordinates are computed in double precision, as the angles of the
+// triangles seen from a point are small for a point close to the cage.
+constexpr double Epsilon = 1e-8;
+constexpr double Pi      = 3.14159265358979323846;
+
+// Mean value coordinates of x, following the pseudo-code of Ju et al.
+// d and u are scratch arrays of the size of the cage.
+void meanValueCoordinates( const std::vector<Eigen::Vector3d>& cage,
+                           const VectorArray<Vector3ui>& triangles,
+                           const Eigen::Vector3d& x,
+                           std::vector<double>& d,
+                           std::vector<Eigen::Vector3d>& u,
+                           std::vector<double>& w ) {
+    const size_t n = cage.size();
+    w.assign( n, 0. );
+    for ( size_t j = 0; j < n; ++j )
+    {
+        u[j] = cage[j] - x;
+        d[j] = u[j].norm();
+        // x is a vertex of the cage
+        if ( d[j] < Epsilon )
+        {
+            w[j] = 1;
+            return;
+        }
+        u[j] /= d[j];
+    }
+
+    for ( const auto& t : triangles )
+    {
+        std::array<double, 3> theta;
+        std::array<double, 3> c;
+        std::array<double, 3> s;
+        double h = 0;
+        for ( int i = 0; i < 3; ++i )
+        {
+            const double l = ( u[t( ( i + 1 ) % 3 )] - u[t( ( i + 2 ) % 3 )] ).norm();
+            theta[i]       = 2 * std::asin( std::min( l / 2, 1. ) );
+            h += theta[i] / 2;
+        }
+        // x lies on the triangle, use 2D barycentric coordinates
+        if ( Pi - h < Epsilon )
+        {
+            w.assign( n, 0. );
+            for ( int i = 0; i < 3; ++i )
+            {
+                w[t( i )] =
+                    std::sin( theta[i] ) * d[t( ( i + 2 ) % 3 )] * d[t( ( i + 1 ) % 3 )];
+            }
+            break;
+        }
+        // sign of det( u0, u1, u2 )
+        const double sign = u[t( 0 )].dot( u[t( 1 )].cross( u[t( 2 )] ) ) < 0 ? -1. : 1.;
+        bool outside = false;
+        for ( int i = 0; i < 3; ++i )
+        {
+            c[i] = 2 * std::sin( h ) * std::sin( h - theta[i] ) /
+                       ( std::sin( theta[( i + 1 ) % 3] ) * std::sin( theta[( i + 2 ) % 3] ) ) -
+                   1;
+            s[i] = sign * std::sqrt( std::max( 1 - c[i] * c[i], 0. ) );
+            // x lies on the plane of the triangle, outside of it
+            if ( std::abs( s[i] ) <= Epsilon ) { outside = true; }
+        }
+        if ( outside ) { continue; }
+        for ( int i = 0; i < 3; ++i )
+        {
+            const int next = ( i + 1 ) % 3;
+            const int prev = ( i + 2 ) % 3;
+            w[t( i )] += ( theta[i] - c[next] * theta[prev] - c[prev] * theta[next] ) /
+                         ( d[t( i )] * std::sin( theta[next] ) * s[prev] );
+        }
+    }
+
+    double sum = 0;
+    for ( const double wj : w )
+    {
+        sum += wj;
+    }
+    for ( double& wj : w )
+    {
+        wj /= sum;
+    }
+}
+
+} // namespace
+
+Vector3Array getCageVertices( const Cage& cage ) {
+    const Pose& pose = cage.getPose( HandleArray::SpaceType::MODEL );
+    Vector3Array vertices( pose.size() );
+    for ( size_t i = 0; i < pose.size(); ++i )
+    {
+        vertices[i] = pose[i].translation();
+    }
+    return vertices;
+}
+
+CageCoordinates computeMeanValueCoordinates( const Vector3Array& cageVertices,
+                                             const VectorArray<Vector3ui>& cageTriangles,
+                                             const Vector3Array& points,
+                                             Scalar threshold ) {
+    const size_t n = cageVertices.size();
+    std::vector<Eigen::Vector3d> cage( n );
+    for ( size_t j = 0; j < n; ++j )
+    {
+        cage[j] = cageVertices[j].cast<double>();
+    }
+
+    // the kept coordinates of each point, gathered in parallel
+    const int size = int( points.size() );
+    std::vector<std::vector<std::pair<int, Scalar>>> rows( points.size() );
+#pragma omp parallel
+    {
+        std::vector<double> d( n );
+        std::vector<Eigen::Vector3d> u( n );
+        std::vector<double> w( n );
+#pragma omp for schedule( dynamic, 64 )
+        for ( int i = 0; i < size; ++i )
+        {
+            meanValueCoordinates( cage, cageTriangles, points[i].cast<double>(), d, u, w );
+            double sum = 0;
+            for ( size_t j = 0; j < n; ++j )
+            {
+                if ( std::abs( w[j] ) >= threshold )
+                {
+                    rows[i].emplace_back( int( j ), Scalar( w[j] ) );
+                    sum += w[j];
+                }
+            }
+            for ( auto& jw : rows[i] )
+            {
+                jw.second = Scalar( jw.second / sum );
+            }
+        }
+    }
+
+    CageCoordinates coordinates( size, int( n ) );
+    Eigen::VectorXi nonZeros( size );
+    for ( int i = 0; i < size; ++i )
+    {
+        nonZeros[i] = int( rows[i].size() );
+    }
+    coordinates.reserve( nonZeros );
+    for ( int i = 0; i < size; ++i )
+    {
+        for ( const auto& jw : rows[i] )
+        {
+            coordinates.insert( i, jw.first ) = jw.second;
+        }
+    }
+    coordinates.makeCompressed();
+    return coordinates;
+}
+
+CageCoordinates
+computeMeanValueCoordinates( const Cage& cage, const Vector3Array& points, Scalar threshold ) {
+    return computeMeanValueCoordinates(
+        getCageVertices( cage ), cage.m_triangle, points, threshold );
+}
+
+void cageDeformation( const Vector3Array& cageVertices,
+                      const CageCoordinates& coordinates,
+                      Vector3Array& outMesh ) {
+    CORE_ASSERT( size_t( coordinates.cols() ) == cageVertices.size(), "Cage size mismatch" );
+    const int size = int( coordinates.rows() );
+    outMesh.resize( size_t( size ) );
+#pragma omp parallel for
+    for ( int i = 0; i < size; ++i )
+    {
+        Vector3 p = Vector3::Zero();
+        for ( CageCoordinates::InnerIterator it( coordinates, i ); it; ++it )
+        {
+            p += it.value() * cageVertices[size_t( it.col() )];
+        }
+        outMesh[i] = p;
+    }
+}
+
+void cageDeformation( const Cage& cage,
+                      const CageCoordinates& coordinates,
+                      Vector3Array& outMesh ) {
+    cageDeformation( getCageVertices( cage ), coordinates, outMesh );
+}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
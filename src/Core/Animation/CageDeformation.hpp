@@ -0,0 +1,61 @@
+#ifndef RADIUMENGINE_CAGE_DEFORMATION_HPP
+#define RADIUMENGINE_CAGE_DEFORMATION_HPP
+
+#include <Core/Animation/Cage.hpp>
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <Eigen/Sparse>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+/**
+ * Cage based deformation: the points of a dense mesh are expressed once as
+ * combinations of the vertices of a coarse, closed triangular cage, and
+ * follow the cage when its vertices move.
+ *
+ * The vertices of a Cage are the translations of its model space pose.
+ */
+
+/// Coordinates of points relative to the vertices of a cage, one row per point.
+using CageCoordinates = Eigen::SparseMatrix<Scalar, Eigen::RowMajor>;
+
+/// The vertices of \p cage, i.e. the translations of its model space pose.
+RA_CORE_API Vector3Array getCageVertices( const Cage& cage );
+
+/// Compute the mean value coordinates of \p points relative to the cage
+/// \p cageVertices, \p cageTriangles, as defined by Ju, Schaefer and Warren,
+/// "Mean value coordinates for closed triangular meshes", ACM ToG, 2005.
+/// The triangles must be consistently oriented. The coordinates smaller than
+/// \p threshold in absolute value are dropped, the other ones being scaled
+/// so that the coordinates of each point sum to 1. The points are processed
+/// in parallel.
+RA_CORE_API CageCoordinates
+computeMeanValueCoordinates( const Vector3Array& cageVertices,
+                             const VectorArray<Vector3ui>& cageTriangles,
+                             const Vector3Array& points,
+                             Scalar threshold = 1e-4_ra );
+
+/// Same as above for the current vertices of \p cage.
+RA_CORE_API CageCoordinates computeMeanValueCoordinates( const Cage& cage,
+                                                         const Vector3Array& points,
+                                                         Scalar threshold = 1e-4_ra );
+
+/// Compute the points of \p coordinates for the cage vertices \p cageVertices,
+/// in parallel over the points.
+RA_CORE_API void cageDeformation( const Vector3Array& cageVertices,
+                                  const CageCoordinates& coordinates,
+                                  Vector3Array& outMesh );
+
+/// Same as above for the current vertices of \p cage.
+RA_CORE_API void
+cageDeformation( const Cage& cage, const CageCoordinates& coordinates, Vector3Array& outMesh );
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_CAGE_DEFORMATION_HPP
@@ -0,0 +1,323 @@
+#include <Core/Animation/CompressedClip.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+namespace {
+
+// Maximal number of keys replaced by the interpolation of two kept keys, which
+// bounds the cost of the key reduction.
+constexpr uint MaxReducedSpan = 256;
+
+// Angle between two rotations, accurate for small angles unlike the arc cosine
+// of the dot product.
+inline Scalar angle( const Quaternion& q0, const Quaternion& q1 ) {
+    const Quaternion q = q0.conjugate() * q1;
+    return 2 * std::atan2( q.vec().norm(), std::abs( q.w() ) );
+}
+
+// Indices of the keys kept by the greedy reduction of the keys of a channel:
+// from each kept key, the next one is the farthest key such that the keys in
+// between are interpolated within the tolerance.
+template <typename Container, typename Lerp, typename Error>
+std::vector<uint> reduceKeys( const std::vector<Time>& times,
+                              const Container& values,
+                              const Scalar tolerance,
+                              const Lerp& lerp,
+                              const Error& error ) {
+    const uint n = uint( times.size() );
+    std::vector<uint> kept {0};
+    // a constant channel is reduced to its first key
+    bool constant = true;
+    for ( uint i = 1; i < n && constant; ++i )
+    {
+        constant = error( values[0], values[i] ) <= tolerance;
+    }
+    if ( constant ) { return kept; }
+
+    const auto fits = [&]( uint a, uint b ) {
+        for ( uint i = a + 1; i < b; ++i )
+        {
+            const Scalar t = ( times[i] - times[a] ) / ( times[b] - times[a] );
+            if ( error( lerp( values[a], values[b], t ), values[i] ) > tolerance ) { return false; }
+        }
+        return true;
+    };
+    uint a = 0;
+    while ( a + 1 < n )
+    {
+        uint b = a + 1;
+        while ( b + 1 < n && b + 1 - a <= MaxReducedSpan && fits( a, b + 1 ) )
+        {
+            ++b;
+        }
+        kept.push_back( b );
+        a = b;
+    }
+    return kept;
+}
+
+} // namespace
+
+CompressedClip::CompressedClip() : CompressedClip( Settings() ) {}
+
+CompressedClip::CompressedClip( const Settings& settings ) : m_settings( settings ) {}
+
+void CompressedClip::Channel::clear() {
+    m_offsets = {0};
+    m_times.clear();
+    m_values.clear();
+    m_origins.clear();
+    m_steps.clear();
+}
+
+size_t CompressedClip::Channel::getMemoryUsage() const {
+    return m_offsets.size() * sizeof( uint ) + m_times.size() * sizeof( Time ) +
+           m_values.size() * sizeof( Quantized ) +
+           ( m_origins.size() + m_steps.size() ) * sizeof( Vector3 );
+}
+
+uint CompressedClip::Channel::findKey( const uint track, const Time& t, uint& key ) const {
+    const uint begin = m_offsets[track];
+    const uint last  = m_offsets[track + 1] - 1;
+    uint k           = std::min( begin + key, last );
+    if ( t < m_times[k] )
+    {
+        const auto it = std::upper_bound( m_times.begin() + begin, m_times.begin() + k, t );
+        k             = it == m_times.begin() + begin ? begin : uint( it - m_times.begin() ) - 1;
+    }
+    else
+    {
+        while ( k < last && m_times[k + 1] <= t )
+        {
+            ++k;
+        }
+    }
+    key = k - begin;
+    return k;
+}
+
+void CompressedClip::Channel::addVectors( const std::vector<Time>& times,
+                                          const Vector3Array& values,
+                                          const std::vector<uint>& kept ) {
+    Vector3 min = values[kept[0]];
+    Vector3 max = min;
+    for ( uint k : kept )
+    {
+        min = min.cwiseMin( values[k] );
+        max = max.cwiseMax( values[k] );
+    }
+    const Vector3 step = ( max - min ) / Scalar( 0xffff );
+    for ( uint k : kept )
+    {
+        Quantized q;
+        for ( int c = 0; c < 3; ++c )
+        {
+            q[c] = step( c ) > 0
+                       ? std::uint16_t( std::lround( ( values[k]( c ) - min( c ) ) / step( c ) ) )
+                       : 0;
+        }
+        m_times.push_back( times[k] );
+        m_values.push_back( q );
+    }
+    m_origins.push_back( min );
+    m_steps.push_back( step );
+    m_offsets.push_back( uint( m_times.size() ) );
+}
+
+Vector3 CompressedClip::Channel::vector( const uint track, const uint k ) const {
+    const Quantized& q = m_values[k];
+    return m_origins[track] +
+           m_steps[track].cwiseProduct( Vector3( Scalar( q[0] ), Scalar( q[1] ), Scalar( q[2] ) ) );
+}
+
+CompressedClip::Quantized CompressedClip::encodeRotation( const Quaternion& rotation ) {
+    Vector4 c = rotation.normalized().coeffs();
+    int largest;
+    c.cwiseAbs().maxCoeff( &largest );
+    // q and -q are the same rotation: the dropped component is positive
+    if ( c( largest ) < 0 ) { c = -c; }
+    Quantized q;
+    int j = 0;
+    for ( int i = 0; i < 4; ++i )
+    {
+        if ( i == largest ) { continue; }
+        // the other components are in [-1/sqrt(2), 1/sqrt(2)], with an even number of
+        // steps so that 0 is exact
+        const Scalar v = std::min( std::max( ( c( i ) * std::sqrt( 2_ra ) + 1 ) / 2, 0_ra ), 1_ra );
+        q[j++]         = std::uint16_t( std::lround( v * 0x7ffe ) );
+    }
+    // the index of the dropped component is stored in the high bits
+    q[0] |= std::uint16_t( ( largest & 1 ) << 15 );
+    q[1] |= std::uint16_t( ( largest >> 1 ) << 15 );
+    return q;
+}
+
+Quaternion CompressedClip::decodeRotation( const Quantized& q ) {
+    const int largest = ( q[0] >> 15 ) | ( ( q[1] >> 15 ) << 1 );
+    Vector4 c;
+    Scalar sum = 0;
+    int j      = 0;
+    for ( int i = 0; i < 4; ++i )
+    {
+        if ( i == largest ) { continue; }
+        const Scalar v = Scalar( q[j++] & 0x7fff ) / 0x7ffe;
+        c( i )         = ( 2 * v - 1 ) / std::sqrt( 2_ra );
+        sum += c( i ) * c( i );
+    }
+    c( largest ) = std::sqrt( std::max( 1 - sum, 0_ra ) );
+    return Quaternion( c );
+}
+
+uint CompressedClip::addTrack( const KeyTransform& keys ) {
+    std::vector<Transform> frames;
+    frames.reserve( keys.size() );
+    for ( uint i = 0; i < keys.size(); ++i )
+    {
+        frames.push_back( keys.getKeyFrame( i ) );
+    }
+    return addTrack( keys.timeSchedule(), frames );
+}
+
+uint CompressedClip::addTrack( const std::vector<Time>& frameTimes,
+                               const std::vector<Transform>& frames ) {
+    CORE_ASSERT( frameTimes.size() == frames.size(), "Times and frames mismatch" );
+    CORE_ASSERT( std::is_sorted( frameTimes.begin(), frameTimes.end() ), "Times are not sorted" );
+    // same decomposition as the interpolation of transforms
+    std::vector<Time> times = frameTimes;
+    Vector3Array translations;
+    AlignedStdVector<Quaternion> rotations;
+    Vector3Array scales;
+    for ( const auto& frame : frames )
+    {
+        Matrix3 rotation;
+        Matrix3 scale;
+        frame.computeRotationScaling( &rotation, &scale );
+        translations.push_back( frame.translation() );
+        rotations.push_back( Quaternion( rotation ) );
+        scales.push_back( scale.diagonal() );
+    }
+    if ( times.empty() )
+    {
+        times.push_back( 0 );
+        translations.push_back( Vector3::Zero() );
+        rotations.push_back( Quaternion::Identity() );
+        scales.push_back( Vector3::Ones() );
+    }
+    else
+    {
+        if ( times.front() < m_time.getStart() ) { m_time.setStart( times.front() ); }
+        if ( times.back() > m_time.getEnd() ) { m_time.setEnd( times.back() ); }
+    }
+
+    const auto lerp = []( const Vector3& v0, const Vector3& v1, Scalar t ) {
+        return Vector3( ( 1 - t ) * v0 + t * v1 );
+    };
+    const auto distance = []( const Vector3& v0, const Vector3& v1 ) {
+        return ( v1 - v0 ).norm();
+    };
+    const auto slerp = []( const Quaternion& q0, const Quaternion& q1, Scalar t ) {
+        return q0.slerp( t, q1 );
+    };
+    const std::vector<uint> keptTranslations =
+        reduceKeys( times, translations, m_settings.translationTolerance, lerp, distance );
+    const std::vector<uint> keptRotations =
+        reduceKeys( times, rotations, m_settings.rotationTolerance, slerp, angle );
+    const std::vector<uint> keptScales =
+        reduceKeys( times, scales, m_settings.scaleTolerance, lerp, distance );
+
+    m_translations.addVectors( times, translations, keptTranslations );
+    m_scales.addVectors( times, scales, keptScales );
+    for ( uint k : keptRotations )
+    {
+        m_rotations.m_times.push_back( times[k] );
+        m_rotations.m_values.push_back( encodeRotation( rotations[k] ) );
+    }
+    m_rotations.m_offsets.push_back( uint( m_rotations.m_times.size() ) );
+    const uint track = getTrackCount() - 1;
+
+    // errors on the source keys
+    m_report.sourceKeys += frames.size();
+    m_report.sourceBytes += frames.size() * ( sizeof( Time ) + sizeof( Transform ) );
+    m_report.keptKeys += keptTranslations.size() + keptRotations.size() + keptScales.size();
+    for ( const auto* kept : {&keptTranslations, &keptRotations, &keptScales} )
+    {
+        if ( kept->size() == 1 && times.size() > 1 ) { ++m_report.constantChannels; }
+    }
+    uint keys[3] = {0, 0, 0};
+    for ( size_t i = 0; i < frames.size(); ++i )
+    {
+        const Transform t = sample( track, times[i], keys );
+        Matrix3 rotation;
+        Matrix3 scale;
+        t.computeRotationScaling( &rotation, &scale );
+        m_report.translationError =
+            std::max( m_report.translationError, distance( t.translation(), translations[i] ) );
+        m_report.rotationError =
+            std::max( m_report.rotationError, angle( Quaternion( rotation ), rotations[i] ) );
+        m_report.scaleError =
+            std::max( m_report.scaleError, distance( scale.diagonal(), scales[i] ) );
+    }
+    return track;
+}
+
+void CompressedClip::clear() {
+    m_translations.clear();
+    m_rotations.clear();
+    m_scales.clear();
+    m_time   = AnimationTime();
+    m_report = Report();
+}
+
+size_t CompressedClip::getMemoryUsage() const {
+    return m_translations.getMemoryUsage() + m_rotations.getMemoryUsage() +
+           m_scales.getMemoryUsage();
+}
+
+Transform CompressedClip::sample( const uint track, const Time& t, uint keys[3] ) const {
+    CORE_ASSERT( track < getTrackCount(), "Invalid track" );
+    // interpolation factor between the key k0 of a channel and the next one
+    const auto factor = [track, &t]( const Channel& channel, uint k0 ) {
+        if ( k0 + 1 >= channel.m_offsets[track + 1] || t <= channel.m_times[k0] ) { return 0_ra; }
+        return ( t - channel.m_times[k0] ) / ( channel.m_times[k0 + 1] - channel.m_times[k0] );
+    };
+
+    const uint t0       = m_translations.findKey( track, t, keys[0] );
+    const Scalar dt     = factor( m_translations, t0 );
+    Vector3 translation = m_translations.vector( track, t0 );
+    if ( dt > 0 )
+    { translation = ( 1 - dt ) * translation + dt * m_translations.vector( track, t0 + 1 ); }
+
+    const uint r0       = m_rotations.findKey( track, t, keys[1] );
+    const Scalar dr     = factor( m_rotations, r0 );
+    Quaternion rotation = decodeRotation( m_rotations.m_values[r0] );
+    if ( dr > 0 )
+    { rotation = rotation.slerp( dr, decodeRotation( m_rotations.m_values[r0 + 1] ) ); }
+
+    const uint s0   = m_scales.findKey( track, t, keys[2] );
+    const Scalar ds = factor( m_scales, s0 );
+    Vector3 scale   = m_scales.vector( track, s0 );
+    if ( ds > 0 ) { scale = ( 1 - ds ) * scale + ds * m_scales.vector( track, s0 + 1 ); }
+
+    Transform result;
+    result.fromPositionOrientationScale( translation, rotation, scale );
+    return result;
+}
+
+void CompressedClip::sample( const Time& t, ClipCursor& cursor, Pose& pose ) const {
+    const uint size = getTrackCount();
+    cursor.m_keys.resize( 3 * size, 0 );
+    pose.resize( size );
+    for ( uint track = 0; track < size; ++track )
+    {
+        pose[track] = sample( track, t, &cursor.m_keys[3 * track] );
+    }
+}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,145 @@
+#ifndef RADIUMENGINE_COMPRESSED_CLIP_HPP
+#define RADIUMENGINE_COMPRESSED_CLIP_HPP
+
+#include <Core/Animation/AnimationTime.hpp>
+#include <Core/Animation/KeyTransform.hpp>
+#include <Core/Animation/Pose.hpp>
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+/**
+ * A CompressedClip stores the keyframes of the transforms of several handles,
+ * e.g. the bones of a skeleton, one track per handle, compressed to reduce the
+ * memory footprint of long clips such as motion captures.
+ *
+ * The keys of each track are decomposed in translation, rotation and scale
+ * channels, which are compressed independently:
+ * - keys which are interpolated by their neighbours within a tolerance are
+ *   removed, so that constant channels are reduced to a single key,
+ * - rotations are quantized with the smallest-three encoding: the largest
+ *   component of the quaternion is dropped, and the three other ones are
+ *   stored on 15 bits each,
+ * - translations and scales are quantized on 16 bits per component, in the
+ *   range of the values of their channel.
+ * The quantization error adds to the tolerance of the key reduction, the
+ * actual errors are measured on the source keys when compressing, see
+ * getReport().
+ * As with BakedClip, a ClipCursor stores the last key used in each channel,
+ * so that sampling at increasing times finds the keys in constant time.
+ */
+class RA_CORE_API CompressedClip
+{
+  public:
+    /// Tolerances of the key reduction.
+    struct Settings {
+        Scalar translationTolerance{1e-3_ra};
+        /// Angle, in radians.
+        Scalar rotationTolerance{1e-3_ra};
+        Scalar scaleTolerance{1e-3_ra};
+    };
+
+    /// Statistics of the compression of all the tracks.
+    struct Report {
+        /// Number of keys of the source tracks, and their size as transforms.
+        size_t sourceKeys{0};
+        size_t sourceBytes{0};
+        /// Number of keys kept in the translation, rotation and scale channels.
+        size_t keptKeys{0};
+        /// Number of channels reduced to a single key.
+        size_t constantChannels{0};
+        /// Maximal errors on the source keys.
+        Scalar translationError{0};
+        Scalar rotationError{0};
+        Scalar scaleError{0};
+    };
+
+    /// The keys used by a player of the clip, one per channel, to be reused
+    /// from a sample to the next one. A cursor can be used with one clip only.
+    struct ClipCursor {
+        std::vector<uint> m_keys;
+    };
+
+    CompressedClip();
+    explicit CompressedClip( const Settings& settings );
+
+    /// Compress and add a track with the keyframes of \p keys, the identity if
+    /// empty.
+    /// \return the index of the track.
+    uint addTrack( const KeyTransform& keys );
+
+    /// Compress and add a track with the transforms \p frames at the
+    /// increasing \p times.
+    /// \return the index of the track.
+    uint addTrack( const std::vector<Time>& times, const std::vector<Transform>& frames );
+
+    /// Remove all the tracks.
+    void clear();
+
+    inline uint getTrackCount() const { return uint( m_translations.m_offsets.size() - 1 ); }
+
+    /// Time span of the keys of all the tracks.
+    inline const AnimationTime& getAnimationTime() const { return m_time; }
+
+    inline const Report& getReport() const { return m_report; }
+
+    /// Size of the compressed data, in bytes.
+    size_t getMemoryUsage() const;
+
+    /// Sample the track \p track at time \p t, starting the search from the
+    /// keys \p keys of its channels, which are updated.
+    Transform sample( const uint track, const Time& t, uint keys[3] ) const;
+
+    /// Sample all the tracks at time \p t into \p pose, using and updating
+    /// \p cursor.
+    void sample( const Time& t, ClipCursor& cursor, Pose& pose ) const;
+
+  private:
+    using Quantized = std::array<std::uint16_t, 3>;
+
+    /// The keys of a channel of all the tracks, those of the track k being
+    /// [m_offsets[k], m_offsets[k + 1][.
+    struct Channel {
+        std::vector<uint> m_offsets{0};
+        std::vector<Time> m_times;
+        std::vector<Quantized> m_values;
+        /// Range of the quantized vectors of each track: origin and step.
+        Vector3Array m_origins;
+        Vector3Array m_steps;
+
+        void clear();
+        size_t getMemoryUsage() const;
+        /// Index of the key of \p track at or before \p t, the first one if
+        /// none, starting the search from the key \p key of the track.
+        uint findKey( const uint track, const Time& t, uint& key ) const;
+        /// Add the keys \p kept of the vectors \p values as a new track.
+        void addVectors( const std::vector<Time>& times,
+                         const Vector3Array& values,
+                         const std::vector<uint>& kept );
+        Vector3 vector( const uint track, const uint k ) const;
+    };
+
+    static Quantized encodeRotation( const Quaternion& q );
+    static Quaternion decodeRotation( const Quantized& q );
+
+    Settings m_settings;
+    Channel m_translations;
+    Channel m_rotations;
+    Channel m_scales;
+    AnimationTime m_time;
+    Report m_report;
+};
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_COMPRESSED_CLIP_HPP
@@ -3,6 +3,48 @@
 namespace Ra {
 namespace Core {
 namespace Animation {
+
+namespace {
+
+// Blend the dual quaternions of the vertex i from packed weights, and transform it.
+inline void skinVertex( const Vector3Array& inMesh,
+                        const Vector3Array& inNormals,
+                        const DQList& poseDQ,
+                        const PackedWeights& weight,
+                        const int i,
+                        Vector3Array& outMesh,
+                        Vector3Array& outNormals ) {
+    // the influences are sorted by decreasing weight, the first one gives the hemisphere
+    const uint* bones       = weight.m_bones.data() + i;
+    const Scalar* w         = weight.m_weights.data() + i;
+    const Quaternion& pivot = poseDQ[bones[0]].getQ0();
+    Quaternion q0( 0, 0, 0, 0 );
+    Quaternion qe( 0, 0, 0, 0 );
+    for ( uint k = 0; k < weight.m_influences; ++k )
+    {
+        const DualQuaternion& dq = poseDQ[bones[k * weight.m_size]];
+        const Scalar sw          = Math::signNZ( dq.getQ0().dot( pivot ) ) * w[k * weight.m_size];
+        q0.coeffs() += sw * dq.getQ0().coeffs();
+        qe.coeffs() += sw * dq.getQe().coeffs();
+    }
+    const Scalar norm = q0.norm();
+    if ( norm == 0 )
+    {
+        outMesh[i] = inMesh[i];
+        if ( !inNormals.empty() ) { outNormals[i] = inNormals[i]; }
+        return;
+    }
+    q0.coeffs() /= norm;
+    qe.coeffs() /= norm;
+    const Matrix3 rotation = q0.toRotationMatrix();
+    const Vector3 translation =
+        2 * ( qe.vec() * q0.w() - q0.vec() * qe.w() + q0.vec().cross( qe.vec() ) );
+    outMesh[i] = rotation * inMesh[i] + translation;
+    if ( !inNormals.empty() ) { outNormals[i] = rotation * inNormals[i]; }
+}
+
+} // namespace
+
 void computeDQ( const Pose& pose, const Sparse& weight, DQList& DQ ) {
     CORE_ASSERT( ( pose.size() == size_t( weight.cols() ) ), "pose/weight size mismatch." );
     DQ.clear();
@@ -115,6 +157,60 @@ void dualQuaternionSkinning( const Ra::Core::Vector3Array& input,
         output[i] = DQ[i].transform( input[i] );
     }
 }
+
+void dualQuaternionSkinning( const Ra::Core::Vector3Array& inMesh,
+                             const Pose& pose,
+                             const PackedWeights& weight,
+                             Ra::Core::Vector3Array& outMesh ) {
+    Vector3Array none;
+    dualQuaternionSkinning( inMesh, none, pose, weight, outMesh, none );
+}
+
+void dualQuaternionSkinning( const Ra::Core::Vector3Array& inMesh,
+                             const Ra::Core::Vector3Array& inNormals,
+                             const Pose& pose,
+                             const PackedWeights& weight,
+                             Ra::Core::Vector3Array& outMesh,
+                             Ra::Core::Vector3Array& outNormals ) {
+    CORE_ASSERT( inMesh.size() == weight.m_size, "Weights do not match the mesh" );
+    CORE_ASSERT( inNormals.empty() || inNormals.size() == inMesh.size(), "Invalid normals" );
+    outMesh.resize( inMesh.size() );
+    outNormals.resize( inNormals.size() );
+    DQList poseDQ;
+    computePoseDQ( pose, poseDQ );
+    const int size = int( weight.m_size );
+#pragma omp parallel for
+    for ( int i = 0; i < size; ++i )
+    {
+        skinVertex( inMesh, inNormals, poseDQ, weight, i, outMesh, outNormals );
+    }
+}
+
+void computePoseDQ( const Pose& pose, DQList& poseDQ ) {
+    poseDQ.resize( pose.size() );
+    for ( size_t j = 0; j < pose.size(); ++j )
+    {
+        poseDQ[j].setFromTransform( pose[j] );
+    }
+}
+
+void dualQuaternionSkinning( const Ra::Core::Vector3Array& inMesh,
+                             const Ra::Core::Vector3Array& inNormals,
+                             const DQList& poseDQ,
+                             const PackedWeights& weight,
+                             const int begin,
+                             const int end,
+                             Ra::Core::Vector3Array& outMesh,
+                             Ra::Core::Vector3Array& outNormals ) {
+    CORE_ASSERT( 0 <= begin && begin <= end && end <= int( weight.m_size ), "Invalid range" );
+    CORE_ASSERT( outMesh.size() == inMesh.size() && outNormals.size() == inNormals.size(),
+                 "Outputs are not allocated" );
+    for ( int i = begin; i < end; ++i )
+    {
+        skinVertex( inMesh, inNormals, poseDQ, weight, i, outMesh, outNormals );
+    }
+}
+
 } // namespace Animation
 } // namespace Core
 } // namespace Ra
@@ -1,6 +1,7 @@
 #ifndef RADIUMENGINE_DUAL_QUATERNION_SKINNING_HPP
 #define RADIUMENGINE_DUAL_QUATERNION_SKINNING_HPP
 
+#include <Core/Animation/HandleWeight.hpp>
 #include <Core/Animation/Pose.hpp>
 #include <Core/Containers/AlignedStdVector.hpp>
 #include <Core/Containers/VectorArray.hpp>
@@ -34,6 +35,49 @@ void RA_CORE_API dualQuaternionSkinning( const Ra::Core::Vector3Array& input,
                                          const DQList& DQ,
                                          Ra::Core::Vector3Array& output );
 
+/*
+ * Dual quaternion skinning with weights packed by packWeights(), blending the dual quaternions and
+ * transforming the vertices in a single parallel pass over the vertices, without storing the
+ * blended dual quaternions.
+ * The dual quaternions of the bones of a vertex are flipped to the hemisphere of the one of its
+ * largest weight before blending, so that the shortest rotation path is used. Vertices without
+ * any weight are left unchanged.
+ */
+void RA_CORE_API dualQuaternionSkinning( const Ra::Core::Vector3Array& inMesh,
+                                         const Pose& pose,
+                                         const PackedWeights& weight,
+                                         Ra::Core::Vector3Array& outMesh );
+
+/*
+ * Same as above, also rotating the normals of the mesh in the same pass. Empty \p inNormals are
+ * skipped.
+ */
+void RA_CORE_API dualQuaternionSkinning( const Ra::Core::Vector3Array& inMesh,
+                                         const Ra::Core::Vector3Array& inNormals,
+                                         const Pose& pose,
+                                         const PackedWeights& weight,
+                                         Ra::Core::Vector3Array& outMesh,
+                                         Ra::Core::Vector3Array& outNormals );
+
+/*
+ * Convert each transform of \p pose to a dual quaternion, ignoring its non-rigid components.
+ */
+void RA_CORE_API computePoseDQ( const Pose& pose, DQList& poseDQ );
+
+/*
+ * Packed dual quaternion skinning with a pose converted by computePoseDQ(), only for the vertices
+ * [\p begin, \p end[, sequentially, in outputs already of the size of the inputs, for callers which
+ * split the vertices between threads themselves.
+ */
+void RA_CORE_API dualQuaternionSkinning( const Ra::Core::Vector3Array& inMesh,
+                                         const Ra::Core::Vector3Array& inNormals,
+                                         const DQList& poseDQ,
+                                         const PackedWeights& weight,
+                                         const int begin,
+                                         const int end,
+                                         Ra::Core::Vector3Array& outMesh,
+                                         Ra::Core::Vector3Array& outNormals );
+
 } // namespace Animation
 } // namespace Core
 } // namespace Ra
@@ -4,6 +4,7 @@
 #include <Core/Containers/AlignedStdVector.hpp>
 #include <Core/Types.hpp>
 #include <map>
+#include <vector>
 
 namespace Ra {
 namespace Core {
@@ -29,6 +30,18 @@ using MeshWeight = AlignedStdVector<VertexWeight>;
 //      M( i, j ) = 0   , otherwise
 using WeightMatrix = Ra::Core::Sparse;
 
+// Defining the skinning weights packed vertex-major, with a fixed number of influences per vertex,
+// as a structure of arrays to process consecutive vertices together:
+//      m_bones[k * m_size + i]   = handle of the k-th influence on vertex i
+//      m_weights[k * m_size + i] = weight of the k-th influence on vertex i
+// Vertices with less influences are padded with handle 0 and weight 0.
+struct PackedWeights {
+    uint m_influences{0};
+    uint m_size{0};
+    std::vector<uint> m_bones;
+    std::vector<Scalar> m_weights;
+};
+
 } // namespace Animation
 } // Namespace Core
 } // Namespace Ra
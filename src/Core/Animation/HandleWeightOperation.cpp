@@ -1,6 +1,9 @@
 #include <Core/Animation/HandleWeightOperation.hpp>
 #include <Core/Math/LinearAlgebra.hpp> // Math::checkInvalidNumbers
 #include <Core/Utils/Log.hpp>
+
+#include <algorithm>
+#include <functional>
 #include <utility>
 
 namespace Ra {
@@ -132,6 +135,49 @@ bool normalizeWeights( Eigen::Ref<WeightMatrix> matrix, const bool MT ) {
     return !skinningWeightOk;
 }
 
+size_t packWeights( const WeightMatrix& weights, const uint influences, PackedWeights& packed ) {
+    CORE_ASSERT( influences > 0, "At least one influence per vertex is required" );
+    const Eigen::SparseMatrix<Scalar, Eigen::RowMajor> rows = weights;
+    const int size                                          = int( rows.rows() );
+    packed.m_influences                                     = influences;
+    packed.m_size                                           = uint( size );
+    packed.m_bones.assign( size_t( size ) * influences, 0 );
+    packed.m_weights.assign( size_t( size ) * influences, 0_ra );
+
+    int truncated = 0;
+#pragma omp parallel for reduction( + : truncated )
+    for ( int i = 0; i < size; ++i )
+    {
+        std::vector<std::pair<Scalar, uint>> row;
+        Scalar sum = 0;
+        for ( Eigen::SparseMatrix<Scalar, Eigen::RowMajor>::InnerIterator it( rows, i ); it; ++it )
+        {
+            if ( it.value() == 0 ) { continue; }
+            row.emplace_back( it.value(), uint( it.col() ) );
+            sum += it.value();
+        }
+        std::sort( row.begin(), row.end(), std::greater<>() );
+        Scalar scale = 1;
+        if ( row.size() > influences )
+        {
+            row.resize( influences );
+            Scalar kept = 0;
+            for ( const auto& w : row )
+            {
+                kept += w.first;
+            }
+            if ( kept != 0 ) { scale = sum / kept; }
+            ++truncated;
+        }
+        for ( size_t k = 0; k < row.size(); ++k )
+        {
+            packed.m_bones[k * size_t( size ) + size_t( i )]   = row[k].second;
+            packed.m_weights[k * size_t( size ) + size_t( i )] = row[k].first * scale;
+        }
+    }
+    return size_t( truncated );
+}
+
 } // namespace Animation
 } // Namespace Core
 } // Namespace Ra
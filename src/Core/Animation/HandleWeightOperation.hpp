@@ -54,6 +54,17 @@ RA_CORE_API bool checkNoWeightVertex( Eigen::Ref<const WeightMatrix> matrix,
  */
 RA_CORE_API bool normalizeWeights( Eigen::Ref<WeightMatrix> matrix, const bool MT = false );
 
+/**
+ * Pack \p weights into \p packed, with \p influences influences per vertex (usually 4 or 8),
+ * sorted by decreasing weight.
+ * The vertices with more influences keep the largest ones, scaled so that the sum of their
+ * weights is unchanged.
+ * \return the number of vertices which lost influences.
+ */
+RA_CORE_API size_t packWeights( const WeightMatrix& weights,
+                                const uint influences,
+                                PackedWeights& packed );
+
 } // namespace Animation
 } // Namespace Core
 } // Namespace Ra
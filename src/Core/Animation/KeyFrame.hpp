@@ -1,6 +1,7 @@
 #ifndef RADIUMENGINE_KEY_FRAME_HPP
 #define RADIUMENGINE_KEY_FRAME_HPP
 
+#include <iterator>
 #include <map>
 #include <set>
 
@@ -33,12 +34,12 @@ class KeyFrame
     /// TRANSFORMATION
     inline FRAME getKeyFrame( const uint i ) const {
         CORE_ASSERT( ( i < size() ), "Index i out of bound" );
-        return ( m_keyframe.begin() + i )->second;
+        return std::next( m_keyframe.begin(), i )->second;
     }
 
     inline FRAME& getKeyFrame( const uint i ) {
         CORE_ASSERT( ( i < size() ), "Index i out of bound" );
-        return ( m_keyframe.begin() + i )->second;
+        return std::next( m_keyframe.begin(), i )->second;
     }
 
     inline FRAME at( const Time& t ) const {
@@ -52,7 +53,7 @@ class KeyFrame
 
     inline void setKeyFrame( const uint i, const FRAME& frame ) {
         CORE_ASSERT( ( i < size() ), "Index i out of bound" );
-        Time t = ( m_keyframe.begin() + i )->first;
+        Time t = std::next( m_keyframe.begin(), i )->first;
         setKeyFrame( t, frame );
     }
 
@@ -1,9 +1,113 @@
 #include <Core/Animation/LinearBlendSkinning.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace Ra {
 namespace Core {
 namespace Animation {
 
+namespace {
+
+// Number of vertices skinned together.
+constexpr int BlockSize = 64;
+
+// Blended matrices of a block of vertices, as 3x4 row-major matrices stored
+// coefficient by coefficient: m[4 * r + c][i] is the coefficient (r, c) of
+// the matrix of the i-th vertex of the block.
+using BlockMatrices = Scalar[12][BlockSize];
+
+// Blend the matrices of the vertices [begin, begin + count[, K being the
+// number of influences if known at compile time, 0 otherwise.
+template <int K>
+void blendMatrices( const PackedWeights& weight,
+                    const Scalar* pose,
+                    const int begin,
+                    const int count,
+                    BlockMatrices& m ) {
+    using Coefficients   = Eigen::Matrix<Scalar, 12, 1>;
+    const int influences = K > 0 ? K : int( weight.m_influences );
+    const uint* bones    = weight.m_bones.data() + begin;
+    const Scalar* w      = weight.m_weights.data() + begin;
+    for ( int i = 0; i < count; ++i )
+    {
+        // the 12 coefficients of each bone are contiguous, and accumulated in
+        // registers before being scattered in the block
+        Coefficients acc = Coefficients::Zero();
+        for ( int k = 0; k < influences; ++k )
+        {
+            const size_t offset = size_t( k ) * weight.m_size + size_t( i );
+            acc += w[offset] * Eigen::Map<const Coefficients>( pose + 12 * bones[offset] );
+        }
+        for ( int e = 0; e < 12; ++e )
+        {
+            m[e][i] = acc( e );
+        }
+    }
+}
+
+void transformPoints( const BlockMatrices& m, const int count, const Scalar* in, Scalar* out ) {
+#pragma omp simd
+    for ( int i = 0; i < count; ++i )
+    {
+        const Scalar x = in[3 * i];
+        const Scalar y = in[3 * i + 1];
+        const Scalar z = in[3 * i + 2];
+        out[3 * i]     = m[0][i] * x + m[1][i] * y + m[2][i] * z + m[3][i];
+        out[3 * i + 1] = m[4][i] * x + m[5][i] * y + m[6][i] * z + m[7][i];
+        out[3 * i + 2] = m[8][i] * x + m[9][i] * y + m[10][i] * z + m[11][i];
+    }
+}
+
+void transformDirections( const BlockMatrices& m, const int count, const Scalar* in, Scalar* out ) {
+#pragma omp simd
+    for ( int i = 0; i < count; ++i )
+    {
+        const Scalar x  = in[3 * i];
+        const Scalar y  = in[3 * i + 1];
+        const Scalar z  = in[3 * i + 2];
+        const Scalar dx = m[0][i] * x + m[1][i] * y + m[2][i] * z;
+        const Scalar dy = m[4][i] * x + m[5][i] * y + m[6][i] * z;
+        const Scalar dz = m[8][i] * x + m[9][i] * y + m[10][i] * z;
+        const Scalar n  = std::sqrt( dx * dx + dy * dy + dz * dz );
+        const Scalar s  = n > 0 ? 1 / n : 0;
+        out[3 * i]      = dx * s;
+        out[3 * i + 1]  = dy * s;
+        out[3 * i + 2]  = dz * s;
+    }
+}
+
+template <int K>
+void packedSkinning( const Vector3Array& inMesh,
+                     const Vector3Array& inNormals,
+                     const Vector3Array& inTangents,
+                     const PoseMatrices& pose,
+                     const PackedWeights& weight,
+                     const int begin,
+                     const int end,
+                     Vector3Array& outMesh,
+                     Vector3Array& outNormals,
+                     Vector3Array& outTangents ) {
+    const bool normals  = !inNormals.empty();
+    const bool tangents = !inTangents.empty();
+    BlockMatrices m;
+    for ( int first = begin; first < end; first += BlockSize )
+    {
+        const int count = std::min( BlockSize, end - first );
+        blendMatrices<K>( weight, pose[0].data(), first, count, m );
+        transformPoints( m, count, inMesh[first].data(), outMesh[first].data() );
+        if ( normals )
+        { transformDirections( m, count, inNormals[first].data(), outNormals[first].data() ); }
+        if ( tangents )
+        {
+            transformDirections(
+                m, count, inTangents[first].data(), outTangents[first].data() );
+        }
+    }
+}
+
+} // namespace
+
 void linearBlendSkinning( const Vector3Array& inMesh,
                           const Pose& pose,
                           const WeightMatrix& weight,
@@ -26,6 +130,114 @@ void linearBlendSkinning( const Vector3Array& inMesh,
     }
 }
 
+void linearBlendSkinning( const Vector3Array& inMesh,
+                          const Pose& pose,
+                          const PackedWeights& weight,
+                          Vector3Array& outMesh ) {
+    Vector3Array none;
+    linearBlendSkinning( inMesh, none, none, pose, weight, outMesh, none, none );
+}
+
+void linearBlendSkinning( const Vector3Array& inMesh,
+                          const Vector3Array& inNormals,
+                          const Vector3Array& inTangents,
+                          const Pose& pose,
+                          const PackedWeights& weight,
+                          Vector3Array& outMesh,
+                          Vector3Array& outNormals,
+                          Vector3Array& outTangents ) {
+    CORE_ASSERT( inMesh.size() == weight.m_size, "Weights do not match the mesh" );
+    CORE_ASSERT( inNormals.empty() || inNormals.size() == inMesh.size(), "Invalid normals" );
+    CORE_ASSERT( inTangents.empty() || inTangents.size() == inMesh.size(), "Invalid tangents" );
+    outMesh.resize( inMesh.size() );
+    outNormals.resize( inNormals.size() );
+    outTangents.resize( inTangents.size() );
+    if ( inMesh.empty() ) { return; }
+    PoseMatrices matrices;
+    computePoseMatrices( pose, matrices );
+    const int size     = int( weight.m_size );
+    const int nbBlocks = ( size + BlockSize - 1 ) / BlockSize;
+#pragma omp parallel for
+    for ( int b = 0; b < nbBlocks; ++b )
+    {
+        const int begin = b * BlockSize;
+        const int end   = std::min( begin + BlockSize, size );
+        linearBlendSkinning( inMesh,
+                             inNormals,
+                             inTangents,
+                             matrices,
+                             weight,
+                             begin,
+                             end,
+                             outMesh,
+                             outNormals,
+                             outTangents );
+    }
+}
+
+void computePoseMatrices( const Pose& pose, PoseMatrices& matrices ) {
+    matrices.resize( pose.size() );
+    for ( size_t j = 0; j < pose.size(); ++j )
+    {
+        matrices[j] = pose[j].matrix().topRows<3>();
+    }
+}
+
+void linearBlendSkinning( const Vector3Array& inMesh,
+                          const Vector3Array& inNormals,
+                          const Vector3Array& inTangents,
+                          const PoseMatrices& pose,
+                          const PackedWeights& weight,
+                          const int begin,
+                          const int end,
+                          Vector3Array& outMesh,
+                          Vector3Array& outNormals,
+                          Vector3Array& outTangents ) {
+    CORE_ASSERT( 0 <= begin && begin <= end && end <= int( weight.m_size ), "Invalid range" );
+    CORE_ASSERT( outMesh.size() == inMesh.size() && outNormals.size() == inNormals.size() &&
+                     outTangents.size() == inTangents.size(),
+                 "Outputs are not allocated" );
+    switch ( weight.m_influences )
+    {
+    case 4:
+        packedSkinning<4>( inMesh,
+                           inNormals,
+                           inTangents,
+                           pose,
+                           weight,
+                           begin,
+                           end,
+                           outMesh,
+                           outNormals,
+                           outTangents );
+        break;
+    case 8:
+        packedSkinning<8>( inMesh,
+                           inNormals,
+                           inTangents,
+                           pose,
+                           weight,
+                           begin,
+                           end,
+                           outMesh,
+                           outNormals,
+                           outTangents );
+        break;
+    default:
+        packedSkinning<0>( inMesh,
+                           inNormals,
+                           inTangents,
+                           pose,
+                           weight,
+                           begin,
+                           end,
+                           outMesh,
+                           outNormals,
+                           outTangents );
+        break;
+    }
+}
+
 } // namespace Animation
 } // namespace Core
 } // namespace Ra
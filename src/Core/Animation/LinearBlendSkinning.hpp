@@ -3,6 +3,7 @@
 
 #include <Core/Animation/HandleWeight.hpp>
 #include <Core/Animation/Pose.hpp>
+#include <Core/Containers/AlignedStdVector.hpp>
 #include <Core/Containers/VectorArray.hpp>
 #include <Core/Types.hpp>
 
@@ -15,6 +16,50 @@ void RA_CORE_API linearBlendSkinning( const Vector3Array& inMesh,
                                       const WeightMatrix& weight,
                                       Vector3Array& outMesh );
 
+/// Linear blend skinning with weights packed by packWeights().
+/// For each vertex, the matrices of its bones are blended first, and the
+/// vertex is then transformed once by the blended matrix. The vertices are
+/// processed by blocks, each step being vectorized across the vertices of a
+/// block, and the blocks are processed in parallel.
+void RA_CORE_API linearBlendSkinning( const Vector3Array& inMesh,
+                                      const Pose& pose,
+                                      const PackedWeights& weight,
+                                      Vector3Array& outMesh );
+
+/// Same as above, also skinning the normals and tangents of the mesh in the
+/// same pass, which are transformed by the linear part of the blended matrix
+/// and normalized. Empty \p inNormals or \p inTangents are skipped.
+void RA_CORE_API linearBlendSkinning( const Vector3Array& inMesh,
+                                      const Vector3Array& inNormals,
+                                      const Vector3Array& inTangents,
+                                      const Pose& pose,
+                                      const PackedWeights& weight,
+                                      Vector3Array& outMesh,
+                                      Vector3Array& outNormals,
+                                      Vector3Array& outTangents );
+
+/// A pose as 3x4 row-major matrices, in the layout used by the packed linear
+/// blend skinning.
+using PoseMatrices = AlignedStdVector<Eigen::Matrix<Scalar, 3, 4, Eigen::RowMajor>>;
+
+/// Convert \p pose to \p matrices.
+void RA_CORE_API computePoseMatrices( const Pose& pose, PoseMatrices& matrices );
+
+/// Packed linear blend skinning with a pose converted by computePoseMatrices(),
+/// only for the vertices [\p begin, \p end[, sequentially, in outputs already
+/// of the size of the inputs, for callers which split the vertices between
+/// threads themselves.
+void RA_CORE_API linearBlendSkinning( const Vector3Array& inMesh,
+                                      const Vector3Array& inNormals,
+                                      const Vector3Array& inTangents,
+                                      const PoseMatrices& pose,
+                                      const PackedWeights& weight,
+                                      const int begin,
+                                      const int end,
+                                      Vector3Array& outMesh,
+                                      Vector3Array& outNormals,
+                                      Vector3Array& outTangents );
+
 } // namespace Animation
 } // namespace Core
 } // namespace Ra
@@ -3,6 +3,8 @@
 
 #include <Core/Containers/AlignedStdVector.hpp>
 
+#include <vector>
+
 namespace Ra {
 namespace Core {
 namespace Animation {
@@ -25,6 +27,29 @@ using ModelPose = Pose;
 
 using RelativePose = Pose;
 
+/*
+ * A pose stored as a structure of arrays: the transforms are decomposed as translation, rotation
+ * and scale, i.e. T * R * S, and each component is stored in its own array, so that all the
+ * transforms are processed together by vectorized loops. See PoseOperation.hpp for conversions.
+ */
+struct PoseBuffer {
+    inline uint size() const { return uint( m_tx.size() ); }
+
+    inline void resize( const uint n ) {
+        for ( auto* a : {&m_tx, &m_ty, &m_tz, &m_qx, &m_qy, &m_qz, &m_qw, &m_sx, &m_sy, &m_sz} )
+        {
+            a->resize( n );
+        }
+    }
+
+    // translations
+    std::vector<Scalar> m_tx, m_ty, m_tz;
+    // rotations as unit quaternions
+    std::vector<Scalar> m_qx, m_qy, m_qz, m_qw;
+    // scales along the axes
+    std::vector<Scalar> m_sx, m_sy, m_sz;
+};
+
 } // namespace Animation
 } // namespace Core
 } // namespace Ra
@@ -68,6 +68,43 @@ Pose interpolatePoses( const Pose& a, const Pose& b, const Scalar t ) {
     return interpolatedPose;
 }
 
+void poseToBuffer( const Pose& pose, PoseBuffer& buffer ) {
+    const uint size = pose.size();
+    buffer.resize( size );
+#pragma omp parallel for
+    for ( int i = 0; i < int( size ); ++i )
+    {
+        // same decomposition as the interpolation of transforms
+        Matrix3 rotation;
+        Matrix3 scale;
+        pose[i].computeRotationScaling( &rotation, &scale );
+        const Quaternion q( rotation );
+        buffer.m_tx[i] = pose[i].translation()( 0 );
+        buffer.m_ty[i] = pose[i].translation()( 1 );
+        buffer.m_tz[i] = pose[i].translation()( 2 );
+        buffer.m_qx[i] = q.x();
+        buffer.m_qy[i] = q.y();
+        buffer.m_qz[i] = q.z();
+        buffer.m_qw[i] = q.w();
+        buffer.m_sx[i] = scale( 0, 0 );
+        buffer.m_sy[i] = scale( 1, 1 );
+        buffer.m_sz[i] = scale( 2, 2 );
+    }
+}
+
+void bufferToPose( const PoseBuffer& buffer, Pose& pose ) {
+    const uint size = buffer.size();
+    pose.resize( size );
+#pragma omp parallel for
+    for ( int i = 0; i < int( size ); ++i )
+    {
+        pose[i].fromPositionOrientationScale(
+            Vector3( buffer.m_tx[i], buffer.m_ty[i], buffer.m_tz[i] ),
+            Quaternion( buffer.m_qw[i], buffer.m_qx[i], buffer.m_qy[i], buffer.m_qz[i] ),
+            Vector3( buffer.m_sx[i], buffer.m_sy[i], buffer.m_sz[i] ) );
+    }
+}
+
 } // namespace Animation
 } // namespace Core
 } // namespace Ra
@@ -44,6 +44,17 @@ RA_CORE_API bool areEqual( const Pose& p0, const Pose& p1 );
 
 RA_CORE_API Pose interpolatePoses( const Pose& a, const Pose& b, const Scalar t );
 
+/*
+ * Decompose the transforms of pose in translation, rotation and scale into buffer, the shears
+ * being dropped.
+ */
+RA_CORE_API void poseToBuffer( const Pose& pose, PoseBuffer& buffer );
+
+/*
+ * Compose the transforms of buffer into pose.
+ */
+RA_CORE_API void bufferToPose( const PoseBuffer& buffer, Pose& pose );
+
 } // namespace Animation
 } // namespace Core
 } // namespace Ra
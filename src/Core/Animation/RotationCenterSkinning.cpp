@@ -1,7 +1,13 @@
 #include <Core/Animation/RotationCenterSkinning.hpp>
 
 #include <array>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <Core/Animation/DualQuaternionSkinning.hpp>
 #include <Core/Animation/HandleWeight.hpp>
@@ -17,6 +23,71 @@ namespace Animation {
 
 using namespace Utils; // log
 
+namespace {
+
+constexpr char Magic[8]         = {'R', 'A', 'C', 'O', 'R', '\0', '\0', '\0'};
+constexpr std::uint32_t Version = 1;
+
+template <typename T>
+inline void put( std::ostream& out, const T& value ) {
+    out.write( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+template <typename T>
+inline bool get( std::istream& in, T& value ) {
+    in.read( reinterpret_cast<char*>( &value ), sizeof( T ) );
+    return bool( in );
+}
+
+// Positive weights of a vertex or a triangle, as (bone, weight) sorted by bone.
+using WeightRow = std::vector<std::pair<int, Scalar>>;
+
+template <typename SparseRow>
+WeightRow toWeightRow( const SparseRow& w ) {
+    WeightRow row;
+    for ( typename SparseRow::InnerIterator it( w, 0 ); it; ++it )
+    {
+        if ( it.value() > 0 ) { row.emplace_back( int( it.index() ), it.value() ); }
+    }
+    return row;
+}
+
+// Same as weightSimilarity(), summing over the pairs of common bones of both
+// rows, which are gathered in the scratch array common.
+Scalar weightRowSimilarity( const WeightRow& w1,
+                            const WeightRow& w2,
+                            Scalar sigma,
+                            std::vector<std::pair<Scalar, Scalar>>& common ) {
+    const Scalar sigmaSq = sigma * sigma;
+    common.clear();
+    for ( size_t a = 0, b = 0; a < w1.size() && b < w2.size(); )
+    {
+        if ( w1[a].first < w2[b].first ) { ++a; }
+        else if ( w2[b].first < w1[a].first )
+        { ++b; }
+        else
+        { common.emplace_back( w1[a++].second, w2[b++].second ); }
+    }
+    Scalar result = 0;
+    for ( size_t j = 0; j < common.size(); ++j )
+    {
+        for ( size_t k = j + 1; k < common.size(); ++k )
+        {
+            const Scalar W1j = common[j].first;
+            const Scalar W2j = common[j].second;
+            const Scalar W1k = common[k].first;
+            const Scalar W2k = common[k].second;
+            const Scalar diff =
+                std::exp( -Math::ipow<2>( ( W1j * W2k ) - ( W1k * W2j ) ) / sigmaSq );
+            result += W1j * W1k * W2j * W2k * diff;
+        }
+    }
+    // the pairs (j, k) and (k, j) have the same term
+    return 2 * result;
+}
+
+} // namespace
+
 Scalar weightSimilarity( const Eigen::SparseVector<Scalar>& v1w,
                          const Eigen::SparseVector<Scalar>& v2w,
                          Scalar sigma ) {
@@ -167,62 +238,213 @@ void computeCoR( Skinning::RefData& dataInOut, Scalar sigma, Scalar weightEpsilo
     // Second step : evaluate the integrals over all triangles for all vertices.
     //
 
-    // naive implementation : iterate over all the triangles (of the subdivided mesh)
-    // for all vertices (of the original mesh).
+    // The similarity of a vertex and a triangle is null unless they share two
+    // bones, so each vertex only visits the triangles of its bones, found in a
+    // bone to triangles index.
     const uint nVerts = V.size();
     dataInOut.m_CoR.clear();
     dataInOut.m_CoR.resize( nVerts, Vector3::Zero() );
 
-    // first precompute triangle data
-    std::map<Geometry::TopologicalMesh::FaceHandle,
-             std::tuple<Vector3, Scalar, Eigen::SparseVector<Scalar>>>
-        triangleData;
+    // first precompute triangle data, the weights being stored as rows of
+    // (bone, weight) sorted by bone
+    std::vector<std::array<int, 3>> faces;
+    faces.reserve( topoMesh.n_faces() );
     for ( auto f_it = topoMesh.faces_begin(); f_it != topoMesh.faces_end(); ++f_it )
     {
-        // get needed data
-        const auto& he0        = topoMesh.halfedge_handle( *f_it );
-        const auto& he1        = topoMesh.next_halfedge_handle( he0 );
-        const auto& he2        = topoMesh.next_halfedge_handle( he1 );
-        const auto& v0         = topoMesh.to_vertex_handle( he0 );
-        const auto& v1         = topoMesh.to_vertex_handle( he1 );
-        const auto& v2         = topoMesh.to_vertex_handle( he2 );
-        const auto& p0         = topoMesh.point( v0 );
-        const auto& p1         = topoMesh.point( v1 );
-        const auto& p2         = topoMesh.point( v2 );
-        const Vector3 centroid = ( p0 + p1 + p2 ) / 3.f;
-        const Scalar area      = Geometry::triangleArea( p0, p1, p2 );
+        const auto& he0 = topoMesh.halfedge_handle( *f_it );
+        const auto& he1 = topoMesh.next_halfedge_handle( he0 );
+        const auto& he2 = topoMesh.next_halfedge_handle( he1 );
+        faces.push_back( {topoMesh.to_vertex_handle( he0 ).idx(),
+                          topoMesh.to_vertex_handle( he1 ).idx(),
+                          topoMesh.to_vertex_handle( he2 ).idx()} );
+    }
+    const int nFaces = int( faces.size() );
+    Vector3Array centroids( faces.size() );
+    std::vector<Scalar> areas( faces.size() );
+    std::vector<WeightRow> triWeights( faces.size() );
+#pragma omp parallel for
+    for ( int f = 0; f < nFaces; ++f )
+    {
+        const auto& p0 = topoMesh.point( Geometry::TopologicalMesh::VertexHandle( faces[f][0] ) );
+        const auto& p1 = topoMesh.point( Geometry::TopologicalMesh::VertexHandle( faces[f][1] ) );
+        const auto& p2 = topoMesh.point( Geometry::TopologicalMesh::VertexHandle( faces[f][2] ) );
+        centroids[f]   = ( p0 + p1 + p2 ) / 3.f;
+        areas[f]       = Geometry::triangleArea( p0, p1, p2 );
         const Eigen::SparseVector<Scalar> triWeight =
-            ( 1 / 3.f ) *
-            ( subdivW.row( v0.idx() ) + subdivW.row( v1.idx() ) + subdivW.row( v2.idx() ) );
-        triangleData[*f_it] = std::make_tuple( centroid, area, triWeight );
+            ( 1 / 3.f ) * ( subdivW.row( faces[f][0] ) + subdivW.row( faces[f][1] ) +
+                            subdivW.row( faces[f][2] ) );
+        triWeights[f] = toWeightRow( triWeight );
     }
 
-#pragma omp parallel for
-    for ( int i = 0; i < int( nVerts ); ++i )
+    // bone to triangles index
+    std::vector<uint> boneOffsets( numCols + 1, 0 );
+    for ( const auto& w : triWeights )
+    {
+        for ( const auto& bw : w )
+        {
+            ++boneOffsets[bw.first + 1];
+        }
+    }
+    for ( int b = 0; b < numCols; ++b )
     {
-        Vector3 cor( 0, 0, 0 );
-        Scalar sumweight                     = 0;
-        const Eigen::SparseVector<Scalar> Wi = subdivW.row( mapV2I[V[i]] );
+        boneOffsets[b + 1] += boneOffsets[b];
+    }
+    std::vector<uint> boneTriangles( boneOffsets[numCols] );
+    {
+        std::vector<uint> next( boneOffsets.begin(), boneOffsets.end() - 1 );
+        for ( int f = 0; f < nFaces; ++f )
+        {
+            for ( const auto& bw : triWeights[f] )
+            {
+                boneTriangles[next[bw.first]++] = uint( f );
+            }
+        }
+    }
 
-        // Sum the cor and weights over all triangles of the subdivided mesh.
-        for ( auto f_it = topoMesh.faces_begin(); f_it != topoMesh.faces_end(); ++f_it )
+    std::vector<int> vertexToTopo( nVerts );
+    for ( uint i = 0; i < nVerts; ++i )
+    {
+        vertexToTopo[i] = mapV2I[V[i]];
+    }
+
+#pragma omp parallel
+    {
+        // last vertex which visited each triangle
+        std::vector<int> visited( faces.size(), -1 );
+        std::vector<std::pair<Scalar, Scalar>> common;
+#pragma omp for schedule( dynamic, 16 )
+        for ( int i = 0; i < int( nVerts ); ++i )
+        {
+            Vector3 cor( 0, 0, 0 );
+            Scalar sumweight    = 0;
+            const WeightRow Wi  = toWeightRow( subdivW.row( vertexToTopo[i] ) );
+
+            // Sum the cor and weights over the triangles sharing two bones, which are
+            // all in the list of a bone of Wi but its last one.
+            for ( size_t k = 0; k + 1 < Wi.size(); ++k )
+            {
+                const int bone = Wi[k].first;
+                for ( uint t = boneOffsets[bone]; t < boneOffsets[bone + 1]; ++t )
+                {
+                    const uint f = boneTriangles[t];
+                    if ( visited[f] == i ) { continue; }
+                    visited[f]     = i;
+                    const Scalar s = weightRowSimilarity( Wi, triWeights[f], sigma, common );
+                    cor += s * areas[f] * centroids[f];
+                    sumweight += s * areas[f];
+                }
+            }
+
+            // Avoid division by 0
+            if ( sumweight > 0 ) { dataInOut.m_CoR[i] = cor / sumweight; }
+        }
+    }
+}
+
+bool computeCoR( Skinning::RefData& dataInOut,
+                 const std::string& cacheDirectory,
+                 Scalar sigma,
+                 Scalar weightEpsilon ) {
+    const std::uint64_t hash = corHash( dataInOut, sigma, weightEpsilon );
+    std::ostringstream name;
+    name << cacheDirectory << "/cor_" << std::hex << std::setw( 16 ) << std::setfill( '0' )
+         << hash << ".bin";
+    const std::string filename = name.str();
+    const uint nVerts          = dataInOut.m_referenceMesh.vertices().size();
+
+    std::ifstream in( filename, std::ios::binary );
+    if ( in )
+    {
+        char magic[sizeof( Magic )];
+        std::uint64_t fileHash = 0;
+        std::uint32_t size     = 0;
+        in.read( magic, sizeof( magic ) );
+        if ( in && std::memcmp( magic, Magic, sizeof( Magic ) ) == 0 && get( in, fileHash ) &&
+             fileHash == hash && get( in, size ) && size == nVerts )
         {
-            const auto& triData     = triangleData[*f_it];
-            const Vector3& centroid = std::get<0>( triData );
-            Scalar area             = std::get<1>( triData );
-            const auto& triWeight   = std::get<2>( triData );
-            const Scalar s          = weightSimilarity( Wi, triWeight, sigma );
-            cor += s * area * centroid;
-            sumweight += s * area;
+            std::vector<float> data( 3 * size_t( size ) );
+            in.read( reinterpret_cast<char*>( data.data() ),
+                     std::streamsize( data.size() * sizeof( float ) ) );
+            if ( in )
+            {
+                dataInOut.m_CoR.resize( nVerts );
+                for ( uint i = 0; i < nVerts; ++i )
+                {
+                    dataInOut.m_CoR[i] =
+                        Vector3( data[3 * i], data[3 * i + 1], data[3 * i + 2] ).cast<Scalar>();
+                }
+                LOG( logDEBUG ) << "CoRs read from " << filename;
+                return true;
+            }
         }
+        LOG( logWARNING ) << "Invalid CoR cache " << filename << ", CoRs are recomputed";
+    }
 
-        // Avoid division by 0
-        if ( sumweight > 0 ) { dataInOut.m_CoR[i] = cor / sumweight; }
+    computeCoR( dataInOut, sigma, weightEpsilon );
+
+    std::vector<float> data( 3 * size_t( nVerts ) );
+    for ( uint i = 0; i < nVerts; ++i )
+    {
+        for ( uint k = 0; k < 3; ++k )
+        {
+            data[3 * i + k] = float( dataInOut.m_CoR[i]( k ) );
+        }
+    }
+    std::ofstream out( filename, std::ios::binary | std::ios::trunc );
+    out.write( Magic, sizeof( Magic ) );
+    put( out, hash );
+    put( out, std::uint32_t( nVerts ) );
+    out.write( reinterpret_cast<const char*>( data.data() ),
+               std::streamsize( data.size() * sizeof( float ) ) );
+    if ( !out ) { LOG( logWARNING ) << "Can not write the CoR cache " << filename; }
+    return false;
+}
 
-#if defined CORE_DEBUG
-        if ( i % 100 == 0 ) { LOG( logDEBUG ) << "CoR: " << i << " / " << nVerts; }
-#endif // CORE_DEBUG
+std::uint64_t corHash( const Skinning::RefData& data, Scalar sigma, Scalar weightEpsilon ) {
+    // FNV-1a over the parameters, the mesh and the weights.
+    constexpr std::uint64_t prime = 1099511628211ull;
+    std::uint64_t h               = 14695981039346656037ull;
+    auto mix                      = [&h]( std::uint64_t x ) {
+        h ^= x;
+        h *= prime;
+    };
+    auto mixScalar = [&mix]( float x ) {
+        std::uint32_t bits;
+        std::memcpy( &bits, &x, sizeof( bits ) );
+        mix( bits );
+    };
+    mix( Version );
+    mixScalar( float( sigma ) );
+    mixScalar( float( weightEpsilon ) );
+    const auto& V = data.m_referenceMesh.vertices();
+    mix( V.size() );
+    for ( const auto& v : V )
+    {
+        mixScalar( float( v( 0 ) ) );
+        mixScalar( float( v( 1 ) ) );
+        mixScalar( float( v( 2 ) ) );
+    }
+    const auto& T = data.m_referenceMesh.m_indices;
+    mix( T.size() );
+    for ( const auto& t : T )
+    {
+        mix( t( 0 ) );
+        mix( t( 1 ) );
+        mix( t( 2 ) );
+    }
+    const auto& W = data.m_weights;
+    mix( std::uint64_t( W.rows() ) );
+    mix( std::uint64_t( W.cols() ) );
+    for ( int k = 0; k < W.outerSize(); ++k )
+    {
+        for ( WeightMatrix::InnerIterator it( W, k ); it; ++it )
+        {
+            mix( std::uint64_t( it.row() ) );
+            mix( std::uint64_t( it.col() ) );
+            mixScalar( float( it.value() ) );
+        }
     }
+    return h;
 }
 
 void corSkinning( const Vector3Array& input,
@@ -5,6 +5,9 @@
 
 #include <Core/Animation/SkinningData.hpp>
 
+#include <cstdint>
+#include <string>
+
 namespace Ra {
 namespace Core {
 namespace Animation {
@@ -19,10 +22,29 @@ Scalar RA_CORE_API weightSimilarity( const Eigen::SparseVector<Scalar>& v1w,
                                      Scalar sigma = 0.1f );
 
 /// Compute the optimal center of rotations (1 per vertex) based on weight similarity.
+/// The vertices are processed in parallel, each one only visiting the triangles
+/// of the subdivided mesh which share at least two bones with it, the others
+/// having a null similarity.
 void RA_CORE_API computeCoR( Skinning::RefData& dataInOut,
                              Scalar sigma         = 0.1f,
                              Scalar weightEpsilon = 0.1f );
 
+/// Same as computeCoR(), but the centers of rotation are read from a binary
+/// file in \p cacheDirectory if it holds the ones of the same reference mesh,
+/// weights and parameters. Otherwise they are computed and written there, the
+/// directory must exist.
+/// \return true if the centers of rotation were read from the cache.
+bool RA_CORE_API computeCoR( Skinning::RefData& dataInOut,
+                             const std::string& cacheDirectory,
+                             Scalar sigma         = 0.1f,
+                             Scalar weightEpsilon = 0.1f );
+
+/// Hash of the reference mesh (vertices and triangles) and weights of
+/// \p data, and of the parameters of computeCoR(), which keys the cache.
+std::uint64_t RA_CORE_API corHash( const Skinning::RefData& data,
+                                   Scalar sigma         = 0.1f,
+                                   Scalar weightEpsilon = 0.1f );
+
 /// Skin the vertices with the optimal centers of rotation.
 void RA_CORE_API corSkinning( const Vector3Array& input,
                               const Animation::Pose& pose,
@@ -11,7 +11,8 @@ namespace Animation {
 /// CONSTRUCTOR
 Skeleton::Skeleton() : HandleArray(), m_graph(), m_modelSpace() {}
 
-Skeleton::Skeleton( const uint n ) : HandleArray( n ), m_graph( n ), m_modelSpace( n ) {}
+Skeleton::Skeleton( const uint n ) :
+    HandleArray( n ), m_graph( n ), m_modelSpace( n ), m_dirty( n, 0 ), m_firstDirty( n ) {}
 
 Skeleton::~Skeleton() {}
 
@@ -19,12 +20,15 @@ void Skeleton::clear() {
     m_pose.clear();
     m_graph.clear();
     m_modelSpace.clear();
+    m_dirty.clear();
+    m_firstDirty = 0;
 }
 
 const Pose& Skeleton::getPose( const SpaceType MODE ) const {
     static_assert( std::is_same<bool, typename std::underlying_type<SpaceType>::type>::value,
                    "SpaceType is not a boolean" );
     if ( MODE == SpaceType::LOCAL ) return m_pose;
+    updateModelSpace();
     return m_modelSpace;
 }
 
@@ -36,34 +40,34 @@ void Skeleton::setPose( const Pose& pose, const SpaceType MODE ) {
     {
         m_pose = pose;
         m_modelSpace.resize( m_pose.size() );
-        for ( uint i = 0; i < m_graph.size(); ++i )
-        {
-            if ( m_graph.isRoot( i ) ) { m_modelSpace[i] = m_pose[i]; }
-            for ( const auto& child : m_graph.children()[i] )
-            {
-                m_modelSpace[child] = m_modelSpace[i] * m_pose[child];
-            }
-        }
+        m_dirty.assign( m_pose.size(), 1 );
+        m_firstDirty = 0;
     }
     else
     {
         m_modelSpace = pose;
         m_pose.resize( m_modelSpace.size() );
-        for ( uint i = 0; i < m_graph.size(); ++i )
+        m_dirty.assign( m_modelSpace.size(), 0 );
+        m_firstDirty = size();
+        // the inverse of each parent is computed once, for all its children
+        const auto& parents = m_graph.parents();
+        Pose inverse( size() );
+        for ( uint i = 0; i < size(); ++i )
         {
+            if ( !m_graph.isLeaf( i ) ) { inverse[i] = m_modelSpace[i].inverse( Eigen::Affine ); }
             if ( m_graph.isRoot( i ) ) { m_pose[i] = m_modelSpace[i]; }
-            for ( const auto& child : m_graph.children()[i] )
-            {
-                m_pose[child] = m_modelSpace[i].inverse() * m_modelSpace[child];
-            }
+            else
+            { m_pose[i] = inverse[parents[i]] * m_modelSpace[i]; }
         }
     }
 }
+
 const Transform& Skeleton::getTransform( const uint i, const SpaceType MODE ) const {
     CORE_ASSERT( ( i < size() ), "Index i out of bounds" );
     static_assert( std::is_same<bool, typename std::underlying_type<SpaceType>::type>::value,
                    "SpaceType is not a boolean" );
     if ( MODE == SpaceType::LOCAL ) return m_pose[i];
+    updateModelSpace();
     return m_modelSpace[i];
 }
 
@@ -73,55 +77,63 @@ void Skeleton::setTransform( const uint i, const Transform& T, const SpaceType M
                    "SpaceType is not a boolean" );
     if ( MODE == SpaceType::LOCAL )
     {
+        // the model space of the subtree is updated when needed
         m_pose[i] = T;
-        // Compute the model space pose
-        if ( m_graph.isRoot( i ) ) { m_modelSpace[i] = m_pose[i]; }
-        else
-        { m_modelSpace[i] = m_modelSpace[m_graph.parents()[i]] * T; }
-        if ( !m_graph.isLeaf( i ) )
-        {
-            std::stack<uint> stack;
-            stack.push( i );
-            while ( !stack.empty() )
-            {
-                uint parent = stack.top();
-                stack.pop();
-                for ( const auto& child : m_graph.children()[parent] )
-                {
-                    m_modelSpace[child] = m_modelSpace[parent] * m_pose[child];
-                    stack.push( child );
-                }
-            }
-        }
+        setDirty( i );
     }
     else
     {
+        updateModelSpace();
         m_modelSpace[i] = T;
-        // Compute the local space pose
+        // Compute the local space pose, the children keeping their model space transform
         if ( m_graph.isRoot( i ) ) { m_pose[i] = m_modelSpace[i]; }
         else
-        { m_pose[i] = m_modelSpace[m_graph.parents()[i]].inverse() * T; }
+        { m_pose[i] = m_modelSpace[m_graph.parents()[i]].inverse( Eigen::Affine ) * T; }
         if ( !m_graph.isLeaf( i ) )
         {
-            std::stack<uint> stack;
-            stack.push( i );
-            while ( !stack.empty() )
+            const Transform inverse = T.inverse( Eigen::Affine );
+            for ( const auto& child : m_graph.children()[i] )
             {
-                uint parent = stack.top();
-                stack.pop();
-                for ( const auto& child : m_graph.children()[parent] )
-                {
-                    m_pose[child] = m_modelSpace[parent].inverse() * m_modelSpace[child];
-                    stack.push( child );
-                }
+                m_pose[child] = inverse * m_modelSpace[child];
             }
         }
     }
 }
 
+void Skeleton::updateModelSpace() const {
+    const uint n = size();
+    if ( m_firstDirty >= n ) { return; }
+    // the parents come before their children, so that the dirty flags are propagated to the
+    // subtrees, and the model space of the parents is updated first
+    const auto& parents = m_graph.parents();
+    for ( uint i = m_firstDirty; i < n; ++i )
+    {
+        const int parent = parents[i];
+        if ( parent < 0 )
+        {
+            if ( m_dirty[i] ) { m_modelSpace[i] = m_pose[i]; }
+            continue;
+        }
+        if ( m_dirty[parent] ) { m_dirty[i] = 1; }
+        if ( m_dirty[i] ) { m_modelSpace[i] = m_modelSpace[parent] * m_pose[i]; }
+    }
+    std::fill( m_dirty.begin() + m_firstDirty, m_dirty.end(), 0 );
+    m_firstDirty = n;
+}
+
+void Skeleton::updateModelSpaces( const std::vector<Skeleton*>& skeletons ) {
+#pragma omp parallel for
+    for ( int s = 0; s < int( skeletons.size() ); ++s )
+    {
+        skeletons[s]->updateModelSpace();
+    }
+}
+
 uint Skeleton::addRoot( const Transform& T, const Label label ) {
     m_pose.push_back( T );
     m_modelSpace.push_back( T );
+    m_dirty.push_back( 0 );
+    if ( m_firstDirty == size() ) { ++m_firstDirty; }
     m_label.push_back( label );
     return m_graph.addRoot();
 }
@@ -132,23 +144,28 @@ uint Skeleton::addBone( const uint parent,
                         const Label label ) {
     static_assert( std::is_same<bool, typename std::underlying_type<SpaceType>::type>::value,
                    "SpaceType is not a boolean" );
+    updateModelSpace();
     if ( MODE == SpaceType::LOCAL )
     {
         m_pose.push_back( T );
-        m_modelSpace.push_back( T * m_modelSpace[parent] );
+        m_modelSpace.push_back( m_modelSpace[parent] * T );
     }
     else
     {
         m_modelSpace.push_back( T );
-        m_pose.push_back( m_modelSpace[parent].inverse() * T );
+        m_pose.push_back( m_modelSpace[parent].inverse( Eigen::Affine ) * T );
     }
+    m_dirty.push_back( 0 );
     m_label.push_back( label );
-    return m_graph.addNode( parent );
+    const uint index = m_graph.addNode( parent );
+    m_firstDirty     = size();
+    return index;
 }
 
 void Skeleton::getBonePoints( const uint i, Vector3& startOut, Vector3& endOut ) const {
     // Check bone index is valid
     CORE_ASSERT( i < m_modelSpace.size(), "invalid bone index" );
+    updateModelSpace();
 
     startOut = m_modelSpace[i].translation();
     // A leaf bone has length 0
@@ -3,6 +3,9 @@
 #include <Core/Animation/HandleArray.hpp>
 #include <Core/Containers/AdjacencyList.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace Ra {
 namespace Core {
 namespace Animation {
@@ -16,6 +19,13 @@ namespace Animation {
  * Skeleton bones represent a couple of joints: the proximal joint and the distal joint,
  * the former begin the parent of the latter in the hierarchy.
  * For animation purposes, a bone transform refers to the proximal joint's tranform.
+ *
+ * The joints are topologically ordered, each parent coming before its children, so that the
+ * model space transforms are computed in a single pass over the parent indices. Setting local
+ * transforms only flags the joints as dirty, in constant time, and the model space transforms of
+ * the dirty joints and of their descendants are recomputed when they are next accessed, or by
+ * updateModelSpace(). Hence the const accessors to the model space may modify the skeleton, and
+ * must not be called concurrently.
  */
 class RA_CORE_API Skeleton : public HandleArray
 {
@@ -54,6 +64,16 @@ class RA_CORE_API Skeleton : public HandleArray
                   const SpaceType MODE = SpaceType::LOCAL,
                   const Label label    = "" );
 
+    /**
+     * Recompute the model space transforms of the dirty joints and of their descendants.
+     */
+    void updateModelSpace() const;
+
+    /**
+     * Update the model space of all the \p skeletons, in parallel.
+     */
+    static void updateModelSpaces( const std::vector<Skeleton*>& skeletons );
+
     /**
      * Get the i-th bone endpoints.
      * @param i             the bone index
@@ -79,9 +99,26 @@ class RA_CORE_API Skeleton : public HandleArray
 
   protected:
     /**
-     * Skeleton pose in MODEL space.
+     * Skeleton pose in MODEL space, up to date for the joints which are not dirty.
+     */
+    mutable ModelPose m_modelSpace;
+
+  private:
+    /// Flag the joint \p i as dirty.
+    inline void setDirty( const uint i ) {
+        m_dirty[i]   = 1;
+        m_firstDirty = std::min( m_firstDirty, i );
+    }
+
+    /**
+     * Joints whose local transform changed since the last update of the model space.
+     */
+    mutable std::vector<char> m_dirty;
+
+    /**
+     * First dirty joint, size() if none.
      */
-    ModelPose m_modelSpace;
+    mutable uint m_firstDirty{0};
 };
 
 } // namespace Animation
@@ -0,0 +1,122 @@
+#include <Core/Animation/SkinningScheduler.hpp>
+
+#include <Core/Tasks/Task.hpp>
+#include <Core/Tasks/TaskQueue.hpp>
+#include <Core/Utils/Timer.hpp>
+
+#include <algorithm>
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+namespace {
+// The chunks are multiples of the blocks of the packed skinning.
+constexpr size_t ChunkGranularity = 64;
+} // namespace
+
+SkinningScheduler::SkinningScheduler( size_t chunkBytes ) : m_chunkBytes( chunkBytes ) {}
+
+size_t SkinningScheduler::addJob( const Job& job ) {
+    CORE_ASSERT( job.vertices && job.pose && job.weights, "Incomplete skinning job" );
+    CORE_ASSERT( job.vertices->size() == job.weights->m_size, "Weights do not match the mesh" );
+    CORE_ASSERT( !job.normals || job.normals->size() == job.vertices->size(), "Invalid normals" );
+    m_jobs.push_back( job );
+    return m_jobs.size() - 1;
+}
+
+void SkinningScheduler::clearJobs() {
+    m_jobs.clear();
+}
+
+size_t SkinningScheduler::getChunkSize( const Job& job ) const {
+    const size_t attribs = job.normals ? 2 : 1;
+    const size_t bytes   = 2 * attribs * sizeof( Vector3 ) +
+                         job.weights->m_influences * ( sizeof( uint ) + sizeof( Scalar ) );
+    const size_t size = m_chunkBytes / bytes / ChunkGranularity * ChunkGranularity;
+    return std::max( size, ChunkGranularity );
+}
+
+void SkinningScheduler::registerTasks( TaskQueue* queue ) {
+    // the buffers of the previous batch are reused, only resized
+    if ( m_outputs.size() < m_jobs.size() ) { m_outputs.resize( m_jobs.size() ); }
+    m_statistics = Statistics();
+    for ( size_t j = 0; j < m_jobs.size(); ++j )
+    {
+        const Job& job = m_jobs[j];
+        Output& output = m_outputs[j];
+        output.vertices.resize( job.vertices->size() );
+        output.normals.resize( job.normals ? job.normals->size() : 0 );
+
+        auto pose = queue->registerTask( new FunctionTask(
+            [&job, &output]() {
+                if ( job.method == Method::LinearBlend )
+                { computePoseMatrices( *job.pose, output.matrices ); }
+                else
+                { computePoseDQ( *job.pose, output.poseDQ ); }
+            },
+            "SkinningPose" ) );
+
+        const int size      = int( job.vertices->size() );
+        const int chunkSize = int( getChunkSize( job ) );
+        for ( int begin = 0; begin < size; begin += chunkSize )
+        {
+            const int end = std::min( begin + chunkSize, size );
+            auto chunk    = queue->registerTask( new FunctionTask(
+                [this, j, begin, end]() { skinChunk( j, begin, end ); }, "SkinningChunk" ) );
+            queue->addDependency( pose, chunk );
+            ++m_statistics.chunks;
+        }
+        m_statistics.vertices += job.vertices->size();
+    }
+    m_statistics.jobs = m_jobs.size();
+}
+
+const SkinningScheduler::Statistics& SkinningScheduler::run( TaskQueue* queue ) {
+    registerTasks( queue );
+    const auto start = Utils::Clock::now();
+    queue->startTasks();
+    queue->waitForTasks();
+    const auto end = Utils::Clock::now();
+    queue->flushTaskQueue();
+    m_statistics.seconds = Utils::getIntervalSeconds( start, end );
+    if ( m_statistics.seconds > 0 )
+    { m_statistics.verticesPerSecond = Scalar( m_statistics.vertices ) / m_statistics.seconds; }
+    return m_statistics;
+}
+
+void SkinningScheduler::skinChunk( size_t job, int begin, int end ) {
+    const Job& j   = m_jobs[job];
+    Output& output = m_outputs[job];
+    const Vector3Array none;
+    const Vector3Array& normals = j.normals ? *j.normals : none;
+    if ( j.method == Method::LinearBlend )
+    {
+        Vector3Array noTangents;
+        linearBlendSkinning( *j.vertices,
+                             normals,
+                             none,
+                             output.matrices,
+                             *j.weights,
+                             begin,
+                             end,
+                             output.vertices,
+                             output.normals,
+                             noTangents );
+    }
+    else
+    {
+        dualQuaternionSkinning( *j.vertices,
+                                normals,
+                                output.poseDQ,
+                                *j.weights,
+                                begin,
+                                end,
+                                output.vertices,
+                                output.normals );
+    }
+}
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,117 @@
+#ifndef RADIUMENGINE_SKINNING_SCHEDULER_HPP_
+#define RADIUMENGINE_SKINNING_SCHEDULER_HPP_
+
+#include <Core/Animation/DualQuaternionSkinning.hpp>
+#include <Core/Animation/HandleWeight.hpp>
+#include <Core/Animation/LinearBlendSkinning.hpp>
+#include <Core/Animation/Pose.hpp>
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/RaCore.hpp>
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+class TaskQueue;
+}
+} // namespace Ra
+
+namespace Ra {
+namespace Core {
+namespace Animation {
+
+/**
+ * Batched skinning of many meshes, e.g. the characters of a crowd, on the
+ * threads of a TaskQueue.
+ * Each job skins a mesh (vertices and optional normals) with a pose and
+ * packed weights. Its vertices are split in chunks whose data fit in the
+ * cache, each chunk being a task of the queue, so that large and small
+ * meshes are balanced between the threads. The pose of each job is converted
+ * once, by a task on which the chunks of the job depend.
+ * The skinned vertices and normals are stored in buffers owned by the
+ * scheduler, which are kept from a batch to the next one: the jobs can be
+ * run again each frame, with updated poses, without any allocation.
+ */
+class RA_CORE_API SkinningScheduler
+{
+  public:
+    enum class Method { LinearBlend, DualQuaternion };
+
+    /// A skinning job. The inputs are not copied, and must be valid until the
+    /// tasks of the batch are done.
+    struct Job {
+        const Vector3Array* vertices{nullptr};
+        /// Optional normals, skipped if nullptr.
+        const Vector3Array* normals{nullptr};
+        const Pose* pose{nullptr};
+        const PackedWeights* weights{nullptr};
+        Method method{Method::LinearBlend};
+    };
+
+    /// Statistics of the last batch.
+    struct Statistics {
+        size_t jobs{0};
+        size_t vertices{0};
+        size_t chunks{0};
+        /// Duration of the batch, only measured by run().
+        Scalar seconds{0};
+        Scalar verticesPerSecond{0};
+    };
+
+    /// \param chunkBytes size of the data of a chunk of vertices: input and
+    /// output positions and normals, and packed weights.
+    explicit SkinningScheduler( size_t chunkBytes = 256 * 1024 );
+
+    /// Add a job to the batch.
+    /// \return the index of the job, to get its results.
+    size_t addJob( const Job& job );
+
+    /// Remove all the jobs, keeping the output buffers for the next jobs.
+    void clearJobs();
+
+    inline size_t getJobCount() const { return m_jobs.size(); }
+
+    /// Register the tasks of the batch in \p queue, e.g. with the other tasks
+    /// of a frame. The results are available once the tasks are done.
+    void registerTasks( TaskQueue* queue );
+
+    /// Register the tasks of the batch in \p queue, which must not be
+    /// running, run them and wait for them, and flush the queue.
+    /// \return the statistics of the batch.
+    const Statistics& run( TaskQueue* queue );
+
+    inline const Statistics& getStatistics() const { return m_statistics; }
+
+    /// Number of vertices of the chunks of \p job.
+    size_t getChunkSize( const Job& job ) const;
+
+    /// Skinned vertices of the job of index \p job.
+    inline const Vector3Array& getVertices( size_t job ) const { return m_outputs[job].vertices; }
+
+    /// Skinned normals of the job of index \p job, empty if it has none.
+    inline const Vector3Array& getNormals( size_t job ) const { return m_outputs[job].normals; }
+
+  private:
+    /// Results and pose of a job.
+    struct Output {
+        Vector3Array vertices;
+        Vector3Array normals;
+        PoseMatrices matrices;
+        DQList poseDQ;
+    };
+
+    /// Skin the vertices [begin, end[ of a job.
+    void skinChunk( size_t job, int begin, int end );
+
+    std::vector<Job> m_jobs;
+    /// Output buffers of the jobs, kept between batches.
+    std::vector<Output> m_outputs;
+    size_t m_chunkBytes;
+    Statistics m_statistics;
+};
+
+} // namespace Animation
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_SKINNING_SCHEDULER_HPP_
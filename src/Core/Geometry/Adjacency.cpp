@@ -14,97 +14,133 @@ namespace Geometry {
 // //////////////// //
 
 AdjacencyMatrix uniformAdjacency( const uint point_size, const AlignedStdVector<Vector3ui>& T ) {
-    AdjacencyMatrix A( point_size, point_size );
-    for ( const auto& t : T )
-    {
-        uint i             = t( 0 );
-        uint j             = t( 1 );
-        uint k             = t( 2 );
-        A.coeffRef( i, j ) = 1;
-        A.coeffRef( j, k ) = 1;
-        A.coeffRef( k, i ) = 1;
-    }
+    AdjacencyMatrix A;
+    uniformAdjacency( T, OperatorPattern( point_size, T ), A );
     return A;
 }
 
 AdjacencyMatrix uniformAdjacency( const VectorArray<Vector3>& p,
                                   const AlignedStdVector<Vector3ui>& T ) {
-    AdjacencyMatrix A( p.size(), p.size() );
-    for ( const auto& t : T )
-    {
-        uint i             = t( 0 );
-        uint j             = t( 1 );
-        uint k             = t( 2 );
-        A.coeffRef( i, j ) = 1;
-        A.coeffRef( j, k ) = 1;
-        A.coeffRef( k, i ) = 1;
-    }
-    return A;
+    return uniformAdjacency( uint( p.size() ), T );
 }
 
 void uniformAdjacency( const VectorArray<Vector3>& p,
                        const AlignedStdVector<Vector3ui>& T,
                        AdjacencyMatrix& Adj ) {
-    Adj.resize( p.size(), p.size() );
+    uniformAdjacency( T, OperatorPattern( uint( p.size() ), T ), Adj );
+}
+
+void uniformAdjacency( const AlignedStdVector<Vector3ui>& T,
+                       const OperatorPattern& pattern,
+                       AdjacencyMatrix& A ) {
+    CORE_ASSERT( pattern.isValidFor( pattern.size(), T ), "Invalid operator pattern" );
+    pattern.setAdjacencyStructure( A );
+    const int n         = int( pattern.size() );
+    const auto& outer   = pattern.outerIndices();
+    const auto& inner   = pattern.innerIndices();
+    const auto& offsets = pattern.entryOffsets();
+    const auto& corners = pattern.entryCorners();
+    auto values         = A.valuePtr();
 #pragma omp parallel for
-    for ( int n = 0; n < int( T.size() ); ++n )
+    for ( int v = 0; v < n; ++v )
     {
-        const Vector3ui& t = T[n];
-        const uint i       = t( 0 );
-        const uint j       = t( 1 );
-        const uint k       = t( 2 );
-#pragma omp critical
+        for ( int e = outer[v]; e < outer[v + 1]; ++e )
         {
-            Adj.coeffRef( i, j ) = 1;
-            Adj.coeffRef( j, k ) = 1;
-            Adj.coeffRef( k, i ) = 1;
+            // 1 if a triangle has the directed edge inner[e] -> v
+            values[e] = 0;
+            for ( uint c = offsets[e]; c < offsets[e + 1]; ++c )
+            {
+                const auto& t = T[VertexTriangleIncidence::triangle( corners[c] )];
+                const uint k  = VertexTriangleIncidence::local( corners[c] );
+                if ( int( t( ( k + 1 ) % 3 ) ) == inner[e] && int( t( ( k + 2 ) % 3 ) ) == v )
+                { values[e] = 1; }
+            }
         }
     }
 }
 
 TVAdj triangleUniformAdjacency( const VectorArray<Vector3>& p,
                                 const AlignedStdVector<Vector3ui>& T ) {
-    const uint p_size = p.size();
-    const uint t_size = T.size();
-    TVAdj A( t_size, p_size );
-    for ( uint t = 0; t < t_size; ++t )
+    // column v holds the triangles incident to v, i.e. its incidence without
+    // the duplicates of degenerate triangles
+    const VertexTriangleIncidence incidence( uint( p.size() ), T );
+    const auto& corners = incidence.corners();
+    const int p_size    = int( p.size() );
+    std::vector<int> outer( p.size() + 1, 0 );
+#pragma omp parallel for
+    for ( int v = 0; v < p_size; ++v )
     {
-        const uint i       = T[t]( 0 );
-        const uint j       = T[t]( 1 );
-        const uint k       = T[t]( 2 );
-        A.coeffRef( t, i ) = 1;
-        A.coeffRef( t, j ) = 1;
-        A.coeffRef( t, k ) = 1;
+        int count = 0;
+        for ( uint c = incidence.offset( v ); c < incidence.offset( v + 1 ); ++c )
+        {
+            if ( c == incidence.offset( v ) || corners[c] / 3 != corners[c - 1] / 3 ) { ++count; }
+        }
+        outer[v + 1] = count;
+    }
+    for ( int v = 0; v < p_size; ++v )
+    {
+        outer[v + 1] += outer[v];
+    }
+
+    TVAdj A( T.size(), p.size() );
+    A.resizeNonZeros( outer.back() );
+    std::copy( outer.begin(), outer.end(), A.outerIndexPtr() );
+#pragma omp parallel for
+    for ( int v = 0; v < p_size; ++v )
+    {
+        int e = outer[v];
+        for ( uint c = incidence.offset( v ); c < incidence.offset( v + 1 ); ++c )
+        {
+            if ( c == incidence.offset( v ) || corners[c] / 3 != corners[c - 1] / 3 )
+            {
+                A.innerIndexPtr()[e] = int( VertexTriangleIncidence::triangle( corners[c] ) );
+                A.valuePtr()[e]      = 1;
+                ++e;
+            }
+        }
     }
     return A;
 }
 
-AdjacencyMatrix cotangentWeightAdjacency( const VectorArray<Vector3>& p,
-                                          const AlignedStdVector<Vector3ui>& T ) {
-    AdjacencyMatrix A( p.size(), p.size() );
-    std::vector<Eigen::Triplet<Scalar>> triplets( T.size() * 6 );
+void cotangentCornerWeights( const VectorArray<Vector3>& p,
+                             const AlignedStdVector<Vector3ui>& T,
+                             std::vector<Scalar>& w ) {
+    w.resize( 3 * T.size() );
 #pragma omp parallel for
     for ( int t_ = 0; t_ < int( T.size() ); ++t_ )
     {
-        const auto& t        = T[t_];
-        uint i               = t( 0 );
-        uint j               = t( 1 );
-        uint k               = t( 2 );
-        const Vector3 IJ     = p[j] - p[i];
-        const Vector3 JK     = p[k] - p[j];
-        const Vector3 KI     = p[i] - p[k];
-        const Scalar cotI    = Math::cotan( IJ, ( -KI ).eval() );
-        const Scalar cotJ    = Math::cotan( JK, ( -IJ ).eval() );
-        const Scalar cotK    = Math::cotan( KI, ( -JK ).eval() );
-        triplets[6 * t_]     = Eigen::Triplet<Scalar>( i, j, cotK );
-        triplets[6 * t_ + 1] = Eigen::Triplet<Scalar>( j, i, cotK );
-        triplets[6 * t_ + 2] = Eigen::Triplet<Scalar>( j, k, cotI );
-        triplets[6 * t_ + 3] = Eigen::Triplet<Scalar>( k, j, cotI );
-        triplets[6 * t_ + 4] = Eigen::Triplet<Scalar>( k, i, cotJ );
-        triplets[6 * t_ + 5] = Eigen::Triplet<Scalar>( i, k, cotJ );
+        const auto& t     = T[t_];
+        uint i            = t( 0 );
+        uint j            = t( 1 );
+        uint k            = t( 2 );
+        const Vector3 IJ  = p[j] - p[i];
+        const Vector3 JK  = p[k] - p[j];
+        const Vector3 KI  = p[i] - p[k];
+        const Scalar cotI = Math::cotan( IJ, ( -KI ).eval() );
+        const Scalar cotJ = Math::cotan( JK, ( -IJ ).eval() );
+        const Scalar cotK = Math::cotan( KI, ( -JK ).eval() );
+        w[3 * t_]         = Scalar( 0.5 ) * cotI;
+        w[3 * t_ + 1]     = Scalar( 0.5 ) * cotJ;
+        w[3 * t_ + 2]     = Scalar( 0.5 ) * cotK;
     }
-    A.setFromTriplets( triplets.begin(), triplets.end() );
-    return ( 0.5 * A );
+}
+
+AdjacencyMatrix cotangentWeightAdjacency( const VectorArray<Vector3>& p,
+                                          const AlignedStdVector<Vector3ui>& T ) {
+    AdjacencyMatrix A;
+    cotangentWeightAdjacency( p, T, OperatorPattern( uint( p.size() ), T ), A );
+    return A;
+}
+
+void cotangentWeightAdjacency( const VectorArray<Vector3>& p,
+                               const AlignedStdVector<Vector3ui>& T,
+                               const OperatorPattern& pattern,
+                               AdjacencyMatrix& A ) {
+    CORE_ASSERT( pattern.isValidFor( uint( p.size() ), T ), "Invalid operator pattern" );
+    std::vector<Scalar> w;
+    cotangentCornerWeights( p, T, w );
+    pattern.setAdjacencyStructure( A );
+    pattern.gatherAdjacency( w, A );
 }
 
 // ///////////// //
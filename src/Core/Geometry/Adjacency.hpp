@@ -3,8 +3,11 @@
 
 #include <Core/Containers/AlignedStdVector.hpp>
 #include <Core/Containers/VectorArray.hpp>
+#include <Core/Geometry/OperatorPattern.hpp>
 #include <Core/Types.hpp>
 
+#include <vector>
+
 namespace Ra {
 namespace Core {
 namespace Geometry {
@@ -73,6 +76,35 @@ void uniformAdjacency( const VectorArray<Vector3>& p,
 RA_CORE_API AdjacencyMatrix cotangentWeightAdjacency( const VectorArray<Vector3>& p,
                                                       const AlignedStdVector<Vector3ui>& T );
 
+/*
+ * Fill w with 0.5 * cot( alpha ) for each corner of T, where alpha is the
+ * angle of the triangle at this corner (see OperatorPattern for corner ids).
+ * This is the contribution of the corner to the cotangent weight of the edge
+ * it faces.
+ */
+RA_CORE_API void cotangentCornerWeights( const VectorArray<Vector3>& p,
+                                         const AlignedStdVector<Vector3ui>& T,
+                                         std::vector<Scalar>& w );
+
+/*
+ * The following functions compute the same matrices as their counterparts
+ * above, assembled in parallel with the precomputed sparsity pattern of T.
+ * If A already has the structure of the operator, e.g. because it has been
+ * computed for a previous pose of the mesh, only its values are refilled.
+ *
+ * \note The pattern must be valid for T (see OperatorPattern::update()).
+ * \note Since the pattern is symmetric, the uniform adjacency of an open
+ * mesh stores explicit zeros for the boundary edges in the reverse direction.
+ */
+RA_CORE_API void uniformAdjacency( const AlignedStdVector<Vector3ui>& T,
+                                   const OperatorPattern& pattern,
+                                   AdjacencyMatrix& A );
+
+RA_CORE_API void cotangentWeightAdjacency( const VectorArray<Vector3>& p,
+                                           const AlignedStdVector<Vector3ui>& T,
+                                           const OperatorPattern& pattern,
+                                           AdjacencyMatrix& A );
+
 // ///////////// //
 // DEGREE MATRIX //
 // ///////////// //
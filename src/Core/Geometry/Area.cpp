@@ -11,139 +11,142 @@ namespace Geometry {
 /// GLOBAL MATRIX ///
 /////////////////////
 
-AreaMatrix oneRingArea( const VectorArray<Vector3>& p, const AlignedStdVector<Vector3ui>& T ) {
-    AreaMatrix A( p.size(), p.size() );
-    A.reserve( p.size() );
-    for ( const auto& t : T )
+namespace {
+
+// Fill A with the per-corner values f( p[i], p[j], p[k] ), which returns the
+// contributions of a triangle ijk to the area of i, j and k.
+template <typename CornerAreas>
+void gatherArea( const VectorArray<Vector3>& p,
+                 const AlignedStdVector<Vector3ui>& T,
+                 const OperatorPattern& pattern,
+                 const CornerAreas& f,
+                 AreaMatrix& A ) {
+    CORE_ASSERT( pattern.isValidFor( uint( p.size() ), T ), "Invalid operator pattern" );
+    const int t_size = int( T.size() );
+    std::vector<Scalar> w( 3 * T.size() );
+#pragma omp parallel for
+    for ( int n = 0; n < t_size; ++n )
+    {
+        const Vector3ui& t = T[n];
+        const Vector3 area = f( p[t( 0 )], p[t( 1 )], p[t( 2 )] );
+        w[3 * n]           = area( 0 );
+        w[3 * n + 1]       = area( 1 );
+        w[3 * n + 2]       = area( 2 );
+    }
+    pattern.setDiagonalStructure( A );
+    pattern.gatherDiagonal( w, A );
+}
+
+Vector3 oneRingCorners( const Vector3& pi, const Vector3& pj, const Vector3& pk ) {
+    return Vector3::Constant( triangleArea( pi, pj, pk ) );
+}
+
+Vector3 barycentricCorners( const Vector3& pi, const Vector3& pj, const Vector3& pk ) {
+    return Vector3::Constant( triangleArea( pi, pj, pk ) / Scalar( 3. ) );
+}
+
+Vector3 voronoiCorners( const Vector3& pi, const Vector3& pj, const Vector3& pk ) {
+    const Scalar w = ( Scalar( 1. ) / Scalar( 8. ) );
+    return {w * Math::cotan( ( pi - pk ), ( pj - pk ) ) * ( pi - pj ).squaredNorm(),
+            w * Math::cotan( ( pj - pi ), ( pk - pi ) ) * ( pj - pk ).squaredNorm(),
+            w * Math::cotan( ( pk - pj ), ( pi - pj ) ) * ( pk - pi ).squaredNorm()};
+}
+
+Vector3 mixedCorners( const Vector3& pi, const Vector3& pj, const Vector3& pk ) {
+    if ( !isTriangleObtuse( pi, pj, pk ) )
     {
-        uint i      = t( 0 );
-        uint j      = t( 1 );
-        uint k      = t( 2 );
-        Scalar area = triangleArea( p[i], p[j], p[k] );
-        A.coeffRef( i, i ) += area;
-        A.coeffRef( j, j ) += area;
-        A.coeffRef( k, k ) += area;
+        const Scalar w    = ( Scalar( 1. ) / Scalar( 8. ) );
+        const Vector3 ij  = pj - pi;
+        const Vector3 jk  = pk - pj;
+        const Vector3 ki  = pi - pk;
+        const Scalar IJ   = ( ij ).squaredNorm();
+        const Scalar JK   = ( jk ).squaredNorm();
+        const Scalar KI   = ( ki ).squaredNorm();
+        const Scalar cotI = Math::cotan( ij, ( -ki ).eval() );
+        const Scalar cotJ = Math::cotan( jk, ( -ij ).eval() );
+        const Scalar cotK = Math::cotan( ki, ( -jk ).eval() );
+        return {w * ( ( KI * cotJ ) + ( IJ * cotK ) ),
+                w * ( ( IJ * cotK ) + ( JK * cotI ) ),
+                w * ( ( JK * cotI ) + ( KI * cotJ ) )};
     }
+    // the obtuse corner gets half of the area, the other ones a quarter
+    const Scalar area = triangleArea( pi, pj, pk );
+    Vector3 corners   = Vector3::Constant( area / Scalar( 4. ) );
+    if ( ( ( ( pj - pi ).normalized() ).dot( ( pk - pi ).normalized() ) ) < Scalar( 0. ) )
+    { corners( 0 ) = area / Scalar( 2. ); }
+    else if ( ( ( ( pk - pj ).normalized() ).dot( ( pi - pj ).normalized() ) ) < Scalar( 0. ) )
+    { corners( 1 ) = area / Scalar( 2. ); }
+    else
+    { corners( 2 ) = area / Scalar( 2. ); }
+    return corners;
+}
+
+} // namespace
+
+AreaMatrix oneRingArea( const VectorArray<Vector3>& p, const AlignedStdVector<Vector3ui>& T ) {
+    AreaMatrix A;
+    oneRingArea( p, T, A );
     return A;
 }
 
 void oneRingArea( const VectorArray<Vector3>& p,
                   const AlignedStdVector<Vector3ui>& T,
                   AreaMatrix& A ) {
-    A.resize( p.size(), p.size() );
-    A.reserve( p.size() );
-    int size = int( T.size() );
-#pragma omp parallel for
-    for ( int n = 0; n < size; ++n )
-    {
-        const Vector3ui& t = T[n];
-        const uint i       = t( 0 );
-        const uint j       = t( 1 );
-        const uint k       = t( 2 );
-        const Scalar area  = triangleArea( p[i], p[j], p[k] );
-#pragma omp critical
-        {
-            A.coeffRef( i, i ) += area;
-            A.coeffRef( j, j ) += area;
-            A.coeffRef( k, k ) += area;
-        }
-    }
+    oneRingArea( p, T, OperatorPattern( uint( p.size() ), T ), A );
+}
+
+void oneRingArea( const VectorArray<Vector3>& p,
+                  const AlignedStdVector<Vector3ui>& T,
+                  const OperatorPattern& pattern,
+                  AreaMatrix& A ) {
+    gatherArea( p, T, pattern, oneRingCorners, A );
 }
 
 AreaMatrix barycentricArea( const VectorArray<Vector3>& p, const AlignedStdVector<Vector3ui>& T ) {
-    return ( ( Scalar( 1. ) / Scalar( 3. ) ) * oneRingArea( p, T ) );
+    AreaMatrix A;
+    barycentricArea( p, T, A );
+    return A;
 }
 
 void barycentricArea( const VectorArray<Vector3>& p,
                       const AlignedStdVector<Vector3ui>& T,
                       AreaMatrix& A ) {
-    oneRingArea( p, T, A );
-    int size = int( p.size() );
-#pragma omp parallel for
-    for ( int i = 0; i < size; ++i )
-    {
-        A.coeffRef( i, i ) /= Scalar( 3. );
-    }
+    barycentricArea( p, T, OperatorPattern( uint( p.size() ), T ), A );
 }
 
-AreaMatrix voronoiArea( const VectorArray<Vector3>& p, const AlignedStdVector<Vector3ui>& T ) {
-    AreaMatrix A( p.size(), p.size() );
-    A.reserve( p.size() );
-    for ( const auto& t : T )
-    {
-        uint i = t( 0 );
-        uint j = t( 1 );
-        uint k = t( 2 );
-        A.coeffRef( i, i ) +=
-            Math::cotan( ( p[i] - p[k] ), ( p[j] - p[k] ) ) * ( p[i] - p[j] ).squaredNorm();
-        A.coeffRef( j, j ) +=
-            Math::cotan( ( p[j] - p[i] ), ( p[k] - p[i] ) ) * ( p[j] - p[k] ).squaredNorm();
-        A.coeffRef( k, k ) +=
-            Math::cotan( ( p[k] - p[j] ), ( p[i] - p[j] ) ) * ( p[k] - p[i] ).squaredNorm();
-    }
-    return ( ( 1.0 / 8.0 ) * A );
+void barycentricArea( const VectorArray<Vector3>& p,
+                      const AlignedStdVector<Vector3ui>& T,
+                      const OperatorPattern& pattern,
+                      AreaMatrix& A ) {
+    gatherArea( p, T, pattern, barycentricCorners, A );
 }
 
-AreaMatrix mixedArea( const VectorArray<Vector3>& p, const AlignedStdVector<Vector3ui>& T ) {
-    AreaMatrix A( p.size(), p.size() );
-    A.reserve( p.size() );
+AreaMatrix voronoiArea( const VectorArray<Vector3>& p, const AlignedStdVector<Vector3ui>& T ) {
+    AreaMatrix A;
+    voronoiArea( p, T, OperatorPattern( uint( p.size() ), T ), A );
+    return A;
+}
 
-    const Scalar w = ( Scalar( 1. ) / Scalar( 8. ) );
+void voronoiArea( const VectorArray<Vector3>& p,
+                  const AlignedStdVector<Vector3ui>& T,
+                  const OperatorPattern& pattern,
+                  AreaMatrix& A ) {
+    gatherArea( p, T, pattern, voronoiCorners, A );
+}
 
-    for ( const auto& t : T )
-    {
-        uint i = t( 0 );
-        uint j = t( 1 );
-        uint k = t( 2 );
-        if ( !isTriangleObtuse( p[i], p[j], p[k] ) )
-        {
-            Vector3 ij  = p[j] - p[i];
-            Vector3 jk  = p[k] - p[j];
-            Vector3 ki  = p[i] - p[k];
-            Scalar IJ   = ( ij ).squaredNorm();
-            Scalar JK   = ( jk ).squaredNorm();
-            Scalar KI   = ( ki ).squaredNorm();
-            Scalar cotI = Math::cotan( ij, ( -ki ).eval() );
-            Scalar cotJ = Math::cotan( jk, ( -ij ).eval() );
-            Scalar cotK = Math::cotan( ki, ( -jk ).eval() );
-            A.coeffRef( i, i ) += w * ( ( KI * cotJ ) + ( IJ * cotK ) );
-            A.coeffRef( j, j ) += w * ( ( IJ * cotK ) + ( JK * cotI ) );
-            A.coeffRef( k, k ) += w * ( ( JK * cotI ) + ( KI * cotJ ) );
-        }
-        else
-        {
-            Scalar area = triangleArea( p[i], p[j], p[k] );
-            if ( ( ( ( p[j] - p[i] ).normalized() ).dot( ( p[k] - p[i] ).normalized() ) ) <
-                 Scalar( 0. ) )
-            {
-                /* obtuse at i */
-                A.coeffRef( i, i ) += area / Scalar( 2. );
-                A.coeffRef( j, j ) += area / Scalar( 4. );
-                A.coeffRef( k, k ) += area / Scalar( 4. );
-            }
-            else
-            {
-                if ( ( ( ( p[k] - p[j] ).normalized() ).dot( ( p[i] - p[j] ).normalized() ) ) <
-                     Scalar( 0.0 ) )
-                {
-                    /* obtuse at j */
-                    A.coeffRef( i, i ) += area / Scalar( 4. );
-                    A.coeffRef( j, j ) += area / Scalar( 2. );
-                    A.coeffRef( k, k ) += area / Scalar( 4. );
-                }
-                else
-                {
-                    /* obtuse at k */
-                    A.coeffRef( i, i ) += area / Scalar( 4. );
-                    A.coeffRef( j, j ) += area / Scalar( 4. );
-                    A.coeffRef( k, k ) += area / Scalar( 2. );
-                }
-            }
-        }
-    }
+AreaMatrix mixedArea( const VectorArray<Vector3>& p, const AlignedStdVector<Vector3ui>& T ) {
+    AreaMatrix A;
+    mixedArea( p, T, OperatorPattern( uint( p.size() ), T ), A );
     return A;
 }
 
+void mixedArea( const VectorArray<Vector3>& p,
+                const AlignedStdVector<Vector3ui>& T,
+                const OperatorPattern& pattern,
+                AreaMatrix& A ) {
+    gatherArea( p, T, pattern, mixedCorners, A );
+}
+
 ////////////////
 /// ONE RING ///
 ////////////////
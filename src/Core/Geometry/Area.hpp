@@ -2,6 +2,7 @@
 #define AREA_DEFINITION
 
 #include <Core/Containers/VectorArray.hpp>
+#include <Core/Geometry/OperatorPattern.hpp>
 #include <Core/Types.hpp>
 
 namespace Ra {
@@ -92,6 +93,35 @@ AreaMatrix RA_CORE_API voronoiArea( const VectorArray<Vector3>& p,
 AreaMatrix RA_CORE_API mixedArea( const VectorArray<Vector3>& p,
                                   const AlignedStdVector<Vector3ui>& T );
 
+/*
+ * The following functions compute the same matrices as their counterparts
+ * above, gathering in parallel the contribution of each triangle corner with
+ * the precomputed pattern of T. If A already has the diagonal structure, e.g.
+ * because it has been computed for a previous pose of the mesh, only its
+ * values are refilled.
+ *
+ * \note The pattern must be valid for p and T (see OperatorPattern::update()).
+ */
+void RA_CORE_API oneRingArea( const VectorArray<Vector3>& p,
+                              const AlignedStdVector<Vector3ui>& T,
+                              const OperatorPattern& pattern,
+                              AreaMatrix& A );
+
+void RA_CORE_API barycentricArea( const VectorArray<Vector3>& p,
+                                  const AlignedStdVector<Vector3ui>& T,
+                                  const OperatorPattern& pattern,
+                                  AreaMatrix& A );
+
+void RA_CORE_API voronoiArea( const VectorArray<Vector3>& p,
+                              const AlignedStdVector<Vector3ui>& T,
+                              const OperatorPattern& pattern,
+                              AreaMatrix& A );
+
+void RA_CORE_API mixedArea( const VectorArray<Vector3>& p,
+                            const AlignedStdVector<Vector3ui>& T,
+                            const OperatorPattern& pattern,
+                            AreaMatrix& A );
+
 ////////////////
 /// ONE RING ///
 ////////////////
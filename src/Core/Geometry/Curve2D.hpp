@@ -23,6 +23,13 @@ class Curve2D
     virtual Vector df( Scalar u ) const                = 0;
     virtual Vector fdf( Scalar t, Vector& grad ) const = 0;
 
+    /// Evaluate positions and gradients at all the parameters \p u, which
+    /// should be sorted. Subclasses share the work between samples, the
+    /// default implementation calls fdf( t, grad ) for each sample.
+    inline virtual void fdf( const std::vector<Scalar>& u,
+                             Core::VectorArray<Vector>& points,
+                             Core::VectorArray<Vector>& grads ) const;
+
   protected:
     int size;
 };
@@ -44,6 +51,9 @@ class QuadraSpline : public Curve2D
     inline Vector f( Scalar u ) const override;
     inline Vector df( Scalar u ) const override;
     inline Vector fdf( Scalar u, Vector& grad ) const override;
+    inline void fdf( const std::vector<Scalar>& u,
+                     Core::VectorArray<Vector>& points,
+                     Core::VectorArray<Vector>& grads ) const override;
 
   private:
     Core::VectorArray<Vector> m_points;
@@ -67,6 +77,9 @@ class CubicBezier : public Curve2D
     inline Vector f( Scalar u ) const override;
     inline Vector df( Scalar u ) const override;
     inline Vector fdf( Scalar t, Vector& grad ) const override;
+    inline void fdf( const std::vector<Scalar>& u,
+                     Core::VectorArray<Vector>& points,
+                     Core::VectorArray<Vector>& grads ) const override;
 
   private:
     Vector m_points[4];
@@ -84,6 +97,9 @@ class Line : public Curve2D
     inline Vector f( Scalar u ) const override;
     inline Vector df( Scalar u ) const override;
     inline Vector fdf( Scalar t, Vector& grad ) const override;
+    inline void fdf( const std::vector<Scalar>& u,
+                     Core::VectorArray<Vector>& points,
+                     Core::VectorArray<Vector>& grads ) const override;
 
   private:
     Vector m_points[2];
@@ -103,6 +119,9 @@ class SplineCurve : public Curve2D
     inline Vector f( Scalar u ) const override;
     inline Vector df( Scalar u ) const override;
     inline Vector fdf( Scalar t, Vector& grad ) const override;
+    inline void fdf( const std::vector<Scalar>& u,
+                     Core::VectorArray<Vector>& points,
+                     Core::VectorArray<Vector>& grads ) const override;
 
   private:
     Core::VectorArray<Vector> m_points;
@@ -6,6 +6,21 @@ namespace Geometry {
 
 /*--------------------------------------------------*/
 
+void Curve2D::fdf( const std::vector<Scalar>& u,
+                   Core::VectorArray<Vector>& points,
+                   Core::VectorArray<Vector>& grads ) const {
+    const int n = int( u.size() );
+    points.resize( u.size() );
+    grads.resize( u.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        points[i] = fdf( u[i], grads[i] );
+    }
+}
+
+/*--------------------------------------------------*/
+
 void CubicBezier::addPoint( const Curve2D::Vector p ) {
     if ( size < 4 ) { m_points[size++] = p; }
 }
@@ -35,6 +50,41 @@ Curve2D::Vector CubicBezier::fdf( Scalar t, Vector& grad ) const {
            3.0 * oneMinusT * t2 * m_points[2] + t3 * m_points[3];
 }
 
+void CubicBezier::fdf( const std::vector<Scalar>& u,
+                       Core::VectorArray<Vector>& points,
+                       Core::VectorArray<Vector>& grads ) const {
+    // Bernstein basis of all the samples at once, so that Eigen vectorizes
+    // across samples
+    const int n = int( u.size() );
+    const Eigen::Map<const Eigen::Array<Scalar, 1, Eigen::Dynamic>> t( u.data(), n );
+    const Eigen::Array<Scalar, 1, Eigen::Dynamic> s = 1 - t;
+    Eigen::Matrix<Scalar, 4, Eigen::Dynamic> basis( 4, n );
+    basis.row( 0 ) = s * s * s;
+    basis.row( 1 ) = 3 * s * s * t;
+    basis.row( 2 ) = 3 * s * t * t;
+    basis.row( 3 ) = t * t * t;
+    Eigen::Matrix<Scalar, 3, Eigen::Dynamic> dbasis( 3, n );
+    dbasis.row( 0 ) = 3 * s * s;
+    dbasis.row( 1 ) = 6 * s * t;
+    dbasis.row( 2 ) = 3 * t * t;
+
+    Eigen::Matrix<Scalar, 2, 4> p;
+    Eigen::Matrix<Scalar, 2, 3> dp;
+    for ( int i = 0; i < 4; ++i )
+    {
+        p.col( i ) = m_points[i];
+    }
+    for ( int i = 0; i < 3; ++i )
+    {
+        dp.col( i ) = m_points[i + 1] - m_points[i];
+    }
+    points.resize( u.size() );
+    grads.resize( u.size() );
+    if ( u.empty() ) { return; }
+    points.getMap() = p * basis;
+    grads.getMap()  = dp * dbasis;
+}
+
 /*--------------------------------------------------*/
 
 void Line::addPoint( const Curve2D::Vector p ) {
@@ -54,6 +104,12 @@ Curve2D::Vector Line::fdf( Scalar t, Vector& grad ) const {
     return ( 1.0 - t ) * m_points[0] + t * m_points[1];
 }
 
+void Line::fdf( const std::vector<Scalar>& u,
+                Core::VectorArray<Vector>& points,
+                Core::VectorArray<Vector>& grads ) const {
+    Curve2D::fdf( u, points, grads );
+}
+
 /*--------------------------------------------------*/
 
 void SplineCurve::addPoint( const Curve2D::Vector p ) {
@@ -83,6 +139,18 @@ Curve2D::Vector SplineCurve::fdf( Scalar u, Curve2D::Vector& grad ) const {
     return spline.f( u );
 }
 
+void SplineCurve::fdf( const std::vector<Scalar>& u,
+                       Core::VectorArray<Vector>& points,
+                       Core::VectorArray<Vector>& grads ) const {
+    Spline<2, 3> spline;
+    spline.setCtrlPoints( m_points );
+
+    Spline<2, 3>::BasisTable table;
+    spline.computeBasis( u, table );
+    spline.f( table, points );
+    spline.df( table, grads );
+}
+
 /*--------------------------------------------------*/
 
 void QuadraSpline::addPoint( const Curve2D::Vector p ) {
@@ -112,6 +180,18 @@ Curve2D::Vector QuadraSpline::fdf( Scalar u, Vector& grad ) const {
     return spline.f( u );
 }
 
+void QuadraSpline::fdf( const std::vector<Scalar>& u,
+                        Core::VectorArray<Vector>& points,
+                        Core::VectorArray<Vector>& grads ) const {
+    Spline<2, 2> spline;
+    spline.setCtrlPoints( m_points );
+
+    Spline<2, 2>::BasisTable table;
+    spline.computeBasis( u, table );
+    spline.f( table, points );
+    spline.df( table, grads );
+}
+
 } // namespace Geometry
 } // namespace Core
 } // namespace Ra
@@ -0,0 +1,78 @@
+#include <Core/Geometry/Incidence.hpp>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+std::size_t topologyHash( const uint point_size, const AlignedStdVector<Vector3ui>& T ) {
+    // FNV-1a over the vertex count and the indices.
+    constexpr std::uint64_t prime = 1099511628211ull;
+    std::uint64_t h               = 14695981039346656037ull;
+    auto mix                      = [&h]( std::uint64_t x ) {
+        h ^= x;
+        h *= prime;
+    };
+    mix( point_size );
+    mix( T.size() );
+    for ( const auto& t : T )
+    {
+        mix( t( 0 ) );
+        mix( t( 1 ) );
+        mix( t( 2 ) );
+    }
+    return std::size_t( h );
+}
+
+VertexTriangleIncidence::VertexTriangleIncidence( const uint point_size,
+                                                  const AlignedStdVector<Vector3ui>& T ) {
+    compute( point_size, T );
+}
+
+void VertexTriangleIncidence::compute( const uint point_size,
+                                       const AlignedStdVector<Vector3ui>& T ) {
+    const int t_size = int( T.size() );
+
+    // count the triangles around each vertex
+    m_offsets.assign( point_size + 1, 0 );
+    for ( const auto& t : T )
+    {
+        ++m_offsets[t( 0 ) + 1];
+        ++m_offsets[t( 1 ) + 1];
+        ++m_offsets[t( 2 ) + 1];
+    }
+    for ( uint v = 0; v < point_size; ++v )
+    {
+        m_offsets[v + 1] += m_offsets[v];
+    }
+
+    // fill in triangle order, so that each row is sorted
+    m_corners.resize( 3 * T.size() );
+    std::vector<uint> cursor( m_offsets.begin(), m_offsets.end() - 1 );
+    for ( int n = 0; n < t_size; ++n )
+    {
+        for ( uint k = 0; k < 3; ++k )
+        {
+            m_corners[cursor[T[n]( k )]++] = 3 * uint( n ) + k;
+        }
+    }
+
+    m_nbTriangles = T.size();
+    m_hash        = topologyHash( point_size, T );
+}
+
+bool VertexTriangleIncidence::update( const uint point_size,
+                                      const AlignedStdVector<Vector3ui>& T ) {
+    if ( isValidFor( point_size, T ) ) { return false; }
+    compute( point_size, T );
+    return true;
+}
+
+bool VertexTriangleIncidence::isValidFor( const uint point_size,
+                                          const AlignedStdVector<Vector3ui>& T ) const {
+    return size() == point_size && m_nbTriangles == T.size() &&
+           m_hash == topologyHash( point_size, T );
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,82 @@
+#ifndef INCIDENCE_DEFINITION
+#define INCIDENCE_DEFINITION
+
+#include <Core/Containers/AlignedStdVector.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/*
+ * Return a hash of the given triangle list, used to check whether two index
+ * buffers describe the same topology without comparing them index by index.
+ */
+RA_CORE_API std::size_t topologyHash( const uint point_size,
+                                      const AlignedStdVector<Vector3ui>& T );
+
+/// Vertex to triangle incidence of a triangle mesh, stored in compressed
+/// sparse row (CSR) form.
+/// The triangles incident to vertex v are stored, in increasing order, in
+/// the range [ offset( v ), offset( v + 1 ) ) of corners(). Each entry is a
+/// corner id c = 3 * t + k, meaning that v is the k-th vertex of triangle t.
+///
+/// The structure only depends on the topology, so it can be computed once and
+/// reused as long as the index buffer does not change: update() rebuilds it
+/// only when the topology hash differs from the one it was built with.
+class RA_CORE_API VertexTriangleIncidence
+{
+  public:
+    /// Create an empty incidence.
+    VertexTriangleIncidence() = default;
+
+    /// Create the incidence of \p T, for a mesh with \p point_size vertices.
+    VertexTriangleIncidence( const uint point_size, const AlignedStdVector<Vector3ui>& T );
+
+    /// Rebuild the incidence of \p T, for a mesh with \p point_size vertices.
+    void compute( const uint point_size, const AlignedStdVector<Vector3ui>& T );
+
+    /// Rebuild the incidence only if \p T differs from the topology it was
+    /// computed from. Return true if the incidence has been rebuilt.
+    bool update( const uint point_size, const AlignedStdVector<Vector3ui>& T );
+
+    /// Return true if *this has been computed from the same topology as \p T.
+    bool isValidFor( const uint point_size, const AlignedStdVector<Vector3ui>& T ) const;
+
+    /// Number of vertices.
+    inline uint size() const { return uint( m_offsets.size() ) - ( m_offsets.empty() ? 0 : 1 ); }
+
+    /// Number of triangles incident to \p v.
+    inline uint valence( const uint v ) const { return m_offsets[v + 1] - m_offsets[v]; }
+
+    /// First corner of vertex \p v in corners().
+    inline uint offset( const uint v ) const { return m_offsets[v]; }
+
+    /// Corner ids, sorted by vertex, then by triangle.
+    inline const std::vector<uint>& corners() const { return m_corners; }
+
+    /// Offsets of each vertex in corners(), of size size() + 1.
+    inline const std::vector<uint>& offsets() const { return m_offsets; }
+
+    /// Triangle index of the corner id \p c.
+    static inline uint triangle( const uint c ) { return c / 3; }
+
+    /// Position of the vertex in the triangle of the corner id \p c, in [0,2].
+    static inline uint local( const uint c ) { return c % 3; }
+
+  private:
+    std::vector<uint> m_offsets;
+    std::vector<uint> m_corners;
+    std::size_t m_nbTriangles{0};
+    std::size_t m_hash{0};
+};
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // INCIDENCE_DEFINITION
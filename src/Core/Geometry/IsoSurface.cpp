@@ -0,0 +1,311 @@
+#include <Core/Geometry/IsoSurface.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+namespace {
+
+constexpr uint InvalidIndex = uint( -1 );
+
+// Number of cell layers processed by each task of the extraction.
+constexpr int SlabSize = 8;
+
+// Corner i of a cell is at offset ( i & 1, ( i >> 1 ) & 1, i >> 2 ), the 12
+// edges of a cell are given as pairs of corners.
+constexpr int CellEdges[12][2] = {{0, 1},
+                                  {2, 3},
+                                  {4, 5},
+                                  {6, 7},
+                                  {0, 2},
+                                  {1, 3},
+                                  {4, 6},
+                                  {5, 7},
+                                  {0, 4},
+                                  {1, 5},
+                                  {2, 6},
+                                  {3, 7}};
+
+inline Vector3 cellCorner( const int i ) {
+    return {Scalar( i & 1 ), Scalar( ( i >> 1 ) & 1 ), Scalar( i >> 2 )};
+}
+
+// Read access to the samples and cells of a grid.
+struct Samples {
+    explicit Samples( const VolumeGrid& grid ) :
+        values( grid.data().data() ),
+        size( grid.size() ),
+        cells( ( grid.size() - Vector3i::Ones() ).cwiseMax( 0 ) ) {}
+
+    inline Scalar operator()( const int x, const int y, const int z ) const {
+        return values[size_t( x ) +
+                      size_t( size( 0 ) ) * ( size_t( y ) + size_t( size( 1 ) ) * size_t( z ) )];
+    }
+
+    // Fill v with the values of the corners of cell ( x, y, z ), and return the
+    // mask of the corners which are inside.
+    inline uint cell( const int x, const int y, const int z, const Scalar iso, Scalar* v ) const {
+        uint mask = 0;
+        for ( int i = 0; i < 8; ++i )
+        {
+            v[i] = ( *this )( x + ( i & 1 ), y + ( ( i >> 1 ) & 1 ), z + ( i >> 2 ) );
+            if ( v[i] < iso ) { mask |= 1u << i; }
+        }
+        return mask;
+    }
+
+    const Scalar* values;
+    Vector3i size;
+    Vector3i cells;
+};
+
+// Call f( x, y, mask, v ) for each cell ( x, y, z ) crossed by the
+// iso-surface, in row major order, skipping the bricks it does not cross.
+template <typename F>
+void forEachCrossedCell( const Samples& s,
+                         const int z,
+                         const Scalar iso,
+                         const VolumeBrickRanges* bricks,
+                         const F& f ) {
+    const bool skip = bricks != nullptr;
+    const int b     = skip ? bricks->brickSize() : std::max( s.cells( 0 ), 1 );
+    Scalar v[8];
+    for ( int y = 0; y < s.cells( 1 ); ++y )
+    {
+        int x = 0;
+        while ( x < s.cells( 0 ) )
+        {
+            const int end = std::min( x - x % b + b, s.cells( 0 ) );
+            if ( skip && !bricks->mayCross( Vector3i( x / b, y / b, z / b ), iso ) )
+            {
+                x = end;
+                continue;
+            }
+            for ( ; x < end; ++x )
+            {
+                const uint mask = s.cell( x, y, z, iso, v );
+                if ( mask != 0 && mask != 0xffu ) { f( x, y, mask, v ); }
+            }
+        }
+    }
+}
+
+// Mass point of the crossings of the edges of a cell, in cell coordinates, and
+// gradient of the trilinear interpolation of the corner values there.
+inline Vector3 cellVertex( const Scalar* v, const uint mask, const Scalar iso, Vector3& gradient ) {
+    Vector3 p = Vector3::Zero();
+    int count = 0;
+    for ( const auto& e : CellEdges )
+    {
+        if ( ( ( mask >> e[0] ) & 1u ) == ( ( mask >> e[1] ) & 1u ) ) { continue; }
+        const Scalar t = ( iso - v[e[0]] ) / ( v[e[1]] - v[e[0]] );
+        p += ( 1 - t ) * cellCorner( e[0] ) + t * cellCorner( e[1] );
+        ++count;
+    }
+    p /= Scalar( count );
+
+    const Scalar x = p( 0 );
+    const Scalar y = p( 1 );
+    const Scalar z = p( 2 );
+
+    gradient( 0 ) = ( 1 - y ) * ( 1 - z ) * ( v[1] - v[0] ) + y * ( 1 - z ) * ( v[3] - v[2] ) +
+                    ( 1 - y ) * z * ( v[5] - v[4] ) + y * z * ( v[7] - v[6] );
+    gradient( 1 ) = ( 1 - x ) * ( 1 - z ) * ( v[2] - v[0] ) + x * ( 1 - z ) * ( v[3] - v[1] ) +
+                    ( 1 - x ) * z * ( v[6] - v[4] ) + x * z * ( v[7] - v[5] );
+    gradient( 2 ) = ( 1 - x ) * ( 1 - y ) * ( v[4] - v[0] ) + x * ( 1 - y ) * ( v[5] - v[1] ) +
+                    ( 1 - x ) * y * ( v[6] - v[2] ) + x * y * ( v[7] - v[3] );
+    return p;
+}
+
+} // namespace
+
+VolumeBrickRanges::VolumeBrickRanges( const VolumeGrid& grid, const int brickSize ) {
+    compute( grid, brickSize );
+}
+
+void VolumeBrickRanges::compute( const VolumeGrid& grid, const int brickSize ) {
+    CORE_ASSERT( brickSize > 0, "Bricks must contain at least one cell" );
+    const Samples s( grid );
+    m_gridSize  = grid.size();
+    m_brickSize = brickSize;
+    m_size      = ( s.cells.array() + brickSize - 1 ) / brickSize;
+
+    const int nbBricks = m_size.prod();
+    m_min.resize( size_t( nbBricks ) );
+    m_max.resize( size_t( nbBricks ) );
+
+#pragma omp parallel for
+    for ( int i = 0; i < nbBricks; ++i )
+    {
+        const Vector3i b( i % m_size( 0 ),
+                          ( i / m_size( 0 ) ) % m_size( 1 ),
+                          i / ( m_size( 0 ) * m_size( 1 ) ) );
+        // samples of the cells of the brick
+        const Vector3i first = b * brickSize;
+        const Vector3i last  = ( first.array() + brickSize ).min( s.cells.array() );
+        Scalar lo            = std::numeric_limits<Scalar>::max();
+        Scalar hi            = std::numeric_limits<Scalar>::lowest();
+        for ( int z = first( 2 ); z <= last( 2 ); ++z )
+        {
+            for ( int y = first( 1 ); y <= last( 1 ); ++y )
+            {
+                for ( int x = first( 0 ); x <= last( 0 ); ++x )
+                {
+                    const Scalar v = s( x, y, z );
+                    lo             = std::min( lo, v );
+                    hi             = std::max( hi, v );
+                }
+            }
+        }
+        m_min[i] = lo;
+        m_max[i] = hi;
+    }
+}
+
+bool VolumeBrickRanges::isValidFor( const VolumeGrid& grid ) const {
+    return m_brickSize > 0 && m_gridSize == grid.size();
+}
+
+TriangleMesh
+extractIsoSurface( const VolumeGrid& grid, const Scalar iso, const VolumeBrickRanges* bricks ) {
+    CORE_ASSERT( bricks == nullptr || bricks->isValidFor( grid ),
+                 "Brick ranges computed for another grid" );
+    TriangleMesh mesh;
+    const Samples s( grid );
+    if ( ( s.cells.array() <= 0 ).any() ) { return mesh; }
+    const int nx = s.cells( 0 );
+    const int nz = s.cells( 2 );
+
+    // first vertex of each layer of cells
+    std::vector<uint> offsets( size_t( nz ) + 1, 0 );
+#pragma omp parallel for
+    for ( int z = 0; z < nz; ++z )
+    {
+        uint count = 0;
+        forEachCrossedCell(
+            s, z, iso, bricks, [&count]( int, int, uint, const Scalar* ) { ++count; } );
+        offsets[z + 1] = count;
+    }
+    for ( int z = 0; z < nz; ++z )
+    {
+        offsets[z + 1] += offsets[z];
+    }
+
+    Vector3Array vertices( offsets.back() );
+    Vector3Array normals( offsets.back() );
+    const Vector3 binSize  = grid.binSize();
+    const size_t layerSize = size_t( nx ) * size_t( s.cells( 1 ) );
+    const int nbSlabs      = ( nz + SlabSize - 1 ) / SlabSize;
+    std::vector<AlignedStdVector<Vector3ui>> slabTriangles( nbSlabs );
+
+#pragma omp parallel for schedule( dynamic )
+    for ( int slab = 0; slab < nbSlabs; ++slab )
+    {
+        const int begin = slab * SlabSize;
+        const int end   = std::min( begin + SlabSize, nz );
+        auto& triangles = slabTriangles[slab];
+
+        // vertex of each cell of the previous and current layers, and
+        // ( cell, mask ) of their crossed cells, to reset the buffers
+        std::vector<uint> previous( layerSize, InvalidIndex );
+        std::vector<uint> current( layerSize, InvalidIndex );
+        std::vector<std::pair<int, uint>> previousCells;
+        std::vector<std::pair<int, uint>> currentCells;
+
+        if ( begin > 0 )
+        {
+            uint index      = offsets[begin - 1];
+            const auto fill = [&]( int x, int y, uint, const Scalar* ) {
+                previous[size_t( x + nx * y )] = index++;
+                previousCells.emplace_back( x + nx * y, 0 );
+            };
+            forEachCrossedCell( s, begin - 1, iso, bricks, fill );
+        }
+
+        for ( int z = begin; z < end; ++z )
+        {
+            uint index      = offsets[z];
+            const auto fill = [&]( int x, int y, uint mask, const Scalar* v ) {
+                Vector3 gradient;
+                const Vector3 p = Vector3( Scalar( x ), Scalar( y ), Scalar( z ) ) +
+                                  cellVertex( v, mask, iso, gradient );
+                vertices[index] = ( p + Vector3::Constant( 0.5_ra ) ).cwiseProduct( binSize );
+                normals[index]  = gradient.cwiseQuotient( binSize ).normalized();
+                current[size_t( x + nx * y )] = index++;
+                currentCells.emplace_back( x + nx * y, mask );
+            };
+            forEachCrossedCell( s, z, iso, bricks, fill );
+
+            // each crossed edge starting at corner 0 of a cell gives a quad
+            // with the 3 cells before it around the edge
+            for ( const auto& cell : currentCells )
+            {
+                const Vector3i c( cell.first % nx, cell.first / nx, z );
+                const uint mask = cell.second;
+                for ( int a = 0; a < 3; ++a )
+                {
+                    const int b = ( a + 1 ) % 3;
+                    const int d = ( a + 2 ) % 3;
+                    if ( c( b ) == 0 || c( d ) == 0 ) { continue; }
+                    const bool inside = ( mask & 1u ) != 0;
+                    if ( inside == ( ( ( mask >> ( 1 << a ) ) & 1u ) != 0 ) ) { continue; }
+
+                    // cells around the edge, counterclockwise around axis a
+                    Vector3i q[4] = {c, c, c, c};
+                    q[0]( b ) -= 1;
+                    q[0]( d ) -= 1;
+                    q[1]( d ) -= 1;
+                    q[3]( b ) -= 1;
+                    uint id[4];
+                    for ( int k = 0; k < 4; ++k )
+                    {
+                        const auto& layer = q[k]( 2 ) == z ? current : previous;
+                        id[k]             = layer[size_t( q[k]( 0 ) + nx * q[k]( 1 ) )];
+                        CORE_ASSERT( id[k] != InvalidIndex, "Missing cell around a crossed edge" );
+                    }
+                    // the normal is along +a when the inside is at the start of the edge
+                    if ( inside )
+                    {
+                        triangles.emplace_back( id[0], id[1], id[2] );
+                        triangles.emplace_back( id[0], id[2], id[3] );
+                    }
+                    else
+                    {
+                        triangles.emplace_back( id[0], id[2], id[1] );
+                        triangles.emplace_back( id[0], id[3], id[2] );
+                    }
+                }
+            }
+
+            for ( const auto& cell : previousCells )
+            {
+                previous[size_t( cell.first )] = InvalidIndex;
+            }
+            std::swap( previous, current );
+            std::swap( previousCells, currentCells );
+            currentCells.clear();
+        }
+    }
+
+    size_t nbTriangles = 0;
+    for ( const auto& t : slabTriangles )
+    {
+        nbTriangles += t.size();
+    }
+    mesh.m_indices.reserve( nbTriangles );
+    for ( const auto& t : slabTriangles )
+    {
+        mesh.m_indices.insert( mesh.m_indices.end(), t.begin(), t.end() );
+    }
+    mesh.setVertices( std::move( vertices ) );
+    mesh.setNormals( std::move( normals ) );
+    return mesh;
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
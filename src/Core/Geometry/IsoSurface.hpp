@@ -0,0 +1,92 @@
+#ifndef RADIUMENGINE_ISO_SURFACE_HPP_
+#define RADIUMENGINE_ISO_SURFACE_HPP_
+
+#include <Core/Geometry/TriangleMesh.hpp>
+#include <Core/Geometry/Volume.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/**
+ * Extraction of the iso-surfaces of a VolumeGrid as triangle meshes.
+ *
+ * The grid samples are located at the center of their bin, i.e. sample
+ * ( i, j, k ) is at ( ( i, j, k ) + 0.5 ) * binSize, and a cell is the cube
+ * between 8 neighbouring samples. Values lower than the iso-value are inside.
+ *
+ * The surface is built by dual contouring: each cell crossed by the surface
+ * holds one vertex, at the mass point of the crossings of its edges, and each
+ * sample edge crossed by the surface gives a quad between the 4 cells around
+ * it. The mesh is thus closed inside the grid, and open where it leaves the
+ * grid. Triangles are oriented towards the outside, and the normals are the
+ * normalized gradient of the trilinear interpolation of the samples.
+ *
+ * The extraction is parallel over slabs of cell layers. Vertices are numbered
+ * layer by layer, from a prefix sum of the number of crossed cells of each
+ * layer, so that each slab finds the vertices of the neighbouring cells in two
+ * layer sized index buffers, without any global hash map. The result does not
+ * depend on the number of threads.
+ *
+ * The vertex placement was taken from:
+ * "Constrained Elastic Surface Nets: generating smooth surfaces from binary
+ * segmented data"
+ * [ Sarah F. F. Gibson ]
+ * MICCAI 1998
+ **/
+
+/// Range of values of each brick of cells of a VolumeGrid, to skip empty space
+/// during iso-surface extraction. The ranges do not depend on the iso-value,
+/// so they can be reused to extract several iso-surfaces of the same grid.
+class RA_CORE_API VolumeBrickRanges
+{
+  public:
+    /// Create empty ranges.
+    VolumeBrickRanges() = default;
+
+    /// Compute the ranges of \p grid, for bricks of \p brickSize ^ 3 cells.
+    explicit VolumeBrickRanges( const VolumeGrid& grid, int brickSize = 8 );
+
+    /// Compute the ranges of \p grid, for bricks of \p brickSize ^ 3 cells.
+    void compute( const VolumeGrid& grid, int brickSize = 8 );
+
+    /// Return true if the ranges have been computed for a grid of the size of
+    /// \p grid (the values are not checked).
+    bool isValidFor( const VolumeGrid& grid ) const;
+
+    /// Number of cells per side of the bricks.
+    inline int brickSize() const { return m_brickSize; }
+
+    /// Number of bricks along each axis.
+    inline const Vector3i& size() const { return m_size; }
+
+    /// Return true if the iso-surface of value \p iso may cross brick \p b.
+    inline bool mayCross( const Vector3i& b, Scalar iso ) const {
+        const size_t i = size_t( b( 0 ) + m_size( 0 ) * ( b( 1 ) + m_size( 1 ) * b( 2 ) ) );
+        return m_min[i] < iso && m_max[i] >= iso;
+    }
+
+  private:
+    Vector3i m_gridSize{Vector3i::Zero()};
+    Vector3i m_size{Vector3i::Zero()};
+    int m_brickSize{0};
+    std::vector<Scalar> m_min;
+    std::vector<Scalar> m_max;
+};
+
+/// Extract the iso-surface of value \p iso of \p grid.
+/// When \p bricks is not null, it must have been computed for \p grid, and the
+/// cells of the bricks the surface does not cross are skipped.
+RA_CORE_API TriangleMesh extractIsoSurface( const VolumeGrid& grid,
+                                            Scalar iso                      = 0,
+                                            const VolumeBrickRanges* bricks = nullptr );
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_ISO_SURFACE_HPP_
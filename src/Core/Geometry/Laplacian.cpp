@@ -40,29 +40,20 @@ LaplacianMatrix powerLaplacian( const LaplacianMatrix& L, const uint k ) {
 
 LaplacianMatrix cotangentWeightLaplacian( const VectorArray<Vector3>& p,
                                           const AlignedStdVector<Vector3ui>& T ) {
-    LaplacianMatrix L( p.size(), p.size() );
-    for ( const auto& t : T )
-    {
-        uint i      = t( 0 );
-        uint j      = t( 1 );
-        uint k      = t( 2 );
-        Vector3 IJ  = p[j] - p[i];
-        Vector3 JK  = p[k] - p[j];
-        Vector3 KI  = p[i] - p[k];
-        Scalar cotI = Math::cotan( IJ, ( -KI ).eval() );
-        Scalar cotJ = Math::cotan( JK, ( -IJ ).eval() );
-        Scalar cotK = Math::cotan( KI, ( -JK ).eval() );
-        L.coeffRef( i, j ) -= cotK;
-        L.coeffRef( j, i ) -= cotK;
-        L.coeffRef( j, k ) -= cotI;
-        L.coeffRef( k, j ) -= cotI;
-        L.coeffRef( k, i ) -= cotJ;
-        L.coeffRef( i, k ) -= cotJ;
-        L.coeffRef( i, i ) += cotJ + cotK;
-        L.coeffRef( j, j ) += cotI + cotK;
-        L.coeffRef( k, k ) += cotI + cotJ;
-    }
-    return ( 0.5 * L );
+    LaplacianMatrix L;
+    cotangentWeightLaplacian( p, T, OperatorPattern( uint( p.size() ), T ), L );
+    return L;
+}
+
+void cotangentWeightLaplacian( const VectorArray<Vector3>& p,
+                               const AlignedStdVector<Vector3ui>& T,
+                               const OperatorPattern& pattern,
+                               LaplacianMatrix& L ) {
+    CORE_ASSERT( pattern.isValidFor( uint( p.size() ), T ), "Invalid operator pattern" );
+    std::vector<Scalar> w;
+    cotangentCornerWeights( p, T, w );
+    pattern.setLaplacianStructure( L );
+    pattern.gatherLaplacian( w, L );
 }
 
 ////////////////
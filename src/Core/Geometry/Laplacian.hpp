@@ -101,6 +101,19 @@ LaplacianMatrix RA_CORE_API powerLaplacian( const LaplacianMatrix& L, const uint
 LaplacianMatrix RA_CORE_API cotangentWeightLaplacian( const VectorArray<Vector3>& p,
                                                       const AlignedStdVector<Vector3ui>& T );
 
+/*
+ * Compute the same matrix as cotangentWeightLaplacian( p, T ), assembled in
+ * parallel with the precomputed sparsity pattern of T. If L already has the
+ * structure of the Laplacian, e.g. because it has been computed for a previous
+ * pose of the mesh, only its values are refilled.
+ *
+ * \note The pattern must be valid for p and T (see OperatorPattern::update()).
+ */
+void RA_CORE_API cotangentWeightLaplacian( const VectorArray<Vector3>& p,
+                                           const AlignedStdVector<Vector3ui>& T,
+                                           const OperatorPattern& pattern,
+                                           LaplacianMatrix& L );
+
 ////////////////
 /// ONE RING ///
 ////////////////
@@ -0,0 +1,276 @@
+#include <Core/Geometry/MeshCleanup.hpp>
+
+#include <Core/Utils/Log.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+using namespace Utils; // log, AttribBase
+
+namespace {
+
+// Number of bits of each cell coordinate in the cell codes.
+constexpr int CellBits         = 21;
+constexpr std::int64_t MaxCell = ( std::int64_t( 1 ) << CellBits ) - 1;
+
+inline std::uint64_t cellCode( std::int64_t x, std::int64_t y, std::int64_t z ) {
+    return ( std::uint64_t( x ) << ( 2 * CellBits ) ) | ( std::uint64_t( y ) << CellBits ) |
+           std::uint64_t( z );
+}
+
+// Vertex attribute compared when welding, as an array of floats for the
+// float attributes, or of scalars for the vector ones.
+struct ComparedAttrib {
+    const float* floats;
+    const Scalar* scalars;
+    size_t dim;
+};
+
+template <typename T>
+inline bool closeComponents( const T* x, const T* y, size_t dim, Scalar epsilon ) {
+    for ( size_t k = 0; k < dim; ++k )
+    {
+        if ( !( std::abs( x[k] - y[k] ) <= epsilon ) ) { return false; }
+    }
+    return true;
+}
+
+template <typename T>
+inline ComparedAttrib vectorAttrib( AttribBase* attr ) {
+    return {nullptr, attr->cast<T>().data()[0].data(), size_t( T::RowsAtCompileTime )};
+}
+
+template <typename T>
+void gatherAttrib( AttribBase* attr, const std::vector<uint>& newToOld ) {
+    auto& attrib = attr->cast<T>();
+    auto& data   = attrib.getDataWithLock();
+    typename Attrib<T>::Container gathered( newToOld.size() );
+    const int n = int( newToOld.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        gathered[i] = data[newToOld[i]];
+    }
+    data.swap( gathered );
+    attrib.unlock();
+}
+
+} // namespace
+
+std::vector<uint> weldVertices( TriangleMesh& mesh, Scalar epsilon, Scalar attribEpsilon ) {
+    const auto& p = mesh.vertices();
+    const int n   = int( p.size() );
+    std::vector<uint> replacement( p.size() );
+    if ( n == 0 ) { return replacement; }
+
+    std::vector<ComparedAttrib> attribs;
+    mesh.vertexAttribs().for_each_attrib( [&attribs, &p]( AttribBase* attr ) {
+        if ( attr->getSize() != p.size() || attr->getName() == "in_position" ) { return; }
+        if ( attr->isFloat() )
+        { attribs.push_back( {attr->cast<float>().data().data(), nullptr, 1} ); }
+        else if ( attr->isVec2() )
+        { attribs.push_back( vectorAttrib<Vector2>( attr ) ); }
+        else if ( attr->isVec3() )
+        { attribs.push_back( vectorAttrib<Vector3>( attr ) ); }
+        else if ( attr->isVec4() )
+        { attribs.push_back( vectorAttrib<Vector4>( attr ) ); }
+        else
+        {
+            LOG( logWARNING ) << "[weldVertices] mesh attribute " << attr->getName()
+                              << " type is not supported (only float, vec2, vec3 nor vec4 are "
+                                 "supported), it is ignored";
+        }
+    } );
+    const auto compatible = [&attribs, attribEpsilon]( uint a, uint b ) {
+        for ( const auto& attrib : attribs )
+        {
+            const bool close =
+                attrib.floats
+                    ? closeComponents( attrib.floats + a, attrib.floats + b, 1, attribEpsilon )
+                    : closeComponents( attrib.scalars + a * attrib.dim,
+                                       attrib.scalars + b * attrib.dim,
+                                       attrib.dim,
+                                       attribEpsilon );
+            if ( !close ) { return false; }
+        }
+        return true;
+    };
+
+    // the cells are at least epsilon wide, so that close vertices are in
+    // neighbouring cells, and small enough to be coded on CellBits bits
+    Aabb aabb;
+    for ( const auto& v : p )
+    {
+        aabb.extend( v );
+    }
+    const Scalar extent = aabb.sizes().maxCoeff();
+    Scalar side         = std::max( epsilon, extent / Scalar( MaxCell - 1 ) );
+    if ( !( side > 0 ) ) { side = 1; }
+    std::vector<std::array<std::int64_t, 3>> cells( p.size() );
+    std::vector<std::pair<std::uint64_t, uint>> sorted( p.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        for ( int a = 0; a < 3; ++a )
+        {
+            const Scalar c = std::floor( ( p[i]( a ) - aabb.min()( a ) ) / side );
+            cells[i][a]    = std::min( std::max( std::int64_t( c ), std::int64_t( 0 ) ), MaxCell );
+        }
+        sorted[i] = {cellCode( cells[i][0], cells[i][1], cells[i][2] ), uint( i )};
+    }
+    // the vertices of a cell are sorted by index
+    std::sort( sorted.begin(), sorted.end() );
+
+    // each vertex is replaced by the first compatible vertex within epsilon
+    const Scalar epsilon2 = epsilon > 0 ? epsilon * epsilon : 0_ra;
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        uint first = uint( i );
+        for ( std::int64_t x = cells[i][0] - 1; x <= cells[i][0] + 1; ++x )
+        {
+            for ( std::int64_t y = cells[i][1] - 1; y <= cells[i][1] + 1; ++y )
+            {
+                for ( std::int64_t z = cells[i][2] - 1; z <= cells[i][2] + 1; ++z )
+                {
+                    if ( std::min( {x, y, z} ) < 0 || std::max( {x, y, z} ) > MaxCell )
+                    { continue; }
+                    const std::pair<std::uint64_t, uint> key{cellCode( x, y, z ), 0};
+                    for ( auto it = std::lower_bound( sorted.begin(), sorted.end(), key );
+                          it != sorted.end() && it->first == key.first && it->second < first;
+                          ++it )
+                    {
+                        if ( ( p[it->second] - p[i] ).squaredNorm() <= epsilon2 &&
+                             compatible( it->second, uint( i ) ) )
+                        {
+                            first = it->second;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        replacement[i] = first;
+    }
+    // the replacing vertex comes first, and is already replaced
+    for ( uint i = 0; i < replacement.size(); ++i )
+    {
+        replacement[i] = replacement[replacement[i]];
+    }
+
+    auto& T        = mesh.m_indices;
+    const int size = int( T.size() );
+#pragma omp parallel for
+    for ( int t = 0; t < size; ++t )
+    {
+        for ( uint k = 0; k < 3; ++k )
+        {
+            T[t]( k ) = replacement[T[t]( k )];
+        }
+    }
+    return replacement;
+}
+
+size_t removeDegenerateTriangles( TriangleMesh& mesh, Scalar areaEpsilon ) {
+    const auto& p  = mesh.vertices();
+    auto& T        = mesh.m_indices;
+    const int size = int( T.size() );
+    std::vector<char> degenerate( T.size() );
+#pragma omp parallel for
+    for ( int t = 0; t < size; ++t )
+    {
+        const Vector3ui& f = T[t];
+        if ( f( 0 ) == f( 1 ) || f( 1 ) == f( 2 ) || f( 2 ) == f( 0 ) ) { degenerate[t] = 1; }
+        else
+        {
+            const Scalar area =
+                ( p[f( 1 )] - p[f( 0 )] ).cross( p[f( 2 )] - p[f( 0 )] ).norm() / 2;
+            degenerate[t] = area <= areaEpsilon;
+        }
+    }
+    size_t kept = 0;
+    for ( size_t t = 0; t < T.size(); ++t )
+    {
+        if ( !degenerate[t] ) { T[kept++] = T[t]; }
+    }
+    const size_t removed = T.size() - kept;
+    T.resize( kept );
+    return removed;
+}
+
+std::vector<uint> removeUnusedVertices( TriangleMesh& mesh ) {
+    const size_t point_size = mesh.vertices().size();
+    std::vector<uint> oldToNew( point_size, InvalidVertex );
+    for ( const auto& t : mesh.m_indices )
+    {
+        for ( uint k = 0; k < 3; ++k )
+        {
+            oldToNew[t( k )] = 0;
+        }
+    }
+    std::vector<uint> newToOld;
+    newToOld.reserve( point_size );
+    for ( uint v = 0; v < point_size; ++v )
+    {
+        if ( oldToNew[v] == InvalidVertex ) { continue; }
+        oldToNew[v] = uint( newToOld.size() );
+        newToOld.push_back( v );
+    }
+    if ( newToOld.size() == point_size ) { return oldToNew; }
+
+    auto& T        = mesh.m_indices;
+    const int size = int( T.size() );
+#pragma omp parallel for
+    for ( int t = 0; t < size; ++t )
+    {
+        for ( uint k = 0; k < 3; ++k )
+        {
+            T[t]( k ) = oldToNew[T[t]( k )];
+        }
+    }
+
+    mesh.vertexAttribs().for_each_attrib( [&newToOld, point_size]( AttribBase* attr ) {
+        if ( attr->getSize() != point_size ) { return; }
+        if ( attr->isFloat() ) { gatherAttrib<float>( attr, newToOld ); }
+        else if ( attr->isVec2() )
+        { gatherAttrib<Vector2>( attr, newToOld ); }
+        else if ( attr->isVec3() )
+        { gatherAttrib<Vector3>( attr, newToOld ); }
+        else if ( attr->isVec4() )
+        { gatherAttrib<Vector4>( attr, newToOld ); }
+        else
+        {
+            LOG( logWARNING ) << "[removeUnusedVertices] mesh attribute " << attr->getName()
+                              << " type is not supported (only float, vec2, vec3 nor vec4 are "
+                                 "supported), it is left unchanged";
+        }
+    } );
+    return oldToNew;
+}
+
+MeshCleanupStatistics cleanupTriangleMesh( TriangleMesh& mesh,
+                                           Scalar epsilon,
+                                           Scalar attribEpsilon,
+                                           Scalar areaEpsilon ) {
+    MeshCleanupStatistics stats;
+    const auto replacement = weldVertices( mesh, epsilon, attribEpsilon );
+    for ( uint v = 0; v < replacement.size(); ++v )
+    {
+        if ( replacement[v] != v ) { ++stats.weldedVertices; }
+    }
+    stats.degenerateTriangles = removeDegenerateTriangles( mesh, areaEpsilon );
+    const auto oldToNew       = removeUnusedVertices( mesh );
+    stats.removedVertices = size_t( std::count( oldToNew.begin(), oldToNew.end(), InvalidVertex ) );
+    return stats;
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,70 @@
+#ifndef RADIUMENGINE_MESH_CLEANUP_HPP_
+#define RADIUMENGINE_MESH_CLEANUP_HPP_
+
+#include <Core/Geometry/TriangleMesh.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/**
+ * Cleanup of triangle meshes, as given by importers which duplicate the
+ * vertices of each face corner: welding of close vertices, removal of the
+ * degenerate triangles and compaction of the vertex attributes.
+ *
+ * Only the float, vec2, vec3 and vec4 vertex attributes are supported, the
+ * other ones are ignored when welding, and left unchanged when compacting.
+ **/
+
+/// Vertex index of the removed vertices, as returned by removeUnusedVertices().
+constexpr uint InvalidVertex = uint( -1 );
+
+/// Statistics of cleanupTriangleMesh().
+struct MeshCleanupStatistics {
+    /// Number of vertices merged with another one.
+    size_t weldedVertices{0};
+    /// Number of triangles removed.
+    size_t degenerateTriangles{0};
+    /// Number of vertices removed, including the welded ones.
+    size_t removedVertices{0};
+};
+
+/// Merge the vertices of \p mesh which are closer than \p epsilon, and whose
+/// other attributes (e.g. normals, texture coordinates, colors) all differ
+/// by at most \p attribEpsilon on each component, so that the seams of the
+/// attributes are kept split. The vertices are hashed in a grid of cells of
+/// side \p epsilon, and each vertex looks for the first compatible vertex in
+/// the neighbouring cells, in parallel. Merges are transitive: a vertex
+/// follows the vertex it is merged with if this one is merged too.
+/// Only the triangles are modified, use removeUnusedVertices() to remove the
+/// merged vertices. An \p epsilon of 0 welds identical positions.
+/// \return the index of the vertex which replaces each vertex (itself if kept).
+RA_CORE_API std::vector<uint>
+weldVertices( TriangleMesh& mesh, Scalar epsilon, Scalar attribEpsilon = 1e-4_ra );
+
+/// Remove the triangles of \p mesh which have a repeated vertex, or whose
+/// area is not larger than \p areaEpsilon.
+/// \return the number of removed triangles.
+RA_CORE_API size_t removeDegenerateTriangles( TriangleMesh& mesh, Scalar areaEpsilon = 0_ra );
+
+/// Remove the vertices of \p mesh which are not referenced by its triangles,
+/// keeping the order of the others, from all its vertex attributes.
+/// \return the new index of each original vertex, InvalidVertex if removed.
+RA_CORE_API std::vector<uint> removeUnusedVertices( TriangleMesh& mesh );
+
+/// Run weldVertices(), removeDegenerateTriangles() and removeUnusedVertices()
+/// on \p mesh.
+RA_CORE_API MeshCleanupStatistics cleanupTriangleMesh( TriangleMesh& mesh,
+                                                       Scalar epsilon,
+                                                       Scalar attribEpsilon = 1e-4_ra,
+                                                       Scalar areaEpsilon   = 0_ra );
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_MESH_CLEANUP_HPP_
@@ -0,0 +1,288 @@
+#include <Core/Geometry/MeshOptimization.hpp>
+
+#include <Core/Geometry/Incidence.hpp>
+#include <Core/Geometry/TriangleOperation.hpp>
+#include <Core/Utils/Log.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+using namespace Utils; // log, AttribBase
+
+namespace {
+
+constexpr uint InvalidIndex = uint( -1 );
+
+// Return a vertex which still has triangles to emit: the most recently
+// referenced one from the dead-end stack if possible, or the next one in
+// input order otherwise. Return InvalidIndex when all triangles are emitted.
+uint skipDeadEnd( const std::vector<uint>& live, std::vector<uint>& deadEnd, uint& cursor ) {
+    while ( !deadEnd.empty() )
+    {
+        const uint v = deadEnd.back();
+        deadEnd.pop_back();
+        if ( live[v] > 0 ) { return v; }
+    }
+    while ( cursor < live.size() )
+    {
+        if ( live[cursor] > 0 ) { return cursor; }
+        ++cursor;
+    }
+    return InvalidIndex;
+}
+
+template <typename T>
+void permuteAttrib( AttribBase* attr, const std::vector<uint>& newToOld ) {
+    auto& attrib = attr->cast<T>();
+    auto& data   = attrib.getDataWithLock();
+    typename Attrib<T>::Container permuted( data.size() );
+    for ( uint i = 0; i < newToOld.size(); ++i )
+    {
+        permuted[i] = data[newToOld[i]];
+    }
+    data.swap( permuted );
+    attrib.unlock();
+}
+
+} // namespace
+
+VertexCacheStatistics computeVertexCacheStatistics( const uint point_size,
+                                                    const AlignedStdVector<Vector3ui>& T,
+                                                    const uint cacheSize ) {
+    VertexCacheStatistics stats;
+    if ( T.empty() ) { return stats; }
+
+    // A vertex is in the cache if less than cacheSize vertices have been
+    // inserted since its own insertion.
+    std::vector<uint> insertion( point_size, 0 );
+    std::vector<bool> referenced( point_size, false );
+    uint time   = cacheSize + 1;
+    uint misses = 0;
+    for ( const auto& t : T )
+    {
+        for ( uint k = 0; k < 3; ++k )
+        {
+            const uint v = t( k );
+            if ( time - insertion[v] > cacheSize )
+            {
+                insertion[v] = time++;
+                ++misses;
+            }
+            referenced[v] = true;
+        }
+    }
+    const auto nbReferenced = std::count( referenced.begin(), referenced.end(), true );
+    stats.acmr              = Scalar( misses ) / Scalar( T.size() );
+    stats.atvr              = Scalar( misses ) / Scalar( nbReferenced );
+    return stats;
+}
+
+void optimizeVertexCache( const uint point_size,
+                          AlignedStdVector<Vector3ui>& T,
+                          const uint cacheSize,
+                          std::vector<uint>* clusters ) {
+    if ( clusters != nullptr ) { clusters->clear(); }
+    if ( T.empty() ) { return; }
+
+    const VertexTriangleIncidence incidence( point_size, T );
+    const auto& corners = incidence.corners();
+
+    // number of triangles still to be emitted around each vertex
+    std::vector<uint> live( point_size );
+    for ( uint v = 0; v < point_size; ++v )
+    {
+        live[v] = incidence.valence( v );
+    }
+    std::vector<uint> cacheTime( point_size, 0 );
+    std::vector<bool> emitted( T.size(), false );
+    std::vector<uint> deadEnd;
+    std::vector<uint> candidates;
+    deadEnd.reserve( 3 * T.size() );
+
+    AlignedStdVector<Vector3ui> out;
+    out.reserve( T.size() );
+
+    uint time       = cacheSize + 1;
+    uint cursor     = 0;
+    uint fanning    = skipDeadEnd( live, deadEnd, cursor );
+    bool newCluster = true;
+    while ( fanning != InvalidIndex )
+    {
+        if ( newCluster && clusters != nullptr ) { clusters->push_back( uint( out.size() ) ); }
+
+        // emit all the remaining triangles around the fanning vertex
+        candidates.clear();
+        const uint end = incidence.offset( fanning + 1 );
+        for ( uint c = incidence.offset( fanning ); c < end; ++c )
+        {
+            const uint t = VertexTriangleIncidence::triangle( corners[c] );
+            if ( emitted[t] ) { continue; }
+            for ( uint k = 0; k < 3; ++k )
+            {
+                const uint v = T[t]( k );
+                deadEnd.push_back( v );
+                candidates.push_back( v );
+                --live[v];
+                if ( time - cacheTime[v] > cacheSize ) { cacheTime[v] = time++; }
+            }
+            emitted[t] = true;
+            out.push_back( T[t] );
+        }
+
+        // pick the candidate that will still be in the cache once all its
+        // triangles are emitted, and has been in there the longest
+        uint next     = InvalidIndex;
+        uint priority = 0;
+        for ( const uint v : candidates )
+        {
+            if ( live[v] == 0 ) { continue; }
+            uint p = 1;
+            if ( time - cacheTime[v] + 2 * live[v] <= cacheSize ) { p += time - cacheTime[v]; }
+            if ( p > priority )
+            {
+                priority = p;
+                next     = v;
+            }
+        }
+        newCluster = next == InvalidIndex;
+        fanning    = newCluster ? skipDeadEnd( live, deadEnd, cursor ) : next;
+    }
+
+    CORE_ASSERT( out.size() == T.size(), "Some triangles have not been emitted" );
+    T = std::move( out );
+}
+
+void optimizeOverdraw( const VectorArray<Vector3>& p,
+                       AlignedStdVector<Vector3ui>& T,
+                       std::vector<uint>& clusters ) {
+    if ( clusters.size() < 2 ) { return; }
+    const int nbClusters = int( clusters.size() );
+
+    // area weighted center of each cluster, and of the whole mesh
+    Vector3 meshCenter = Vector3::Zero();
+    Scalar meshArea    = 0;
+    for ( const auto& t : T )
+    {
+        const Scalar area = triangleArea( p[t( 0 )], p[t( 1 )], p[t( 2 )] );
+        meshCenter += area * triangleBarycenter( p[t( 0 )], p[t( 1 )], p[t( 2 )] );
+        meshArea += area;
+    }
+    if ( meshArea > 0 ) { meshCenter /= meshArea; }
+
+    // sort key: how much the cluster faces away from the center
+    std::vector<Scalar> key( clusters.size() );
+#pragma omp parallel for
+    for ( int c = 0; c < nbClusters; ++c )
+    {
+        const uint begin = clusters[c];
+        const uint end   = c + 1 < nbClusters ? clusters[c + 1] : uint( T.size() );
+        Vector3 center   = Vector3::Zero();
+        Vector3 normal   = Vector3::Zero();
+        Scalar area      = 0;
+        for ( uint i = begin; i < end; ++i )
+        {
+            const auto& t     = T[i];
+            const Vector3 n   = ( p[t( 1 )] - p[t( 0 )] ).cross( p[t( 2 )] - p[t( 0 )] );
+            const Scalar triA = n.norm() / 2;
+            center += triA * triangleBarycenter( p[t( 0 )], p[t( 1 )], p[t( 2 )] );
+            normal += n;
+            area += triA;
+        }
+        if ( area > 0 ) { center /= area; }
+        key[c] = ( center - meshCenter ).dot( normal.normalized() );
+    }
+
+    std::vector<uint> order( clusters.size() );
+    std::iota( order.begin(), order.end(), 0 );
+    std::stable_sort(
+        order.begin(), order.end(), [&key]( uint a, uint b ) { return key[a] > key[b]; } );
+
+    AlignedStdVector<Vector3ui> out;
+    std::vector<uint> outClusters;
+    out.reserve( T.size() );
+    outClusters.reserve( clusters.size() );
+    for ( const uint c : order )
+    {
+        const uint begin = clusters[c];
+        const uint end   = c + 1 < clusters.size() ? clusters[c + 1] : uint( T.size() );
+        outClusters.push_back( uint( out.size() ) );
+        out.insert( out.end(), T.begin() + begin, T.begin() + end );
+    }
+    T        = std::move( out );
+    clusters = std::move( outClusters );
+}
+
+std::vector<uint> optimizeVertexFetch( TriangleMesh& mesh ) {
+    const uint point_size = uint( mesh.vertices().size() );
+
+    // the attributes which can not be permuted would no longer match the
+    // vertices, so the mesh is left untouched
+    bool supported = true;
+    mesh.vertexAttribs().for_each_attrib( [&supported, point_size]( AttribBase* attr ) {
+        if ( attr->getSize() == point_size &&
+             !( attr->isFloat() || attr->isVec2() || attr->isVec3() || attr->isVec4() ) )
+        {
+            LOG( logWARNING ) << "[optimizeVertexFetch] mesh attribute " << attr->getName()
+                              << " type is not supported (only float, vec2, vec3 nor vec4 are "
+                                 "supported), the vertices are not reordered";
+            supported = false;
+        }
+    } );
+    if ( !supported ) { return {}; }
+
+    std::vector<uint> oldToNew( point_size, InvalidIndex );
+    std::vector<uint> newToOld;
+    newToOld.reserve( point_size );
+
+    for ( auto& t : mesh.m_indices )
+    {
+        for ( uint k = 0; k < 3; ++k )
+        {
+            uint& v = oldToNew[t( k )];
+            if ( v == InvalidIndex )
+            {
+                v = uint( newToOld.size() );
+                newToOld.push_back( t( k ) );
+            }
+            t( k ) = v;
+        }
+    }
+    for ( uint v = 0; v < point_size; ++v )
+    {
+        if ( oldToNew[v] == InvalidIndex )
+        {
+            oldToNew[v] = uint( newToOld.size() );
+            newToOld.push_back( v );
+        }
+    }
+
+    mesh.vertexAttribs().for_each_attrib( [&newToOld, point_size]( AttribBase* attr ) {
+        if ( attr->getSize() != point_size ) { return; }
+        if ( attr->isFloat() ) { permuteAttrib<float>( attr, newToOld ); }
+        else if ( attr->isVec2() )
+        { permuteAttrib<Vector2>( attr, newToOld ); }
+        else if ( attr->isVec3() )
+        { permuteAttrib<Vector3>( attr, newToOld ); }
+        else if ( attr->isVec4() )
+        { permuteAttrib<Vector4>( attr, newToOld ); }
+    } );
+
+    return oldToNew;
+}
+
+void optimizeTriangleMesh( TriangleMesh& mesh, const uint cacheSize, const bool sortOverdraw ) {
+    const uint point_size = uint( mesh.vertices().size() );
+    std::vector<uint> clusters;
+    optimizeVertexCache(
+        point_size, mesh.m_indices, cacheSize, sortOverdraw ? &clusters : nullptr );
+    if ( sortOverdraw ) { optimizeOverdraw( mesh.vertices(), mesh.m_indices, clusters ); }
+    optimizeVertexFetch( mesh );
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,83 @@
+#ifndef RADIUMENGINE_MESH_OPTIMIZATION_HPP_
+#define RADIUMENGINE_MESH_OPTIMIZATION_HPP_
+
+#include <Core/Containers/AlignedStdVector.hpp>
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/Geometry/TriangleMesh.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/**
+ * Reordering of triangle mesh index and vertex buffers for GPU rendering.
+ *
+ * The triangle order is optimized for the post-transform vertex cache with
+ * the linear-speed Tipsify algorithm, then clusters of triangles can be
+ * sorted to reduce overdraw, and finally the vertices are renumbered in
+ * the order they are first referenced, to make vertex fetch sequential.
+ *
+ * The algorithms were taken from:
+ * "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+ * [ Pedro V. Sander, Diego Nehab, Joshua Barczak ]
+ * SIGGRAPH 2007
+ **/
+
+/// Post-transform vertex cache statistics of an index buffer, simulated with
+/// a FIFO cache.
+struct VertexCacheStatistics {
+    /// Average cache miss ratio: number of cache misses per triangle.
+    /// Ranges from 3 (no reuse) down to ~0.5 for very regular meshes.
+    Scalar acmr{0};
+    /// Average transform to vertex ratio: number of cache misses per
+    /// referenced vertex. 1 is optimal.
+    Scalar atvr{0};
+};
+
+/// Simulate a FIFO cache of \p cacheSize entries while drawing \p T.
+RA_CORE_API VertexCacheStatistics
+computeVertexCacheStatistics( const uint point_size,
+                              const AlignedStdVector<Vector3ui>& T,
+                              const uint cacheSize = 16 );
+
+/// Reorder the triangles of \p T for a cache of \p cacheSize entries (Tipsify).
+/// If \p clusters is not null, it is filled with the index of the first
+/// triangle of each cluster, i.e. each place where the algorithm had to
+/// jump to a non adjacent part of the mesh. The vertices are not modified.
+RA_CORE_API void optimizeVertexCache( const uint point_size,
+                                      AlignedStdVector<Vector3ui>& T,
+                                      const uint cacheSize         = 16,
+                                      std::vector<uint>* clusters = nullptr );
+
+/// Reorder the \p clusters of \p T (as computed by optimizeVertexCache) so that
+/// the clusters facing away from the mesh center are drawn first, which
+/// lowers overdraw from most view points. Triangles are kept in order inside
+/// a cluster, so the cache efficiency is preserved. \p clusters is updated.
+RA_CORE_API void optimizeOverdraw( const VectorArray<Vector3>& p,
+                                   AlignedStdVector<Vector3ui>& T,
+                                   std::vector<uint>& clusters );
+
+/// Renumber the vertices of \p mesh in the order they are first referenced by
+/// its triangles, and permute all its vertex attributes accordingly.
+/// Unreferenced vertices are moved at the end of the buffers.
+/// The mesh is left unchanged if it has a vertex attribute of another type
+/// than float, Vector2, Vector3 or Vector4, which could not be permuted.
+/// \return the new index of each original vertex, or an empty vector if the
+/// mesh is left unchanged.
+RA_CORE_API std::vector<uint> optimizeVertexFetch( TriangleMesh& mesh );
+
+/// Run the full optimization on \p mesh: vertex cache, optional overdraw
+/// sorting, and vertex fetch.
+RA_CORE_API void optimizeTriangleMesh( TriangleMesh& mesh,
+                                       const uint cacheSize    = 16,
+                                       const bool sortOverdraw = true );
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_MESH_OPTIMIZATION_HPP_
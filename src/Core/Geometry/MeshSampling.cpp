@@ -0,0 +1,309 @@
+#include <Core/Geometry/MeshSampling.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+namespace {
+
+// Number of samples per task of the parallel loops over the samples, each
+// task having its own random generator.
+constexpr int ChunkSize = 1 << 14;
+
+inline int chunkCount( const size_t n ) {
+    return int( ( n + ChunkSize - 1 ) / ChunkSize );
+}
+
+// Point on a triangle, given by its barycentric coordinates.
+struct SurfaceSample {
+    uint triangle;
+    Vector3 weights;
+};
+
+std::vector<Scalar> triangleAreas( const TriangleMesh& mesh ) {
+    const auto& v = mesh.vertices();
+    const auto& T = mesh.m_indices;
+    const int n   = int( T.size() );
+    std::vector<Scalar> areas( T.size() );
+#pragma omp parallel for
+    for ( int t = 0; t < n; ++t )
+    {
+        areas[t] = ( v[T[t]( 1 )] - v[T[t]( 0 )] ).cross( v[T[t]( 2 )] - v[T[t]( 0 )] ).norm() / 2;
+    }
+    return areas;
+}
+
+// Draw count samples uniformly on the mesh whose triangle areas are given by
+// table, the samples of each chunk being drawn from their own generator.
+std::vector<SurfaceSample> uniformSamples( const AliasTable& table, size_t count, uint seed ) {
+    std::vector<SurfaceSample> samples( count );
+    const int n        = int( count );
+    const int nbChunks = chunkCount( count );
+#pragma omp parallel for
+    for ( int c = 0; c < nbChunks; ++c )
+    {
+        std::seed_seq seq{seed, uint( c )};
+        std::mt19937 gen( seq );
+        std::uniform_real_distribution<Scalar> dis( 0_ra, 1_ra );
+        const int end = std::min( n, ( c + 1 ) * ChunkSize );
+        for ( int i = c * ChunkSize; i < end; ++i )
+        {
+            const Scalar u1 = dis( gen );
+            const Scalar u2 = dis( gen );
+            const Scalar s  = std::sqrt( dis( gen ) );
+            const Scalar r  = dis( gen );
+            samples[i]      = {table.sample( u1, u2 ), Vector3( 1 - s, s * ( 1 - r ), s * r )};
+        }
+    }
+    return samples;
+}
+
+template <typename T>
+void interpolateAttrib( const Utils::AttribBase* attr,
+                        const TriangleMesh& mesh,
+                        const std::vector<SurfaceSample>& samples,
+                        PointCloud& cloud ) {
+    const auto& data = attr->cast<T>().data();
+    const auto& I    = mesh.m_indices;
+    const int n      = int( samples.size() );
+    typename Utils::Attrib<T>::Container result( samples.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        const auto& t = I[samples[i].triangle];
+        const auto& w = samples[i].weights;
+        result[i]     = w( 0 ) * data[t( 0 )] + w( 1 ) * data[t( 1 )] + w( 2 ) * data[t( 2 )];
+    }
+    cloud.addAttrib<T>( attr->getName(), std::move( result ) );
+}
+
+Vector3Array samplePositions( const TriangleMesh& mesh,
+                              const std::vector<SurfaceSample>& samples ) {
+    const auto& v = mesh.vertices();
+    const auto& I = mesh.m_indices;
+    const int n   = int( samples.size() );
+    Vector3Array points( samples.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        const auto& t = I[samples[i].triangle];
+        const auto& w = samples[i].weights;
+        points[i]     = w( 0 ) * v[t( 0 )] + w( 1 ) * v[t( 1 )] + w( 2 ) * v[t( 2 )];
+    }
+    return points;
+}
+
+PointCloud makePointCloud( const TriangleMesh& mesh, const std::vector<SurfaceSample>& samples ) {
+    const auto& v         = mesh.vertices();
+    const auto& vn        = mesh.normals();
+    const auto& I         = mesh.m_indices;
+    const bool hasNormals = vn.size() == v.size();
+    const int n           = int( samples.size() );
+    Vector3Array normals( samples.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        const auto& t = I[samples[i].triangle];
+        const auto& w = samples[i].weights;
+        const Vector3 normal =
+            hasNormals ? Vector3( w( 0 ) * vn[t( 0 )] + w( 1 ) * vn[t( 1 )] + w( 2 ) * vn[t( 2 )] )
+                       : Vector3( ( v[t( 1 )] - v[t( 0 )] ).cross( v[t( 2 )] - v[t( 0 )] ) );
+        normals[i] = normal.normalized();
+    }
+    PointCloud cloud;
+    cloud.setVertices( samplePositions( mesh, samples ) );
+    cloud.setNormals( std::move( normals ) );
+
+    // the other attributes are interpolated the same way
+    mesh.vertexAttribs().for_each_attrib( [&]( const auto& attr ) {
+        if ( cloud.vertexAttribs().contains( attr->getName() ) || attr->getSize() != v.size() )
+        { return; }
+        if ( attr->isFloat() ) { interpolateAttrib<float>( attr, mesh, samples, cloud ); }
+        if ( attr->isVec2() ) { interpolateAttrib<Vector2>( attr, mesh, samples, cloud ); }
+        if ( attr->isVec3() ) { interpolateAttrib<Vector3>( attr, mesh, samples, cloud ); }
+        if ( attr->isVec4() ) { interpolateAttrib<Vector4>( attr, mesh, samples, cloud ); }
+    } );
+    return cloud;
+}
+
+} // namespace
+
+AliasTable::AliasTable( const std::vector<Scalar>& weights ) :
+    m_probabilities( weights.size() ), m_aliases( weights.size() ) {
+    const double sum = std::accumulate( weights.begin(), weights.end(), 0. );
+    CORE_ASSERT( sum > 0, "The weights must have a positive sum" );
+    const size_t n = weights.size();
+
+    // Vose's method: the columns under the mean weight are filled by the ones
+    // above it
+    std::vector<double> scaled( n );
+    std::vector<uint> small;
+    std::vector<uint> large;
+    for ( size_t i = 0; i < n; ++i )
+    {
+        scaled[i] = double( weights[i] ) * double( n ) / sum;
+        ( scaled[i] < 1 ? small : large ).push_back( uint( i ) );
+    }
+    while ( !small.empty() && !large.empty() )
+    {
+        const uint s = small.back();
+        const uint l = large.back();
+        small.pop_back();
+        m_probabilities[s] = Scalar( scaled[s] );
+        m_aliases[s]       = l;
+        scaled[l] -= 1 - scaled[s];
+        if ( scaled[l] < 1 )
+        {
+            large.pop_back();
+            small.push_back( l );
+        }
+    }
+    // the remaining columns are full, up to rounding errors
+    for ( const uint i : large )
+    {
+        m_probabilities[i] = 1;
+        m_aliases[i]       = i;
+    }
+    for ( const uint i : small )
+    {
+        m_probabilities[i] = 1;
+        m_aliases[i]       = i;
+    }
+}
+
+PointCloud sampleSurface( const TriangleMesh& mesh, const size_t count, const uint seed ) {
+    if ( mesh.m_indices.empty() || count == 0 ) { return PointCloud(); }
+    const AliasTable table( triangleAreas( mesh ) );
+    return makePointCloud( mesh, uniformSamples( table, count, seed ) );
+}
+
+PointCloud sampleSurfacePoissonDisk( const TriangleMesh& mesh,
+                                     const Scalar radius,
+                                     const uint seed,
+                                     const Scalar candidatesPerArea ) {
+    CORE_ASSERT( radius > 0, "The radius must be positive" );
+    if ( mesh.m_indices.empty() ) { return PointCloud(); }
+    const std::vector<Scalar> areas = triangleAreas( mesh );
+    const double area               = std::accumulate( areas.begin(), areas.end(), 0. );
+    const size_t nbCandidates =
+        size_t( std::ceil( area * double( candidatesPerArea ) / ( double( radius ) * radius ) ) );
+    const std::vector<SurfaceSample> candidates =
+        uniformSamples( AliasTable( areas ), nbCandidates, seed );
+    const Vector3Array positions = samplePositions( mesh, candidates );
+
+    // cells of side radius, hashed by their packed coordinates, a cell keeps
+    // its candidates in drawing order, which is random
+    Aabb aabb;
+    for ( const auto& p : positions )
+    {
+        aabb.extend( p );
+    }
+    CORE_ASSERT( ( aabb.sizes() / radius ).maxCoeff() < Scalar( 1 << 20 ), "Too many cells" );
+    const auto cellOf = [&]( const Vector3& p ) {
+        return ( ( p - aabb.min() ) / radius ).array().floor().cast<int>().matrix().eval();
+    };
+    const auto key = []( const Vector3i& c ) {
+        return std::uint64_t( c( 0 ) + 1 ) | std::uint64_t( c( 1 ) + 1 ) << 21 |
+               std::uint64_t( c( 2 ) + 1 ) << 42;
+    };
+    std::vector<std::pair<std::uint64_t, uint>> sorted( positions.size() );
+    for ( size_t i = 0; i < positions.size(); ++i )
+    {
+        sorted[i] = {key( cellOf( positions[i] ) ), uint( i )};
+    }
+    std::stable_sort( sorted.begin(), sorted.end(), []( const auto& a, const auto& b ) {
+        return a.first < b.first;
+    } );
+
+    std::vector<uint> cellStart;
+    std::vector<Vector3i> cellCoords;
+    std::unordered_map<std::uint64_t, uint> cells;
+    cells.reserve( positions.size() );
+    for ( size_t i = 0; i < sorted.size(); ++i )
+    {
+        if ( i > 0 && sorted[i].first == sorted[i - 1].first ) { continue; }
+        cells.emplace( sorted[i].first, uint( cellStart.size() ) );
+        cellStart.push_back( uint( i ) );
+        cellCoords.push_back( cellOf( positions[sorted[i].second] ) );
+    }
+    cellStart.push_back( uint( sorted.size() ) );
+    const uint nbCells = uint( cellCoords.size() );
+
+    // cells of the same phase are at least 2 cells apart, so that their
+    // samples can not conflict, and they accept their candidates independently
+    std::array<std::vector<uint>, 8> phases;
+    for ( uint c = 0; c < nbCells; ++c )
+    {
+        const Vector3i& p = cellCoords[c];
+        phases[size_t( p( 0 ) % 2 + 2 * ( p( 1 ) % 2 ) + 4 * ( p( 2 ) % 2 ) )].push_back( c );
+    }
+
+    // points at least radius apart in a cube of side radius are at most 8
+    struct CellSamples {
+        std::array<uint, 8> samples;
+        uint count{0};
+    };
+    std::vector<CellSamples> accepted( nbCells );
+    const Scalar sqRadius = radius * radius;
+    for ( const auto& phase : phases )
+    {
+        const int nbPhaseCells = int( phase.size() );
+#pragma omp parallel for schedule( dynamic, 64 )
+        for ( int i = 0; i < nbPhaseCells; ++i )
+        {
+            const uint c = phase[i];
+            // samples accepted around the cell
+            std::vector<uint> near;
+            for ( int z = -1; z <= 1; ++z )
+            {
+                for ( int y = -1; y <= 1; ++y )
+                {
+                    for ( int x = -1; x <= 1; ++x )
+                    {
+                        const auto it = cells.find( key( cellCoords[c] + Vector3i( x, y, z ) ) );
+                        if ( it == cells.end() ) { continue; }
+                        const CellSamples& n = accepted[it->second];
+                        near.insert( near.end(), n.samples.begin(), n.samples.begin() + n.count );
+                    }
+                }
+            }
+            CellSamples& cell = accepted[c];
+            for ( uint j = cellStart[c]; j < cellStart[c + 1]; ++j )
+            {
+                const uint candidate = sorted[j].second;
+                const Vector3& p     = positions[candidate];
+                const auto conflict  = [&]( const uint s ) {
+                    return ( positions[s] - p ).squaredNorm() < sqRadius;
+                };
+                const auto end = cell.samples.begin() + cell.count;
+                if ( std::any_of( near.begin(), near.end(), conflict ) ||
+                     std::any_of( cell.samples.begin(), end, conflict ) )
+                { continue; }
+                CORE_ASSERT( cell.count < 8, "Too many samples in a cell" );
+                cell.samples[cell.count++] = candidate;
+            }
+        }
+    }
+
+    std::vector<SurfaceSample> samples;
+    for ( const auto& cell : accepted )
+    {
+        for ( uint j = 0; j < cell.count; ++j )
+        {
+            samples.push_back( candidates[cell.samples[j]] );
+        }
+    }
+    return makePointCloud( mesh, samples );
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,84 @@
+#ifndef RADIUMENGINE_MESH_SAMPLING_HPP_
+#define RADIUMENGINE_MESH_SAMPLING_HPP_
+
+#include <Core/Geometry/TriangleMesh.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/**
+ * Generation of point clouds on the surface of triangle meshes.
+ *
+ * The points are returned as a PointCloud, whose vertex attributes are the
+ * ones of the mesh (e.g. colors, texture coordinates), interpolated at the
+ * points from the vertices of their triangle. The normals are the
+ * interpolated normals of the mesh, or the normals of the triangles if the
+ * mesh has no normals. The sampling is deterministic for a given seed,
+ * whatever the number of threads.
+ *
+ * The alias method was taken from:
+ * "A Linear Algorithm For Generating Random Numbers With a Given Distribution"
+ * [ Michael D. Vose ]
+ * IEEE Transactions on Software Engineering 1991
+ *
+ * The parallel Poisson disk sampling was taken from:
+ * "Parallel Poisson Disk Sampling"
+ * [ Li-Yi Wei ]
+ * SIGGRAPH 2008
+ **/
+
+/// Table of the alias method, to draw indices in constant time with
+/// probabilities proportional to given weights.
+class RA_CORE_API AliasTable
+{
+  public:
+    AliasTable() = default;
+
+    /// Build the table of \p weights, which must be non negative with a
+    /// positive sum.
+    explicit AliasTable( const std::vector<Scalar>& weights );
+
+    /// Number of weights.
+    inline size_t size() const { return m_probabilities.size(); }
+
+    /// Index drawn from two independent uniform numbers in [0, 1).
+    inline uint sample( Scalar u1, Scalar u2 ) const {
+        const uint i = std::min( uint( u1 * Scalar( size() ) ), uint( size() - 1 ) );
+        return u2 < m_probabilities[i] ? i : m_aliases[i];
+    }
+
+  private:
+    std::vector<Scalar> m_probabilities;
+    std::vector<uint> m_aliases;
+};
+
+/// Sample \p count points uniformly on the surface of \p mesh: the triangles
+/// are drawn with probabilities proportional to their area with an
+/// AliasTable, then the points are drawn uniformly in them, in parallel.
+RA_CORE_API PointCloud sampleSurface( const TriangleMesh& mesh, size_t count, uint seed = 0 );
+
+/// Sample points on the surface of \p mesh, at a distance of at least
+/// \p radius from each other (the euclidean distance, not the geodesic one).
+/// Candidates are sampled uniformly, then hashed in a sparse grid of cubic
+/// cells of side \p radius. The cells are split in 8 phases, such that the
+/// cells of a phase are too far apart to conflict, and the cells of a phase
+/// accept their candidates in parallel, each candidate being kept if it is far
+/// enough from the samples already accepted in its neighbourhood.
+/// \p candidatesPerArea is the number of candidates per radius^2 of surface,
+/// more candidates giving a denser sampling, closer to a maximal one.
+RA_CORE_API PointCloud sampleSurfacePoissonDisk( const TriangleMesh& mesh,
+                                                 Scalar radius,
+                                                 uint seed                = 0,
+                                                 Scalar candidatesPerArea = 20 );
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_MESH_SAMPLING_HPP_
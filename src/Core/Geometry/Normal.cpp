@@ -9,37 +9,68 @@ namespace Ra {
 namespace Core {
 namespace Geometry {
 
-//////////////
-/// GLOBAL ///
-//////////////
+namespace {
 
-void uniformNormal( const VectorArray<Vector3>& p,
-                    const AlignedStdVector<Vector3ui>& T,
-                    VectorArray<Vector3>& normal ) {
-    const size_t N = p.size();
-    normal.clear();
-    normal.resize( N, Vector3::Zero() );
+// Normal of triangle t, discarding degenerate triangles.
+inline Vector3 finiteTriangleNormal( const VectorArray<Vector3>& p, const Vector3ui& t ) {
+    const Vector3 triN = triangleNormal( p[t( 0 )], p[t( 1 )], p[t( 2 )] );
+    return triN.allFinite() ? triN : Vector3::Zero();
+}
+
+// Normal of triangle t, weighted by its area.
+inline Vector3 areaTriangleNormal( const VectorArray<Vector3>& p, const Vector3ui& t ) {
+    const Scalar area = triangleArea( p[t( 0 )], p[t( 1 )], p[t( 2 )] );
+    return area * triangleNormal( p[t( 0 )], p[t( 1 )], p[t( 2 )] );
+}
 
-    for ( const auto& t : T )
+// Angle of triangle t at its k-th vertex.
+inline Scalar cornerAngle( const VectorArray<Vector3>& p, const Vector3ui& t, const uint k ) {
+    const uint i = t( k );
+    const uint a = t( k == 0 ? 1 : 0 );
+    const uint b = t( k == 2 ? 1 : 2 );
+    return Math::angle( ( p[a] - p[i] ), ( p[b] - p[i] ) );
+}
+
+// Sum the contributions of the triangles incident to v, in triangle order so
+// that the result matches a scatter over T.
+template <typename CornerNormal>
+inline Vector3 gatherNormal( const uint v,
+                             const VertexTriangleIncidence& incidence,
+                             const CornerNormal& cornerNormal ) {
+    Vector3 n           = Vector3::Zero();
+    const auto& corners = incidence.corners();
+    const uint end      = incidence.offset( v + 1 );
+    for ( uint c = incidence.offset( v ); c < end; ++c )
     {
-        const uint i       = t( 0 );
-        const uint j       = t( 1 );
-        const uint k       = t( 2 );
-        const Vector3 triN = triangleNormal( p[i], p[j], p[k] );
-        if ( !triN.allFinite() ) { continue; }
-        normal[i] += triN;
-        normal[j] += triN;
-        normal[k] += triN;
+        n += cornerNormal( corners[c] );
     }
+    return n;
+}
 
+// Compute one value per triangle in parallel.
+template <typename TriangleFunc>
+inline void computePerTriangle( const AlignedStdVector<Vector3ui>& T,
+                                const TriangleFunc& f,
+                                VectorArray<Vector3>& out ) {
+    const int t_size = int( T.size() );
+    out.resize( T.size() );
 #pragma omp parallel for
-    for ( int i = 0; i < int( N ); ++i )
+    for ( int t = 0; t < t_size; ++t )
     {
-        if ( !normal[i].isApprox( Vector3::Zero() ) ) { normal[i].normalize(); }
+        out[t] = f( T[t] );
     }
+}
 
-    // could also do:
-    // normal.getMap().colwise().normalize();
+} // namespace
+
+//////////////
+/// GLOBAL ///
+//////////////
+
+void uniformNormal( const VectorArray<Vector3>& p,
+                    const AlignedStdVector<Vector3ui>& T,
+                    VectorArray<Vector3>& normal ) {
+    uniformNormal( p, T, VertexTriangleIncidence( p.size(), T ), normal );
 }
 
 Vector3 localUniformNormal( const uint ii,
@@ -61,48 +92,138 @@ Vector3 localUniformNormal( const uint ii,
 void angleWeightedNormal( const VectorArray<Vector3>& p,
                           const AlignedStdVector<Vector3ui>& T,
                           VectorArray<Vector3>& normal ) {
-    const size_t N = p.size();
-    normal.clear();
-    normal.resize( N, Vector3::Zero() );
-    for ( const auto& t : T )
+    angleWeightedNormal( p, T, VertexTriangleIncidence( p.size(), T ), normal );
+}
+
+void areaWeightedNormal( const VectorArray<Vector3>& p,
+                         const AlignedStdVector<Vector3ui>& T,
+                         VectorArray<Vector3>& normal ) {
+    areaWeightedNormal( p, T, VertexTriangleIncidence( p.size(), T ), normal );
+}
+
+/////////////////
+/// INCIDENCE ///
+/////////////////
+
+void uniformNormal( const VectorArray<Vector3>& p,
+                    const AlignedStdVector<Vector3ui>& T,
+                    const VertexTriangleIncidence& incidence,
+                    VectorArray<Vector3>& normal ) {
+    CORE_ASSERT( incidence.size() == p.size(), "Incidence does not match the mesh" );
+    VectorArray<Vector3> triN;
+    auto triangleFunc = [&p]( const Vector3ui& t ) { return finiteTriangleNormal( p, t ); };
+    computePerTriangle( T, triangleFunc, triN );
+
+    auto cornerFunc = [&triN]( uint c ) { return triN[VertexTriangleIncidence::triangle( c )]; };
+    const int N     = int( p.size() );
+    normal.resize( p.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < N; ++i )
     {
-        uint i               = t( 0 );
-        uint j               = t( 1 );
-        uint k               = t( 2 );
-        const Vector3 triN   = triangleNormal( p[i], p[j], p[k] );
-        const Scalar theta_i = Math::angle( ( p[j] - p[i] ), ( p[k] - p[i] ) );
-        const Scalar theta_j = Math::angle( ( p[i] - p[j] ), ( p[k] - p[j] ) );
-        const Scalar theta_k = Math::angle( ( p[i] - p[k] ), ( p[j] - p[k] ) );
-        normal[i] += theta_i * triN;
-        normal[j] += theta_j * triN;
-        normal[k] += theta_k * triN;
+        Vector3 n = gatherNormal( i, incidence, cornerFunc );
+        if ( !n.isApprox( Vector3::Zero() ) ) { n.normalize(); }
+        normal[i] = n;
     }
-    for ( auto& n : normal )
+}
+
+void angleWeightedNormal( const VectorArray<Vector3>& p,
+                          const AlignedStdVector<Vector3ui>& T,
+                          const VertexTriangleIncidence& incidence,
+                          VectorArray<Vector3>& normal ) {
+    CORE_ASSERT( incidence.size() == p.size(), "Incidence does not match the mesh" );
+    VectorArray<Vector3> triN;
+    auto triangleFunc = [&p]( const Vector3ui& t ) {
+        return triangleNormal( p[t( 0 )], p[t( 1 )], p[t( 2 )] );
+    };
+    computePerTriangle( T, triangleFunc, triN );
+
+    auto cornerFunc = [&p, &T, &triN]( uint c ) {
+        const uint t = VertexTriangleIncidence::triangle( c );
+        return cornerAngle( p, T[t], VertexTriangleIncidence::local( c ) ) * triN[t];
+    };
+    const int N = int( p.size() );
+    normal.resize( p.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < N; ++i )
     {
-        n.normalize();
+        normal[i] = gatherNormal( i, incidence, cornerFunc ).normalized();
     }
 }
 
 void areaWeightedNormal( const VectorArray<Vector3>& p,
                          const AlignedStdVector<Vector3ui>& T,
+                         const VertexTriangleIncidence& incidence,
                          VectorArray<Vector3>& normal ) {
-    const size_t N = p.size();
-    normal.clear();
-    normal.resize( N, Vector3::Zero() );
-    for ( const auto& t : T )
+    CORE_ASSERT( incidence.size() == p.size(), "Incidence does not match the mesh" );
+    VectorArray<Vector3> triN;
+    auto triangleFunc = [&p]( const Vector3ui& t ) { return areaTriangleNormal( p, t ); };
+    computePerTriangle( T, triangleFunc, triN );
+
+    auto cornerFunc = [&triN]( uint c ) { return triN[VertexTriangleIncidence::triangle( c )]; };
+    const int N     = int( p.size() );
+    normal.resize( p.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < N; ++i )
+    {
+        normal[i] = gatherNormal( i, incidence, cornerFunc ).normalized();
+    }
+}
+
+void uniformNormal( const VectorArray<Vector3>& p,
+                    const AlignedStdVector<Vector3ui>& T,
+                    const VertexTriangleIncidence& incidence,
+                    const std::vector<uint>& vertices,
+                    VectorArray<Vector3>& normal ) {
+    CORE_ASSERT( normal.size() == p.size(), "Normals must be allocated" );
+    auto cornerFunc = [&p, &T]( uint c ) {
+        return finiteTriangleNormal( p, T[VertexTriangleIncidence::triangle( c )] );
+    };
+    const int N = int( vertices.size() );
+#pragma omp parallel for
+    for ( int n = 0; n < N; ++n )
+    {
+        const uint i = vertices[n];
+        Vector3 sum  = gatherNormal( i, incidence, cornerFunc );
+        if ( !sum.isApprox( Vector3::Zero() ) ) { sum.normalize(); }
+        normal[i] = sum;
+    }
+}
+
+void angleWeightedNormal( const VectorArray<Vector3>& p,
+                          const AlignedStdVector<Vector3ui>& T,
+                          const VertexTriangleIncidence& incidence,
+                          const std::vector<uint>& vertices,
+                          VectorArray<Vector3>& normal ) {
+    CORE_ASSERT( normal.size() == p.size(), "Normals must be allocated" );
+    auto cornerFunc = [&p, &T]( uint c ) -> Vector3 {
+        const Vector3ui& t = T[VertexTriangleIncidence::triangle( c )];
+        return cornerAngle( p, t, VertexTriangleIncidence::local( c ) ) *
+               triangleNormal( p[t( 0 )], p[t( 1 )], p[t( 2 )] );
+    };
+    const int N = int( vertices.size() );
+#pragma omp parallel for
+    for ( int n = 0; n < N; ++n )
     {
-        uint i             = t( 0 );
-        uint j             = t( 1 );
-        uint k             = t( 2 );
-        const Scalar area  = triangleArea( p[i], p[j], p[k] );
-        const Vector3 triN = area * triangleNormal( p[i], p[j], p[k] );
-        normal[i] += triN;
-        normal[j] += triN;
-        normal[k] += triN;
+        const uint i = vertices[n];
+        normal[i]    = gatherNormal( i, incidence, cornerFunc ).normalized();
     }
-    for ( auto& n : normal )
+}
+
+void areaWeightedNormal( const VectorArray<Vector3>& p,
+                         const AlignedStdVector<Vector3ui>& T,
+                         const VertexTriangleIncidence& incidence,
+                         const std::vector<uint>& vertices,
+                         VectorArray<Vector3>& normal ) {
+    CORE_ASSERT( normal.size() == p.size(), "Normals must be allocated" );
+    auto cornerFunc = [&p, &T]( uint c ) {
+        return areaTriangleNormal( p, T[VertexTriangleIncidence::triangle( c )] );
+    };
+    const int N = int( vertices.size() );
+#pragma omp parallel for
+    for ( int n = 0; n < N; ++n )
     {
-        n.normalize();
+        const uint i = vertices[n];
+        normal[i]    = gatherNormal( i, incidence, cornerFunc ).normalized();
     }
 }
 
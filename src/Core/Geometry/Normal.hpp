@@ -2,6 +2,7 @@
 #define NORMAL_DEFINITION
 
 #include <Core/Containers/VectorArray.hpp>
+#include <Core/Geometry/Incidence.hpp>
 #include <Core/Types.hpp>
 
 namespace Ra {
@@ -60,6 +61,62 @@ void RA_CORE_API areaWeightedNormal( const VectorArray<Vector3>& p,
                                      const AlignedStdVector<Vector3ui>& T,
                                      VectorArray<Vector3>& normal );
 
+/////////////////
+/// INCIDENCE ///
+/////////////////
+
+/*
+ * The following functions compute the same normals as their global
+ * counterparts, using the precomputed vertex to triangle incidence of T.
+ * Each normal is gathered from its incident triangles, so that all the
+ * vertices are processed in parallel without write conflicts, and the
+ * incidence can be reused as long as the topology does not change.
+ *
+ * \note The incidence must be valid for p and T (see
+ * VertexTriangleIncidence::update()).
+ */
+void RA_CORE_API uniformNormal( const VectorArray<Vector3>& p,
+                                const AlignedStdVector<Vector3ui>& T,
+                                const VertexTriangleIncidence& incidence,
+                                VectorArray<Vector3>& normal );
+
+void RA_CORE_API angleWeightedNormal( const VectorArray<Vector3>& p,
+                                      const AlignedStdVector<Vector3ui>& T,
+                                      const VertexTriangleIncidence& incidence,
+                                      VectorArray<Vector3>& normal );
+
+void RA_CORE_API areaWeightedNormal( const VectorArray<Vector3>& p,
+                                     const AlignedStdVector<Vector3ui>& T,
+                                     const VertexTriangleIncidence& incidence,
+                                     VectorArray<Vector3>& normal );
+
+/*
+ * Recompute in place only the normals of the given vertices, leaving the
+ * other entries of normal untouched. Only the triangles incident to these
+ * vertices are visited. Moving a vertex changes the normals of its one-ring
+ * neighbours too, so after a local deformation, vertices must contain the
+ * moved vertices and their one-ring.
+ *
+ * \note normal must already have one entry per point of p.
+ */
+void RA_CORE_API uniformNormal( const VectorArray<Vector3>& p,
+                                const AlignedStdVector<Vector3ui>& T,
+                                const VertexTriangleIncidence& incidence,
+                                const std::vector<uint>& vertices,
+                                VectorArray<Vector3>& normal );
+
+void RA_CORE_API angleWeightedNormal( const VectorArray<Vector3>& p,
+                                      const AlignedStdVector<Vector3ui>& T,
+                                      const VertexTriangleIncidence& incidence,
+                                      const std::vector<uint>& vertices,
+                                      VectorArray<Vector3>& normal );
+
+void RA_CORE_API areaWeightedNormal( const VectorArray<Vector3>& p,
+                                     const AlignedStdVector<Vector3ui>& T,
+                                     const VertexTriangleIncidence& incidence,
+                                     const std::vector<uint>& vertices,
+                                     VectorArray<Vector3>& normal );
+
 ////////////////
 /// ONE RING ///
 ////////////////
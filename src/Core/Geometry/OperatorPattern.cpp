@@ -0,0 +1,212 @@
+#include <Core/Geometry/OperatorPattern.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+OperatorPattern::OperatorPattern( const uint point_size, const AlignedStdVector<Vector3ui>& T ) {
+    compute( point_size, T );
+}
+
+void OperatorPattern::compute( const uint point_size, const AlignedStdVector<Vector3ui>& T ) {
+    m_incidence.compute( point_size, T );
+    const auto& corners = m_incidence.corners();
+    const int n         = int( point_size );
+
+    // ( row, facing corner ) of the edges around each vertex, sorted, in the
+    // range of the vertex corners (each corner gives at most two edges)
+    std::vector<std::pair<int, uint>> edges( 2 * corners.size() );
+    std::vector<int> entryCount( point_size + 1, 0 );
+    std::vector<uint> cornerCount( point_size + 1, 0 );
+#pragma omp parallel for
+    for ( int v = 0; v < n; ++v )
+    {
+        const auto first = edges.begin() + 2 * m_incidence.offset( v );
+        auto last        = first;
+        const uint end   = m_incidence.offset( v + 1 );
+        for ( uint c = m_incidence.offset( v ); c < end; ++c )
+        {
+            const uint t    = VertexTriangleIncidence::triangle( corners[c] );
+            const uint k    = VertexTriangleIncidence::local( corners[c] );
+            const uint k1   = ( k + 1 ) % 3;
+            const uint k2   = ( k + 2 ) % 3;
+            const auto& tri = T[t];
+            // edge { v, t( k1 ) } faces k2, edge { v, t( k2 ) } faces k1
+            if ( tri( k1 ) != uint( v ) ) { *last++ = {int( tri( k1 ) ), 3 * t + k2}; }
+            if ( tri( k2 ) != uint( v ) ) { *last++ = {int( tri( k2 ) ), 3 * t + k1}; }
+        }
+        std::sort( first, last );
+        int count = 0;
+        for ( auto it = first; it != last; ++it )
+        {
+            if ( it == first || it->first != ( it - 1 )->first ) { ++count; }
+        }
+        entryCount[v + 1]  = count;
+        cornerCount[v + 1] = uint( last - first );
+    }
+    for ( int v = 0; v < n; ++v )
+    {
+        entryCount[v + 1] += entryCount[v];
+        cornerCount[v + 1] += cornerCount[v];
+    }
+
+    m_outer = std::move( entryCount );
+    m_inner.resize( m_outer.back() );
+    m_diagonal.resize( point_size );
+    m_entryOffsets.resize( m_inner.size() + 1 );
+    m_entryCorners.resize( cornerCount.back() );
+#pragma omp parallel for
+    for ( int v = 0; v < n; ++v )
+    {
+        const auto first = edges.begin() + 2 * m_incidence.offset( v );
+        const auto last  = first + ( cornerCount[v + 1] - cornerCount[v] );
+        int e            = m_outer[v] - 1;
+        uint c           = cornerCount[v];
+        m_diagonal[v]    = m_outer[v + 1];
+        for ( auto it = first; it != last; ++it )
+        {
+            if ( it == first || it->first != ( it - 1 )->first )
+            {
+                ++e;
+                m_inner[e]        = it->first;
+                m_entryOffsets[e] = c;
+                if ( it->first > v && m_diagonal[v] == m_outer[v + 1] ) { m_diagonal[v] = e; }
+            }
+            m_entryCorners[c++] = it->second;
+        }
+    }
+    m_entryOffsets.back() = uint( m_entryCorners.size() );
+}
+
+bool OperatorPattern::update( const uint point_size, const AlignedStdVector<Vector3ui>& T ) {
+    if ( isValidFor( point_size, T ) ) { return false; }
+    compute( point_size, T );
+    return true;
+}
+
+bool OperatorPattern::isValidFor( const uint point_size,
+                                  const AlignedStdVector<Vector3ui>& T ) const {
+    return m_incidence.isValidFor( point_size, T );
+}
+
+namespace {
+
+// Give M the size n x n and nnz compressed entries, keeping its memory if
+// it already has them.
+inline void reshape( const int n, const int nnz, Sparse& M ) {
+    if ( M.rows() != n || M.cols() != n || !M.isCompressed() || M.nonZeros() != nnz )
+    {
+        M.resize( n, n );
+        M.resizeNonZeros( nnz );
+    }
+}
+
+} // namespace
+
+void OperatorPattern::setAdjacencyStructure( Sparse& A ) const {
+    reshape( int( size() ), int( nonZeros() ), A );
+    std::copy( m_outer.begin(), m_outer.end(), A.outerIndexPtr() );
+    std::copy( m_inner.begin(), m_inner.end(), A.innerIndexPtr() );
+}
+
+void OperatorPattern::setLaplacianStructure( Sparse& L ) const {
+    const int n = int( size() );
+    reshape( n, int( nonZeros() ) + n, L );
+    auto outer = L.outerIndexPtr();
+    auto inner = L.innerIndexPtr();
+#pragma omp parallel for
+    for ( int v = 0; v < n; ++v )
+    {
+        int pos  = m_outer[v] + v;
+        outer[v] = pos;
+        for ( int e = m_outer[v]; e < m_outer[v + 1]; ++e )
+        {
+            if ( e == m_diagonal[v] ) { inner[pos++] = v; }
+            inner[pos++] = m_inner[e];
+        }
+        if ( m_diagonal[v] == m_outer[v + 1] ) { inner[pos] = v; }
+    }
+    outer[n] = int( nonZeros() ) + n;
+}
+
+void OperatorPattern::setDiagonalStructure( Sparse& D ) const {
+    const int n = int( size() );
+    reshape( n, n, D );
+    auto outer = D.outerIndexPtr();
+    auto inner = D.innerIndexPtr();
+#pragma omp parallel for
+    for ( int v = 0; v < n; ++v )
+    {
+        outer[v] = v;
+        inner[v] = v;
+    }
+    outer[n] = n;
+}
+
+void OperatorPattern::gatherAdjacency( const std::vector<Scalar>& w, Sparse& A ) const {
+    CORE_ASSERT( A.nonZeros() == Eigen::Index( nonZeros() ),
+                 "A does not have the adjacency structure" );
+    const int nnz = int( nonZeros() );
+    auto values   = A.valuePtr();
+#pragma omp parallel for
+    for ( int e = 0; e < nnz; ++e )
+    {
+        Scalar value = 0;
+        for ( uint c = m_entryOffsets[e]; c < m_entryOffsets[e + 1]; ++c )
+        {
+            value += w[m_entryCorners[c]];
+        }
+        values[e] = value;
+    }
+}
+
+void OperatorPattern::gatherLaplacian( const std::vector<Scalar>& w, Sparse& L ) const {
+    const int n = int( size() );
+    CORE_ASSERT( L.nonZeros() == Eigen::Index( nonZeros() ) + n,
+                 "L does not have the Laplacian structure" );
+    auto values = L.valuePtr();
+#pragma omp parallel for
+    for ( int v = 0; v < n; ++v )
+    {
+        int pos         = m_outer[v] + v;
+        int diagonalPos = pos + m_diagonal[v] - m_outer[v];
+        Scalar diagonal = 0;
+        for ( int e = m_outer[v]; e < m_outer[v + 1]; ++e )
+        {
+            if ( e == m_diagonal[v] ) { ++pos; }
+            Scalar value = 0;
+            for ( uint c = m_entryOffsets[e]; c < m_entryOffsets[e + 1]; ++c )
+            {
+                value -= w[m_entryCorners[c]];
+            }
+            values[pos++] = value;
+            diagonal -= value;
+        }
+        values[diagonalPos] = diagonal;
+    }
+}
+
+void OperatorPattern::gatherDiagonal( const std::vector<Scalar>& w, Sparse& D ) const {
+    const int n = int( size() );
+    CORE_ASSERT( D.nonZeros() == n, "D does not have the diagonal structure" );
+    const auto& corners = m_incidence.corners();
+    auto values         = D.valuePtr();
+#pragma omp parallel for
+    for ( int v = 0; v < n; ++v )
+    {
+        Scalar value   = 0;
+        const uint end = m_incidence.offset( v + 1 );
+        for ( uint c = m_incidence.offset( v ); c < end; ++c )
+        {
+            value += w[corners[c]];
+        }
+        values[v] = value;
+    }
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
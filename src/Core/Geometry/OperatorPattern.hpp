@@ -0,0 +1,114 @@
+#ifndef OPERATOR_PATTERN_DEFINITION
+#define OPERATOR_PATTERN_DEFINITION
+
+#include <Core/Containers/AlignedStdVector.hpp>
+#include <Core/Geometry/Incidence.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/// Sparsity pattern of the vertex to vertex operators of a triangle mesh
+/// (adjacency, Laplacian and area matrices), built once per topology.
+///
+/// The pattern stores the compressed columns of the edges of the mesh, and
+/// for each edge entry the triangle corners facing it. An operator is then
+/// assembled by computing one value per triangle corner, in parallel over the
+/// triangles, and gathering them into each entry, in parallel over the
+/// columns: there is no triplet list, no sort, and no write conflict.
+/// When the positions change but not the topology, the values are refilled in
+/// place in the matrix, without any allocation.
+///
+/// Corner ids are the ones of VertexTriangleIncidence: c = 3 * t + k is the
+/// k-th vertex of triangle t. The edge facing c goes from t( k + 1 ) to
+/// t( k + 2 ) (modulo 3).
+///
+/// The pattern is symmetric and has no diagonal entry: degenerate edges (i.e.
+/// between a vertex and itself) are ignored.
+class RA_CORE_API OperatorPattern
+{
+  public:
+    /// Create an empty pattern.
+    OperatorPattern() = default;
+
+    /// Create the pattern of \p T, for a mesh with \p point_size vertices.
+    OperatorPattern( const uint point_size, const AlignedStdVector<Vector3ui>& T );
+
+    /// Rebuild the pattern of \p T, for a mesh with \p point_size vertices.
+    void compute( const uint point_size, const AlignedStdVector<Vector3ui>& T );
+
+    /// Rebuild the pattern only if \p T differs from the topology it was
+    /// computed from. Return true if the pattern has been rebuilt.
+    bool update( const uint point_size, const AlignedStdVector<Vector3ui>& T );
+
+    /// Return true if *this has been computed from the same topology as \p T.
+    bool isValidFor( const uint point_size, const AlignedStdVector<Vector3ui>& T ) const;
+
+    /// Number of vertices.
+    inline uint size() const { return m_incidence.size(); }
+
+    /// Number of off-diagonal entries, i.e. twice the number of edges.
+    inline uint nonZeros() const { return uint( m_inner.size() ); }
+
+    /// Vertex to triangle incidence of the mesh.
+    inline const VertexTriangleIncidence& incidence() const { return m_incidence; }
+
+    /// Start of each column in innerIndices(), of size size() + 1.
+    inline const std::vector<int>& outerIndices() const { return m_outer; }
+
+    /// Row of each entry, sorted in each column.
+    inline const std::vector<int>& innerIndices() const { return m_inner; }
+
+    /// Start of the corners facing each entry in entryCorners(), of size
+    /// nonZeros() + 1.
+    inline const std::vector<uint>& entryOffsets() const { return m_entryOffsets; }
+
+    /// Corners facing each entry, in increasing order.
+    inline const std::vector<uint>& entryCorners() const { return m_entryCorners; }
+
+    /// \name Assembly
+    /// The set*Structure() functions give the matrix the pattern of an
+    /// operator, reusing its memory when it already has the right number of
+    /// entries. The gather*() functions fill the values of a matrix which has
+    /// the corresponding structure, from one value per corner.
+    /// \{
+
+    /// Off-diagonal entries only.
+    void setAdjacencyStructure( Sparse& A ) const;
+
+    /// Off-diagonal and diagonal entries.
+    void setLaplacianStructure( Sparse& L ) const;
+
+    /// Diagonal entries only.
+    void setDiagonalStructure( Sparse& D ) const;
+
+    /// A( i, j ) = sum of w[c] over the corners c facing edge { i, j }.
+    void gatherAdjacency( const std::vector<Scalar>& w, Sparse& A ) const;
+
+    /// L( i, j ) = - sum of w[c] over the corners c facing edge { i, j },
+    /// L( i, i ) = - sum of L( i, j ) for j != i.
+    void gatherLaplacian( const std::vector<Scalar>& w, Sparse& L ) const;
+
+    /// D( i, i ) = sum of w[c] over the corners c of vertex i.
+    void gatherDiagonal( const std::vector<Scalar>& w, Sparse& D ) const;
+    /// \}
+
+  private:
+    VertexTriangleIncidence m_incidence;
+    std::vector<int> m_outer;
+    std::vector<int> m_inner;
+    // index of the first entry below the diagonal, in each column
+    std::vector<int> m_diagonal;
+    std::vector<uint> m_entryOffsets;
+    std::vector<uint> m_entryCorners;
+};
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // OPERATOR_PATTERN_DEFINITION
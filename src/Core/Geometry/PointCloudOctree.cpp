@@ -0,0 +1,538 @@
+#include <Core/Geometry/PointCloudOctree.hpp>
+
+#include <Core/Utils/Log.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+using namespace Utils; // log
+
+namespace {
+
+constexpr char Magic[8]             = {'R', 'A', 'P', 'C', 'O', 'C', 'T', '\0'};
+constexpr std::uint32_t Version     = 1;
+constexpr std::uint32_t NormalsFlag = 1;
+constexpr std::uint32_t ColorsFlag  = 2;
+
+inline std::string hierarchyFile( const std::string& directory ) {
+    return directory + "/hierarchy.bin";
+}
+
+inline std::string pointsFile( const std::string& directory ) {
+    return directory + "/points.bin";
+}
+
+template <typename T>
+inline void put( std::ostream& out, const T& value ) {
+    out.write( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+template <typename T>
+inline bool get( std::istream& in, T& value ) {
+    in.read( reinterpret_cast<char*>( &value ), sizeof( T ) );
+    return bool( in );
+}
+
+// Binary record of a point in the points file and in the temporary files.
+struct RecordLayout {
+    bool normals;
+    bool colors;
+
+    size_t size() const {
+        return 3 * sizeof( float ) + ( normals ? 3 * sizeof( float ) : 0 ) + ( colors ? 4 : 0 );
+    }
+};
+
+// Write the points [begin, end) of the arrays, using buffer as scratch memory.
+void writePoints( std::ostream& out,
+                  const RecordLayout& layout,
+                  const Vector3Array& points,
+                  const Vector3Array& normals,
+                  const Vector4Array& colors,
+                  const size_t begin,
+                  const size_t end,
+                  std::vector<char>& buffer ) {
+    buffer.resize( ( end - begin ) * layout.size() );
+    char* r = buffer.data();
+    for ( size_t i = begin; i < end; ++i )
+    {
+        const Eigen::Vector3f p = points[i].cast<float>();
+        std::memcpy( r, p.data(), sizeof( p ) );
+        r += sizeof( p );
+        if ( layout.normals )
+        {
+            const Eigen::Vector3f n = normals[i].cast<float>();
+            std::memcpy( r, n.data(), sizeof( n ) );
+            r += sizeof( n );
+        }
+        if ( layout.colors )
+        {
+            for ( int c = 0; c < 4; ++c )
+            {
+                const Scalar v = std::min( std::max( colors[i]( c ), 0_ra ), 1_ra );
+                *r++           = char( std::uint8_t( std::lround( v * 255 ) ) );
+            }
+        }
+    }
+    out.write( buffer.data(), std::streamsize( buffer.size() ) );
+}
+
+// Append count points read from in to the arrays, using buffer as scratch
+// memory.
+bool readPoints( std::istream& in,
+                 const RecordLayout& layout,
+                 const size_t count,
+                 Vector3Array& points,
+                 Vector3Array& normals,
+                 Vector4Array& colors,
+                 std::vector<char>& buffer ) {
+    buffer.resize( count * layout.size() );
+    in.read( buffer.data(), std::streamsize( buffer.size() ) );
+    if ( !in ) { return false; }
+    const char* r = buffer.data();
+    for ( size_t i = 0; i < count; ++i )
+    {
+        Eigen::Vector3f p;
+        std::memcpy( p.data(), r, sizeof( p ) );
+        r += sizeof( p );
+        points.push_back( p.cast<Scalar>() );
+        if ( layout.normals )
+        {
+            Eigen::Vector3f n;
+            std::memcpy( n.data(), r, sizeof( n ) );
+            r += sizeof( n );
+            normals.push_back( n.cast<Scalar>() );
+        }
+        if ( layout.colors )
+        {
+            Vector4 color;
+            for ( int c = 0; c < 4; ++c )
+            {
+                color( c ) = Scalar( std::uint8_t( *r++ ) ) / 255_ra;
+            }
+            colors.push_back( color );
+        }
+    }
+    return true;
+}
+
+template <typename Array>
+inline void append( Array& a, const Array& b, const size_t i ) {
+    if ( !b.empty() ) { a.push_back( b[i] ); }
+}
+
+// Node whose points are in a temporary file, or in the source for the root.
+struct PendingNode {
+    int node;
+    std::string file;
+    std::uint64_t count;
+};
+
+// Points given by a node to one of its children, buffered before being
+// written to the temporary file of the child.
+struct ChildPoints {
+    std::string file;
+    std::ofstream out;
+    std::uint64_t count{0};
+    Vector3Array points;
+    Vector3Array normals;
+    Vector4Array colors;
+};
+
+// Removes the temporary files of a node being processed, its input and the
+// files of its children, unless released once the children own them.
+struct TemporaryFilesGuard {
+    std::ifstream& in;
+    const std::string& input;
+    std::array<ChildPoints, 8>& children;
+    bool released{false};
+
+    ~TemporaryFilesGuard() {
+        if ( released ) { return; }
+        in.close();
+        if ( !input.empty() ) { std::remove( input.c_str() ); }
+        for ( auto& child : children )
+        {
+            child.out.close();
+            std::remove( child.file.c_str() );
+        }
+    }
+};
+
+struct OctreeBuilder {
+    OctreeBuilder( PointSource& s, const std::string& d, const PointCloudOctreeOptions& o ) :
+        source( s ), directory( d ), options( o ), layout{s.hasNormals(), s.hasColors()} {}
+
+    PointSource& source;
+    const std::string& directory;
+    const PointCloudOctreeOptions& options;
+    RecordLayout layout;
+    std::vector<PointCloudOctree::Node> nodes;
+    std::ofstream points;
+    std::uint64_t written{0};
+    std::mutex mutex;
+
+    // Split the points of pending between the samples of the node, which are
+    // written to the points file, and its children. Returns false on IO errors.
+    bool process( const PendingNode& pending, std::array<PendingNode, 8>& children );
+
+    // Write the hierarchy file.
+    bool writeHierarchy() const;
+};
+
+bool OctreeBuilder::process( const PendingNode& pending, std::array<PendingNode, 8>& children ) {
+    const PointCloudOctree::Node node = nodes[size_t( pending.node )];
+    const bool leaf   = pending.count <= options.maxLeafPoints || node.depth >= options.maxDepth;
+    const int g       = int( options.samplingGrid );
+    const Scalar side = node.aabb.sizes()( 0 );
+
+    std::vector<bool> occupied( leaf ? 0 : size_t( g ) * size_t( g ) * size_t( g ), false );
+    std::array<ChildPoints, 8> childPoints;
+    const size_t flushSize = std::max( size_t( options.chunkSize / 8 ), size_t( 1 ) );
+    std::vector<char> buffer;
+    const auto flush = [&]( ChildPoints& child ) {
+        if ( child.points.empty() ) { return true; }
+        if ( !child.out.is_open() )
+        {
+            child.out.open( child.file, std::ios::binary | std::ios::trunc );
+            if ( !child.out ) { return false; }
+        }
+        writePoints( child.out,
+                     layout,
+                     child.points,
+                     child.normals,
+                     child.colors,
+                     0,
+                     child.points.size(),
+                     buffer );
+        child.count += child.points.size();
+        child.points.clear();
+        child.normals.clear();
+        child.colors.clear();
+        return bool( child.out );
+    };
+    for ( int o = 0; o < 8; ++o )
+    {
+        childPoints[o].file = directory + "/node" + std::to_string( pending.node ) + "_" +
+                              std::to_string( o ) + ".tmp";
+    }
+    std::ifstream in;
+    TemporaryFilesGuard guard{in, pending.file, childPoints};
+    if ( !pending.file.empty() )
+    {
+        in.open( pending.file, std::ios::binary );
+        if ( !in ) { return false; }
+    }
+    else
+    { source.reset(); }
+
+    Vector3Array keptPoints;
+    Vector3Array keptNormals;
+    Vector4Array keptColors;
+    Vector3Array chunkPoints;
+    Vector3Array chunkNormals;
+    Vector4Array chunkColors;
+    std::uint64_t consumed = 0;
+    bool ok                = true;
+    for ( ;; )
+    {
+        size_t n = 0;
+        if ( pending.file.empty() )
+        { n = source.read( options.chunkSize, chunkPoints, chunkNormals, chunkColors ); }
+        else
+        {
+            n = size_t( std::min( std::uint64_t( options.chunkSize ), pending.count - consumed ) );
+            chunkPoints.clear();
+            chunkNormals.clear();
+            chunkColors.clear();
+            if ( n > 0 &&
+                 !readPoints( in, layout, n, chunkPoints, chunkNormals, chunkColors, buffer ) )
+            { return false; }
+        }
+        if ( n == 0 ) { break; }
+        consumed += n;
+
+        for ( size_t i = 0; i < n; ++i )
+        {
+            const Vector3& p = chunkPoints[i];
+            if ( !leaf )
+            {
+                // the first point of each cell of the sampling grid is kept
+                const Vector3 rel = ( p - node.aabb.min() ) / side;
+                size_t cell       = 0;
+                int octant        = 0;
+                for ( int a = 2; a >= 0; --a )
+                {
+                    const int c = std::min( std::max( int( rel( a ) * Scalar( g ) ), 0 ), g - 1 );
+                    cell        = cell * size_t( g ) + size_t( c );
+                    octant |= ( rel( a ) >= 0.5_ra ? 1 : 0 ) << a;
+                }
+                if ( occupied[cell] )
+                {
+                    ChildPoints& child = childPoints[octant];
+                    child.points.push_back( p );
+                    append( child.normals, chunkNormals, i );
+                    append( child.colors, chunkColors, i );
+                    if ( child.points.size() >= flushSize ) { ok = ok && flush( child ); }
+                    continue;
+                }
+                occupied[cell] = true;
+            }
+            keptPoints.push_back( p );
+            append( keptNormals, chunkNormals, i );
+            append( keptColors, chunkColors, i );
+        }
+        if ( !ok ) { return false; }
+    }
+    in.close();
+    if ( !pending.file.empty() ) { std::remove( pending.file.c_str() ); }
+
+    for ( int o = 0; o < 8; ++o )
+    {
+        if ( !flush( childPoints[o] ) ) { return false; }
+        children[o] = {-1, childPoints[o].file, childPoints[o].count};
+    }
+    guard.released = true;
+
+    // the points of a node are contiguous in the points file
+    std::lock_guard<std::mutex> lock( mutex );
+    nodes[size_t( pending.node )].offset = written;
+    nodes[size_t( pending.node )].count  = uint( keptPoints.size() );
+    writePoints(
+        points, layout, keptPoints, keptNormals, keptColors, 0, keptPoints.size(), buffer );
+    written += keptPoints.size();
+    return bool( points );
+}
+
+bool OctreeBuilder::writeHierarchy() const {
+    std::ofstream out( hierarchyFile( directory ), std::ios::binary | std::ios::trunc );
+    out.write( Magic, sizeof( Magic ) );
+    put( out, Version );
+    put( out, std::uint32_t( ( layout.normals ? NormalsFlag : 0 ) |
+                             ( layout.colors ? ColorsFlag : 0 ) ) );
+    put( out, written );
+    put( out, std::uint32_t( nodes.size() ) );
+    for ( const auto& node : nodes )
+    {
+        const Eigen::Vector3f min = node.aabb.min().cast<float>();
+        const Eigen::Vector3f max = node.aabb.max().cast<float>();
+        out.write( reinterpret_cast<const char*>( min.data() ), sizeof( min ) );
+        out.write( reinterpret_cast<const char*>( max.data() ), sizeof( max ) );
+        put( out, float( node.spacing ) );
+        put( out, node.offset );
+        put( out, std::uint32_t( node.count ) );
+        put( out, std::uint32_t( node.depth ) );
+        put( out, std::int32_t( node.parent ) );
+        for ( const int c : node.children )
+        {
+            put( out, std::int32_t( c ) );
+        }
+    }
+    return bool( out );
+}
+
+} // namespace
+
+ArrayPointSource::ArrayPointSource( const Vector3Array& points,
+                                    const Vector3Array& normals,
+                                    const Vector4Array& colors ) :
+    m_points( points ), m_normals( normals ), m_colors( colors ) {
+    CORE_ASSERT( normals.empty() || normals.size() == points.size(), "Missing normals" );
+    CORE_ASSERT( colors.empty() || colors.size() == points.size(), "Missing colors" );
+}
+
+size_t ArrayPointSource::read( const size_t maxCount,
+                               Vector3Array& points,
+                               Vector3Array& normals,
+                               Vector4Array& colors ) {
+    const size_t end = std::min( m_points.size(), m_next + maxCount );
+    points.assign( m_points.begin() + m_next, m_points.begin() + end );
+    normals.clear();
+    colors.clear();
+    if ( hasNormals() ) { normals.assign( m_normals.begin() + m_next, m_normals.begin() + end ); }
+    if ( hasColors() ) { colors.assign( m_colors.begin() + m_next, m_colors.begin() + end ); }
+    const size_t n = end - m_next;
+    m_next         = end;
+    return n;
+}
+
+bool buildPointCloudOctree( PointSource& source,
+                            const std::string& directory,
+                            const PointCloudOctreeOptions& options ) {
+    CORE_ASSERT( options.samplingGrid > 0 && options.chunkSize > 0, "Invalid options" );
+
+    // bounds of the points, enlarged to a cube
+    Aabb aabb;
+    std::uint64_t count = 0;
+    {
+        Vector3Array points;
+        Vector3Array normals;
+        Vector4Array colors;
+        source.reset();
+        while ( const size_t n = source.read( options.chunkSize, points, normals, colors ) )
+        {
+            for ( size_t i = 0; i < n; ++i )
+            {
+                aabb.extend( points[i] );
+            }
+            count += n;
+        }
+    }
+    if ( count == 0 ) { return false; }
+    const Scalar extent  = aabb.sizes().maxCoeff();
+    const Scalar half    = extent > 0 ? extent / 2 : 0.5_ra;
+    const Vector3 center = aabb.center();
+    aabb = Aabb( center - Vector3::Constant( half ), center + Vector3::Constant( half ) );
+
+    OctreeBuilder builder( source, directory, options );
+    builder.points.open( pointsFile( directory ), std::ios::binary | std::ios::trunc );
+    if ( !builder.points )
+    {
+        LOG( logERROR ) << "Can not write the octree in " << directory;
+        return false;
+    }
+    PointCloudOctree::Node root;
+    root.aabb    = aabb;
+    root.spacing = 2 * half / Scalar( options.samplingGrid );
+    builder.nodes.push_back( root );
+
+    // the nodes are processed level by level, the children of the nodes of a
+    // level being created once the level is done
+    std::vector<PendingNode> level{{0, std::string(), count}};
+    bool ok = true;
+    while ( !level.empty() )
+    {
+        const int n = int( level.size() );
+        std::vector<std::array<PendingNode, 8>> children( level.size() );
+        std::vector<char> success( level.size() );
+#pragma omp parallel for schedule( dynamic )
+        for ( int i = 0; i < n; ++i )
+        {
+            success[i] = builder.process( level[i], children[i] );
+        }
+
+        std::vector<PendingNode> next;
+        for ( int i = 0; i < n; ++i )
+        {
+            ok = ok && success[i];
+            for ( int o = 0; o < 8; ++o )
+            {
+                PendingNode& child = children[i][o];
+                if ( child.count == 0 ) { continue; }
+                if ( !ok )
+                {
+                    std::remove( child.file.c_str() );
+                    continue;
+                }
+                const auto& parent = builder.nodes[size_t( level[i].node )];
+                PointCloudOctree::Node node;
+                const Vector3 size = parent.aabb.sizes() / 2;
+                Vector3 min        = parent.aabb.min();
+                for ( int a = 0; a < 3; ++a )
+                {
+                    if ( o & ( 1 << a ) ) { min( a ) += size( a ); }
+                }
+                node.aabb    = Aabb( min, min + size );
+                node.spacing = parent.spacing / 2;
+                node.depth   = parent.depth + 1;
+                node.parent  = level[i].node;
+                child.node   = int( builder.nodes.size() );
+                builder.nodes[size_t( level[i].node )].children[o] = child.node;
+                builder.nodes.push_back( node );
+                next.push_back( child );
+            }
+        }
+        level = std::move( next );
+    }
+    builder.points.close();
+    if ( !ok || !builder.points || !builder.writeHierarchy() )
+    {
+        LOG( logERROR ) << "Can not write the octree in " << directory;
+        return false;
+    }
+    CORE_ASSERT( builder.written == count, "Points were lost" );
+    return true;
+}
+
+bool PointCloudOctree::open( const std::string& directory ) {
+    m_nodes.clear();
+    m_pointCount = 0;
+    std::ifstream in( hierarchyFile( directory ), std::ios::binary );
+    char magic[sizeof( Magic )];
+    std::uint32_t version  = 0;
+    std::uint32_t flags    = 0;
+    std::uint32_t nbNodes  = 0;
+    std::uint64_t nbPoints = 0;
+    in.read( magic, sizeof( magic ) );
+    if ( !in || std::memcmp( magic, Magic, sizeof( Magic ) ) != 0 || !get( in, version ) ||
+         version != Version || !get( in, flags ) || !get( in, nbPoints ) || !get( in, nbNodes ) )
+    { return false; }
+
+    std::vector<Node> nodes( nbNodes );
+    for ( auto& node : nodes )
+    {
+        Eigen::Vector3f min;
+        Eigen::Vector3f max;
+        float spacing;
+        std::uint32_t count;
+        std::uint32_t depth;
+        std::int32_t parent;
+        in.read( reinterpret_cast<char*>( min.data() ), sizeof( min ) );
+        in.read( reinterpret_cast<char*>( max.data() ), sizeof( max ) );
+        get( in, spacing );
+        get( in, node.offset );
+        get( in, count );
+        get( in, depth );
+        get( in, parent );
+        for ( int& c : node.children )
+        {
+            std::int32_t child;
+            get( in, child );
+            c = child;
+        }
+        if ( !in ) { return false; }
+        node.aabb    = Aabb( min.cast<Scalar>(), max.cast<Scalar>() );
+        node.spacing = Scalar( spacing );
+        node.count   = count;
+        node.depth   = depth;
+        node.parent  = parent;
+    }
+    m_directory  = directory;
+    m_nodes      = std::move( nodes );
+    m_pointCount = nbPoints;
+    m_hasNormals = ( flags & NormalsFlag ) != 0;
+    m_hasColors  = ( flags & ColorsFlag ) != 0;
+    return true;
+}
+
+bool PointCloudOctree::loadNode( const int node,
+                                 Vector3Array& points,
+                                 Vector3Array& normals,
+                                 Vector4Array& colors ) const {
+    CORE_ASSERT( node >= 0 && size_t( node ) < m_nodes.size(), "Invalid node" );
+    points.clear();
+    normals.clear();
+    colors.clear();
+    const Node& n = m_nodes[size_t( node )];
+    const RecordLayout layout{m_hasNormals, m_hasColors};
+    // each call has its own stream, so that nodes can be loaded in parallel
+    std::ifstream in( pointsFile( m_directory ), std::ios::binary );
+    in.seekg( std::streamoff( n.offset * layout.size() ) );
+    points.reserve( n.count );
+    normals.reserve( m_hasNormals ? n.count : 0 );
+    colors.reserve( m_hasColors ? n.count : 0 );
+    std::vector<char> buffer;
+    return in && readPoints( in, layout, n.count, points, normals, colors, buffer );
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
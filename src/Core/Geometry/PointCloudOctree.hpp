@@ -0,0 +1,177 @@
+#ifndef RADIUMENGINE_POINT_CLOUD_OCTREE_HPP_
+#define RADIUMENGINE_POINT_CLOUD_OCTREE_HPP_
+
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/**
+ * Out-of-core level of detail octree of a point cloud, stored in a directory.
+ * Each node keeps a subsample of the points falling in it, at most one point
+ * per cell of a regular grid over the node, and gives the remaining points to
+ * its children, so that the points of a node and of all its ancestors form a
+ * uniform sampling of the node, refined at each level. The leaves keep all
+ * their points. This is the layout of:
+ * "Potree: Rendering Large Point Clouds in Web Browsers"
+ * [ Markus Schuetz ]
+ * Master's thesis, TU Wien 2016
+ *
+ * The directory contains two files: "hierarchy.bin", which holds the nodes,
+ * and "points.bin", which holds the points of all the nodes, those of a node
+ * being contiguous. A point is stored as its position, its normal and its 8
+ * bits RGBA color, the attributes being present in all the points or in none.
+ **/
+
+/// Sequential reader of the points to put in an octree, which may be too
+/// large to fit in memory.
+class RA_CORE_API PointSource
+{
+  public:
+    virtual ~PointSource() = default;
+
+    /// Whether the points have normals.
+    virtual bool hasNormals() const = 0;
+
+    /// Whether the points have colors.
+    virtual bool hasColors() const = 0;
+
+    /// Restart reading from the first point.
+    virtual void reset() = 0;
+
+    /// Replace the content of the arrays by the next \p maxCount points, or by
+    /// all the remaining points if there are fewer. The attributes the points
+    /// do not have are left empty. Returns the number of points read, 0 once
+    /// all the points have been read.
+    virtual size_t read( size_t maxCount,
+                         Vector3Array& points,
+                         Vector3Array& normals,
+                         Vector4Array& colors ) = 0;
+};
+
+/// Source reading points from arrays in memory, which must outlive it. Empty
+/// attribute arrays are ignored, otherwise they must have one element per
+/// point.
+class RA_CORE_API ArrayPointSource : public PointSource
+{
+  public:
+    ArrayPointSource( const Vector3Array& points,
+                      const Vector3Array& normals,
+                      const Vector4Array& colors );
+
+    bool hasNormals() const override { return !m_normals.empty(); }
+    bool hasColors() const override { return !m_colors.empty(); }
+    void reset() override { m_next = 0; }
+    size_t read( size_t maxCount,
+                 Vector3Array& points,
+                 Vector3Array& normals,
+                 Vector4Array& colors ) override;
+
+  private:
+    const Vector3Array& m_points;
+    const Vector3Array& m_normals;
+    const Vector4Array& m_colors;
+    size_t m_next{0};
+};
+
+/// Parameters of buildPointCloudOctree().
+struct PointCloudOctreeOptions {
+    /// Nodes with at most this number of points are not split.
+    uint maxLeafPoints{20000};
+    /// Number of cells along each axis of the sampling grid of the nodes.
+    uint samplingGrid{128};
+    /// Maximum depth of the nodes, the nodes at this depth keep all their
+    /// points (e.g. when many points are at the same position).
+    uint maxDepth{16};
+    /// Number of points read from the source or the temporary files at once.
+    uint chunkSize{1 << 18};
+};
+
+/// Build the octree of the points of \p source in \p directory, which must
+/// exist. The points are read twice from the source, once to compute their
+/// bounds, then to fill the root. Each node then splits its points between
+/// its samples and one temporary file per child, the nodes of a level being
+/// processed in parallel, so that the memory used is bounded by the sampling
+/// grids and the leaves being processed, whatever the size of the cloud.
+/// Returns false if the source is empty or the files can not be written.
+RA_CORE_API bool buildPointCloudOctree( PointSource& source,
+                                        const std::string& directory,
+                                        const PointCloudOctreeOptions& options = {} );
+
+/// Reader of an octree built by buildPointCloudOctree(). The points of the
+/// nodes are loaded on demand, possibly from several threads.
+class RA_CORE_API PointCloudOctree
+{
+  public:
+    struct Node {
+        /// Bounds of the node, a cube.
+        Aabb aabb;
+        /// Distance between the samples of the node, i.e. the side of the
+        /// cells of its sampling grid.
+        Scalar spacing{0};
+        /// First point of the node in the points file.
+        std::uint64_t offset{0};
+        /// Number of points of the node.
+        uint count{0};
+        /// Depth of the node, 0 for the root.
+        uint depth{0};
+        /// Parent node, -1 for the root.
+        int parent{-1};
+        /// Child nodes, by octant (bit a set if above the center on axis a),
+        /// -1 where the node has no points.
+        std::array<int, 8> children{{-1, -1, -1, -1, -1, -1, -1, -1}};
+
+        bool isLeaf() const {
+            for ( const int c : children )
+            {
+                if ( c >= 0 ) { return false; }
+            }
+            return true;
+        }
+    };
+
+    /// Read the hierarchy of the octree stored in \p directory, returns false
+    /// if it is not a valid octree.
+    bool open( const std::string& directory );
+
+    /// Whether an octree has been opened.
+    inline bool isOpen() const { return !m_nodes.empty(); }
+
+    /// Nodes of the octree, node 0 being the root.
+    inline const std::vector<Node>& nodes() const { return m_nodes; }
+
+    /// Total number of points.
+    inline std::uint64_t pointCount() const { return m_pointCount; }
+
+    inline bool hasNormals() const { return m_hasNormals; }
+    inline bool hasColors() const { return m_hasColors; }
+
+    /// Replace the content of the arrays by the points of \p node, leaving
+    /// the attributes the octree does not have empty. Can be called from
+    /// several threads at once. Returns false if the points can not be read.
+    bool loadNode( int node,
+                   Vector3Array& points,
+                   Vector3Array& normals,
+                   Vector4Array& colors ) const;
+
+  private:
+    std::string m_directory;
+    std::vector<Node> m_nodes;
+    std::uint64_t m_pointCount{0};
+    bool m_hasNormals{false};
+    bool m_hasColors{false};
+};
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_POINT_CLOUD_OCTREE_HPP_
@@ -0,0 +1,359 @@
+#include <Core/Geometry/PointCloudProcessing.hpp>
+
+#include <Core/Geometry/PointGrid.hpp>
+
+#include <Eigen/Eigenvalues>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <tuple>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+namespace {
+
+// Number of points per task of the parallel loops over the points.
+constexpr int ChunkSize = 1 << 14;
+
+inline int chunkCount( const size_t n ) {
+    return int( ( n + ChunkSize - 1 ) / ChunkSize );
+}
+
+struct VoxelPoint {
+    std::uint64_t key;
+    uint index;
+};
+
+// Stable parallel least significant digit radix sort of the items by the
+// \p bits low bits of their key, 8 bits per pass.
+void radixSort( std::vector<VoxelPoint>& items, const int bits ) {
+    const int n        = int( items.size() );
+    const int nbChunks = chunkCount( items.size() );
+    std::vector<VoxelPoint> buffer( items.size() );
+    std::vector<std::array<uint, 256>> offsets( nbChunks );
+    for ( int shift = 0; shift < bits; shift += 8 )
+    {
+#pragma omp parallel for
+        for ( int c = 0; c < nbChunks; ++c )
+        {
+            offsets[c].fill( 0 );
+            const int end = std::min( n, ( c + 1 ) * ChunkSize );
+            for ( int i = c * ChunkSize; i < end; ++i )
+            {
+                ++offsets[c][( items[i].key >> shift ) & 0xff];
+            }
+        }
+        // the items of a digit are placed chunk after chunk
+        uint sum = 0;
+        for ( int d = 0; d < 256; ++d )
+        {
+            for ( auto& chunk : offsets )
+            {
+                const uint count = chunk[d];
+                chunk[d]         = sum;
+                sum += count;
+            }
+        }
+#pragma omp parallel for
+        for ( int c = 0; c < nbChunks; ++c )
+        {
+            const int end = std::min( n, ( c + 1 ) * ChunkSize );
+            for ( int i = c * ChunkSize; i < end; ++i )
+            {
+                buffer[offsets[c][( items[i].key >> shift ) & 0xff]++] = items[i];
+            }
+        }
+        items.swap( buffer );
+    }
+}
+
+// Keep the elements of a given by kept, in this order.
+template <typename Array>
+void keepElements( const std::vector<uint>& kept, Array& a ) {
+    if ( a.empty() ) { return; }
+    const int n = int( kept.size() );
+    Array result( kept.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        result[i] = a[kept[i]];
+    }
+    a = std::move( result );
+}
+
+// Flip the normals to be consistent along the minimum spanning tree of the
+// symmetrized neighbourhood graph, k neighbours per point being given in
+// neighbours, invalid ones being uint( -1 ).
+void orientNormals( const uint k,
+                    const Vector3Array& points,
+                    const std::vector<uint>& neighbours,
+                    Vector3Array& normals ) {
+    const uint n = uint( points.size() );
+    std::vector<uint> offsets( n + 1, 0 );
+    for ( uint i = 0; i < n; ++i )
+    {
+        for ( uint j = 0; j < k && neighbours[i * k + j] != uint( -1 ); ++j )
+        {
+            ++offsets[i + 1];
+            ++offsets[neighbours[i * k + j] + 1];
+        }
+    }
+    std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+    std::vector<uint> adjacency( offsets[n] );
+    std::vector<uint> next( offsets.begin(), offsets.end() - 1 );
+    for ( uint i = 0; i < n; ++i )
+    {
+        for ( uint j = 0; j < k && neighbours[i * k + j] != uint( -1 ); ++j )
+        {
+            const uint neighbour         = neighbours[i * k + j];
+            adjacency[next[i]++]         = neighbour;
+            adjacency[next[neighbour]++] = i;
+        }
+    }
+
+    // Prim's algorithm, from the highest point of each connected component
+    std::vector<uint> seeds( n );
+    std::iota( seeds.begin(), seeds.end(), 0 );
+    std::sort( seeds.begin(), seeds.end(), [&points]( const uint a, const uint b ) {
+        return points[a]( 2 ) > points[b]( 2 );
+    } );
+    std::vector<char> visited( n, 0 );
+    using Edge = std::tuple<Scalar, uint, uint>; // weight, target, source
+    std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge>> edges;
+    const auto visit = [&]( const uint i ) {
+        visited[i] = 1;
+        for ( uint e = offsets[i]; e < offsets[i + 1]; ++e )
+        {
+            const uint j = adjacency[e];
+            if ( !visited[j] )
+            { edges.emplace( 1 - std::abs( normals[i].dot( normals[j] ) ), j, i ); }
+        }
+    };
+    for ( const uint seed : seeds )
+    {
+        if ( visited[seed] ) { continue; }
+        if ( normals[seed]( 2 ) < 0 ) { normals[seed] = -normals[seed]; }
+        visit( seed );
+        while ( !edges.empty() )
+        {
+            const uint target = std::get<1>( edges.top() );
+            const uint source = std::get<2>( edges.top() );
+            edges.pop();
+            if ( visited[target] ) { continue; }
+            if ( normals[target].dot( normals[source] ) < 0 )
+            { normals[target] = -normals[target]; }
+            visit( target );
+        }
+    }
+}
+
+} // namespace
+
+void downsampleVoxelGrid( const Scalar voxelSize,
+                          Vector3Array& points,
+                          Vector3Array& normals,
+                          Vector4Array& colors ) {
+    CORE_ASSERT( voxelSize > 0, "Voxels must not be empty" );
+    CORE_ASSERT( normals.empty() || normals.size() == points.size(), "Missing normals" );
+    CORE_ASSERT( colors.empty() || colors.size() == points.size(), "Missing colors" );
+    if ( points.empty() ) { return; }
+    const int n        = int( points.size() );
+    const int nbChunks = chunkCount( points.size() );
+
+    std::vector<Aabb> chunkBounds( nbChunks );
+#pragma omp parallel for
+    for ( int c = 0; c < nbChunks; ++c )
+    {
+        const int end = std::min( n, ( c + 1 ) * ChunkSize );
+        for ( int i = c * ChunkSize; i < end; ++i )
+        {
+            chunkBounds[c].extend( points[i] );
+        }
+    }
+    Aabb aabb;
+    for ( const auto& b : chunkBounds )
+    {
+        aabb.extend( b );
+    }
+
+    // voxel of each point, as its linear index in the grid
+    const Eigen::Vector3d size =
+        ( aabb.sizes().cast<double>() / double( voxelSize ) ).array().floor() + 1;
+    CORE_ASSERT( size.prod() < 9.2e18, "Too many voxels" );
+    const int bits                                = int( std::ceil( std::log2( size.prod() ) ) );
+    const Eigen::Matrix<std::uint64_t, 3, 1> last = size.cast<std::uint64_t>().array() - 1;
+    std::vector<VoxelPoint> items( points.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        const Vector3 v   = ( ( points[i] - aabb.min() ) / voxelSize ).array().floor();
+        std::uint64_t key = 0;
+        for ( int a = 2; a >= 0; --a )
+        {
+            key = key * ( last( a ) + 1 ) + std::min( std::uint64_t( v( a ) ), last( a ) );
+        }
+        items[i] = {key, uint( i )};
+    }
+    radixSort( items, bits );
+
+    std::vector<uint> voxels;
+    for ( int i = 0; i < n; ++i )
+    {
+        if ( i == 0 || items[i].key != items[i - 1].key ) { voxels.push_back( uint( i ) ); }
+    }
+    voxels.push_back( uint( n ) );
+
+    const int nbVoxels = int( voxels.size() ) - 1;
+    Vector3Array newPoints( nbVoxels );
+    Vector3Array newNormals( normals.empty() ? 0 : size_t( nbVoxels ) );
+    Vector4Array newColors( colors.empty() ? 0 : size_t( nbVoxels ) );
+#pragma omp parallel for
+    for ( int v = 0; v < nbVoxels; ++v )
+    {
+        const Scalar count = Scalar( voxels[v + 1] - voxels[v] );
+        Vector3 p          = Vector3::Zero();
+        for ( uint i = voxels[v]; i < voxels[v + 1]; ++i )
+        {
+            p += points[items[i].index];
+        }
+        newPoints[v] = p / count;
+        if ( !normals.empty() )
+        {
+            Vector3 normal = Vector3::Zero();
+            for ( uint i = voxels[v]; i < voxels[v + 1]; ++i )
+            {
+                normal += normals[items[i].index];
+            }
+            const Scalar norm = normal.norm();
+            newNormals[v]     = norm > 0 ? Vector3( normal / norm ) : normal;
+        }
+        if ( !colors.empty() )
+        {
+            Vector4 color = Vector4::Zero();
+            for ( uint i = voxels[v]; i < voxels[v + 1]; ++i )
+            {
+                color += colors[items[i].index];
+            }
+            newColors[v] = color / count;
+        }
+    }
+    points  = std::move( newPoints );
+    normals = std::move( newNormals );
+    colors  = std::move( newColors );
+}
+
+void removeStatisticalOutliers( const uint k,
+                                const Scalar stdDevRatio,
+                                Vector3Array& points,
+                                Vector3Array& normals,
+                                Vector4Array& colors ) {
+    CORE_ASSERT( normals.empty() || normals.size() == points.size(), "Missing normals" );
+    CORE_ASSERT( colors.empty() || colors.size() == points.size(), "Missing colors" );
+    if ( k == 0 || points.size() <= k ) { return; }
+    const int n        = int( points.size() );
+    const int nbChunks = chunkCount( points.size() );
+    const PointGrid grid( points );
+
+    std::vector<Scalar> meanDistances( points.size() );
+#pragma omp parallel for schedule( dynamic )
+    for ( int c = 0; c < nbChunks; ++c )
+    {
+        std::vector<uint> indices;
+        std::vector<Scalar> sqDistances;
+        const int end = std::min( n, ( c + 1 ) * ChunkSize );
+        for ( int i = c * ChunkSize; i < end; ++i )
+        {
+            grid.kNearest( points[i], k, indices, sqDistances, uint( i ) );
+            Scalar sum = 0;
+            for ( const Scalar d : sqDistances )
+            {
+                sum += std::sqrt( d );
+            }
+            meanDistances[i] = sum / Scalar( sqDistances.size() );
+        }
+    }
+
+    double sum   = 0;
+    double sqSum = 0;
+    for ( const Scalar d : meanDistances )
+    {
+        sum += d;
+        sqSum += double( d ) * d;
+    }
+    const double mean        = sum / n;
+    const double stdDev      = std::sqrt( std::max( sqSum / n - mean * mean, 0. ) );
+    const Scalar maxDistance = Scalar( mean + stdDevRatio * stdDev );
+
+    std::vector<uint> kept;
+    kept.reserve( points.size() );
+    for ( int i = 0; i < n; ++i )
+    {
+        if ( meanDistances[i] <= maxDistance ) { kept.push_back( uint( i ) ); }
+    }
+    if ( kept.size() == points.size() ) { return; }
+    keepElements( kept, points );
+    keepElements( kept, normals );
+    keepElements( kept, colors );
+}
+
+void estimateNormals( const uint k,
+                      const Vector3Array& points,
+                      Vector3Array& normals,
+                      const bool orient ) {
+    normals.assign( points.size(), Vector3::UnitZ() );
+    if ( k == 0 || points.size() < 3 ) { return; }
+    const int n        = int( points.size() );
+    const int nbChunks = chunkCount( points.size() );
+    const PointGrid grid( points );
+
+    std::vector<uint> neighbours( points.size() * k, uint( -1 ) );
+#pragma omp parallel for schedule( dynamic )
+    for ( int c = 0; c < nbChunks; ++c )
+    {
+        std::vector<uint> indices;
+        std::vector<Scalar> sqDistances;
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+        const int end = std::min( n, ( c + 1 ) * ChunkSize );
+        for ( int i = c * ChunkSize; i < end; ++i )
+        {
+            grid.kNearest( points[i], k, indices, sqDistances, uint( i ) );
+            std::copy( indices.begin(), indices.end(), neighbours.begin() + size_t( i ) * k );
+            if ( indices.size() < 2 ) { continue; }
+
+            // covariance of the neighbourhood, relative to the point to limit
+            // cancellation
+            Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+            Eigen::Matrix3d cov  = Eigen::Matrix3d::Zero();
+            for ( const uint j : indices )
+            {
+                const Eigen::Vector3d d = ( points[j] - points[i] ).cast<double>();
+                mean += d;
+                cov += d * d.transpose();
+            }
+            const double count = double( indices.size() + 1 );
+            mean /= count;
+            cov = cov / count - mean * mean.transpose();
+            solver.computeDirect( cov );
+            // the eigen values are sorted by increasing order
+            normals[i] = solver.eigenvectors().col( 0 ).cast<Scalar>().normalized();
+        }
+    }
+    if ( orient ) { orientNormals( k, points, neighbours, normals ); }
+}
+
+void estimateNormals( const uint k, PointCloud& cloud, const bool orient ) {
+    Vector3Array normals;
+    estimateNormals( k, cloud.vertices(), normals, orient );
+    cloud.setNormals( std::move( normals ) );
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
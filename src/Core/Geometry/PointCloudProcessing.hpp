@@ -0,0 +1,70 @@
+#ifndef RADIUMENGINE_POINT_CLOUD_PROCESSING_HPP_
+#define RADIUMENGINE_POINT_CLOUD_PROCESSING_HPP_
+
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/Geometry/TriangleMesh.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/**
+ * Reduction of large point clouds, given as arrays of positions and optional
+ * per point normals and colors. An empty attribute array is left empty,
+ * otherwise it must have one element per point.
+ *
+ * The statistical outlier removal was taken from:
+ * "Towards 3D Point cloud based object maps for household environments"
+ * [ Radu Bogdan Rusu, Zoltan Csaba Marton, Nico Blodow, Mihai Dolha, Michael Beetz ]
+ * Robotics and Autonomous Systems 2008
+ *
+ * The normal estimation and orientation were taken from:
+ * "Surface reconstruction from unorganized points"
+ * [ Hugues Hoppe, Tony DeRose, Tom Duchamp, John McDonald, Werner Stuetzle ]
+ * SIGGRAPH 1992
+ **/
+
+/// Replace the points of each cube of side \p voxelSize of a grid aligned on
+/// the bounding box of the points by a single point, at their mean position,
+/// with their mean color and their normalized mean normal.
+/// The points are sorted by voxel with a parallel radix sort, then the voxels
+/// are reduced in parallel. The resulting points are ordered by voxel.
+RA_CORE_API void downsampleVoxelGrid( Scalar voxelSize,
+                                      Vector3Array& points,
+                                      Vector3Array& normals,
+                                      Vector4Array& colors );
+
+/// Remove the points whose mean distance to their \p k nearest neighbours is
+/// greater than m + \p stdDevRatio * s, where m and s are the mean and the
+/// standard deviation of these distances over the cloud. The order of the
+/// remaining points is kept.
+RA_CORE_API void removeStatisticalOutliers( uint k,
+                                            Scalar stdDevRatio,
+                                            Vector3Array& points,
+                                            Vector3Array& normals,
+                                            Vector4Array& colors );
+
+/// Set the normal of each point to the direction of least variance of the
+/// point and its \p k nearest neighbours, computed in parallel with the closed
+/// form eigen decomposition of their 3x3 covariance matrix. If \p orient is
+/// true, the normals are then flipped to be consistent along a minimum
+/// spanning tree of the neighbourhood graph, where the edges between points of
+/// parallel normals are the lightest. The propagation starts from the highest
+/// point of each connected component, whose normal is oriented towards +z, so
+/// that the normals of closed surfaces point outwards.
+RA_CORE_API void estimateNormals( uint k,
+                                  const Vector3Array& points,
+                                  Vector3Array& normals,
+                                  bool orient = true );
+
+/// Replace the normals of \p cloud by the ones estimated from its vertices,
+/// see estimateNormals( uint, const Vector3Array&, Vector3Array&, bool ).
+RA_CORE_API void estimateNormals( uint k, PointCloud& cloud, bool orient = true );
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_POINT_CLOUD_PROCESSING_HPP_
@@ -0,0 +1,221 @@
+#include <Core/Geometry/PointGrid.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+namespace {
+
+// Average number of points per non empty cell targeted by the automatic cell
+// size.
+constexpr Scalar CellPoints = 8;
+
+// Number of points per task of the parallel loops over the points.
+constexpr int ChunkSize = 1 << 14;
+
+Aabb pointBounds( const Vector3Array& points ) {
+    const int n        = int( points.size() );
+    const int nbChunks = ( n + ChunkSize - 1 ) / ChunkSize;
+    std::vector<Aabb> chunks( nbChunks );
+#pragma omp parallel for
+    for ( int c = 0; c < nbChunks; ++c )
+    {
+        const int end = std::min( n, ( c + 1 ) * ChunkSize );
+        for ( int i = c * ChunkSize; i < end; ++i )
+        {
+            chunks[c].extend( points[i] );
+        }
+    }
+    Aabb aabb;
+    for ( const auto& chunk : chunks )
+    {
+        aabb.extend( chunk );
+    }
+    return aabb;
+}
+
+} // namespace
+
+PointGrid::PointGrid( const Vector3Array& points, const Scalar cellSize ) {
+    compute( points, cellSize );
+}
+
+void PointGrid::compute( const Vector3Array& points, Scalar cellSize ) {
+    m_offsets.clear();
+    m_points.clear();
+    m_indices.clear();
+    m_size = Vector3i::Zero();
+    if ( points.empty() ) { return; }
+    const Aabb aabb = pointBounds( points );
+
+    if ( cellSize > 0 )
+    {
+        build( points, aabb, cellSize );
+        return;
+    }
+
+    // start from a uniform distribution of the points in the non flat
+    // dimensions of their bounding box, then refine the cells if the points
+    // are clustered (e.g. on a surface)
+    const Vector3 extent = aabb.sizes();
+    const Scalar epsilon = extent.maxCoeff() * std::numeric_limits<Scalar>::epsilon() * 16;
+    Scalar volume        = 1;
+    int dimension        = 0;
+    for ( int a = 0; a < 3; ++a )
+    {
+        if ( extent( a ) > epsilon )
+        {
+            volume *= extent( a );
+            ++dimension;
+        }
+    }
+    if ( dimension == 0 )
+    {
+        build( points, aabb, 1 );
+        return;
+    }
+    cellSize =
+        std::pow( volume * CellPoints / Scalar( points.size() ), 1_ra / Scalar( dimension ) );
+    for ( int pass = 0; pass < 3; ++pass )
+    {
+        const size_t nonEmpty = build( points, aabb, cellSize );
+        const Scalar mean     = Scalar( points.size() ) / Scalar( nonEmpty );
+        if ( mean <= 2 * CellPoints || m_cellSize > cellSize ) { break; }
+        cellSize /= std::cbrt( mean / CellPoints );
+    }
+}
+
+size_t PointGrid::build( const Vector3Array& points, const Aabb& aabb, Scalar cellSize ) {
+    // enlarge the cells to bound the number of cells
+    const double maxCells = std::max( 2 * double( points.size() ), 64. );
+    Eigen::Vector3d size;
+    for ( ;; )
+    {
+        size = ( aabb.sizes().cast<double>() / double( cellSize ) ).array().floor() + 1;
+        if ( size.prod() <= maxCells ) { break; }
+        cellSize *= Scalar( std::cbrt( size.prod() / maxCells ) ) * 1.01_ra;
+    }
+    m_cellSize = cellSize;
+    m_origin   = aabb.min();
+    m_size     = size.cast<int>();
+
+    const int n = int( points.size() );
+    std::vector<uint> cells( points.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        cells[i] = uint( cellIndex( cell( points[i] ) ) );
+    }
+
+    // counting sort of the points by cell
+    m_offsets.assign( size_t( m_size.prod() ) + 1, 0 );
+    for ( const uint c : cells )
+    {
+        ++m_offsets[c + 1];
+    }
+    size_t nonEmpty = 0;
+    for ( size_t c = 0; c + 1 < m_offsets.size(); ++c )
+    {
+        if ( m_offsets[c + 1] != 0 ) { ++nonEmpty; }
+        m_offsets[c + 1] += m_offsets[c];
+    }
+    m_indices.resize( points.size() );
+    std::vector<uint> next( m_offsets.begin(), m_offsets.end() - 1 );
+    for ( int i = 0; i < n; ++i )
+    {
+        m_indices[next[cells[i]]++] = uint( i );
+    }
+    m_points.resize( points.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        m_points[i] = points[m_indices[i]];
+    }
+    return nonEmpty;
+}
+
+void PointGrid::kNearest( const Vector3& q,
+                          const uint k,
+                          std::vector<uint>& indices,
+                          std::vector<Scalar>& sqDistances,
+                          const uint skip ) const {
+    indices.clear();
+    sqDistances.clear();
+    if ( k == 0 || m_points.empty() ) { return; }
+
+    // the neighbours are kept sorted by insertion, k is expected to be small
+    const auto visit = [&]( const uint begin, const uint end ) {
+        for ( uint i = begin; i < end; ++i )
+        {
+            if ( m_indices[i] == skip ) { continue; }
+            const Scalar d = ( m_points[i] - q ).squaredNorm();
+            if ( indices.size() == k )
+            {
+                if ( d >= sqDistances.back() ) { continue; }
+                indices.pop_back();
+                sqDistances.pop_back();
+            }
+            auto pos = std::upper_bound( sqDistances.begin(), sqDistances.end(), d );
+            indices.insert( indices.begin() + ( pos - sqDistances.begin() ), m_indices[i] );
+            sqDistances.insert( pos, d );
+        }
+    };
+
+    // visit the rings of cells around the cell of q, until the k-th neighbour
+    // is closer than the cells which have not been visited
+    const Vector3i c = cell( q );
+    for ( int r = 0;; ++r )
+    {
+        const Vector3i lo = ( c.array() - r ).max( 0 );
+        const Vector3i hi = ( c.array() + r ).min( m_size.array() - 1 );
+        for ( int z = lo( 2 ); z <= hi( 2 ); ++z )
+        {
+            for ( int y = lo( 1 ); y <= hi( 1 ); ++y )
+            {
+                const size_t row = cellIndex( Vector3i( 0, y, z ) );
+                if ( std::abs( z - c( 2 ) ) == r || std::abs( y - c( 1 ) ) == r )
+                {
+                    visit( m_offsets[row + size_t( lo( 0 ) )],
+                           m_offsets[row + size_t( hi( 0 ) ) + 1] );
+                    continue;
+                }
+                if ( c( 0 ) - r >= 0 )
+                {
+                    const size_t x = row + size_t( c( 0 ) - r );
+                    visit( m_offsets[x], m_offsets[x + 1] );
+                }
+                if ( c( 0 ) + r < m_size( 0 ) )
+                {
+                    const size_t x = row + size_t( c( 0 ) + r );
+                    visit( m_offsets[x], m_offsets[x + 1] );
+                }
+            }
+        }
+
+        // distance from q to the closest cell out of the visited block
+        Scalar bound = std::numeric_limits<Scalar>::max();
+        for ( int a = 0; a < 3; ++a )
+        {
+            if ( c( a ) - r > 0 )
+            {
+                bound = std::min( bound,
+                                  q( a ) - m_origin( a ) - Scalar( c( a ) - r ) * m_cellSize );
+            }
+            if ( c( a ) + r < m_size( a ) - 1 )
+            {
+                bound = std::min( bound,
+                                  m_origin( a ) + Scalar( c( a ) + r + 1 ) * m_cellSize - q( a ) );
+            }
+        }
+        if ( bound == std::numeric_limits<Scalar>::max() ) { break; }
+        if ( indices.size() == k && sqDistances.back() <= bound * bound ) { break; }
+    }
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
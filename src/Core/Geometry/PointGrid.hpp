@@ -0,0 +1,108 @@
+#ifndef RADIUMENGINE_POINT_GRID_HPP_
+#define RADIUMENGINE_POINT_GRID_HPP_
+
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+#include <vector>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/// Uniform grid of a set of points, for nearest neighbours queries.
+/// The points are copied and sorted by cell, so that the points of a cell are
+/// contiguous in memory, and the cells are stored densely: the cell size is
+/// enlarged if needed so that there are at most twice as many cells as points.
+/// The grid does not change once built, so queries can run in parallel.
+class RA_CORE_API PointGrid
+{
+  public:
+    /// Create an empty grid.
+    PointGrid() = default;
+
+    /// Build the grid of \p points, see compute().
+    explicit PointGrid( const Vector3Array& points, Scalar cellSize = 0 );
+
+    /// Build the grid of \p points, with cells of side \p cellSize. If
+    /// \p cellSize is 0, it is chosen so that the non empty cells hold a few
+    /// points each.
+    void compute( const Vector3Array& points, Scalar cellSize = 0 );
+
+    /// Number of points in the grid.
+    inline size_t size() const { return m_points.size(); }
+
+    /// Side of the cells.
+    inline Scalar cellSize() const { return m_cellSize; }
+
+    /// Fill \p indices with the indices of the \p k points closest to \p q, by
+    /// increasing distance, and \p sqDistances with their squared distances.
+    /// Point \p skip is ignored, so that the neighbours of the point i of the
+    /// grid are given by kNearest( points[i], k, indices, sqDistances, i ).
+    /// Fewer than \p k neighbours are given if the grid does not have enough
+    /// points.
+    void kNearest( const Vector3& q,
+                   uint k,
+                   std::vector<uint>& indices,
+                   std::vector<Scalar>& sqDistances,
+                   uint skip = uint( -1 ) ) const;
+
+    /// Call f( index, sqDistance ) for each point closer than \p radius to
+    /// \p q, in no particular order.
+    template <typename F>
+    inline void forEachInRadius( const Vector3& q, Scalar radius, const F& f ) const;
+
+  private:
+    // Cell containing p, clamped to the grid.
+    inline Vector3i cell( const Vector3& p ) const {
+        const Vector3 c = ( ( p - m_origin ) / m_cellSize ).array().floor();
+        return c.cwiseMax( Vector3::Zero() )
+            .cwiseMin( ( m_size - Vector3i::Ones() ).cast<Scalar>() )
+            .cast<int>();
+    }
+
+    inline size_t cellIndex( const Vector3i& c ) const {
+        const size_t nx = size_t( m_size( 0 ) );
+        const size_t ny = size_t( m_size( 1 ) );
+        return size_t( c( 0 ) ) + nx * ( size_t( c( 1 ) ) + ny * size_t( c( 2 ) ) );
+    }
+
+    // Build the grid with the given cell size, return the number of non empty
+    // cells.
+    size_t build( const Vector3Array& points, const Aabb& aabb, Scalar cellSize );
+
+    Vector3 m_origin{Vector3::Zero()};
+    Vector3i m_size{Vector3i::Zero()};
+    Scalar m_cellSize{1};
+    std::vector<uint> m_offsets; // first point of each cell
+    Vector3Array m_points;       // sorted by cell
+    std::vector<uint> m_indices; // index of the sorted points in the input
+};
+
+template <typename F>
+void PointGrid::forEachInRadius( const Vector3& q, const Scalar radius, const F& f ) const {
+    if ( m_points.empty() ) { return; }
+    const Vector3i lo     = cell( q - Vector3::Constant( radius ) );
+    const Vector3i hi     = cell( q + Vector3::Constant( radius ) );
+    const Scalar sqRadius = radius * radius;
+    for ( int z = lo( 2 ); z <= hi( 2 ); ++z )
+    {
+        for ( int y = lo( 1 ); y <= hi( 1 ); ++y )
+        {
+            const size_t row = cellIndex( Vector3i( 0, y, z ) );
+            const uint end   = m_offsets[row + size_t( hi( 0 ) ) + 1];
+            for ( uint i = m_offsets[row + size_t( lo( 0 ) )]; i < end; ++i )
+            {
+                const Scalar sqDistance = ( m_points[i] - q ).squaredNorm();
+                if ( sqDistance < sqRadius ) { f( m_indices[i], sqDistance ); }
+            }
+        }
+    }
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_POINT_GRID_HPP_
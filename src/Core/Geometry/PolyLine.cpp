@@ -4,6 +4,20 @@ namespace Ra {
 namespace Core {
 namespace Geometry {
 
+namespace {
+
+constexpr uint BvhLeafSize = 4;
+
+// Squared distance between q and the segment [a, a + ab], and parameter t of
+// the projection of q on the segment.
+inline Scalar
+segmentSqDistance( const Vector3& q, const Vector3& a, const Vector3& ab, Scalar& t ) {
+    t = Geometry::projectOnSegment( q, a, ab );
+    return ( q - ( a + t * ( ab ) ) ).squaredNorm();
+}
+
+} // namespace
+
 void PolyLine::update() {
     m_ptsDiff.clear();
     m_lengths.clear();
@@ -17,6 +31,96 @@ void PolyLine::update() {
         len += m_ptsDiff.back().norm();
         m_lengths.push_back( len );
     }
+
+    m_bvh.clear();
+    if ( m_ptsDiff.size() >= s_bvhMinSegments )
+    {
+        // the leaves are inflated to contain the points computed on the
+        // segments despite rounding errors, so that pruning is conservative
+        Scalar scale = 0;
+        for ( uint i = 0; i < m_ptsDiff.size(); ++i )
+        {
+            scale = std::max( scale, m_pts[i].cwiseAbs().maxCoeff() + m_ptsDiff[i].norm() );
+        }
+        m_bvhMargin = 8 * std::numeric_limits<Scalar>::epsilon() * scale;
+        m_bvh.reserve( 2 * ( m_ptsDiff.size() / BvhLeafSize + 1 ) );
+        buildBvh( 0, uint( m_ptsDiff.size() ) );
+    }
+}
+
+uint PolyLine::buildBvh( uint begin, uint end ) {
+    const uint node = uint( m_bvh.size() );
+    m_bvh.push_back( {Aabb(), begin, end, 0} );
+    if ( end - begin <= BvhLeafSize )
+    {
+        for ( uint i = begin; i <= end; ++i )
+        {
+            m_bvh[node].aabb.extend( m_pts[i] );
+        }
+        m_bvh[node].aabb.min().array() -= m_bvhMargin;
+        m_bvh[node].aabb.max().array() += m_bvhMargin;
+    }
+    else
+    {
+        const uint mid   = ( begin + end ) / 2;
+        const uint left  = buildBvh( begin, mid );
+        const uint right = buildBvh( mid, end );
+        m_bvh[node].aabb  = m_bvh[left].aabb.merged( m_bvh[right].aabb );
+        m_bvh[node].right = right;
+    }
+    return node;
+}
+
+uint PolyLine::nearestSegment( const Vector3& p, Scalar& tOut, Scalar& sqDistOut ) const {
+    CORE_ASSERT( m_pts.size() > 1, "Line must have at least two points" );
+    Scalar sqDist = std::numeric_limits<Scalar>::max();
+    Scalar t      = 0;
+    uint segment  = 0;
+    auto visit    = [&]( uint begin, uint end ) {
+        for ( uint i = begin; i < end; ++i )
+        {
+            Scalar proj;
+            const Scalar d = segmentSqDistance( p, m_pts[i], m_ptsDiff[i], proj );
+            if ( d < sqDist || ( d == sqDist && i < segment ) )
+            {
+                sqDist  = d;
+                t       = proj;
+                segment = i;
+            }
+        }
+    };
+
+    if ( m_bvh.empty() ) { visit( 0, uint( m_ptsDiff.size() ) ); }
+    else
+    {
+        // depth first traversal, nearest child first, skipping the nodes
+        // farther than the current nearest segment (with a tolerance on the
+        // distances rounding errors)
+        const Scalar tolerance = 1 + 16 * std::numeric_limits<Scalar>::epsilon();
+        uint stack[64];
+        int top      = 0;
+        stack[top++] = 0;
+        while ( top > 0 )
+        {
+            const uint n     = stack[--top];
+            const auto& node = m_bvh[n];
+            if ( node.aabb.squaredExteriorDistance( p ) > tolerance * sqDist ) { continue; }
+            if ( node.right == 0 )
+            {
+                visit( node.begin, node.end );
+                continue;
+            }
+            const Scalar dLeft  = m_bvh[n + 1].aabb.squaredExteriorDistance( p );
+            const Scalar dRight = m_bvh[node.right].aabb.squaredExteriorDistance( p );
+            stack[top++]        = dLeft <= dRight ? node.right : n + 1;
+            stack[top++]        = dLeft <= dRight ? n + 1 : node.right;
+        }
+    }
+
+    CORE_ASSERT( segment < m_ptsDiff.size(), "Invalid index" );
+    tOut      = t;
+    sqDistOut = sqDist;
+    return segment;
 }
 
 PolyLine::PolyLine( const Vector3Array& pts ) : m_pts( pts ) {
@@ -29,12 +133,9 @@ void PolyLine::setPoints( const Vector3Array& pts ) {
 }
 
 Scalar PolyLine::squaredDistance( const Vector3& p ) const {
-    CORE_ASSERT( m_pts.size() > 1, "Line must have at least two points" );
-    Scalar sqDist = std::numeric_limits<Scalar>::max();
-    for ( uint i = 0; i < m_ptsDiff.size(); ++i )
-    {
-        sqDist = std::min( Geometry::pointToSegmentSq( p, m_pts[i], m_ptsDiff[i] ), sqDist );
-    }
+    Scalar t;
+    Scalar sqDist;
+    nearestSegment( p, t, sqDist );
     return sqDist;
 }
 
@@ -49,36 +150,26 @@ Scalar PolyLine::projectOnSegment( const Vector3& p, uint segment ) const {
 }
 
 Scalar PolyLine::project( const Vector3& p ) const {
-    CORE_ASSERT( m_pts.size() > 1, "Line must have at least two points" );
-    Scalar sqDist = std::numeric_limits<Scalar>::max();
-    uint segment  = 0;
-    std::vector<Scalar> ts;
-    std::vector<Scalar> ds;
-    ts.reserve( m_ptsDiff.size() );
-    ds.reserve( m_ptsDiff.size() );
-
-    for ( uint i = 0; i < m_ptsDiff.size(); ++i )
-    {
-        Scalar proj = Geometry::projectOnSegment( p, m_pts[i], m_ptsDiff[i] );
-        Scalar d    = ( p - ( m_pts[i] + proj * ( m_ptsDiff[i] ) ) ).squaredNorm();
-        ds.push_back( d );
-        ts.push_back( proj );
-        if ( d < sqDist )
-        {
-            sqDist  = d;
-            segment = i;
-        }
-    }
+    Scalar t;
+    Scalar sqDist;
+    const uint segment = nearestSegment( p, t, sqDist );
 
-    CORE_ASSERT( segment < m_ptsDiff.size(), "Invalid index" );
-    Scalar t = ts[segment];
     if ( t > 0 && t < 1 )
     {
-        bool prev = segment > 0 && ts[segment - 1] > 0 && ts[segment - 1] < 1;
-        bool next = segment < m_ptsDiff.size() - 1 && ts[segment + 1] > 0 && ts[segment + 1] < 1;
+        const uint last = uint( m_ptsDiff.size() ) - 1;
+        Scalar tPrev    = 0;
+        Scalar tNext    = 0;
+        Scalar dPrev    = 0;
+        Scalar dNext    = 0;
+        if ( segment > 0 )
+        { dPrev = segmentSqDistance( p, m_pts[segment - 1], m_ptsDiff[segment - 1], tPrev ); }
+        if ( segment < last )
+        { dNext = segmentSqDistance( p, m_pts[segment + 1], m_ptsDiff[segment + 1], tNext ); }
+        bool prev = segment > 0 && tPrev > 0 && tPrev < 1;
+        bool next = segment < last && tNext > 0 && tNext < 1;
         if ( prev || next )
         {
-            if ( prev && next ) { prev = ds[segment - 1] < ds[segment + 1]; }
+            if ( prev && next ) { prev = dPrev < dNext; }
             uint i     = prev ? segment - 1 : segment;
             Vector3 ba = -m_ptsDiff[i];
             Vector3 bc = m_ptsDiff[i + 1];
@@ -86,8 +177,8 @@ Scalar PolyLine::project( const Vector3& p ) const {
             Scalar c1  = Math::cotan( ba, bp );
             Scalar c2  = Math::cotan( bp, bc );
 
-            Scalar t1 = getLineParameter( i, ts[i] );
-            Scalar t2 = getLineParameter( i + 1, ts[i + 1] );
+            Scalar t1 = getLineParameter( i, prev ? tPrev : t );
+            Scalar t2 = getLineParameter( i + 1, prev ? t : tNext );
             return ( c1 * t1 + c2 * t2 ) / ( c1 + c2 );
         }
     }
@@ -114,22 +205,39 @@ Vector3 PolyLine::f( Scalar t ) const {
 }
 
 uint PolyLine::getNearestSegment( const Vector3& p ) const {
-    CORE_ASSERT( m_pts.size() > 1, "Line must have at least two points" );
-    Scalar sqDist = std::numeric_limits<Scalar>::max();
-    uint segment  = 0;
-    for ( uint i = 0; i < m_ptsDiff.size(); ++i )
+    Scalar t;
+    Scalar sqDist;
+    return nearestSegment( p, t, sqDist );
+}
+
+void PolyLine::squaredDistance( const Vector3Array& p, std::vector<Scalar>& sqDistOut ) const {
+    const int size = int( p.size() );
+    sqDistOut.resize( p.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < size; ++i )
     {
-        Scalar proj = Geometry::projectOnSegment( p, m_pts[i], m_ptsDiff[i] );
-        Scalar d    = ( p - ( m_pts[i] + proj * ( m_ptsDiff[i] ) ) ).squaredNorm();
-        if ( d < sqDist )
-        {
-            sqDist  = d;
-            segment = i;
-        }
+        sqDistOut[i] = squaredDistance( p[i] );
     }
+}
 
-    CORE_ASSERT( segment < m_ptsDiff.size(), "Invalid index" );
-    return segment;
+void PolyLine::project( const Vector3Array& p, std::vector<Scalar>& tOut ) const {
+    const int size = int( p.size() );
+    tOut.resize( p.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < size; ++i )
+    {
+        tOut[i] = project( p[i] );
+    }
+}
+
+void PolyLine::getNearestSegment( const Vector3Array& p, std::vector<uint>& segmentOut ) const {
+    const int size = int( p.size() );
+    segmentOut.resize( p.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < size; ++i )
+    {
+        segmentOut[i] = getNearestSegment( p[i] );
+    }
 }
 
 } // namespace Geometry
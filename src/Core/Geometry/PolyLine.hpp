@@ -6,11 +6,20 @@
 #include <Core/RaCore.hpp>
 #include <Core/Types.hpp>
 
+#include <vector>
+
 namespace Ra {
 namespace Core {
 namespace Geometry {
 /// A parametrized polyline, i.e. a continuous polygonal chain of segments.
 /// Points go from P0 to Pn. The ith segments joins Pi and Pi+1.
+///
+/// Nearest segment queries (squaredDistance(), project(), getNearestSegment())
+/// use a bounding volume hierarchy of the segments when the line is long
+/// enough, so that they run in logarithmic time instead of scanning all the
+/// segments. The hierarchy follows the chain order, which keeps it cheap to
+/// rebuild each time the points are set, and it gives the same results as a
+/// linear scan.
 class RA_CORE_API PolyLine
 {
 
@@ -60,6 +69,17 @@ class RA_CORE_API PolyLine
     /// Values of t below 0 map to the first point, and values above 1 to the last.
     Vector3 f( Scalar t ) const;
 
+    /// \name Batch queries
+    /// Same as the single point versions, for all the points of \p p, in parallel.
+    /// \{
+    void squaredDistance( const Vector3Array& p, std::vector<Scalar>& sqDistOut ) const;
+    void project( const Vector3Array& p, std::vector<Scalar>& tOut ) const;
+    void getNearestSegment( const Vector3Array& p, std::vector<uint>& segmentOut ) const;
+    /// \}
+
+    /// Minimal number of segments for which a hierarchy is built.
+    static constexpr uint s_bvhMinSegments = 16;
+
   protected:
     /// Update the precomputed values after new points have been set.
     void update();
@@ -69,13 +89,34 @@ class RA_CORE_API PolyLine
     /// in the whole line parametrization.
     inline Scalar getLineParameter( uint segment, Scalar tSegment ) const;
 
+    /// Return the index of the segment nearest to p, the lowest one in case of
+    /// equality, and set its parameter \p tOut and squared distance \p sqDistOut.
+    uint nearestSegment( const Vector3& p, Scalar& tOut, Scalar& sqDistOut ) const;
+
   private:
+    /// Node of the segment hierarchy, spanning the segments [begin, end).
+    /// The left child of an inner node follows it in m_bvh, and is spanning
+    /// [begin, mid), while the right child spans [mid, end).
+    struct BvhNode {
+        Aabb aabb;
+        uint begin;
+        uint end;
+        uint right;
+    };
+
+    /// Build the node spanning [begin, end) and its descendants.
+    uint buildBvh( uint begin, uint end );
+
     // Stores the points Pi
     Vector3Array m_pts;
     // Stores the vectors (Pi+1 - Pi)
     Vector3Array m_ptsDiff;
     // Length from origin to point Pi+1.
     std::vector<Scalar> m_lengths;
+    // Segment hierarchy, root first, empty for short lines.
+    std::vector<BvhNode> m_bvh;
+    // Inflation of the hierarchy leaves.
+    Scalar m_bvhMargin{0};
 };
 
 } // namespace Geometry
@@ -0,0 +1,196 @@
+#include <Core/Geometry/Quantization.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+namespace {
+
+constexpr Scalar SnormMax = 32767;
+constexpr Scalar UnormMax = 65535;
+
+inline Scalar signNotZero( const Scalar x ) {
+    return x >= 0 ? Scalar( 1 ) : Scalar( -1 );
+}
+
+inline std::int16_t toSnorm16( const Scalar x ) {
+    return std::int16_t( std::round( std::clamp( x, Scalar( -1 ), Scalar( 1 ) ) * SnormMax ) );
+}
+
+inline Scalar fromSnorm16( const std::int16_t x ) {
+    return std::max( Scalar( x ) / SnormMax, Scalar( -1 ) );
+}
+
+// Apply \p f to each element of \p in.
+template <typename Out, typename In, typename F>
+VectorArray<Out> transform( const VectorArray<In>& in, const F& f ) {
+    const int size = int( in.size() );
+    VectorArray<Out> out( in.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < size; ++i )
+    {
+        out[i] = f( in[i] );
+    }
+    return out;
+}
+
+} // namespace
+
+std::uint16_t floatToHalf( const float f ) {
+    std::uint32_t x;
+    std::memcpy( &x, &f, sizeof( x ) );
+    const auto sign      = std::uint16_t( ( x >> 16 ) & 0x8000u );
+    const std::uint32_t a = x & 0x7fffffffu;
+
+    // infinity and NaN (keep a quiet NaN)
+    if ( a >= 0x7f800000u ) { return sign | 0x7c00u | ( a > 0x7f800000u ? 0x0200u : 0u ); }
+    // too large, rounds to infinity
+    if ( a >= 0x477ff000u ) { return sign | 0x7c00u; }
+    // too small, rounds to zero
+    if ( a <= 0x33000000u ) { return sign; }
+
+    std::uint32_t h;
+    std::uint32_t remainder;
+    std::uint32_t halfway;
+    if ( a < 0x38800000u )
+    {
+        // subnormal half: the mantissa, with its implicit bit, is shifted
+        // according to the exponent
+        const std::uint32_t shift    = 126u - ( a >> 23 );
+        const std::uint32_t mantissa = ( a & 0x007fffffu ) | 0x00800000u;
+        h                            = mantissa >> shift;
+        remainder                    = mantissa & ( ( 1u << shift ) - 1u );
+        halfway                      = 1u << ( shift - 1u );
+    }
+    else
+    {
+        // normal half: rebias the exponent from 127 to 15, and drop 13 bits
+        // of mantissa
+        h         = ( a - 0x38000000u ) >> 13;
+        remainder = a & 0x1fffu;
+        halfway   = 0x1000u;
+    }
+    // round to nearest even, a carry correctly increments the exponent
+    if ( remainder > halfway || ( remainder == halfway && ( h & 1u ) ) ) { ++h; }
+    return sign | std::uint16_t( h );
+}
+
+float halfToFloat( const std::uint16_t h ) {
+    const std::uint32_t sign     = std::uint32_t( h & 0x8000u ) << 16;
+    const std::uint32_t exponent = ( h >> 10 ) & 0x1fu;
+    const std::uint32_t mantissa = h & 0x03ffu;
+
+    std::uint32_t x;
+    if ( exponent == 0 )
+    {
+        // zero and subnormals, exactly representable as floats
+        const float f = std::ldexp( float( mantissa ), -24 );
+        return sign ? -f : f;
+    }
+    if ( exponent == 0x1fu ) { x = sign | 0x7f800000u | ( mantissa << 13 ); }
+    else
+    { x = sign | ( ( exponent + 112u ) << 23 ) | ( mantissa << 13 ); }
+    float f;
+    std::memcpy( &f, &x, sizeof( f ) );
+    return f;
+}
+
+HalfVector2 encodeHalf( const Vector2& v ) {
+    return {floatToHalf( float( v( 0 ) ) ), floatToHalf( float( v( 1 ) ) )};
+}
+
+Vector2 decodeHalf( const HalfVector2& h ) {
+    return {Scalar( halfToFloat( h( 0 ) ) ), Scalar( halfToFloat( h( 1 ) ) )};
+}
+
+VectorArray<HalfVector2> encodeHalf( const Vector2Array& v ) {
+    return transform<HalfVector2>( v, []( const Vector2& x ) { return encodeHalf( x ); } );
+}
+
+Vector2Array decodeHalf( const VectorArray<HalfVector2>& h ) {
+    return transform<Vector2>( h, []( const HalfVector2& x ) { return decodeHalf( x ); } );
+}
+
+OctahedralVector encodeOctahedral( const Vector3& n ) {
+    // project on the octahedron |x| + |y| + |z| = 1, then unfold the lower
+    // hemisphere on the corners of the [-1,1]^2 square
+    const Scalar l1 = n.cwiseAbs().sum();
+    if ( l1 <= 0 ) { return {0, 0}; }
+    Scalar x = n( 0 ) / l1;
+    Scalar y = n( 1 ) / l1;
+    if ( n( 2 ) < 0 )
+    {
+        const Scalar fx = ( 1 - std::abs( y ) ) * signNotZero( x );
+        const Scalar fy = ( 1 - std::abs( x ) ) * signNotZero( y );
+        x               = fx;
+        y               = fy;
+    }
+    return {toSnorm16( x ), toSnorm16( y )};
+}
+
+Vector3 decodeOctahedral( const OctahedralVector& e ) {
+    const Scalar x = fromSnorm16( e( 0 ) );
+    const Scalar y = fromSnorm16( e( 1 ) );
+    Vector3 n( x, y, 1 - std::abs( x ) - std::abs( y ) );
+    if ( n( 2 ) < 0 )
+    {
+        n( 0 ) = ( 1 - std::abs( y ) ) * signNotZero( x );
+        n( 1 ) = ( 1 - std::abs( x ) ) * signNotZero( y );
+    }
+    return n.normalized();
+}
+
+VectorArray<OctahedralVector> encodeOctahedral( const Vector3Array& n ) {
+    return transform<OctahedralVector>( n,
+                                        []( const Vector3& x ) { return encodeOctahedral( x ); } );
+}
+
+Vector3Array decodeOctahedral( const VectorArray<OctahedralVector>& e ) {
+    return transform<Vector3>( e,
+                               []( const OctahedralVector& x ) { return decodeOctahedral( x ); } );
+}
+
+Scalar octahedralError() {
+    // Each component is rounded by at most 1/2 step. This moves the point on
+    // the octahedron by at most sqrt(6) half steps, and the octahedron is at
+    // least at distance 1/sqrt(3) from the origin.
+    return std::sqrt( Scalar( 18 ) ) * Scalar( 0.5 ) / SnormMax;
+}
+
+QuantizedPosition quantizePosition( const Vector3& p, const Aabb& aabb ) {
+    const Vector3 extent = aabb.sizes();
+    QuantizedPosition q;
+    for ( int k = 0; k < 3; ++k )
+    {
+        const Scalar t = extent( k ) > 0 ? ( p( k ) - aabb.min()( k ) ) / extent( k ) : Scalar( 0 );
+        q( k )         = std::uint16_t( std::round( std::clamp( t, Scalar( 0 ), Scalar( 1 ) ) *
+                                            UnormMax ) );
+    }
+    return q;
+}
+
+Vector3 dequantizePosition( const QuantizedPosition& q, const Aabb& aabb ) {
+    return aabb.min() + ( q.cast<Scalar>() / UnormMax ).cwiseProduct( aabb.sizes() );
+}
+
+VectorArray<QuantizedPosition> quantizePositions( const Vector3Array& p, const Aabb& aabb ) {
+    return transform<QuantizedPosition>(
+        p, [&aabb]( const Vector3& x ) { return quantizePosition( x, aabb ); } );
+}
+
+Vector3Array dequantizePositions( const VectorArray<QuantizedPosition>& q, const Aabb& aabb ) {
+    return transform<Vector3>(
+        q, [&aabb]( const QuantizedPosition& x ) { return dequantizePosition( x, aabb ); } );
+}
+
+Vector3 positionQuantizationError( const Aabb& aabb ) {
+    return aabb.sizes() * ( Scalar( 0.5 ) / UnormMax );
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,114 @@
+#ifndef RADIUMENGINE_QUANTIZATION_HPP_
+#define RADIUMENGINE_QUANTIZATION_HPP_
+
+#include <Core/Containers/VectorArray.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+#include <Core/Utils/Attribs.hpp>
+
+#include <cstdint>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/**
+ * Compact encodings of vertex attributes, to reduce memory footprint and GPU
+ * upload bandwidth:
+ *  - positions are quantized on 16 bits per component, relative to a
+ *    bounding box (6 bytes instead of 12, or 24 with double precision),
+ *  - unit vectors (normals, tangents) use the octahedral mapping on two 16
+ *    bits signed normalized components (4 bytes instead of 12),
+ *  - texture coordinates are stored as half floats (4 bytes instead of 8).
+ *
+ * The encoded types are plain integer Eigen vectors, so they can be stored
+ * in an Utils::Attrib and uploaded as is: the attrib encoding
+ * (Utils::AttribBase::Encoding) tells how to fetch them. Half floats are
+ * converted by the vertex fetch, but the default shaders do not decode
+ * quantized positions nor octahedral vectors, so the renderer does not bind
+ * these attribs: they are meant for storage, and are decoded on the CPU with
+ * dequantizePositions() and decodeOctahedral() before rendering.
+ *
+ * The octahedral mapping was taken from:
+ * "A Survey of Efficient Representations for Independent Unit Vectors"
+ * [ Zina H. Cigolle, Sam Donow, Daniel Evangelakos, Michael Mara,
+ *   Morgan McGuire, Quirin Meyer ]
+ * Journal of Computer Graphics Techniques, 2014
+ **/
+
+/// Position quantized on 16 bits unsigned normalized components.
+using QuantizedPosition = Eigen::Matrix<std::uint16_t, 3, 1>;
+
+/// Unit vector stored with the octahedral mapping, on 16 bits signed
+/// normalized components.
+using OctahedralVector = Eigen::Matrix<std::int16_t, 2, 1>;
+
+/// Two dimensional vector stored as half floats. It is a distinct type from
+/// the other 16 bits unsigned vectors, so that its attribs get the HALF
+/// encoding.
+class HalfVector2 : public Eigen::Matrix<std::uint16_t, 2, 1>
+{
+  public:
+    using Base = Eigen::Matrix<std::uint16_t, 2, 1>;
+    static constexpr Utils::AttribBase::Encoding AttribEncoding =
+        Utils::AttribBase::Encoding::HALF;
+
+    HalfVector2() = default;
+    HalfVector2( const std::uint16_t x, const std::uint16_t y ) : Base( x, y ) {}
+    template <typename Derived>
+    HalfVector2( const Eigen::MatrixBase<Derived>& other ) : Base( other ) {}
+    template <typename Derived>
+    HalfVector2& operator=( const Eigen::MatrixBase<Derived>& other ) {
+        Base::operator=( other );
+        return *this;
+    }
+};
+
+/// \name Half floats
+/// IEEE 754 binary16 conversions. Values are rounded to the nearest
+/// representable half, ties to even. Values too large for a half are
+/// converted to infinity, NaN are preserved.
+/// \{
+RA_CORE_API std::uint16_t floatToHalf( const float f );
+RA_CORE_API float halfToFloat( const std::uint16_t h );
+
+RA_CORE_API HalfVector2 encodeHalf( const Vector2& v );
+RA_CORE_API Vector2 decodeHalf( const HalfVector2& h );
+RA_CORE_API VectorArray<HalfVector2> encodeHalf( const Vector2Array& v );
+RA_CORE_API Vector2Array decodeHalf( const VectorArray<HalfVector2>& h );
+/// \}
+
+/// \name Octahedral unit vectors
+/// The decoded vectors are unit length. The angular error is lower than
+/// octahedralError() radians.
+/// \{
+RA_CORE_API OctahedralVector encodeOctahedral( const Vector3& n );
+RA_CORE_API Vector3 decodeOctahedral( const OctahedralVector& e );
+RA_CORE_API VectorArray<OctahedralVector> encodeOctahedral( const Vector3Array& n );
+RA_CORE_API Vector3Array decodeOctahedral( const VectorArray<OctahedralVector>& e );
+
+/// Upper bound of the angular error, in radians, of the octahedral encoding.
+RA_CORE_API Scalar octahedralError();
+/// \}
+
+/// \name Quantized positions
+/// Positions are quantized on the regular grid of 2^16 steps per axis that
+/// spans \p aabb. Positions outside \p aabb are clamped to it.
+/// The error on each axis is lower than positionQuantizationError( aabb ).
+/// \{
+RA_CORE_API QuantizedPosition quantizePosition( const Vector3& p, const Aabb& aabb );
+RA_CORE_API Vector3 dequantizePosition( const QuantizedPosition& q, const Aabb& aabb );
+RA_CORE_API VectorArray<QuantizedPosition> quantizePositions( const Vector3Array& p,
+                                                               const Aabb& aabb );
+RA_CORE_API Vector3Array dequantizePositions( const VectorArray<QuantizedPosition>& q,
+                                              const Aabb& aabb );
+
+/// Upper bound of the per-axis quantization error of positions within \p aabb.
+RA_CORE_API Vector3 positionQuantizationError( const Aabb& aabb );
+/// \}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_QUANTIZATION_HPP_
@@ -0,0 +1,368 @@
+#include <Core/Geometry/SignedDistance.hpp>
+
+#include <Core/Geometry/DistanceQueries.hpp>
+#include <Core/Geometry/TriangleOperation.hpp>
+#include <Core/Math/Math.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+namespace {
+
+constexpr uint BvhLeafSize = 4;
+
+// A node is approximated by its dipole when the query point is farther than
+// WindingAccuracy times its radius.
+constexpr Scalar WindingAccuracy = 2;
+
+// Solid angle of the triangle abc, given relatively to the query point,
+// positive when abc is counterclockwise seen from the query point.
+inline Scalar solidAngle( const Vector3& a, const Vector3& b, const Vector3& c ) {
+    const Scalar la = a.norm();
+    const Scalar lb = b.norm();
+    const Scalar lc = c.norm();
+    const Scalar d  = la * lb * lc + a.dot( b ) * lc + a.dot( c ) * lb + b.dot( c ) * la;
+    return 2 * std::atan2( a.dot( b.cross( c ) ), d );
+}
+
+// Bounding volume hierarchy of the triangles of a mesh, with the moments
+// needed by the winding number approximation.
+class TriangleHierarchy
+{
+  public:
+    TriangleHierarchy( const Vector3Array& p, const AlignedStdVector<Vector3ui>& T ) :
+        m_p( p ), m_T( T ), m_order( T.size() ) {
+        std::iota( m_order.begin(), m_order.end(), 0 );
+        Vector3Array centroids( T.size() );
+        for ( size_t i = 0; i < T.size(); ++i )
+        {
+            centroids[i] = ( p[T[i]( 0 )] + p[T[i]( 1 )] + p[T[i]( 2 )] ) / 3;
+        }
+        if ( !T.empty() ) { build( 0, uint( T.size() ), centroids ); }
+    }
+
+    /// Squared distance from q to the closest triangle, or maxSqDist if all
+    /// the triangles are farther.
+    Scalar closest( const Vector3& q, const Scalar maxSqDist ) const {
+        Scalar sqDist = maxSqDist;
+        if ( m_nodes.empty() ) { return sqDist; }
+        uint stack[64];
+        int top      = 0;
+        stack[top++] = 0;
+        while ( top > 0 )
+        {
+            const uint n     = stack[--top];
+            const auto& node = m_nodes[n];
+            if ( node.aabb.squaredExteriorDistance( q ) >= sqDist ) { continue; }
+            if ( node.right == 0 )
+            {
+                for ( uint i = node.begin; i < node.end; ++i )
+                {
+                    const auto& t  = m_T[m_order[i]];
+                    const auto res = pointToTriSq( q, m_p[t( 0 )], m_p[t( 1 )], m_p[t( 2 )] );
+                    sqDist         = std::min( sqDist, res.distanceSquared );
+                }
+                continue;
+            }
+            // nearest child first
+            const Scalar dLeft  = m_nodes[n + 1].aabb.squaredExteriorDistance( q );
+            const Scalar dRight = m_nodes[node.right].aabb.squaredExteriorDistance( q );
+            stack[top++]        = dLeft <= dRight ? node.right : n + 1;
+            stack[top++]        = dLeft <= dRight ? n + 1 : node.right;
+        }
+        return sqDist;
+    }
+
+    /// Generalized winding number of the mesh at q.
+    Scalar windingNumber( const Vector3& q ) const {
+        Scalar angle = 0;
+        if ( m_nodes.empty() ) { return angle; }
+        uint stack[64];
+        int top      = 0;
+        stack[top++] = 0;
+        while ( top > 0 )
+        {
+            const uint n     = stack[--top];
+            const auto& node = m_nodes[n];
+            const Vector3 d  = node.center - q;
+            const Scalar l   = d.norm();
+            if ( l > WindingAccuracy * node.radius )
+            { angle += node.areaNormal.dot( d ) / ( l * l * l ); }
+            else if ( node.right == 0 )
+            {
+                for ( uint i = node.begin; i < node.end; ++i )
+                {
+                    const auto& t = m_T[m_order[i]];
+                    angle += solidAngle( m_p[t( 0 )] - q, m_p[t( 1 )] - q, m_p[t( 2 )] - q );
+                }
+            }
+            else
+            {
+                stack[top++] = n + 1;
+                stack[top++] = node.right;
+            }
+        }
+        return angle / ( 4 * Math::Pi );
+    }
+
+    /// Fill \p out with the coordinates along axis \p a where the line
+    /// parallel to axis \p a through \p q crosses the mesh, sorted.
+    /// Points exactly on an edge or a vertex are counted once per sheet of
+    /// the mesh, consistently between neighbouring triangles.
+    void crossings( const Vector3& q, const int a, std::vector<Scalar>& out ) const {
+        out.clear();
+        if ( m_nodes.empty() ) { return; }
+        const int b = ( a + 1 ) % 3;
+        const int c = ( a + 2 ) % 3;
+        uint stack[64];
+        int top      = 0;
+        stack[top++] = 0;
+        while ( top > 0 )
+        {
+            const uint n     = stack[--top];
+            const auto& node = m_nodes[n];
+            if ( q( b ) < node.aabb.min()( b ) || q( b ) > node.aabb.max()( b ) ||
+                 q( c ) < node.aabb.min()( c ) || q( c ) > node.aabb.max()( c ) )
+            { continue; }
+            if ( node.right != 0 )
+            {
+                stack[top++] = n + 1;
+                stack[top++] = node.right;
+                continue;
+            }
+            for ( uint i = node.begin; i < node.end; ++i )
+            {
+                Scalar coord;
+                if ( axisLineCrossing( m_p, m_T[m_order[i]], a, q, coord ) )
+                { out.push_back( coord ); }
+            }
+        }
+        std::sort( out.begin(), out.end() );
+    }
+
+  private:
+    struct Node {
+        Aabb aabb;
+        uint begin;
+        uint end;
+        uint right;         // 0 for leaves, the left child follows its parent
+        Vector3 areaNormal; // sum of the triangle normals, weighted by their area
+        Vector3 center;     // barycenter of the triangles, weighted by their area
+        Scalar area;
+        Scalar radius; // of the ball centered on center which holds the node
+    };
+
+    uint build( const uint begin, const uint end, const Vector3Array& centroids ) {
+        const uint n = uint( m_nodes.size() );
+        m_nodes.emplace_back();
+        Node node;
+        node.begin = begin;
+        node.end   = end;
+        node.right = 0;
+        if ( end - begin <= BvhLeafSize )
+        {
+            node.areaNormal = Vector3::Zero();
+            node.center     = Vector3::Zero();
+            node.area       = 0;
+            for ( uint i = begin; i < end; ++i )
+            {
+                const auto& t     = m_T[m_order[i]];
+                const Vector3& p0 = m_p[t( 0 )];
+                const Vector3& p1 = m_p[t( 1 )];
+                const Vector3& p2 = m_p[t( 2 )];
+                node.aabb.extend( p0 );
+                node.aabb.extend( p1 );
+                node.aabb.extend( p2 );
+                const Vector3 an  = ( p1 - p0 ).cross( p2 - p0 ) / 2;
+                const Scalar area = an.norm();
+                node.areaNormal += an;
+                node.center += area * centroids[m_order[i]];
+                node.area += area;
+            }
+            node.center = node.area > 0 ? Vector3( node.center / node.area ) : node.aabb.center();
+        }
+        else
+        {
+            // median split along the largest extent of the centroids
+            Aabb box;
+            for ( uint i = begin; i < end; ++i )
+            {
+                box.extend( centroids[m_order[i]] );
+            }
+            int axis;
+            box.sizes().maxCoeff( &axis );
+            const uint mid = ( begin + end ) / 2;
+            std::nth_element( m_order.begin() + begin,
+                              m_order.begin() + mid,
+                              m_order.begin() + end,
+                              [&centroids, axis]( uint i, uint j ) {
+                                  return centroids[i]( axis ) < centroids[j]( axis );
+                              } );
+            const uint left  = build( begin, mid, centroids );
+            const uint right = build( mid, end, centroids );
+            const Node& l    = m_nodes[left];
+            const Node& r    = m_nodes[right];
+            node.right       = right;
+            node.aabb        = l.aabb.merged( r.aabb );
+            node.areaNormal  = l.areaNormal + r.areaNormal;
+            node.area        = l.area + r.area;
+            node.center      = node.area > 0 ? Vector3( ( l.area * l.center + r.area * r.center ) /
+                                                   node.area )
+                                        : node.aabb.center();
+        }
+        node.radius = ( node.aabb.max() - node.center )
+                          .cwiseAbs()
+                          .cwiseMax( ( node.center - node.aabb.min() ).cwiseAbs() )
+                          .norm();
+        m_nodes[n] = node;
+        return n;
+    }
+
+    const Vector3Array& m_p;
+    const AlignedStdVector<Vector3ui>& m_T;
+    std::vector<uint> m_order;
+    std::vector<Node> m_nodes;
+};
+
+inline Vector3
+samplePosition( const Vector3& origin, const Vector3& binSize, int x, int y, int z ) {
+    const Vector3 s( Scalar( x ) + 0.5_ra, Scalar( y ) + 0.5_ra, Scalar( z ) + 0.5_ra );
+    return origin + s.cwiseProduct( binSize );
+}
+
+// Return true if at least two of the three axis aligned lines through q cross
+// the mesh an odd number of times before q.
+bool parityInside( const TriangleHierarchy& bvh, const Vector3& q, std::vector<Scalar>& hits ) {
+    int votes = 0;
+    for ( int a = 0; a < 3; ++a )
+    {
+        bvh.crossings( q, a, hits );
+        const auto before = std::lower_bound( hits.begin(), hits.end(), q( a ) ) - hits.begin();
+        if ( before % 2 == 1 ) { ++votes; }
+    }
+    return votes >= 2;
+}
+
+} // namespace
+
+void bakeSignedDistance( const TriangleMesh& mesh,
+                         VolumeGrid& grid,
+                         const SignMethod method,
+                         const Scalar narrowBand,
+                         const Vector3& origin ) {
+    const Vector3i n = grid.size();
+    auto& data       = grid.data();
+    CORE_ASSERT( data.size() == size_t( n.prod() ), "Grid storage does not match its size" );
+    const Vector3 binSize = grid.binSize();
+    const TriangleHierarchy bvh( mesh.vertices(), mesh.m_indices );
+    const Scalar far   = narrowBand > 0 ? narrowBand : std::numeric_limits<Scalar>::max();
+    const Scalar maxSq = narrowBand > 0 ? narrowBand * narrowBand : far;
+    auto index         = [&n]( int x, int y, int z ) {
+        return size_t( x ) + size_t( n( 0 ) ) * ( size_t( y ) + size_t( n( 1 ) ) * size_t( z ) );
+    };
+
+    // parity votes, one line at a time along each axis
+    std::vector<std::uint8_t> votes;
+    if ( method == SignMethod::RAY_PARITY )
+    {
+        votes.resize( data.size(), 0 );
+        for ( int a = 0; a < 3; ++a )
+        {
+            const int b       = ( a + 1 ) % 3;
+            const int c       = ( a + 2 ) % 3;
+            const int nbLines = n( b ) * n( c );
+#pragma omp parallel for schedule( dynamic, 16 )
+            for ( int line = 0; line < nbLines; ++line )
+            {
+                std::vector<Scalar> hits;
+                Vector3i s;
+                s( a ) = 0;
+                s( b ) = line % n( b );
+                s( c ) = line / n( b );
+                bvh.crossings( samplePosition( origin, binSize, s( 0 ), s( 1 ), s( 2 ) ), a, hits );
+                size_t before = 0;
+                for ( s( a ) = 0; s( a ) < n( a ); ++s( a ) )
+                {
+                    const Scalar x = samplePosition( origin, binSize, s( 0 ), s( 1 ), s( 2 ) )( a );
+                    while ( before < hits.size() && hits[before] < x )
+                    {
+                        ++before;
+                    }
+                    if ( before % 2 == 1 ) { ++votes[index( s( 0 ), s( 1 ), s( 2 ) )]; }
+                }
+            }
+        }
+    }
+
+    const int nbLines = n( 1 ) * n( 2 );
+#pragma omp parallel for schedule( dynamic, 16 )
+    for ( int line = 0; line < nbLines; ++line )
+    {
+        const int y = line % n( 1 );
+        const int z = line / n( 1 );
+        for ( int x = 0; x < n( 0 ); ++x )
+        {
+            const Vector3 q     = samplePosition( origin, binSize, x, y, z );
+            const size_t i      = index( x, y, z );
+            const Scalar sqDist = bvh.closest( q, maxSq );
+            const Scalar d      = sqDist < maxSq ? std::sqrt( sqDist ) : far;
+            const bool inside   = method == SignMethod::RAY_PARITY ? votes[i] >= 2
+                                                                 : bvh.windingNumber( q ) > 0.5_ra;
+            data[i] = inside ? -d : d;
+        }
+    }
+}
+
+void bakeSignedDistance( const TriangleMesh& mesh,
+                         VolumeSparse& volume,
+                         const Scalar narrowBand,
+                         const SignMethod method,
+                         const Vector3& origin ) {
+    CORE_ASSERT( narrowBand > 0, "The narrow band must not be empty" );
+    const Vector3i n      = volume.size();
+    const Vector3 binSize = volume.binSize();
+    const TriangleHierarchy bvh( mesh.vertices(), mesh.m_indices );
+    const Scalar maxSq = narrowBand * narrowBand;
+
+    // samples of each layer, concatenated in order afterwards
+    std::vector<VolumeSparse::Container> layers( size_t( n( 2 ) ) );
+#pragma omp parallel for schedule( dynamic )
+    for ( int z = 0; z < n( 2 ); ++z )
+    {
+        std::vector<Scalar> hits;
+        for ( int y = 0; y < n( 1 ); ++y )
+        {
+            for ( int x = 0; x < n( 0 ); ++x )
+            {
+                const Vector3 q     = samplePosition( origin, binSize, x, y, z );
+                const Scalar sqDist = bvh.closest( q, maxSq );
+                if ( sqDist >= maxSq ) { continue; }
+                const bool inside = method == SignMethod::RAY_PARITY
+                                        ? parityInside( bvh, q, hits )
+                                        : bvh.windingNumber( q ) > 0.5_ra;
+                const Scalar d = std::sqrt( sqDist );
+                const size_t row   = size_t( y ) + size_t( n( 1 ) ) * size_t( z );
+                const size_t index = size_t( x ) + size_t( n( 0 ) ) * row;
+                layers[z].emplace_back( index, inside ? -d : d );
+            }
+        }
+    }
+
+    auto& data = volume.data();
+    data.clear();
+    for ( const auto& layer : layers )
+    {
+        data.insert( data.end(), layer.begin(), layer.end() );
+    }
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
@@ -0,0 +1,62 @@
+#ifndef RADIUMENGINE_SIGNED_DISTANCE_HPP_
+#define RADIUMENGINE_SIGNED_DISTANCE_HPP_
+
+#include <Core/Geometry/TriangleMesh.hpp>
+#include <Core/Geometry/Volume.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/**
+ * Signed distance fields of triangle meshes, baked into discrete volumes.
+ *
+ * Sample ( i, j, k ) of the volume is located at
+ * origin + ( ( i, j, k ) + 0.5 ) * binSize, as for extractIsoSurface(). Its
+ * value is the distance to the closest triangle, negative inside the mesh.
+ * The size and bin size of the volume must be set before baking.
+ *
+ * The closest triangles are found with a bounding volume hierarchy of the
+ * triangles, and the samples are processed in parallel.
+ *
+ * The fast winding number approximation was taken from:
+ * "Fast Winding Numbers for Soups and Clouds"
+ * [ Gavin Barill, Neil G. Dickson, Ryan Schmidt, David I.W. Levin, Alec Jacobson ]
+ * ACM Transactions on Graphics (SIGGRAPH 2018)
+ **/
+
+/// Inside / outside classification of the samples.
+enum class SignMethod {
+    /// Inside if the generalized winding number of the mesh is greater than
+    /// 1/2. Robust to holes, self intersections and non manifold meshes.
+    WINDING_NUMBER,
+    /// Inside if at least two of the three axis aligned lines through the
+    /// sample cross the mesh an odd number of times before it. Faster, but
+    /// requires a closed mesh.
+    RAY_PARITY
+};
+
+/// Fill \p grid with the signed distance to \p mesh.
+/// If \p narrowBand is greater than 0, the distances are clamped to
+/// [ -narrowBand; narrowBand ], which bounds the closest triangle searches.
+RA_CORE_API void bakeSignedDistance( const TriangleMesh& mesh,
+                                     VolumeGrid& grid,
+                                     SignMethod method     = SignMethod::WINDING_NUMBER,
+                                     Scalar narrowBand     = 0,
+                                     const Vector3& origin = Vector3::Zero() );
+
+/// Fill \p volume with the signed distance to \p mesh, keeping only the
+/// samples closer than \p narrowBand to the mesh (in increasing index order).
+RA_CORE_API void bakeSignedDistance( const TriangleMesh& mesh,
+                                     VolumeSparse& volume,
+                                     Scalar narrowBand,
+                                     SignMethod method     = SignMethod::WINDING_NUMBER,
+                                     const Vector3& origin = Vector3::Zero() );
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_SIGNED_DISTANCE_HPP_
@@ -14,6 +14,11 @@ namespace Geometry {
  * @brief Handling spline curves of arbitrary dimensions
  * @note This class use the efficient blossom algorithm to compute a position on
  * the curve.
+ * To sample many parameters, the batch versions of f() and df() compute once
+ * the values of the basis functions at each parameter (see BasisTable), and
+ * then evaluate all the samples in parallel. The table only depends on the
+ * nodal vector, so it can be reused as long as the number of control points
+ * and the type do not change, e.g. to resample a deforming curve.
  * @tparam D : dimension of the curve.
  * @tparam K  :order of the curve (min 2)
  */
@@ -28,6 +33,19 @@ class Spline
 
     using Vector = typename Eigen::Matrix<Scalar, D, 1>;
 
+    /// Values of the basis functions of the spline at a set of parameters.
+    /// Sample j depends on the control points [ span[j], span[j] + K ), with
+    /// the weights in the j-th column of position, and on the control point
+    /// differences [ span[j], span[j] + K - 1 ) for the speed.
+    struct BasisTable {
+        std::vector<uint> span;
+        Eigen::Matrix<Scalar, K, Eigen::Dynamic> position;
+        Eigen::Matrix<Scalar, K - 1, Eigen::Dynamic> speed;
+        /// Size and type of the nodal vector the table has been computed with.
+        size_t nodeSize{0};
+        Type type{OPEN_UNIFORM};
+    };
+
   public:
     /// Type of the nodal vector
     /// @param type : nodal vector type (uniform, open_uniform)
@@ -51,6 +69,21 @@ class Spline
     /// Evaluate speed of the spline
     inline Vector df( Scalar u ) const;
 
+    /// Compute the basis functions values at each parameter of \p u, clamped
+    /// to [0; 1]. The span search is incremental, so it is linear in the
+    /// number of samples and control points when \p u is sorted.
+    inline void computeBasis( const std::vector<Scalar>& u, BasisTable& table ) const;
+
+    /// \name Batch evaluation
+    /// Evaluate position or speed of the spline at all the parameters of the
+    /// table, or at all the (preferably sorted) parameters \p u.
+    /// \{
+    inline void f( const BasisTable& table, Core::VectorArray<Vector>& out ) const;
+    inline void df( const BasisTable& table, Core::VectorArray<Vector>& out ) const;
+    inline void f( const std::vector<Scalar>& u, Core::VectorArray<Vector>& out ) const;
+    inline void df( const std::vector<Scalar>& u, Core::VectorArray<Vector>& out ) const;
+    /// \}
+
   private:
     // -------------------------------------------------------------------------
     /// @name Class tools
@@ -84,10 +117,15 @@ class Spline
                                uint k,
                                int off = 0 );
 
-    static inline Vector evalRec( Scalar u,
-                                  const Core::VectorArray<Vector>& points,
-                                  const std::vector<Scalar>& node,
-                                  uint k );
+    /// Compute the k basis functions of order k which are not null at u, for
+    /// the span starting at control point dec (as found by eval()), with the
+    /// triangular Cox-de Boor scheme.
+    template <uint k>
+    static inline void basis( Scalar u,
+                              const std::vector<Scalar>& node,
+                              uint dec,
+                              int off,
+                              Scalar* out );
 
     // -------------------------------------------------------------------------
     /// @name attributes
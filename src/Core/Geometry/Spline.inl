@@ -3,6 +3,7 @@
 #include <Core/Math/Math.hpp>
 
 #include <algorithm>
+#include <array>
 
 namespace Ra {
 namespace Core {
@@ -138,57 +139,163 @@ inline typename Spline<D, K>::Vector Spline<D, K>::eval( Scalar u,
     CORE_ASSERT( k >= 2, "K must be at least 2" );
     CORE_ASSERT( points.size() >= k, "Not enough points" );
     uint dec = 0;
-    // TODO: better search with dichotomy ?
     // TODO: check for overflow
     while ( u > node[dec + k + off] )
     {
         dec++;
     }
 
-    // TODO: use buffers in attributes for better performances ?
-    Core::VectorArray<Vector> pOut( k, Vector::Zero() );
-    for ( uint i = dec, j = 0; i < ( dec + k ); ++i, ++j )
+    // iterative blossom, in place on the k control points of the span: at
+    // level r, the nodes of the span are node[dec + 1 + off + r .. dec + 2k - 2 + off - r]
+    std::array<Vector, K> p;
+    for ( uint i = 0; i < k; ++i )
     {
-        pOut[j] = points[i];
+        p[i] = points[dec + i];
     }
-
-    std::vector<Scalar> nodeOut( k + k - 2, Scalar( 0 ) );
-    for ( uint i = ( dec + 1 ), j = 0; i < ( dec + k + k - 1 ); ++i, ++j )
+    const Scalar* n = node.data() + dec + 1 + off;
+    for ( uint r = 0; r < k - 1; ++r )
     {
-        nodeOut[j] = node[i + off];
+        for ( uint i = 0; i < ( k - 1 - r ); ++i )
+        {
+            const Scalar n0 = n[i + k - 1];
+            const Scalar n1 = n[i + r];
+            const Scalar f0 = ( n0 - u ) / ( n0 - n1 );
+            const Scalar f1 = ( u - n1 ) / ( n0 - n1 );
+
+            p[i] = p[i] * f0 + p[i + 1] * f1;
+        }
     }
-    return evalRec( u, pOut, nodeOut, k );
+    return p[0];
 }
 
 // -----------------------------------------------------------------------------
 
 template <uint D, uint K>
-inline typename Spline<D, K>::Vector Spline<D, K>::evalRec( Scalar u,
-                                                            const Core::VectorArray<Vector>& points,
-                                                            const std::vector<Scalar>& node,
-                                                            uint k ) {
-    if ( points.size() == 1 ) { return points[0]; }
+template <uint k>
+inline void Spline<D, K>::basis( Scalar u,
+                                 const std::vector<Scalar>& node,
+                                 uint dec,
+                                 int off,
+                                 Scalar* out ) {
+    // "The NURBS Book" (Piegl & Tiller), algorithm A2.2, on the span
+    // [ node[s]; node[s + 1] ] which holds u
+    const uint s = dec + k - 1 + off;
+    std::array<Scalar, k> left;
+    std::array<Scalar, k> right;
+    out[0] = 1;
+    for ( uint j = 1; j < k; ++j )
+    {
+        left[j]      = u - node[s + 1 - j];
+        right[j]     = node[s + j] - u;
+        Scalar saved = 0;
+        for ( uint r = 0; r < j; ++r )
+        {
+            const Scalar tmp = out[r] / ( right[r + 1] + left[j - r] );
+            out[r]           = saved + right[r + 1] * tmp;
+            saved            = left[j - r] * tmp;
+        }
+        out[j] = saved;
+    }
+}
 
-    // TODO: use buffers in attributes for better performances ?
-    Core::VectorArray<Vector> pOut( k - 1, Vector::Zero() );
+// -----------------------------------------------------------------------------
 
-    for ( uint i = 0; i < ( k - 1 ); ++i )
+template <uint D, uint K>
+inline void Spline<D, K>::computeBasis( const std::vector<Scalar>& u, BasisTable& table ) const {
+    const int size = int( u.size() );
+    table.span.resize( u.size() );
+    table.position.resize( K, size );
+    table.speed.resize( K - 1, size );
+    table.nodeSize = m_node.size();
+    table.type     = m_type;
+
+    // walk the nodal vector along the parameters, restarting from the first
+    // span when they are not sorted
+    uint dec    = 0;
+    Scalar prev = 0;
+    for ( int j = 0; j < size; ++j )
     {
-        const Scalar n0 = node[i + k - 1];
-        const Scalar n1 = node[i];
-        const Scalar f0 = ( n0 - u ) / ( n0 - n1 );
-        const Scalar f1 = ( u - n1 ) / ( n0 - n1 );
+        const Scalar t = std::clamp( u[j], Scalar( 0 ), Scalar( 1 ) );
+        if ( t < prev ) { dec = 0; }
+        while ( t > m_node[dec + K] )
+        {
+            dec++;
+        }
+        table.span[j] = dec;
+        prev          = t;
+    }
 
-        pOut[i] = points[i] * f0 + points[i + 1] * f1;
+#pragma omp parallel for
+    for ( int j = 0; j < size; ++j )
+    {
+        const Scalar t = std::clamp( u[j], Scalar( 0 ), Scalar( 1 ) );
+        basis<K>( t, m_node, table.span[j], 0, table.position.col( j ).data() );
+        basis<K - 1>( t, m_node, table.span[j], 1, table.speed.col( j ).data() );
     }
+}
 
-    std::vector<Scalar> nodeOut( node.size() - 2 );
+// -----------------------------------------------------------------------------
 
-    for ( uint i = 1; i < node.size() - 1; ++i )
+template <uint D, uint K>
+inline void Spline<D, K>::f( const BasisTable& table,
+                             Core::VectorArray<typename Spline<D, K>::Vector>& out ) const {
+    CORE_ASSERT( table.nodeSize == m_node.size() && table.type == m_type,
+                 "Basis table computed for another nodal vector" );
+    const int size = int( table.span.size() );
+    out.resize( table.span.size() );
+#pragma omp parallel for
+    for ( int j = 0; j < size; ++j )
     {
-        nodeOut[i - 1] = node[i];
+        const uint dec = table.span[j];
+        Vector p       = Vector::Zero();
+        for ( uint r = 0; r < K; ++r )
+        {
+            p += table.position( r, j ) * m_points[dec + r];
+        }
+        out[j] = p;
     }
-    return evalRec( u, pOut, nodeOut, k - 1 );
+}
+
+// -----------------------------------------------------------------------------
+
+template <uint D, uint K>
+inline void Spline<D, K>::df( const BasisTable& table,
+                              Core::VectorArray<typename Spline<D, K>::Vector>& out ) const {
+    CORE_ASSERT( table.nodeSize == m_node.size() && table.type == m_type,
+                 "Basis table computed for another nodal vector" );
+    const int size = int( table.span.size() );
+    out.resize( table.span.size() );
+#pragma omp parallel for
+    for ( int j = 0; j < size; ++j )
+    {
+        const uint dec = table.span[j];
+        Vector v       = Vector::Zero();
+        for ( uint r = 0; r < K - 1; ++r )
+        {
+            v += table.speed( r, j ) * m_vecs[dec + r];
+        }
+        out[j] = v * Scalar( K - 1 );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+template <uint D, uint K>
+inline void Spline<D, K>::f( const std::vector<Scalar>& u,
+                             Core::VectorArray<typename Spline<D, K>::Vector>& out ) const {
+    BasisTable table;
+    computeBasis( u, table );
+    f( table, out );
+}
+
+// -----------------------------------------------------------------------------
+
+template <uint D, uint K>
+inline void Spline<D, K>::df( const std::vector<Scalar>& u,
+                              Core::VectorArray<typename Spline<D, K>::Vector>& out ) const {
+    BasisTable table;
+    computeBasis( u, table );
+    df( table, out );
 }
 } // namespace Geometry
 } // namespace Core
@@ -1,6 +1,8 @@
 #include <Core/Geometry/TriangleOperation.hpp>
 #include <Core/Math/LinearAlgebra.hpp> // Math::angle
 
+#include <algorithm>
+
 namespace Ra {
 namespace Core {
 namespace Geometry {
@@ -67,6 +69,79 @@ barycentricCoordinate( const Vector3& v, const Vector3& p, const Vector3& q, con
     return result;
 }
 
+bool triangleBoxOverlap( const Vector3& p, const Vector3& q, const Vector3& r, const Aabb& box ) {
+    const Vector3 c = box.center();
+    const Vector3 h = box.max() - c;
+    const Vector3 v[3]{p - c, q - c, r - c};
+
+    // axes of the box
+    for ( int a = 0; a < 3; ++a )
+    {
+        if ( std::min( {v[0]( a ), v[1]( a ), v[2]( a )} ) > h( a ) ||
+             std::max( {v[0]( a ), v[1]( a ), v[2]( a )} ) < -h( a ) )
+        { return false; }
+    }
+
+    // projections on axis n are separated if they do not overlap
+    const auto separated = [&v, &h]( const Vector3& n ) {
+        const Scalar p0 = n.dot( v[0] );
+        const Scalar p1 = n.dot( v[1] );
+        const Scalar p2 = n.dot( v[2] );
+        const Scalar e  = h.dot( n.cwiseAbs() );
+        return std::min( {p0, p1, p2} ) > e || std::max( {p0, p1, p2} ) < -e;
+    };
+
+    // normal of the triangle, then cross products of its edges with the axes
+    const Vector3 f[3]{v[1] - v[0], v[2] - v[1], v[0] - v[2]};
+    if ( separated( f[0].cross( f[1] ) ) ) { return false; }
+    for ( const auto& e : f )
+    {
+        if ( separated( Vector3( 0, -e( 2 ), e( 1 ) ) ) ||
+             separated( Vector3( e( 2 ), 0, -e( 0 ) ) ) ||
+             separated( Vector3( -e( 1 ), e( 0 ), 0 ) ) )
+        { return false; }
+    }
+    return true;
+}
+
+namespace {
+// Edge function of the segment v0 v1 at q, in the plane of axes b and c,
+// computed in the same order for both orientations of the edge.
+inline Scalar edgeFunction( const Vector3Array& p,
+                            const uint v0,
+                            const uint v1,
+                            const int b,
+                            const int c,
+                            const Vector3& q ) {
+    if ( v0 > v1 ) { return -edgeFunction( p, v1, v0, b, c, q ); }
+    return ( p[v1]( b ) - p[v0]( b ) ) * ( q( c ) - p[v0]( c ) ) -
+           ( p[v1]( c ) - p[v0]( c ) ) * ( q( b ) - p[v0]( b ) );
+}
+} // namespace
+
+bool axisLineCrossing(
+    const Vector3Array& p, const Vector3ui& T, const int a, const Vector3& q, Scalar& coord ) {
+    const int b = ( a + 1 ) % 3;
+    const int c = ( a + 2 ) % 3;
+    Scalar w[3];
+    int positive = 0;
+    for ( int k = 0; k < 3; ++k )
+    {
+        // edge opposite to vertex k, a zero edge function counts as positive on
+        // one side of the edge only (top-left rule)
+        const uint v0   = T( ( k + 1 ) % 3 );
+        const uint v1   = T( ( k + 2 ) % 3 );
+        const Scalar dx = p[v1]( b ) - p[v0]( b );
+        const Scalar dy = p[v1]( c ) - p[v0]( c );
+        w[k]            = edgeFunction( p, v0, v1, b, c, q );
+        if ( w[k] > 0 || ( w[k] == 0 && ( dy > 0 || ( dy == 0 && dx > 0 ) ) ) ) { ++positive; }
+    }
+    const Scalar sum = w[0] + w[1] + w[2];
+    if ( ( positive != 0 && positive != 3 ) || sum == 0 ) { return false; }
+    coord = ( w[0] * p[T( 0 )]( a ) + w[1] * p[T( 1 )]( a ) + w[2] * p[T( 2 )]( a ) ) / sum;
+    return true;
+}
+
 } // namespace Geometry
 } // namespace Core
 } // namespace Ra
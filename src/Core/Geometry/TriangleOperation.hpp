@@ -1,6 +1,7 @@
 #ifndef TRIANGLE_OPERATION
 #define TRIANGLE_OPERATION
 
+#include <Core/Containers/VectorArray.hpp>
 #include <Core/Types.hpp>
 
 namespace Ra {
@@ -59,6 +60,29 @@ RA_CORE_API Vector3 barycentricCoordinate( const Vector3& v,
                                            const Vector3& q,
                                            const Vector3& r );
 
+/*
+ * Return true if the triangle PQR overlaps the axis aligned box, including
+ * their boundaries, with the separating axis test of:
+ * "Fast 3D Triangle-Box Overlap Testing"
+ * [ Tomas Akenine-Moller ]
+ * Journal of Graphics Tools 2001
+ */
+RA_CORE_API bool
+triangleBoxOverlap( const Vector3& p, const Vector3& q, const Vector3& r, const Aabb& box );
+
+/*
+ * Return true if the line parallel to axis a through q crosses the triangle T
+ * of a mesh with vertices p, and set coord to the coordinate along axis a of
+ * the crossing.
+ *
+ * The edge functions are evaluated in the order of the vertex indices, so
+ * that neighbouring triangles agree exactly: a line through an edge or a
+ * vertex crosses each sheet of a closed mesh once, which makes parity tests
+ * watertight.
+ */
+RA_CORE_API bool axisLineCrossing(
+    const Vector3Array& p, const Vector3ui& T, int a, const Vector3& q, Scalar& coord );
+
 } // namespace Geometry
 } // namespace Core
 } // namespace Ra
@@ -242,10 +242,10 @@ class RA_CORE_API VolumeSparse : public AbstractDiscreteVolume
     using ValueType = AbstractDiscreteVolume::ValueType;
     using IndexType = AbstractDiscreteVolume::IndexType;
     struct SampleType {
-        int index;
+        size_t index;
         ValueType value;
 
-        inline SampleType( int idx, const ValueType& v ) : index( idx ), value( v ) {}
+        inline SampleType( size_t idx, const ValueType& v ) : index( idx ), value( v ) {}
     };
     using Container = std::vector<SampleType>;
 
@@ -258,6 +258,12 @@ class RA_CORE_API VolumeSparse : public AbstractDiscreteVolume
     using AbstractDiscreteVolume::addToBin;
     using AbstractDiscreteVolume::getBinValue;
 
+    /// Direct access to the managed samples
+    inline const Container& data() const { return m_data; }
+    /// Direct access, with modification allowed to the managed samples.
+    /// \warning each bin must be stored at most once
+    inline Container& data() { return m_data; }
+
   protected:
     /** Get the function value at a given position p (if the bin exists)
      *
@@ -283,7 +289,7 @@ class RA_CORE_API VolumeSparse : public AbstractDiscreteVolume
         if ( res != std::end( m_data ) )
             res->value += value;
         else
-            m_data.emplace_back( idx, value );
+            m_data.emplace_back( size_t( idx ), value );
     }
 
     inline void updateStorage() override { m_data.clear(); }
@@ -292,12 +298,12 @@ class RA_CORE_API VolumeSparse : public AbstractDiscreteVolume
     inline Container::iterator findBin( typename IndexType::Scalar idx ) {
         return std::find_if( std::begin( m_data ),
                              std::end( m_data ),
-                             [&idx]( const SampleType& s ) { return s.index == idx; } );
+                             [&idx]( const SampleType& s ) { return s.index == size_t( idx ); } );
     }
     inline Container::const_iterator findBin( typename IndexType::Scalar idx ) const {
         return std::find_if( std::begin( m_data ),
                              std::end( m_data ),
-                             [&idx]( const SampleType& s ) { return s.index == idx; } );
+                             [&idx]( const SampleType& s ) { return s.index == size_t( idx ); } );
     }
 
   private:
@@ -0,0 +1,394 @@
+#include <Core/Geometry/Voxelization.hpp>
+
+#include <Core/Geometry/TriangleOperation.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+namespace {
+
+// Number of voxels along each side of the tiles processed by each task.
+constexpr int TileSize = 32;
+
+// Minimal number of triangles per task of the binning, and maximal number of
+// tasks, which bounds the memory of the tile counts of the tasks.
+constexpr int BinChunkSize = 1 << 14;
+constexpr int MaxBinChunks = 64;
+
+// Vertices of the mesh in voxel coordinates, where voxel ( i, j, k ) is the
+// unit cube at ( i, j, k ) and its sample is at its center.
+Vector3Array
+voxelCoordinates( const TriangleMesh& mesh, const Vector3& binSize, const Vector3& origin ) {
+    const auto& vertices = mesh.vertices();
+    const int n          = int( vertices.size() );
+    Vector3Array p( vertices.size() );
+#pragma omp parallel for
+    for ( int i = 0; i < n; ++i )
+    {
+        p[i] = ( vertices[i] - origin ).cwiseQuotient( binSize );
+    }
+    return p;
+}
+
+inline Aabb triangleBounds( const Vector3Array& p, const Vector3ui& t ) {
+    Aabb box( p[t( 0 )] );
+    box.extend( p[t( 1 )] );
+    box.extend( p[t( 2 )] );
+    return box;
+}
+
+// Triangles overlapping each tile, in increasing order.
+struct TileBins {
+    Vector3i count;            // number of tiles along each axis
+    std::vector<uint> offsets; // first triangle of each tile
+    std::vector<uint> triangles;
+
+    int size() const { return count.prod(); }
+
+    Vector3i tile( const int i ) const {
+        return {i % count( 0 ), ( i / count( 0 ) ) % count( 1 ), i / ( count( 0 ) * count( 1 ) )};
+    }
+};
+
+// Bin the triangles into tiles, where range( t, lo, hi ) sets the first and
+// last voxels covered by triangle t, and returns false if it covers none.
+template <typename Range>
+TileBins binTriangles( const int nbTriangles, const Vector3i& count, const Range& range ) {
+    TileBins bins;
+    bins.count = count;
+
+    // tiles covered by each triangle, empty when lo > hi
+    std::vector<Vector3i> lo( size_t( nbTriangles ), Vector3i::Ones() );
+    std::vector<Vector3i> hi( size_t( nbTriangles ), Vector3i::Zero() );
+#pragma omp parallel for
+    for ( int t = 0; t < nbTriangles; ++t )
+    {
+        Vector3i first;
+        Vector3i last;
+        if ( range( t, first, last ) )
+        {
+            lo[t] = first / TileSize;
+            hi[t] = last / TileSize;
+        }
+    }
+
+    const auto forEachTile = [&count, &lo, &hi]( const int t, auto f ) {
+        for ( int z = lo[t]( 2 ); z <= hi[t]( 2 ); ++z )
+        {
+            for ( int y = lo[t]( 1 ); y <= hi[t]( 1 ); ++y )
+            {
+                for ( int x = lo[t]( 0 ); x <= hi[t]( 0 ); ++x )
+                {
+                    f( x + count( 0 ) * ( y + count( 1 ) * z ) );
+                }
+            }
+        }
+    };
+
+    // counting sort by tile of contiguous chunks of triangles, each chunk
+    // writing its triangles after the ones of the previous chunks
+    const int chunks    = ( nbTriangles + BinChunkSize - 1 ) / BinChunkSize;
+    const int nbChunks  = std::max( std::min( chunks, MaxBinChunks ), 1 );
+    const int chunkSize = ( nbTriangles + nbChunks - 1 ) / nbChunks;
+    const int nbTiles   = bins.size();
+    std::vector<uint> next( size_t( nbChunks ) * size_t( nbTiles ), 0 );
+#pragma omp parallel for
+    for ( int c = 0; c < nbChunks; ++c )
+    {
+        uint* counts  = next.data() + size_t( c ) * size_t( nbTiles );
+        const int end = std::min( nbTriangles, ( c + 1 ) * chunkSize );
+        for ( int t = c * chunkSize; t < end; ++t )
+        {
+            forEachTile( t, [counts]( int i ) { ++counts[i]; } );
+        }
+    }
+
+    bins.offsets.assign( size_t( nbTiles ) + 1, 0 );
+#pragma omp parallel for
+    for ( int i = 0; i < nbTiles; ++i )
+    {
+        for ( int c = 0; c < nbChunks; ++c )
+        {
+            bins.offsets[i + 1] += next[size_t( c ) * size_t( nbTiles ) + size_t( i )];
+        }
+    }
+    for ( int i = 0; i < nbTiles; ++i )
+    {
+        bins.offsets[i + 1] += bins.offsets[i];
+    }
+#pragma omp parallel for
+    for ( int i = 0; i < nbTiles; ++i )
+    {
+        uint offset = bins.offsets[i];
+        for ( int c = 0; c < nbChunks; ++c )
+        {
+            uint& start      = next[size_t( c ) * size_t( nbTiles ) + size_t( i )];
+            const uint count = start;
+            start            = offset;
+            offset += count;
+        }
+    }
+
+    bins.triangles.resize( bins.offsets.back() );
+#pragma omp parallel for
+    for ( int c = 0; c < nbChunks; ++c )
+    {
+        uint* first   = next.data() + size_t( c ) * size_t( nbTiles );
+        const int end = std::min( nbTriangles, ( c + 1 ) * chunkSize );
+        for ( int t = c * chunkSize; t < end; ++t )
+        {
+            forEachTile( t, [&bins, first, t]( int i ) {
+                bins.triangles[first[i]++] = uint( t );
+            } );
+        }
+    }
+    return bins;
+}
+
+// Call f( tile, x, y, z ) once for each voxel of a grid of size n overlapping
+// a triangle, in parallel over the tiles of voxels.
+template <typename F>
+void forEachSurfaceVoxel( const TriangleMesh& mesh,
+                          const Vector3i& n,
+                          const Vector3& binSize,
+                          const Vector3& origin,
+                          const F& f ) {
+    if ( ( n.array() <= 0 ).any() ) { return; }
+    const Vector3Array p = voxelCoordinates( mesh, binSize, origin );
+    const auto& T        = mesh.m_indices;
+    const Vector3 last   = ( n - Vector3i::Ones() ).cast<Scalar>();
+
+    // voxels are closed: a point on a face belongs to the voxels on both sides
+    const auto range = [&p, &T, &n, &last]( const int t, Vector3i& lo, Vector3i& hi ) {
+        const Aabb box = triangleBounds( p, T[t] );
+        if ( ( box.max().array() < 0 ).any() ||
+             ( box.min().array() > n.cast<Scalar>().array() ).any() )
+        { return false; }
+        lo = ( box.min().array().ceil() - 1 ).max( 0 ).cast<int>();
+        hi = box.max().array().floor().min( last.array() ).cast<int>();
+        return true;
+    };
+    const TileBins bins =
+        binTriangles( int( T.size() ), ( n.array() + TileSize - 1 ) / TileSize, range );
+
+#pragma omp parallel for schedule( dynamic )
+    for ( int i = 0; i < bins.size(); ++i )
+    {
+        if ( bins.offsets[i] == bins.offsets[i + 1] ) { continue; }
+        const Vector3i first = bins.tile( i ) * TileSize;
+        const Vector3i end   = ( first.array() + TileSize ).min( n.array() );
+        std::vector<std::uint8_t> marked( size_t( TileSize * TileSize * TileSize ), 0 );
+        const auto local = [&first]( const int x, const int y, const int z ) {
+            return size_t( ( x - first( 0 ) ) +
+                           TileSize * ( ( y - first( 1 ) ) + TileSize * ( z - first( 2 ) ) ) );
+        };
+
+        for ( uint k = bins.offsets[i]; k < bins.offsets[i + 1]; ++k )
+        {
+            const auto& t = T[bins.triangles[k]];
+            Vector3i lo;
+            Vector3i hi;
+            range( int( bins.triangles[k] ), lo, hi );
+            lo = lo.cwiseMax( first );
+            hi = hi.cwiseMin( end - Vector3i::Ones() );
+            for ( int z = lo( 2 ); z <= hi( 2 ); ++z )
+            {
+                for ( int y = lo( 1 ); y <= hi( 1 ); ++y )
+                {
+                    for ( int x = lo( 0 ); x <= hi( 0 ); ++x )
+                    {
+                        auto& m = marked[local( x, y, z )];
+                        if ( m != 0 ) { continue; }
+                        const Vector3 corner = Vector3i( x, y, z ).cast<Scalar>();
+                        const Aabb voxel( corner, corner + Vector3::Ones() );
+                        if ( triangleBoxOverlap( p[t( 0 )], p[t( 1 )], p[t( 2 )], voxel ) )
+                        { m = 1; }
+                    }
+                }
+            }
+        }
+
+        for ( int z = first( 2 ); z < end( 2 ); ++z )
+        {
+            for ( int y = first( 1 ); y < end( 1 ); ++y )
+            {
+                for ( int x = first( 0 ); x < end( 0 ); ++x )
+                {
+                    if ( marked[local( x, y, z )] != 0 ) { f( i, x, y, z ); }
+                }
+            }
+        }
+    }
+}
+
+// Call f( tile, x, y, z ) once for each voxel of a grid of size n whose sample
+// is inside the mesh, in parallel over tiles of z columns of voxels.
+template <typename F>
+void forEachSolidVoxel( const TriangleMesh& mesh,
+                        const Vector3i& n,
+                        const Vector3& binSize,
+                        const Vector3& origin,
+                        const F& f ) {
+    if ( ( n.array() <= 0 ).any() ) { return; }
+    const Vector3Array p = voxelCoordinates( mesh, binSize, origin );
+    const auto& T        = mesh.m_indices;
+
+    // columns whose line goes through the bounding box of the triangle, the
+    // crossings outside of the grid along z count for the parity
+    const auto range = [&p, &T, &n]( const int t, Vector3i& lo, Vector3i& hi ) {
+        const Aabb box = triangleBounds( p, T[t] );
+        lo             = Vector3i::Zero();
+        hi             = Vector3i::Zero();
+        for ( int a = 0; a < 2; ++a )
+        {
+            const Scalar first = std::max( std::ceil( box.min()( a ) - 0.5_ra ), 0_ra );
+            const Scalar last =
+                std::min( std::floor( box.max()( a ) - 0.5_ra ), Scalar( n( a ) - 1 ) );
+            if ( first > last ) { return false; }
+            lo( a ) = int( first );
+            hi( a ) = int( last );
+        }
+        return true;
+    };
+    const Vector3i count(
+        ( n( 0 ) + TileSize - 1 ) / TileSize, ( n( 1 ) + TileSize - 1 ) / TileSize, 1 );
+    const TileBins bins = binTriangles( int( T.size() ), count, range );
+
+#pragma omp parallel for schedule( dynamic )
+    for ( int i = 0; i < bins.size(); ++i )
+    {
+        if ( bins.offsets[i] == bins.offsets[i + 1] ) { continue; }
+        const Vector3i first = bins.tile( i ) * TileSize;
+        const Vector3i end   = ( first.array() + TileSize ).min( n.array() );
+        std::vector<std::vector<Scalar>> crossings( size_t( TileSize * TileSize ) );
+        const auto local = [&first]( const int x, const int y ) {
+            return size_t( ( x - first( 0 ) ) + TileSize * ( y - first( 1 ) ) );
+        };
+
+        for ( uint k = bins.offsets[i]; k < bins.offsets[i + 1]; ++k )
+        {
+            Vector3i lo;
+            Vector3i hi;
+            range( int( bins.triangles[k] ), lo, hi );
+            lo = lo.cwiseMax( first );
+            hi = hi.cwiseMin( end - Vector3i::Ones() );
+            for ( int y = lo( 1 ); y <= hi( 1 ); ++y )
+            {
+                for ( int x = lo( 0 ); x <= hi( 0 ); ++x )
+                {
+                    const Vector3 q( Scalar( x ) + 0.5_ra, Scalar( y ) + 0.5_ra, 0_ra );
+                    Scalar z;
+                    if ( axisLineCrossing( p, T[bins.triangles[k]], 2, q, z ) )
+                    { crossings[local( x, y )].push_back( z ); }
+                }
+            }
+        }
+
+        // samples between consecutive pairs of crossings are inside, a sample
+        // on a crossing is inside if the line enters the mesh before it
+        for ( int y = first( 1 ); y < end( 1 ); ++y )
+        {
+            for ( int x = first( 0 ); x < end( 0 ); ++x )
+            {
+                auto& hits = crossings[local( x, y )];
+                std::sort( hits.begin(), hits.end() );
+                for ( size_t h = 0; h + 1 < hits.size(); h += 2 )
+                {
+                    const Scalar in  = std::floor( hits[h] - 0.5_ra ) + 1;
+                    const Scalar out = std::floor( hits[h + 1] - 0.5_ra ) + 1;
+                    const int zBegin = int( std::max( in, 0_ra ) );
+                    const int zEnd   = int( std::min( out, Scalar( n( 2 ) ) ) );
+                    for ( int z = zBegin; z < zEnd; ++z )
+                    {
+                        f( i, x, y, z );
+                    }
+                }
+            }
+        }
+    }
+}
+
+inline size_t gridIndex( const Vector3i& n, const int x, const int y, const int z ) {
+    return size_t( x ) + size_t( n( 0 ) ) * ( size_t( y ) + size_t( n( 1 ) ) * size_t( z ) );
+}
+
+// Concatenate the samples of the tiles into volume, in increasing index order.
+void gatherTiles( std::vector<VolumeSparse::Container>& tiles, VolumeSparse& volume ) {
+    size_t size = 0;
+    for ( const auto& tile : tiles )
+    {
+        size += tile.size();
+    }
+    auto& data = volume.data();
+    data.clear();
+    data.reserve( size );
+    for ( auto& tile : tiles )
+    {
+        data.insert( data.end(), tile.begin(), tile.end() );
+        VolumeSparse::Container().swap( tile );
+    }
+    std::sort( data.begin(), data.end(), []( const auto& a, const auto& b ) {
+        return a.index < b.index;
+    } );
+}
+
+} // namespace
+
+void voxelizeSurface( const TriangleMesh& mesh,
+                      VolumeGrid& grid,
+                      const Scalar value,
+                      const Vector3& origin ) {
+    const Vector3i n = grid.size();
+    auto& data       = grid.data();
+    CORE_ASSERT( data.size() == size_t( n.prod() ), "Grid storage does not match its size" );
+    forEachSurfaceVoxel( mesh, n, grid.binSize(), origin, [&]( int, int x, int y, int z ) {
+        data[gridIndex( n, x, y, z )] = value;
+    } );
+}
+
+void voxelizeSurface( const TriangleMesh& mesh,
+                      VolumeSparse& volume,
+                      const Scalar value,
+                      const Vector3& origin ) {
+    const Vector3i n = volume.size();
+    const Vector3i count = ( n.array().max( 0 ) + TileSize - 1 ) / TileSize;
+    std::vector<VolumeSparse::Container> tiles( size_t( count.prod() ) );
+    forEachSurfaceVoxel( mesh, n, volume.binSize(), origin, [&]( int i, int x, int y, int z ) {
+        tiles[i].emplace_back( gridIndex( n, x, y, z ), value );
+    } );
+    gatherTiles( tiles, volume );
+}
+
+void voxelizeSolid( const TriangleMesh& mesh,
+                    VolumeGrid& grid,
+                    const Scalar value,
+                    const Vector3& origin ) {
+    const Vector3i n = grid.size();
+    auto& data       = grid.data();
+    CORE_ASSERT( data.size() == size_t( n.prod() ), "Grid storage does not match its size" );
+    forEachSolidVoxel( mesh, n, grid.binSize(), origin, [&]( int, int x, int y, int z ) {
+        data[gridIndex( n, x, y, z )] = value;
+    } );
+}
+
+void voxelizeSolid( const TriangleMesh& mesh,
+                    VolumeSparse& volume,
+                    const Scalar value,
+                    const Vector3& origin ) {
+    const Vector3i n = volume.size();
+    const Vector2i count = ( n.head<2>().array().max( 0 ) + TileSize - 1 ) / TileSize;
+    std::vector<VolumeSparse::Container> tiles( size_t( count.prod() ) );
+    forEachSolidVoxel( mesh, n, volume.binSize(), origin, [&]( int i, int x, int y, int z ) {
+        tiles[i].emplace_back( gridIndex( n, x, y, z ), value );
+    } );
+    gatherTiles( tiles, volume );
+}
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
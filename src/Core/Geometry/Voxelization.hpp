@@ -0,0 +1,68 @@
+#ifndef RADIUMENGINE_VOXELIZATION_HPP_
+#define RADIUMENGINE_VOXELIZATION_HPP_
+
+#include <Core/Geometry/TriangleMesh.hpp>
+#include <Core/Geometry/Volume.hpp>
+#include <Core/RaCore.hpp>
+#include <Core/Types.hpp>
+
+namespace Ra {
+namespace Core {
+namespace Geometry {
+
+/**
+ * Voxelization of triangle meshes into discrete volumes.
+ *
+ * Voxel ( i, j, k ) of the volume is the bin
+ * origin + [ ( i, j, k ); ( i, j, k ) + 1 ] * binSize, and its sample is at the
+ * center of the bin, as for bakeSignedDistance(). The size and bin size of the
+ * volume must be set before voxelizing.
+ *
+ * The triangles are binned into tiles of voxels, in parallel over the
+ * triangles, then the tiles are voxelized in parallel, each task writing only
+ * the voxels of its tile. No intermediate storage of the size of the volume is
+ * used, so that large grids of large meshes can be voxelized.
+ *
+ * The triangle-box overlap test was taken from:
+ * "Fast 3D Triangle-Box Overlap Testing"
+ * [ Tomas Akenine-Moller ]
+ * Journal of Graphics Tools 2001
+ **/
+
+/// Set to \p value the samples of \p grid whose bin overlaps a triangle of
+/// \p mesh, boundaries included (conservative voxelization). The other samples
+/// are left unchanged.
+RA_CORE_API void voxelizeSurface( const TriangleMesh& mesh,
+                                  VolumeGrid& grid,
+                                  Scalar value          = 1,
+                                  const Vector3& origin = Vector3::Zero() );
+
+/// Fill \p volume with the samples whose bin overlaps a triangle of \p mesh,
+/// boundaries included, set to \p value (in increasing index order).
+RA_CORE_API void voxelizeSurface( const TriangleMesh& mesh,
+                                  VolumeSparse& volume,
+                                  Scalar value          = 1,
+                                  const Vector3& origin = Vector3::Zero() );
+
+/// Set to \p value the samples of \p grid which are inside \p mesh. The other
+/// samples are left unchanged.
+/// The samples are classified by the parity of the number of crossings of the
+/// mesh along the line parallel to z through them, so the mesh must be closed.
+/// Combined with voxelizeSurface(), this gives a conservative solid.
+RA_CORE_API void voxelizeSolid( const TriangleMesh& mesh,
+                                VolumeGrid& grid,
+                                Scalar value          = 1,
+                                const Vector3& origin = Vector3::Zero() );
+
+/// Fill \p volume with the samples which are inside the closed mesh \p mesh,
+/// set to \p value (in increasing index order).
+RA_CORE_API void voxelizeSolid( const TriangleMesh& mesh,
+                                VolumeSparse& volume,
+                                Scalar value          = 1,
+                                const Vector3& origin = Vector3::Zero() );
+
+} // namespace Geometry
+} // namespace Core
+} // namespace Ra
+
+#endif // RADIUMENGINE_VOXELIZATION_HPP_
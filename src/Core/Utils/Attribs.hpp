@@ -1,7 +1,9 @@
 #ifndef RADIUMENGINE_ATTRIBS_HPP
 #define RADIUMENGINE_ATTRIBS_HPP
 
+#include <cstdint>
 #include <map>
+#include <type_traits>
 
 #include <Core/Containers/VectorArray.hpp>
 #include <Core/RaCore.hpp>
@@ -33,6 +35,17 @@ class RA_CORE_API AttribBase : public ObservableVoid
     AttribBase( const AttribBase& ) = delete;
     AttribBase& operator=( const AttribBase& ) = delete;
 
+    /// Storage format of the attribute components, telling how the GPU has
+    /// to fetch them.
+    /// \see Core/Geometry/Quantization.hpp for encoders and decoders.
+    enum class Encoding {
+        FLOAT,   ///< 32 bits floats.
+        DOUBLE,  ///< 64 bits floats.
+        HALF,    ///< 16 bits floats.
+        UNORM16, ///< 16 bits unsigned integers, mapped to [0,1].
+        SNORM16  ///< 16 bits signed integers, mapped to [-1,1].
+    };
+
     /// Return the attribute's name.
     inline std::string getName() const;
 
@@ -87,6 +100,15 @@ class RA_CORE_API AttribBase : public ObservableVoid
     /// Return a void * on the attrib data
     virtual const void* dataPtr() const = 0;
 
+    /// Return the storage format of the components.
+    /// It is set when the attrib is created, by the element type if it has a
+    /// static AttribEncoding member (e.g. Geometry::HalfVector2), and deduced
+    /// from the component type otherwise.
+    inline Encoding getEncoding() const;
+
+    /// Set the storage format of the components.
+    inline void setEncoding( Encoding encoding );
+
     /// Return true if data is locked, i.e. has been locked for write access with
     /// getDataWithlock() (defined in subclass Attrib). Double lock is prohebited, so when finished,
     /// call unlock();
@@ -104,6 +126,9 @@ class RA_CORE_API AttribBase : public ObservableVoid
 
     /// Is data access locked by a user ?
     bool m_isLocked{false};
+
+    /// Storage format of the components.
+    Encoding m_encoding{Encoding::FLOAT};
 };
 
 /**
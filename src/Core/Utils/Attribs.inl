@@ -34,6 +34,14 @@ void AttribBase::unlock() {
     lock( false );
 }
 
+AttribBase::Encoding AttribBase::getEncoding() const {
+    return m_encoding;
+}
+
+void AttribBase::setEncoding( Encoding encoding ) {
+    m_encoding = encoding;
+}
+
 void AttribBase::lock( bool isLocked ) {
     CORE_ASSERT( isLocked != m_isLocked, "double (un)lock" );
     m_isLocked = isLocked;
@@ -42,8 +50,45 @@ void AttribBase::lock( bool isLocked ) {
 
 /////////////// Attrib ///////////////////
 
+namespace internal {
+// Type of the components of an attrib element.
+template <typename T, bool = std::is_arithmetic<T>::value>
+struct AttribComponent {
+    using type = T;
+};
+template <typename T>
+struct AttribComponent<T, false> {
+    using type = typename T::Scalar;
+};
+
+// Encoding of an attrib element deduced from its component type.
+template <typename T>
+constexpr AttribBase::Encoding componentEncoding() {
+    using C = typename AttribComponent<T>::type;
+    return std::is_same<C, double>::value
+               ? AttribBase::Encoding::DOUBLE
+               : std::is_same<C, std::uint16_t>::value
+                     ? AttribBase::Encoding::UNORM16
+                     : std::is_same<C, std::int16_t>::value ? AttribBase::Encoding::SNORM16
+                                                            : AttribBase::Encoding::FLOAT;
+}
+
+// Default encoding of an attrib element, given by the element type or
+// deduced from its component type.
+template <typename T, typename = void>
+struct DefaultEncoding {
+    static constexpr AttribBase::Encoding value = componentEncoding<T>();
+};
 template <typename T>
-Attrib<T>::Attrib( const std::string& name ) : AttribBase( name ) {}
+struct DefaultEncoding<T, std::void_t<decltype( T::AttribEncoding )>> {
+    static constexpr AttribBase::Encoding value = T::AttribEncoding;
+};
+} // namespace internal
+
+template <typename T>
+Attrib<T>::Attrib( const std::string& name ) : AttribBase( name ) {
+    setEncoding( internal::DefaultEncoding<T>::value );
+}
 
 template <typename T>
 
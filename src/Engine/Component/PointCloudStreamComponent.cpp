@@ -0,0 +1,268 @@
+#include <Engine/Component/PointCloudStreamComponent.hpp>
+
+#include <Core/Containers/MakeShared.hpp>
+#include <Core/Geometry/Frustum.hpp>
+#include <Core/Utils/Log.hpp>
+#include <Engine/Entity/Entity.hpp>
+#include <Engine/Renderer/Camera/ViewingParameters.hpp>
+#include <Engine/Renderer/Material/BlinnPhongMaterial.hpp>
+#include <Engine/Renderer/Mesh/Mesh.hpp>
+#include <Engine/Renderer/RenderObject/RenderObject.hpp>
+#include <Engine/Renderer/RenderObject/RenderObjectManager.hpp>
+#include <Engine/Renderer/RenderObject/RenderObjectTypes.hpp>
+#include <Engine/Renderer/RenderTechnique/RenderTechnique.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace Ra {
+namespace Engine {
+
+using namespace Core::Utils; // log
+
+PointCloudStreamComponent::PointCloudStreamComponent( const std::string& name,
+                                                      Entity* entity,
+                                                      const std::string& directory,
+                                                      const Options& options ) :
+    Component( name, entity ), m_options( options ) {
+    if ( !m_octree.open( directory ) )
+    {
+        LOG( logERROR ) << "[PointCloudStream] Can not open the octree in " << directory;
+        return;
+    }
+    LOG( logINFO ) << "[PointCloudStream] " << m_octree.pointCount() << " points in "
+                   << m_octree.nodes().size() << " nodes";
+    m_nodes.resize( m_octree.nodes().size() );
+    for ( uint i = 0; i < std::max( m_options.loaderThreads, 1u ); ++i )
+    {
+        m_threads.emplace_back( &PointCloudStreamComponent::loaderLoop, this );
+    }
+}
+
+PointCloudStreamComponent::PointCloudStreamComponent( const std::string& name,
+                                                      Entity* entity,
+                                                      const std::string& directory ) :
+    PointCloudStreamComponent( name, entity, directory, Options() ) {}
+
+PointCloudStreamComponent::~PointCloudStreamComponent() {
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    for ( auto& thread : m_threads )
+    {
+        thread.join();
+    }
+}
+
+void PointCloudStreamComponent::loaderLoop() {
+    for ( ;; )
+    {
+        int node = -1;
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_condition.wait( lock, [this]() { return m_stop || !m_requests.empty(); } );
+            if ( m_stop ) { return; }
+            node = m_requests.front();
+            m_requests.pop_front();
+        }
+
+        Core::Vector3Array points;
+        Core::Vector3Array normals;
+        Core::Vector4Array colors;
+        LoadedNode loaded{node, m_octree.loadNode( node, points, normals, colors ), {}};
+        if ( loaded.valid )
+        {
+            loaded.cloud.setVertices( std::move( points ) );
+            loaded.cloud.setNormals( std::move( normals ) );
+            if ( !colors.empty() )
+            { loaded.cloud.addAttrib( Mesh::getAttribName( Mesh::VERTEX_COLOR ), colors ); }
+        }
+        else
+        { LOG( logERROR ) << "[PointCloudStream] Can not load node " << node; }
+
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_loaded.push_back( std::move( loaded ) );
+    }
+}
+
+void PointCloudStreamComponent::adoptLoadedNodes() {
+    std::vector<LoadedNode> loaded;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        loaded.swap( m_loaded );
+    }
+    for ( auto& l : loaded )
+    {
+        NodeData& data = m_nodes[size_t( l.node )];
+        if ( !l.valid )
+        {
+            data.state = NodeState::FAILED;
+            continue;
+        }
+        data.state    = NodeState::LOADED;
+        data.lastUsed = m_frame;
+        data.points   = l.cloud.vertices().size();
+        m_loadedPoints += data.points;
+
+        const std::string name = m_name + "_node" + std::to_string( l.node );
+        auto mat               = Core::make_shared<BlinnPhongMaterial>( name + "_Material" );
+        mat->m_renderAsSplat   = m_octree.hasNormals();
+        mat->m_perVertexColor  = m_octree.hasColors();
+        auto cloud             = Core::make_shared<PointCloud>( name );
+        cloud->setRenderMode( AttribArrayDisplayable::RM_POINTS );
+        cloud->loadGeometry( std::move( l.cloud ) );
+        auto ro = RenderObject::createRenderObject(
+            name + "_RO", this, RenderObjectType::Geometry, cloud, RenderTechnique{} );
+        ro->setMaterial( mat );
+        // displayed by the next updateView() if still selected
+        ro->setVisible( false );
+        data.roIndex = addRenderObject( ro );
+    }
+}
+
+void PointCloudStreamComponent::updateView( const ViewingParameters& view,
+                                            const Scalar viewportHeight ) {
+    if ( !isValid() ) { return; }
+    ++m_frame;
+    adoptLoadedNodes();
+
+    // the nodes are in the frame of the entity
+    const Core::Matrix4 modelView = view.viewMatrix * getEntity()->getTransform().matrix();
+    const Core::Geometry::Frustum frustum( view.projMatrix * modelView );
+    const Core::Vector3 eye    = modelView.inverse().block<3, 1>( 0, 3 );
+    const bool perspective     = view.projMatrix( 3, 3 ) == 0;
+    const Scalar pixelsPerUnit = view.projMatrix( 1, 1 ) * viewportHeight / 2;
+    const Scalar scale = std::cbrt( std::abs( modelView.block<3, 3>( 0, 0 ).determinant() ) );
+    const auto& nodes  = m_octree.nodes();
+
+    const auto isVisible = [&]( const Core::Geometry::PointCloudOctree::Node& node ) {
+        for ( const auto& plane : frustum.m_planes )
+        {
+            // corner of the box the farthest along the plane normal
+            Core::Vector3 p;
+            for ( int a = 0; a < 3; ++a )
+            {
+                p( a ) = plane( a ) > 0 ? node.aabb.max()( a ) : node.aabb.min()( a );
+            }
+            if ( plane.head<3>().dot( p ) + plane( 3 ) < 0 ) { return false; }
+        }
+        return true;
+    };
+    // spacing of the points of the node on the screen
+    const auto screenSpacing = [&]( const Core::Geometry::PointCloudOctree::Node& node ) {
+        const Scalar spacing = node.spacing * scale * pixelsPerUnit;
+        if ( !perspective ) { return spacing; }
+        const Scalar radius   = node.aabb.sizes().norm() / 2;
+        const Scalar distance = ( ( node.aabb.center() - eye ).norm() - radius ) * scale;
+        if ( distance <= 0 ) { return std::numeric_limits<Scalar>::max(); }
+        return spacing / distance;
+    };
+
+    // refine the nodes by decreasing screen spacing, the children of a node
+    // being candidates once it is loaded
+    using Candidate = std::pair<Scalar, int>;
+    std::priority_queue<Candidate> candidates;
+    if ( isVisible( nodes[0] ) ) { candidates.emplace( screenSpacing( nodes[0] ), 0 ); }
+    std::vector<int> displayed;
+    std::vector<int> requests;
+    size_t selectedPoints = 0;
+    while ( !candidates.empty() )
+    {
+        const Candidate c = candidates.top();
+        candidates.pop();
+        const auto& node = nodes[size_t( c.second )];
+        NodeData& data   = m_nodes[size_t( c.second )];
+        if ( data.state == NodeState::FAILED ) { continue; }
+        if ( selectedPoints + node.count > m_options.pointBudget ) { break; }
+        selectedPoints += node.count;
+        if ( data.state != NodeState::LOADED )
+        {
+            requests.push_back( c.second );
+            continue;
+        }
+        displayed.push_back( c.second );
+        data.lastUsed = m_frame;
+        if ( c.first <= m_options.maxScreenSpacing ) { continue; }
+        for ( const int child : node.children )
+        {
+            if ( child >= 0 && isVisible( nodes[size_t( child )] ) )
+            { candidates.emplace( screenSpacing( nodes[size_t( child )] ), child ); }
+        }
+    }
+
+    // show the selected nodes only
+    auto roMgr = getRoMgr();
+    for ( const int n : m_displayed )
+    {
+        const NodeData& data = m_nodes[size_t( n )];
+        if ( data.state == NodeState::LOADED )
+        { roMgr->getRenderObject( data.roIndex )->setVisible( false ); }
+    }
+    for ( const int n : displayed )
+    {
+        roMgr->getRenderObject( m_nodes[size_t( n )].roIndex )->setVisible( true );
+    }
+    m_displayed = std::move( displayed );
+
+    // the pending requests are replaced by the ones of this view, which are
+    // ordered by decreasing priority, the queued nodes which are not pending
+    // are being loaded
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        for ( const int n : m_requests )
+        {
+            m_nodes[size_t( n )].state = NodeState::UNLOADED;
+        }
+        m_requests.clear();
+        for ( const int n : requests )
+        {
+            if ( m_nodes[size_t( n )].state != NodeState::UNLOADED ) { continue; }
+            m_nodes[size_t( n )].state = NodeState::QUEUED;
+            m_requests.push_back( n );
+        }
+    }
+    m_condition.notify_all();
+
+    evictNodes();
+}
+
+void PointCloudStreamComponent::evictNodes() {
+    if ( m_loadedPoints <= m_options.memoryBudget ) { return; }
+    std::vector<int> cached;
+    for ( int i = 0; i < int( m_nodes.size() ); ++i )
+    {
+        if ( m_nodes[i].state == NodeState::LOADED && m_nodes[i].lastUsed != m_frame )
+        { cached.push_back( i ); }
+    }
+    std::sort( cached.begin(), cached.end(), [this]( const int a, const int b ) {
+        return m_nodes[size_t( a )].lastUsed < m_nodes[size_t( b )].lastUsed;
+    } );
+    for ( const int n : cached )
+    {
+        if ( m_loadedPoints <= m_options.memoryBudget ) { break; }
+        NodeData& data = m_nodes[size_t( n )];
+        removeRenderObject( data.roIndex );
+        m_loadedPoints -= data.points;
+        data.state   = NodeState::UNLOADED;
+        data.roIndex = Core::Utils::Index();
+        data.points  = 0;
+    }
+}
+
+Core::Aabb PointCloudStreamComponent::computeAabb() const {
+    Core::Aabb aabb;
+    if ( !isValid() ) { return aabb; }
+    const Core::Aabb& bounds = m_octree.nodes()[0].aabb;
+    for ( int i = 0; i < 8; ++i )
+    {
+        aabb.extend( getEntity()->getTransform() * bounds.corner( Core::Aabb::CornerType( i ) ) );
+    }
+    return aabb;
+}
+
+} // namespace Engine
+} // namespace Ra
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <Core/Geometry/PointCloudOctree.hpp>
+#include <Core/Geometry/TriangleMesh.hpp>
+#include <Engine/Component/Component.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Ra {
+namespace Engine {
+struct ViewingParameters;
+} // namespace Engine
+} // namespace Ra
+
+namespace Ra {
+namespace Engine {
+
+/*!
+ * \brief Out-of-core display of a point cloud octree built by
+ * Core::Geometry::buildPointCloudOctree().
+ *
+ * Each frame, updateView() selects the nodes whose parent, once projected on
+ * the screen, has a spacing larger than the tolerated error, in decreasing
+ * error order and within the point budget, the nodes out of the view frustum
+ * being skipped. The missing nodes are loaded by background threads, and each
+ * loaded node is displayed by its own render object, shown only while the
+ * node is selected. The nodes which are no longer selected are kept in memory
+ * as a cache, and released, least recently used first, when the loaded points
+ * exceed the memory budget.
+ */
+class RA_ENGINE_API PointCloudStreamComponent : public Component
+{
+  public:
+    struct Options {
+        /// Maximum number of points displayed at once.
+        size_t pointBudget{10000000};
+        /// Maximum number of points kept in memory, displayed or cached.
+        size_t memoryBudget{20000000};
+        /// Spacing of the points on the screen, in pixels, under which the
+        /// children of a node are not displayed.
+        Scalar maxScreenSpacing{2};
+        /// Number of threads loading the nodes.
+        uint loaderThreads{2};
+    };
+
+    /// Open the octree stored in \p directory, see isValid().
+    PointCloudStreamComponent( const std::string& name,
+                               Entity* entity,
+                               const std::string& directory,
+                               const Options& options );
+    PointCloudStreamComponent( const std::string& name,
+                               Entity* entity,
+                               const std::string& directory );
+
+    /// Stop the loading threads.
+    ~PointCloudStreamComponent() override;
+
+    void initialize() override {}
+
+    /// Whether the octree has been opened.
+    inline bool isValid() const { return m_octree.isOpen(); }
+
+    inline const Core::Geometry::PointCloudOctree& getOctree() const { return m_octree; }
+
+    /// Select and request the nodes to display for the given view, and
+    /// display the nodes loaded since the last call. Must be called from the
+    /// main thread, once per frame, \p viewportHeight being the height of the
+    /// viewport in pixels. The component is not updated by itself, the
+    /// application calls it with the parameters given to the renderer.
+    void updateView( const ViewingParameters& view, Scalar viewportHeight );
+
+    /// Number of points in memory.
+    inline size_t getLoadedPoints() const { return m_loadedPoints; }
+
+    /// Bounds of the whole octree, whatever the loaded nodes.
+    Core::Aabb computeAabb() const override;
+
+  private:
+    // the nodes which can not be loaded are not requested again
+    enum class NodeState { UNLOADED, QUEUED, LOADED, FAILED };
+
+    struct NodeData {
+        NodeState state{NodeState::UNLOADED};
+        Core::Utils::Index roIndex;
+        // number of points in memory, counted in m_loadedPoints
+        size_t points{0};
+        std::uint64_t lastUsed{0};
+    };
+
+    struct LoadedNode {
+        int node;
+        bool valid;
+        Core::Geometry::PointCloud cloud;
+    };
+
+    void loaderLoop();
+
+    // Create the render objects of the nodes loaded by the threads.
+    void adoptLoadedNodes();
+
+    // Release the least recently used nodes which are not displayed.
+    void evictNodes();
+
+    Options m_options;
+    Core::Geometry::PointCloudOctree m_octree;
+    std::vector<NodeData> m_nodes;
+    std::vector<int> m_displayed;
+    size_t m_loadedPoints{0};
+    std::uint64_t m_frame{0};
+
+    // requests, by decreasing priority, and results of the loading threads
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<int> m_requests;
+    std::vector<LoadedNode> m_loaded;
+    bool m_stop{false};
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace Engine
+} // namespace Ra
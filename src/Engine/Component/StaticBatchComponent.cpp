@@ -0,0 +1,78 @@
+#include <Engine/Component/StaticBatchComponent.hpp>
+
+#include <Core/Containers/MakeShared.hpp>
+#include <Engine/Renderer/Material/Material.hpp>
+#include <Engine/Renderer/Mesh/StaticBatchMesh.hpp>
+#include <Engine/Renderer/RenderObject/RenderObject.hpp>
+#include <Engine/Renderer/RenderObject/RenderObjectManager.hpp>
+#include <Engine/Renderer/RenderObject/RenderObjectTypes.hpp>
+#include <Engine/Renderer/RenderTechnique/RenderTechnique.hpp>
+
+namespace Ra {
+namespace Engine {
+
+StaticBatchComponent::StaticBatchComponent( const std::string& name,
+                                            Entity* entity,
+                                            size_t maxBatchVertices ) :
+    Component( name, entity ), m_maxBatchVertices( maxBatchVertices ) {}
+
+StaticBatchComponent::~StaticBatchComponent() {
+    for ( const auto& member : m_members )
+    {
+        m_batches[member.second].mesh->removeMember( member.first );
+    }
+}
+
+bool StaticBatchComponent::addToBatch( const Core::Utils::Index& roIndex ) {
+    auto roMgr = getRoMgr();
+    if ( !roMgr->exists( roIndex ) ) { return false; }
+    auto ro = roMgr->getRenderObject( roIndex );
+    if ( ro->isBatched() || ro->isXRay() || ro->getType() != RenderObjectType::Geometry )
+    { return false; }
+
+    const Material* material = ro->getMaterial().get();
+    const auto technique     = ro->getRenderTechnique();
+    const size_t vertices    = ro->getMesh()->getNumVertices();
+    for ( size_t b = 0; b < m_batches.size(); ++b )
+    {
+        const Batch& batch = m_batches[b];
+        if ( batch.material == material && batch.technique == technique.get() &&
+             batch.transparent == ro->isTransparent() && batch.mesh->isCompatible( *ro ) &&
+             batch.mesh->getNumVertices() + vertices <= m_maxBatchVertices &&
+             batch.mesh->addMember( ro ) )
+        {
+            m_members[roIndex] = b;
+            return true;
+        }
+    }
+
+    // new batch, with the material and technique of its first member
+    const std::string name = m_name + "_batch" + std::to_string( m_batches.size() );
+    auto mesh              = Core::make_shared<StaticBatchMesh>( name );
+    if ( !mesh->addMember( ro ) ) { return false; }
+    auto batchRo = new RenderObject( name + "_RO", this, RenderObjectType::Geometry );
+    batchRo->setMesh( mesh );
+    batchRo->setRenderTechnique( technique );
+    batchRo->setMaterial( ro->getMaterial() );
+    batchRo->setTransparent( ro->isTransparent() );
+    addRenderObject( batchRo );
+    m_batches.push_back( {mesh, material, technique.get(), ro->isTransparent()} );
+    m_members[roIndex] = m_batches.size() - 1;
+    return true;
+}
+
+bool StaticBatchComponent::removeFromBatch( const Core::Utils::Index& roIndex ) {
+    auto it = m_members.find( roIndex );
+    if ( it == m_members.end() ) { return false; }
+    m_batches[it->second].mesh->removeMember( roIndex );
+    m_members.erase( it );
+    return true;
+}
+
+void StaticBatchComponent::setDirty( const Core::Utils::Index& roIndex ) {
+    auto it = m_members.find( roIndex );
+    if ( it != m_members.end() ) { m_batches[it->second].mesh->setMemberDirty( roIndex ); }
+}
+
+} // namespace Engine
+} // namespace Ra
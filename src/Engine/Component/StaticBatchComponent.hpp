@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Engine/Component/Component.hpp>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Ra {
+namespace Engine {
+class Material;
+class RenderTechnique;
+class StaticBatchMesh;
+} // namespace Engine
+} // namespace Ra
+
+namespace Ra {
+namespace Engine {
+
+/*!
+ * \brief Static batching of render objects.
+ *
+ * The render objects added to this component are gathered in batches of
+ * compatible render objects, which share their material, render technique,
+ * transparency and vertex attributes. Each batch is a StaticBatchMesh,
+ * displayed by a render object of this component, and the batched render
+ * objects are no longer rendered by themselves, but keep their visibility
+ * and picking. Since the batches contain the transformed vertices, the
+ * entity of this component must keep the identity transform.
+ */
+class RA_ENGINE_API StaticBatchComponent : public Component
+{
+  public:
+    /// The batches are limited to \p maxBatchVertices vertices, so that
+    /// rebuilding a batch stays cheap, unless a render object is larger.
+    StaticBatchComponent( const std::string& name,
+                          Entity* entity,
+                          size_t maxBatchVertices = 1 << 20 );
+
+    /// Render the batched render objects by themselves again.
+    ~StaticBatchComponent() override;
+
+    void initialize() override {}
+
+    /// Draw the render object \p roIndex with a batch of compatible render
+    /// objects, which is created if needed.
+    /// \return false if it can not be batched: its mesh is not a triangle
+    /// Mesh with float attributes, it is x-ray, or it is already batched.
+    bool addToBatch( const Core::Utils::Index& roIndex );
+
+    /// Render the render object \p roIndex by itself again.
+    /// \return false if it is not batched by this component.
+    bool removeFromBatch( const Core::Utils::Index& roIndex );
+
+    /// Update the batched render object \p roIndex after a change of its
+    /// indices, see StaticBatchMesh::setMemberDirty().
+    void setDirty( const Core::Utils::Index& roIndex );
+
+    inline size_t getBatchCount() const { return m_batches.size(); }
+
+  private:
+    struct Batch {
+        std::shared_ptr<StaticBatchMesh> mesh;
+        const Material* material;
+        const RenderTechnique* technique;
+        bool transparent;
+    };
+
+    size_t m_maxBatchVertices;
+    std::vector<Batch> m_batches;
+    // batch of each batched render object
+    std::map<Core::Utils::Index, size_t> m_members;
+};
+
+} // namespace Engine
+} // namespace Ra
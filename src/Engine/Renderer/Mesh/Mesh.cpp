@@ -123,6 +123,31 @@ void AttribArrayDisplayable::updatePickingRenderMode() {
     }
 }
 
+bool AttribArrayDisplayable::isFetchable( const AttribBase* attrib ) {
+    const auto encoding = attrib->getEncoding();
+    return encoding == AttribBase::Encoding::FLOAT || encoding == AttribBase::Encoding::DOUBLE ||
+           encoding == AttribBase::Encoding::HALF;
+}
+
+void AttribArrayDisplayable::setAttribFormat( globjects::VertexAttributeBinding* binding,
+                                              const AttribBase* attrib ) {
+    CORE_ASSERT( isFetchable( attrib ), "Normalized integer attribs are not fetched" );
+    const auto size = GLint( attrib->getElementSize() );
+    switch ( attrib->getEncoding() )
+    {
+    case AttribBase::Encoding::DOUBLE:
+        binding->setFormat( size, GL_DOUBLE );
+        break;
+    case AttribBase::Encoding::HALF:
+        binding->setFormat( size, GL_HALF_FLOAT );
+        break;
+    case AttribBase::Encoding::FLOAT:
+    default:
+        binding->setFormat( size, GL_FLOAT );
+        break;
+    }
+}
+
 void AttribArrayDisplayable::setDirty( const std::string& name ) {
     auto itr = m_handleToBuffer.find( name );
     if ( itr == m_handleToBuffer.end() )
@@ -25,6 +25,7 @@
 namespace globjects {
 
 class VertexArray;
+class VertexAttributeBinding;
 class Buffer;
 
 } // namespace globjects
@@ -137,6 +138,17 @@ class RA_ENGINE_API AttribArrayDisplayable : public Displayable
     /// Update the picking render mode according to the object render mode
     void updatePickingRenderMode();
 
+    /// Whether \p attrib can be fetched by the default shaders. Half and
+    /// double attribs are converted to floats by the vertex fetch, but the
+    /// normalized integer ones (quantized positions, octahedral vectors) would
+    /// need a decoding which the shaders do not do, so they are not bound.
+    static bool isFetchable( const AttribBase* attrib );
+
+    /// Set the format of \p binding according to the element size and the
+    /// encoding of \p attrib, which must be fetchable.
+    static void setAttribFormat( globjects::VertexAttributeBinding* binding,
+                                 const AttribBase* attrib );
+
     class AttribObserver
     {
       public:
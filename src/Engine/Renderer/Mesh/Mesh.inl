@@ -137,7 +137,7 @@ void IndexedAttribArrayDisplayable<I>::autoVertexAttribPointer( const ShaderProg
         auto attribName = name; // m_translationTableShaderToMesh[name];
         auto attrib     = m_attribManager.getAttribBase( attribName );
 
-        if ( attrib && attrib->getSize() > 0 )
+        if ( attrib && attrib->getSize() > 0 && isFetchable( attrib ) )
         {
             m_vao->enable( loc );
             auto binding = m_vao->binding( idx );
@@ -145,7 +145,7 @@ void IndexedAttribArrayDisplayable<I>::autoVertexAttribPointer( const ShaderProg
             CORE_ASSERT( m_vbos[m_handleToBuffer[attribName]].get(), "vbo is nullptr" );
             binding->setBuffer(
                 m_vbos[m_handleToBuffer[attribName]].get(), 0, attrib->getStride() );
-            binding->setFormat( attrib->getElementSize(), GL_FLOAT );
+            setAttribFormat( binding, attrib );
         }
         else
         { m_vao->disable( loc ); }
@@ -248,7 +248,7 @@ void CoreGeometryDisplayable<CoreGeometry>::autoVertexAttribPointer( const Shade
         auto attribName = m_translationTableShaderToMesh[name];
         auto attrib     = m_mesh.getAttribBase( attribName );
 
-        if ( attrib && attrib->getSize() > 0 )
+        if ( attrib && attrib->getSize() > 0 && isFetchable( attrib ) )
         {
             m_vao->enable( loc );
             auto binding = m_vao->binding( idx );
@@ -256,7 +256,7 @@ void CoreGeometryDisplayable<CoreGeometry>::autoVertexAttribPointer( const Shade
             CORE_ASSERT( m_vbos[m_handleToBuffer[attribName]].get(), "vbo is nullptr" );
             binding->setBuffer(
                 m_vbos[m_handleToBuffer[attribName]].get(), 0, attrib->getStride() );
-            binding->setFormat( attrib->getElementSize(), GL_FLOAT );
+            setAttribFormat( binding, attrib );
         }
         else
         { m_vao->disable( loc ); }
@@ -0,0 +1,432 @@
+#include <Engine/Renderer/Mesh/StaticBatchMesh.hpp>
+
+#include <Core/Utils/Log.hpp>
+#include <Engine/Renderer/OpenGL/OpenGL.hpp>
+#include <Engine/Renderer/RenderObject/RenderObject.hpp>
+#include <Engine/Renderer/RenderTechnique/ShaderProgram.hpp>
+
+#include <globjects/Buffer.h>
+#include <globjects/Program.h>
+#include <globjects/VertexArray.h>
+#include <globjects/VertexAttributeBinding.h>
+
+#include <algorithm>
+
+namespace Ra {
+namespace Engine {
+
+using namespace Core::Utils; // log
+
+StaticBatchMesh::StaticBatchMesh( const std::string& name ) :
+    AttribArrayDisplayable( name, RM_TRIANGLES ) {}
+
+StaticBatchMesh::~StaticBatchMesh() {
+    for ( auto& member : m_members )
+    {
+        detachObservers( *member );
+    }
+}
+
+bool StaticBatchMesh::computeLayout( const RenderObject& ro, AttribLayout& layout ) {
+    layout.clear();
+    auto mesh = std::dynamic_pointer_cast<const Mesh>( ro.getMesh() );
+    if ( !mesh || mesh->getRenderMode() != RM_TRIANGLES ) { return false; }
+    const size_t size = mesh->getCoreGeometry().vertices().size();
+    bool supported    = true;
+    mesh->getCoreGeometry().vertexAttribs().for_each_attrib(
+        [&layout, &supported, size]( const AttribBase* attr ) {
+            if ( attr->getSize() == 0 ) { return; }
+            if ( attr->getSize() != size || attr->getEncoding() != AttribBase::Encoding::FLOAT ||
+                 !( attr->isFloat() || attr->isVec2() || attr->isVec3() || attr->isVec4() ) )
+            {
+                supported = false;
+                return;
+            }
+            layout.emplace_back( attr->getName(), attr->getElementSize() );
+        } );
+    std::sort( layout.begin(), layout.end() );
+    return supported;
+}
+
+bool StaticBatchMesh::isCompatible( const RenderObject& ro ) const {
+    AttribLayout layout;
+    return computeLayout( ro, layout ) && ( m_members.empty() || layout == m_layout );
+}
+
+bool StaticBatchMesh::addMember( const std::shared_ptr<RenderObject>& ro ) {
+    AttribLayout layout;
+    if ( !computeLayout( *ro, layout ) || ( !m_members.empty() && layout != m_layout ) )
+    { return false; }
+    if ( m_members.empty() ) { m_layout = layout; }
+    auto member     = std::make_unique<Member>();
+    member->ro      = ro;
+    member->roIndex = ro->getIndex();
+    member->mesh    = std::static_pointer_cast<Mesh>( ro->getMesh() );
+    // the sizes are known before the next GL update, to limit the size of the batches
+    const auto& geometry = member->mesh->getCoreGeometry();
+    member->vertexCount  = geometry.vertices().size();
+    member->indexCount   = 3 * geometry.m_indices.size();
+    ro->setBatched( true );
+    m_members.push_back( std::move( member ) );
+    m_isDirty = true;
+    return true;
+}
+
+bool StaticBatchMesh::removeMember( const Core::Utils::Index& roIndex ) {
+    auto it = std::find_if( m_members.begin(), m_members.end(), [&roIndex]( const auto& m ) {
+        return m->roIndex == roIndex;
+    } );
+    if ( it == m_members.end() ) { return false; }
+    Member& member = **it;
+    detachObservers( member );
+    if ( auto ro = member.ro.lock() ) { ro->setBatched( false ); }
+    if ( member.placed )
+    {
+        m_freeVertices += member.vertexCount;
+        m_freeIndices += member.indexCount;
+    }
+    m_members.erase( it );
+    m_isDirty = true;
+    return true;
+}
+
+void StaticBatchMesh::setMemberDirty( const Core::Utils::Index& roIndex ) {
+    for ( auto& member : m_members )
+    {
+        if ( member->roIndex == roIndex )
+        {
+            member->dirty = true;
+            m_isDirty     = true;
+        }
+    }
+}
+
+const Core::Geometry::AbstractGeometry& StaticBatchMesh::getAbstractGeometry() const {
+    return m_bounds;
+}
+
+Core::Geometry::AbstractGeometry& StaticBatchMesh::getAbstractGeometry() {
+    return m_bounds;
+}
+
+void StaticBatchMesh::detachObservers( Member& member ) {
+    for ( const auto& observer : member.observers )
+    {
+        auto attr = member.mesh->getCoreGeometry().getAttribBase( observer.first );
+        if ( attr ) { attr->detach( observer.second ); }
+    }
+    member.observers.clear();
+}
+
+bool StaticBatchMesh::fitsInBuffers() const {
+    size_t vertices = m_vertexEnd;
+    size_t indices  = m_indexEnd;
+    for ( const auto& member : m_members )
+    {
+        if ( member->placed ) { continue; }
+        vertices += member->vertexCount;
+        indices += member->indexCount;
+    }
+    return vertices <= m_vertexCapacity && indices <= m_indexCapacity &&
+           2 * m_freeVertices <= vertices && 2 * m_freeIndices <= indices;
+}
+
+void StaticBatchMesh::rebuildBuffers() {
+    size_t vertices = 0;
+    size_t indices  = 0;
+    for ( auto& member : m_members )
+    {
+        member->firstVertex = vertices;
+        member->firstIndex  = indices;
+        member->placed      = true;
+        member->dirty       = true;
+        vertices += member->vertexCount;
+        indices += member->indexCount;
+    }
+    // room for the members to come
+    m_vertexCapacity = vertices + vertices / 2;
+    m_indexCapacity  = indices + indices / 2;
+    m_vertexEnd      = vertices;
+    m_indexEnd       = indices;
+    m_freeVertices   = 0;
+    m_freeIndices    = 0;
+
+    m_vbos.clear();
+    m_dataDirty.clear();
+    m_handleToBuffer.clear();
+    for ( const auto& attrib : m_layout )
+    {
+        m_handleToBuffer[attrib.first] = uint( m_vbos.size() );
+        m_vbos.push_back( globjects::Buffer::create() );
+        m_vbos.back()->setData(
+            gl::GLsizeiptr( m_vertexCapacity * attrib.second * sizeof( float ) ),
+            nullptr,
+            GL_STATIC_DRAW );
+        m_dataDirty.push_back( false );
+    }
+    m_indices = globjects::Buffer::create();
+    m_indices->setData(
+        gl::GLsizeiptr( m_indexCapacity * sizeof( uint ) ), nullptr, GL_STATIC_DRAW );
+    if ( !m_vao ) { m_vao = globjects::VertexArray::create(); }
+    m_vao->bind();
+    m_vao->bindElementBuffer( m_indices.get() );
+    m_vao->unbind();
+}
+
+void StaticBatchMesh::writeMember( Member& member ) {
+    auto& geometry        = member.mesh->getCoreGeometry();
+    const Core::Matrix3 L = member.transform.block<3, 3>( 0, 0 );
+    const Core::Vector3 t = member.transform.block<3, 1>( 0, 3 );
+    const Core::Matrix3 N = L.inverse().transpose();
+    member.aabb.setEmpty();
+
+    std::vector<float> data;
+    for ( size_t a = 0; a < m_layout.size(); ++a )
+    {
+        const std::string& name = m_layout[a].first;
+        const size_t dim        = m_layout[a].second;
+        const auto attr         = geometry.getAttribBase( name );
+        const auto src          = static_cast<const float*>( attr->dataPtr() );
+        const size_t stride     = size_t( attr->getStride() ) / sizeof( float );
+        data.resize( member.vertexCount * dim );
+        for ( size_t v = 0; v < member.vertexCount; ++v )
+        {
+            std::copy( src + v * stride, src + v * stride + dim, data.data() + v * dim );
+        }
+
+        const bool position = name == getAttribName( VERTEX_POSITION );
+        const bool normal   = name == getAttribName( VERTEX_NORMAL );
+        const bool tangent =
+            name == getAttribName( VERTEX_TANGENT ) || name == getAttribName( VERTEX_BITANGENT );
+        if ( dim == 3 && ( position || normal || tangent ) )
+        {
+            for ( size_t v = 0; v < member.vertexCount; ++v )
+            {
+                Eigen::Map<Core::Vector3> x( data.data() + v * dim );
+                if ( position )
+                {
+                    x = L * x + t;
+                    member.aabb.extend( x );
+                }
+                else if ( normal )
+                { x = ( N * x ).normalized(); }
+                else
+                { x = ( L * x ).normalized(); }
+            }
+        }
+        m_vbos[a]->setSubData( gl::GLintptr( member.firstVertex * dim * sizeof( float ) ),
+                               gl::GLsizeiptr( data.size() * sizeof( float ) ),
+                               data.data() );
+    }
+
+    std::vector<uint> indices;
+    indices.reserve( member.indexCount );
+    for ( const auto& f : geometry.m_indices )
+    {
+        for ( uint k = 0; k < 3; ++k )
+        {
+            indices.push_back( f( k ) + uint( member.firstVertex ) );
+        }
+    }
+    m_indices->setSubData( gl::GLintptr( member.firstIndex * sizeof( uint ) ),
+                           gl::GLsizeiptr( indices.size() * sizeof( uint ) ),
+                           indices.data() );
+    member.dirty = false;
+}
+
+void StaticBatchMesh::updateGL() {
+    // the destroyed members are removed, and the moved ones are rewritten
+    std::vector<Core::Utils::Index> removed;
+    for ( auto& member : m_members )
+    {
+        auto ro = member->ro.lock();
+        if ( !ro )
+        {
+            removed.push_back( member->roIndex );
+            continue;
+        }
+        const Core::Matrix4 transform = ro->getTransformAsMatrix();
+        if ( member->transform != transform || !member->placed )
+        {
+            member->transform = transform;
+            member->dirty     = true;
+            m_isDirty         = true;
+        }
+    }
+    for ( const auto& index : removed )
+    {
+        removeMember( index );
+    }
+    if ( !m_isDirty ) { return; }
+
+    removed.clear();
+    for ( auto& member : m_members )
+    {
+        if ( !member->dirty ) { continue; }
+        AttribLayout layout;
+        if ( !computeLayout( *member->ro.lock(), layout ) || layout != m_layout )
+        {
+            LOG( logWARNING ) << "[StaticBatchMesh] " << member->mesh->getName()
+                              << " attributes changed, it is removed from " << getName();
+            removed.push_back( member->roIndex );
+            continue;
+        }
+        // the observers are attached again, in case the attributes were replaced
+        detachObservers( *member );
+        member->mesh->getCoreGeometry().vertexAttribs().for_each_attrib(
+            [this, &member]( AttribBase* attr ) {
+                Member* m = member.get();
+                const int id = attr->attach( [this, m]() {
+                    m->dirty  = true;
+                    m_isDirty = true;
+                } );
+                member->observers.emplace_back( attr->getName(), id );
+            } );
+
+        // the resized members are moved at the end of the buffers
+        const size_t vertexCount = member->mesh->getCoreGeometry().vertices().size();
+        const size_t indexCount  = 3 * member->mesh->getCoreGeometry().m_indices.size();
+        if ( member->placed &&
+             ( vertexCount != member->vertexCount || indexCount != member->indexCount ) )
+        {
+            m_freeVertices += member->vertexCount;
+            m_freeIndices += member->indexCount;
+            member->placed = false;
+        }
+        member->vertexCount = vertexCount;
+        member->indexCount  = indexCount;
+    }
+    for ( const auto& index : removed )
+    {
+        removeMember( index );
+    }
+    m_isDirty = false;
+    if ( m_members.empty() )
+    {
+        m_bounds.clear();
+        return;
+    }
+
+    if ( !fitsInBuffers() ) { rebuildBuffers(); }
+    else
+    {
+        for ( auto& member : m_members )
+        {
+            if ( member->placed ) { continue; }
+            member->firstVertex = m_vertexEnd;
+            member->firstIndex  = m_indexEnd;
+            member->placed      = true;
+            m_vertexEnd += member->vertexCount;
+            m_indexEnd += member->indexCount;
+        }
+    }
+    std::sort( m_members.begin(), m_members.end(), []( const auto& a, const auto& b ) {
+        return a->firstIndex < b->firstIndex;
+    } );
+
+    m_bounds.clear();
+    for ( auto& member : m_members )
+    {
+        if ( member->dirty ) { writeMember( *member ); }
+        m_bounds.m_aabb.extend( member->aabb );
+    }
+    GL_CHECK_ERROR;
+}
+
+void StaticBatchMesh::autoVertexAttribPointer( const ShaderProgram* prog ) {
+    auto glprog           = prog->getProgramObject();
+    gl::GLint attribCount = glprog->get( GL_ACTIVE_ATTRIBUTES );
+
+    m_vao->bind();
+    for ( GLint idx = 0; idx < attribCount; ++idx )
+    {
+        const gl::GLsizei bufSize = 256;
+        gl::GLchar name[bufSize];
+        gl::GLsizei length;
+        gl::GLint size;
+        gl::GLenum type;
+        glprog->getActiveAttrib( idx, bufSize, &length, &size, &type, name );
+        auto loc = glprog->getAttributeLocation( name );
+
+        auto it = m_handleToBuffer.find( name );
+        if ( it != m_handleToBuffer.end() )
+        {
+            const auto dim = GLint( m_layout[it->second].second );
+            m_vao->enable( loc );
+            auto binding = m_vao->binding( idx );
+            binding->setAttribute( loc );
+            binding->setBuffer( m_vbos[it->second].get(), 0, GLint( dim * sizeof( float ) ) );
+            binding->setFormat( dim, GL_FLOAT );
+        }
+        else
+        { m_vao->disable( loc ); }
+    }
+    m_vao->unbind();
+}
+
+void StaticBatchMesh::render( const ShaderProgram* prog ) {
+    if ( !m_vao || m_members.empty() ) { return; }
+    autoVertexAttribPointer( prog );
+    m_vao->bind();
+    const auto draw = [this]( size_t first, size_t count ) {
+        m_vao->drawElements( static_cast<GLenum>( m_renderMode ),
+                             GLsizei( count ),
+                             GL_UNSIGNED_INT,
+                             reinterpret_cast<const void*>( first * sizeof( uint ) ) );
+    };
+
+    if ( prog->getProgramObject()->getUniformLocation( "objectId" ) >= 0 )
+    {
+        // picking: one draw per member, so that its triangles are numbered
+        // from 0, with the index of its own render object
+        for ( const auto& member : m_members )
+        {
+            auto ro = member->ro.lock();
+            if ( !ro || !member->placed || !ro->isVisible() || !ro->isPickable() ) { continue; }
+            prog->setUniform( "objectId", member->roIndex.getValue() );
+            draw( member->firstIndex, member->indexCount );
+        }
+    }
+    else
+    {
+        // one draw per run of contiguous visible members
+        size_t first = 0;
+        size_t count = 0;
+        for ( const auto& member : m_members )
+        {
+            auto ro = member->ro.lock();
+            if ( !ro || !member->placed || !ro->isVisible() ) { continue; }
+            if ( count > 0 && member->firstIndex == first + count )
+            { count += member->indexCount; }
+            else
+            {
+                if ( count > 0 ) { draw( first, count ); }
+                first = member->firstIndex;
+                count = member->indexCount;
+            }
+        }
+        if ( count > 0 ) { draw( first, count ); }
+    }
+    m_vao->unbind();
+}
+
+size_t StaticBatchMesh::getNumFaces() const {
+    size_t faces = 0;
+    for ( const auto& member : m_members )
+    {
+        faces += member->indexCount / 3;
+    }
+    return faces;
+}
+
+size_t StaticBatchMesh::getNumVertices() const {
+    size_t vertices = 0;
+    for ( const auto& member : m_members )
+    {
+        vertices += member->vertexCount;
+    }
+    return vertices;
+}
+
+} // namespace Engine
+} // namespace Ra
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <Engine/RaEngine.hpp>
+#include <Engine/Renderer/Mesh/Mesh.hpp>
+
+#include <Core/Geometry/AbstractGeometry.hpp>
+#include <Core/Utils/Index.hpp>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Ra {
+namespace Engine {
+class RenderObject;
+} // namespace Engine
+} // namespace Ra
+
+namespace Ra {
+namespace Engine {
+
+/**
+ * A displayable merging the triangle meshes of several render objects, its
+ * members, in shared vertex and index buffers, to draw them with a few draw
+ * calls instead of one per render object.
+ *
+ * The members must have the same float vertex attributes (names and sizes).
+ * Their vertices are transformed once, by the transform of their render
+ * object, so that the batch must be drawn with the identity transform. Each
+ * member keeps its own sub-range of the buffers:
+ * - the visible members are drawn by runs of contiguous sub-ranges,
+ * - when the shader has an objectId uniform, i.e. in the picking pass, each
+ *   visible and pickable member is drawn alone with the index of its render
+ *   object, so that picking results refer to the member and its triangles.
+ *
+ * The buffers are updated incrementally by updateGL(): a member whose
+ * geometry (vertex attributes) or transform changed is rewritten in place if
+ * its size is unchanged, and new members are appended. The buffers are only
+ * rebuilt when they are full, or when the removed members leave more than
+ * half of them unused. Members whose render object has been destroyed are
+ * removed.
+ */
+class RA_ENGINE_API StaticBatchMesh : public AttribArrayDisplayable, public VaoIndices
+{
+  public:
+    explicit StaticBatchMesh( const std::string& name );
+    ~StaticBatchMesh() override;
+
+    /// Whether the mesh of \p ro is a triangle Mesh with the vertex attributes
+    /// of the batch. Any triangle Mesh with float attributes is compatible
+    /// with an empty batch.
+    bool isCompatible( const RenderObject& ro ) const;
+
+    /// Add \p ro to the batch, which must be compatible.
+    /// \return false if \p ro is not compatible.
+    bool addMember( const std::shared_ptr<RenderObject>& ro );
+
+    /// Remove the render object of index \p roIndex from the batch.
+    /// \return false if it is not a member.
+    bool removeMember( const Core::Utils::Index& roIndex );
+
+    /// Ask for the update of a member whose indices changed. Changes of the
+    /// vertex attributes and of the transform are detected by the batch.
+    void setMemberDirty( const Core::Utils::Index& roIndex );
+
+    inline size_t getMemberCount() const { return m_members.size(); }
+
+    /// The geometry of a batch only gives the bounding box of its members.
+    const Core::Geometry::AbstractGeometry& getAbstractGeometry() const override;
+    Core::Geometry::AbstractGeometry& getAbstractGeometry() override;
+
+    /// Remove the destroyed members, and update the buffers of the modified
+    /// ones.
+    void updateGL() override;
+
+    void render( const ShaderProgram* prog ) override;
+
+    size_t getNumFaces() const override;
+    size_t getNumVertices() const override;
+
+  private:
+    struct Bounds : public Core::Geometry::AbstractGeometry {
+        void clear() override { m_aabb.setEmpty(); }
+        Core::Aabb computeAabb() const override { return m_aabb; }
+        Core::Aabb m_aabb;
+    };
+
+    /// Float vertex attribute of the batch: name and number of scalars.
+    using AttribLayout = std::vector<std::pair<std::string, size_t>>;
+
+    struct Member {
+        std::weak_ptr<RenderObject> ro;
+        Core::Utils::Index roIndex;
+        std::shared_ptr<Mesh> mesh;
+        // observers of the attributes of the mesh
+        std::vector<std::pair<std::string, int>> observers;
+        Core::Matrix4 transform;
+        Core::Aabb aabb;
+        // sub-ranges of the buffers, in vertices and indices
+        size_t firstVertex{0};
+        size_t vertexCount{0};
+        size_t firstIndex{0};
+        size_t indexCount{0};
+        bool placed{false};
+        bool dirty{true};
+    };
+
+    static bool computeLayout( const RenderObject& ro, AttribLayout& layout );
+
+    void detachObservers( Member& member );
+
+    // Whether the members fit in the buffers without rebuilding them.
+    bool fitsInBuffers() const;
+
+    // Reallocate the buffers for all the members, placed contiguously.
+    void rebuildBuffers();
+
+    // Transform and upload the data of a placed member.
+    void writeMember( Member& member );
+
+    void autoVertexAttribPointer( const ShaderProgram* prog );
+
+    AttribLayout m_layout;
+    // the members by increasing sub-ranges, which are not placed at the end
+    std::vector<std::unique_ptr<Member>> m_members;
+    Bounds m_bounds;
+
+    size_t m_vertexCapacity{0};
+    size_t m_indexCapacity{0};
+    // end of the used part of the buffers, and size of the unused sub-ranges
+    size_t m_vertexEnd{0};
+    size_t m_indexEnd{0};
+    size_t m_freeVertices{0};
+    size_t m_freeIndices{0};
+};
+
+} // namespace Engine
+} // namespace Ra
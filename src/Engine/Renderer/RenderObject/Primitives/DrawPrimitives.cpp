@@ -483,18 +483,17 @@ MeshPtr Spline( const Core::Geometry::Spline<3, 3>& spline,
                 uint pointCount,
                 const Core::Utils::Color& color,
                 Scalar /*scale*/ ) {
-    Core::Vector3Array vertices;
-    vertices.reserve( pointCount );
-
-    std::vector<uint> indices;
-    indices.reserve( pointCount * 2 - 2 );
-
+    std::vector<Scalar> params( pointCount );
     Scalar dt = Scalar( 1 ) / Scalar( pointCount - 1 );
     for ( uint i = 0; i < pointCount; ++i )
     {
-        Scalar t = dt * i;
-        vertices.push_back( spline.f( t ) );
+        params[i] = dt * i;
     }
+    Core::Vector3Array vertices;
+    spline.f( params, vertices );
+
+    std::vector<uint> indices;
+    indices.reserve( pointCount * 2 - 2 );
 
     for ( uint i = 0; i < pointCount - 1; ++i )
     {
@@ -116,6 +116,14 @@ bool RenderObject::isTransparent() const {
     return m_transparent;
 }
 
+void RenderObject::setBatched( bool batched ) {
+    m_batched = batched;
+}
+
+bool RenderObject::isBatched() const {
+    return m_batched;
+}
+
 bool RenderObject::isDirty() const {
     return m_dirty;
 }
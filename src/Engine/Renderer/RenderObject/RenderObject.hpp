@@ -116,6 +116,11 @@ class RA_ENGINE_API RenderObject final : public Core::Utils::IndexedObject
     void toggleTransparent();
     bool isTransparent() const;
 
+    /// A batched render object is drawn by a StaticBatchMesh, with its
+    /// visibility and picking, and is no longer rendered by itself.
+    void setBatched( bool batched );
+    bool isBatched() const;
+
     bool isDirty() const;
 
     void setRenderTechnique( const std::shared_ptr<RenderTechnique>& technique );
@@ -190,6 +195,7 @@ class RA_ENGINE_API RenderObject final : public Core::Utils::IndexedObject
     bool m_pickable{true};
     bool m_xray{false};
     bool m_transparent{false};
+    bool m_batched{false};
     bool m_dirty{true};
     bool m_hasLifetime{false};
 };
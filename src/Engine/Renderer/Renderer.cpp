@@ -331,7 +331,9 @@ void Renderer::feedRenderQueuesInternal( const ViewingParameters& /*renderData*/
 
     for ( auto it = m_fancyRenderObjects.begin(); it != m_fancyRenderObjects.end(); )
     {
-        if ( ( *it )->isXRay() )
+        // drawn by their batch
+        if ( ( *it )->isBatched() ) { it = m_fancyRenderObjects.erase( it ); }
+        else if ( ( *it )->isXRay() )
         {
             m_xrayRenderObjects.push_back( *it );
             it = m_fancyRenderObjects.erase( it );
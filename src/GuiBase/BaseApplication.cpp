@@ -121,6 +121,21 @@ BaseApplication::BaseApplication( int& argc,
                                "file name",
                                "foo.bar" );
     QCommandLineOption recordOpt( QStringList{"s", "recordFrames"}, "Enable snapshot recording." );
+    QCommandLineOption pointVoxelOpt( QStringList{"pointVoxelSize"},
+                                      "Downsample the loaded PLY point clouds, keeping one point "
+                                      "per voxel of the given size.",
+                                      "size",
+                                      "0" );
+    QCommandLineOption pointOutliersOpt( QStringList{"pointOutliers"},
+                                         "Remove the outliers of the loaded PLY point clouds, from "
+                                         "the mean distance to the given number of neighbours.",
+                                         "number",
+                                         "0" );
+    QCommandLineOption pointNormalsOpt( QStringList{"pointNormals"},
+                                        "Estimate the normals of the loaded PLY point clouds "
+                                        "without normals, from the given number of neighbours.",
+                                        "number",
+                                        "0" );
 
     parser.addOptions( {fpsOpt,
                         pluginOpt,
@@ -130,7 +145,10 @@ BaseApplication::BaseApplication( int& argc,
                         camOpt,
                         maxThreadsOpt,
                         numFramesOpt,
-                        recordOpt} );
+                        recordOpt,
+                        pointVoxelOpt,
+                        pointOutliersOpt,
+                        pointNormalsOpt} );
     parser.process( *this );
 
     if ( parser.isSet( fpsOpt ) ) m_targetFPS = parser.value( fpsOpt ).toUInt();
@@ -267,8 +285,15 @@ BaseApplication::BaseApplication( int& argc,
 #ifdef IO_USE_TINYPLY
     // Register before AssimpFileLoader, in order to ease override of such
     // custom loader (first loader able to load is taking the file)
-    m_engine->registerFileLoader(
-        std::shared_ptr<FileLoaderInterface>( new IO::TinyPlyFileLoader() ) );
+    {
+        auto plyLoader = std::make_shared<IO::TinyPlyFileLoader>();
+        IO::TinyPlyFileLoader::PointCloudOptions options;
+        options.voxelSize         = parser.value( pointVoxelOpt ).toFloat();
+        options.outlierNeighbours = parser.value( pointOutliersOpt ).toUInt();
+        options.normalNeighbours  = parser.value( pointNormalsOpt ).toUInt();
+        plyLoader->setPointCloudOptions( options );
+        m_engine->registerFileLoader( plyLoader );
+    }
 #endif
     m_engine->registerFileLoader(
         std::shared_ptr<FileLoaderInterface>( new IO::CameraFileLoader() ) );
@@ -0,0 +1,219 @@
+#include <IO/PlyPointSource/PlyPointSource.hpp>
+
+#include <Core/Utils/Log.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+namespace Ra {
+namespace IO {
+
+using namespace Core::Utils; // log
+
+namespace {
+
+const std::string propertyNames[10] = {
+    "x", "y", "z", "nx", "ny", "nz", "red", "green", "blue", "alpha"};
+
+template <typename T>
+inline double value( const char* data ) {
+    T v;
+    std::memcpy( &v, data, sizeof( T ) );
+    return double( v );
+}
+
+inline bool isLittleEndian() {
+    const std::uint16_t one = 1;
+    char first;
+    std::memcpy( &first, &one, 1 );
+    return first == 1;
+}
+
+} // namespace
+
+PlyPointSource::PlyPointSource( const std::string& filename ) :
+    m_file( filename, std::ios::binary ) {
+    m_valid = m_file && readHeader();
+    if ( !m_valid )
+    { LOG( logERROR ) << "[PlyPointSource] Can not read the points of " << filename; }
+}
+
+bool PlyPointSource::readHeader() {
+    std::string line;
+    if ( !std::getline( m_file, line ) || line.compare( 0, 3, "ply" ) != 0 ) { return false; }
+    bool vertices = false;
+    bool done     = false;
+    int found     = 0; // bit i set if the property propertyNames[i] is found
+    while ( !done && std::getline( m_file, line ) )
+    {
+        if ( !line.empty() && line.back() == '\r' ) { line.pop_back(); }
+        std::istringstream ss( line );
+        std::string keyword;
+        ss >> keyword;
+        if ( keyword == "format" )
+        {
+            std::string format;
+            ss >> format;
+            if ( format == "ascii" ) { m_format = Format::ASCII; }
+            else if ( format == "binary_little_endian" )
+            { m_format = Format::BINARY_LITTLE_ENDIAN; }
+            else if ( format == "binary_big_endian" )
+            { m_format = Format::BINARY_BIG_ENDIAN; }
+            else
+            { return false; }
+        }
+        else if ( keyword == "element" )
+        {
+            std::string name;
+            size_t count = 0;
+            ss >> name >> count;
+            if ( name == "vertex" ) { m_size = count; }
+            // the vertices must come first, the next elements are ignored
+            else if ( !vertices && count > 0 )
+            {
+                LOG( logERROR ) << "[PlyPointSource] Element " << name << " before the vertices";
+                return false;
+            }
+            vertices = name == "vertex";
+        }
+        else if ( keyword == "property" && vertices )
+        {
+            std::string type;
+            std::string name;
+            ss >> type >> name;
+            Property property;
+            if ( type == "char" || type == "int8" ) { property = {Type::INT8, 1, -1}; }
+            else if ( type == "uchar" || type == "uint8" )
+            { property = {Type::UINT8, 1, -1}; }
+            else if ( type == "short" || type == "int16" )
+            { property = {Type::INT16, 2, -1}; }
+            else if ( type == "ushort" || type == "uint16" )
+            { property = {Type::UINT16, 2, -1}; }
+            else if ( type == "int" || type == "int32" )
+            { property = {Type::INT32, 4, -1}; }
+            else if ( type == "uint" || type == "uint32" )
+            { property = {Type::UINT32, 4, -1}; }
+            else if ( type == "float" || type == "float32" )
+            { property = {Type::FLOAT32, 4, -1}; }
+            else if ( type == "double" || type == "float64" )
+            { property = {Type::FLOAT64, 8, -1}; }
+            else
+            {
+                LOG( logERROR ) << "[PlyPointSource] Unsupported vertex property " << line;
+                return false;
+            }
+            const auto it =
+                std::find( std::begin( propertyNames ), std::end( propertyNames ), name );
+            if ( it != std::end( propertyNames ) )
+            {
+                property.target = int( it - std::begin( propertyNames ) );
+                found |= 1 << property.target;
+            }
+            m_properties.push_back( property );
+            m_recordSize += property.size;
+        }
+        else if ( keyword == "end_header" )
+        { done = true; }
+    }
+    if ( !done || ( found & 0x7 ) != 0x7 ) { return false; }
+    m_hasNormals = ( found & 0x38 ) == 0x38;
+    m_hasColors  = ( found & 0x1c0 ) == 0x1c0;
+    m_dataStart  = m_file.tellg();
+    return true;
+}
+
+double PlyPointSource::decode( const char* data, const Property& property ) const {
+    char bytes[8];
+    std::memcpy( bytes, data, property.size );
+    if ( ( m_format == Format::BINARY_LITTLE_ENDIAN ) != isLittleEndian() )
+    { std::reverse( bytes, bytes + property.size ); }
+    switch ( property.type )
+    {
+    case Type::INT8:
+        return value<std::int8_t>( bytes );
+    case Type::UINT8:
+        return value<std::uint8_t>( bytes );
+    case Type::INT16:
+        return value<std::int16_t>( bytes );
+    case Type::UINT16:
+        return value<std::uint16_t>( bytes );
+    case Type::INT32:
+        return value<std::int32_t>( bytes );
+    case Type::UINT32:
+        return value<std::uint32_t>( bytes );
+    case Type::FLOAT32:
+        return value<float>( bytes );
+    case Type::FLOAT64:
+        return value<double>( bytes );
+    }
+    return 0;
+}
+
+void PlyPointSource::reset() {
+    m_file.clear();
+    m_file.seekg( m_dataStart );
+    m_next = 0;
+}
+
+size_t PlyPointSource::read( const size_t maxCount,
+                             Core::Vector3Array& points,
+                             Core::Vector3Array& normals,
+                             Core::Vector4Array& colors ) {
+    points.clear();
+    normals.clear();
+    colors.clear();
+    if ( !m_valid ) { return 0; }
+    const size_t n = std::min( maxCount, m_size - m_next );
+    points.reserve( n );
+    normals.reserve( m_hasNormals ? n : 0 );
+    colors.reserve( m_hasColors ? n : 0 );
+
+    std::vector<char> buffer;
+    if ( m_format != Format::ASCII )
+    {
+        buffer.resize( n * m_recordSize );
+        m_file.read( buffer.data(), std::streamsize( buffer.size() ) );
+        if ( !m_file ) { return 0; }
+    }
+
+    double values[10];
+    for ( size_t i = 0; i < n; ++i )
+    {
+        std::fill( std::begin( values ), std::end( values ), 1. );
+        const char* data = m_format == Format::ASCII ? nullptr : buffer.data() + i * m_recordSize;
+        for ( const auto& property : m_properties )
+        {
+            double v = 0;
+            if ( m_format == Format::ASCII ) { m_file >> v; }
+            else
+            {
+                v = decode( data, property );
+                data += property.size;
+            }
+            if ( property.target < 0 ) { continue; }
+            // integer colors are normalized
+            if ( property.target >= 6 && property.type == Type::UINT8 ) { v /= 255; }
+            else if ( property.target >= 6 && property.type == Type::UINT16 )
+            { v /= 65535; }
+            values[property.target] = v;
+        }
+        if ( !m_file ) { return 0; }
+        points.emplace_back( Scalar( values[0] ), Scalar( values[1] ), Scalar( values[2] ) );
+        if ( m_hasNormals )
+        { normals.emplace_back( Scalar( values[3] ), Scalar( values[4] ), Scalar( values[5] ) ); }
+        if ( m_hasColors )
+        {
+            colors.emplace_back( Scalar( values[6] ),
+                                 Scalar( values[7] ),
+                                 Scalar( values[8] ),
+                                 Scalar( values[9] ) );
+        }
+    }
+    m_next += n;
+    return n;
+}
+
+} // namespace IO
+} // namespace Ra
@@ -0,0 +1,73 @@
+#ifndef RADIUMENGINE_PLYPOINTSOURCE_HPP
+#define RADIUMENGINE_PLYPOINTSOURCE_HPP
+
+#include <Core/Geometry/PointCloudOctree.hpp>
+#include <IO/RaIO.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Ra {
+namespace IO {
+
+/// Streaming reader of the vertices of a PLY file, to convert point clouds
+/// which do not fit in memory with Core::Geometry::buildPointCloudOctree().
+/// Ascii and binary files are supported, the vertex element must be the first
+/// element of the file and must not have list properties. The positions are
+/// read from the x, y, z properties, the normals from nx, ny, nz and the colors
+/// from red, green, blue and the optional alpha, integer colors being
+/// normalized to [0, 1].
+class RA_IO_API PlyPointSource : public Core::Geometry::PointSource
+{
+  public:
+    /// Open \p filename and read its header.
+    explicit PlyPointSource( const std::string& filename );
+
+    /// Whether the file has been opened and its header is supported.
+    inline bool isValid() const { return m_valid; }
+
+    /// Number of vertices of the file.
+    inline size_t size() const { return m_size; }
+
+    bool hasNormals() const override { return m_hasNormals; }
+    bool hasColors() const override { return m_hasColors; }
+    void reset() override;
+    size_t read( size_t maxCount,
+                 Core::Vector3Array& points,
+                 Core::Vector3Array& normals,
+                 Core::Vector4Array& colors ) override;
+
+  private:
+    enum class Format { ASCII, BINARY_LITTLE_ENDIAN, BINARY_BIG_ENDIAN };
+    enum class Type { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+    struct Property {
+        Type type;
+        size_t size;
+        // index of the value in x, y, z, nx, ny, nz, red, green, blue, alpha,
+        // -1 if the property is ignored
+        int target;
+    };
+
+    bool readHeader();
+
+    // Value of a property of a binary record.
+    double decode( const char* data, const Property& property ) const;
+
+    std::ifstream m_file;
+    std::streampos m_dataStart{0};
+    Format m_format{Format::ASCII};
+    std::vector<Property> m_properties;
+    size_t m_recordSize{0};
+    size_t m_size{0};
+    size_t m_next{0};
+    bool m_hasNormals{false};
+    bool m_hasColors{false};
+    bool m_valid{false};
+};
+
+} // namespace IO
+} // namespace Ra
+
+#endif // RADIUMENGINE_PLYPOINTSOURCE_HPP
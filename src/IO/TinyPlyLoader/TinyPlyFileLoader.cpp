@@ -1,6 +1,7 @@
 #include <IO/TinyPlyLoader/TinyPlyFileLoader.hpp>
 
 #include <Core/Asset/FileData.hpp>
+#include <Core/Geometry/PointCloudProcessing.hpp>
 
 #include <tinyply.h>
 
@@ -182,6 +183,37 @@ FileData* TinyPlyFileLoader::loadFile( const std::string& filename ) {
         }
     }
 
+    if ( m_options.voxelSize > 0 || m_options.outlierNeighbours > 0 )
+    {
+        const size_t inputSize = geometry->getVerticesSize();
+        if ( m_options.voxelSize > 0 )
+        {
+            Core::Geometry::downsampleVoxelGrid( m_options.voxelSize,
+                                                 geometry->getVertices(),
+                                                 geometry->getNormals(),
+                                                 geometry->getColors() );
+        }
+        if ( m_options.outlierNeighbours > 0 )
+        {
+            Core::Geometry::removeStatisticalOutliers( m_options.outlierNeighbours,
+                                                       m_options.outlierStdDevRatio,
+                                                       geometry->getVertices(),
+                                                       geometry->getNormals(),
+                                                       geometry->getColors() );
+        }
+        LOG( logINFO ) << "[TinyPLY] Point cloud reduced from " << inputSize << " to "
+                       << geometry->getVerticesSize() << " points";
+    }
+
+    if ( m_options.normalNeighbours > 0 && !geometry->hasNormals() )
+    {
+        Core::Geometry::estimateNormals( m_options.normalNeighbours,
+                                         geometry->getVertices(),
+                                         geometry->getNormals() );
+        LOG( logINFO ) << "[TinyPLY] Normals estimated from " << m_options.normalNeighbours
+                       << " neighbours";
+    }
+
     fileData->m_loadingTime = ( std::clock() - startTime ) / Scalar( CLOCKS_PER_SEC );
 
     fileData->m_geometryData.push_back( std::move( geometry ) );
@@ -2,6 +2,7 @@
 #define RADIUMENGINE_TINYPLYFILELOADER_HPP
 
 #include <Core/Asset/FileLoaderInterface.hpp>
+#include <Core/Types.hpp>
 #include <IO/RaIO.hpp>
 
 namespace Ra {
@@ -18,6 +19,31 @@ class RA_IO_API TinyPlyFileLoader : public Core::Asset::FileLoaderInterface
     bool handleFileExtension( const std::string& extension ) const override;
     Core::Asset::FileData* loadFile( const std::string& filename ) override;
     std::string name() const override;
+
+    /// Optional processing of the loaded point clouds, downsampling first, see
+    /// Core::Geometry::downsampleVoxelGrid(),
+    /// Core::Geometry::removeStatisticalOutliers() and
+    /// Core::Geometry::estimateNormals().
+    struct PointCloudOptions {
+        /// Side of the voxels of the downsampling, disabled when 0.
+        Scalar voxelSize{0};
+        /// Number of neighbours of the outlier removal, disabled when 0.
+        uint outlierNeighbours{0};
+        /// Number of standard deviations of the outlier removal.
+        Scalar outlierStdDevRatio{1};
+        /// Number of neighbours of the estimation of the normals of the clouds
+        /// without normals, disabled when 0.
+        uint normalNeighbours{0};
+    };
+
+    /// Set the processing applied to the point clouds loaded afterwards.
+    void setPointCloudOptions( const PointCloudOptions& options ) { m_options = options; }
+
+    /// Processing applied to the loaded point clouds.
+    const PointCloudOptions& pointCloudOptions() const { return m_options; }
+
+  private:
+    PointCloudOptions m_options;
 };
 
 } // namespace IO
@@ -1,6 +1,110 @@
+#include <Core/Animation/BakedClip.hpp>
+#include <Core/Animation/BlendTree.hpp>
+#include <Core/Animation/BulgeCorrection.hpp>
+#include <Core/Animation/CageDeformation.hpp>
+#include <Core/Animation/CompressedClip.hpp>
+#include <Core/Animation/DualQuaternionSkinning.hpp>
 #include <Core/Animation/HandleWeightOperation.hpp>
+#include <Core/Animation/LinearBlendSkinning.hpp>
+#include <Core/Animation/PoseOperation.hpp>
+#include <Core/Animation/RotationCenterSkinning.hpp>
+#include <Core/Animation/Skeleton.hpp>
+#include <Core/Animation/SkinningScheduler.hpp>
+#include <Core/Geometry/MeshCleanup.hpp>
+#include <Core/Geometry/MeshPrimitives.hpp>
+#include <Core/Geometry/TriangleOperation.hpp>
+#include <Core/Tasks/TaskQueue.hpp>
+#include <Core/Utils/Timer.hpp>
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <random>
+
+namespace {
+
+using namespace Ra::Core;
+using namespace Ra::Core::Animation;
+
+// Random character: vertices in the unit cube, influenced by up to
+// maxInfluences of nbBones random bones, with weights summing to 1, and a
+// random pose of rotations up to maxAngle, scales and translations.
+struct Character {
+    Vector3Array vertices;
+    Vector3Array normals;
+    WeightMatrix weights;
+    Pose pose;
+};
+
+// Random keyframes of a bone, at irregular times in [0, 10].
+KeyTransform makeTrack( std::mt19937& gen, int nbKeys ) {
+    std::uniform_real_distribution<Scalar> dis( -1_ra, 1_ra );
+    KeyTransform track;
+    for ( int k = 0; k < nbKeys; ++k )
+    {
+        Transform t = Transform::Identity();
+        t.translate( Vector3( dis( gen ), dis( gen ), dis( gen ) ) );
+        const Vector3 axis = Vector3( dis( gen ), dis( gen ), 1_ra ).normalized();
+        t.rotate( AngleAxis( dis( gen ) * 3_ra, axis ) );
+        t.scale( Vector3( 1_ra + dis( gen ) / 4, 1_ra + dis( gen ) / 4, 1_ra ) );
+        track.insertKeyFrame( 10_ra * ( k + ( dis( gen ) + 1 ) / 4 ) / nbKeys, t );
+    }
+    return track;
+}
+
+Character makeCharacter( int size, int nbBones, int maxInfluences, Scalar maxAngle = 3_ra ) {
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dis( -1_ra, 1_ra );
+    std::uniform_int_distribution<int> bone( 0, nbBones - 1 );
+    std::uniform_int_distribution<int> influences( 1, maxInfluences );
+    Character c;
+    c.vertices.resize( size_t( size ) );
+    c.normals.resize( size_t( size ) );
+    for ( int i = 0; i < size; ++i )
+    {
+        c.vertices[i] = Vector3( dis( gen ), dis( gen ), dis( gen ) );
+        c.normals[i]  = Vector3( dis( gen ), dis( gen ), dis( gen ) ).normalized();
+    }
+    std::vector<Eigen::Triplet<Scalar>> triplets;
+    for ( int i = 0; i < size; ++i )
+    {
+        std::vector<int> bones;
+        const int n = influences( gen );
+        while ( int( bones.size() ) < n )
+        {
+            const int b = bone( gen );
+            if ( std::find( bones.begin(), bones.end(), b ) == bones.end() )
+            { bones.push_back( b ); }
+        }
+        std::vector<Scalar> w( bones.size() );
+        Scalar sum = 0;
+        for ( auto& x : w )
+        {
+            x = dis( gen ) + 1.5_ra;
+            sum += x;
+        }
+        for ( size_t k = 0; k < bones.size(); ++k )
+        {
+            triplets.emplace_back( i, bones[k], w[k] / sum );
+        }
+    }
+    c.weights.resize( size, nbBones );
+    c.weights.setFromTriplets( triplets.begin(), triplets.end() );
+    for ( int j = 0; j < nbBones; ++j )
+    {
+        Transform t = Transform::Identity();
+        t.translate( Vector3( dis( gen ), dis( gen ), dis( gen ) ) );
+        const Vector3 axis = Vector3( dis( gen ), dis( gen ), 1_ra ).normalized();
+        t.rotate( AngleAxis( dis( gen ) * maxAngle, axis ) );
+        t.scale( 1_ra + dis( gen ) / 4 );
+        c.pose.push_back( t );
+    }
+    return c;
+}
+
+} // namespace
+
 TEST_CASE( "Core/Animation/HandleWeightOperation",
            "[Core][Core/Animation][HandleWeightOperation]" ) {
     using namespace Ra::Core;
@@ -41,3 +145,836 @@ TEST_CASE( "Core/Animation/HandleWeightOperation",
         REQUIRE( !Ra::Core::Animation::checkWeightMatrix( matrix2, false ) );
     }
 }
+
+TEST_CASE( "Core/Animation/LinearBlendSkinning", "[Core][Core/Animation][LinearBlendSkinning]" ) {
+    const Character c = makeCharacter( 1000, 20, 4 );
+    Vector3Array reference;
+    linearBlendSkinning( c.vertices, c.pose, c.weights, reference );
+
+    SECTION( "Packed weights" ) {
+        for ( uint k : {4u, 5u, 8u} )
+        {
+            PackedWeights packed;
+            REQUIRE( packWeights( c.weights, k, packed ) == 0 );
+            REQUIRE( packed.m_size == c.vertices.size() );
+            REQUIRE( packed.m_weights.size() == k * c.vertices.size() );
+            Vector3Array skinned;
+            linearBlendSkinning( c.vertices, c.pose, packed, skinned );
+            REQUIRE( skinned.size() == reference.size() );
+            for ( size_t i = 0; i < skinned.size(); ++i )
+            {
+                REQUIRE( skinned[i].isApprox( reference[i], 1e-4_ra ) );
+            }
+        }
+
+        // the largest influences are kept, with the same sum
+        PackedWeights packed;
+        REQUIRE( packWeights( c.weights, 2, packed ) > 0 );
+        const Eigen::SparseMatrix<Scalar, Eigen::RowMajor> rows = c.weights;
+        for ( uint i = 0; i < packed.m_size; ++i )
+        {
+            const Scalar w0 = packed.m_weights[i];
+            const Scalar w1 = packed.m_weights[packed.m_size + i];
+            REQUIRE( w0 + w1 == Approx( 1 ).epsilon( 1e-5 ) );
+            REQUIRE( w0 >= w1 );
+            for ( Eigen::SparseMatrix<Scalar, Eigen::RowMajor>::InnerIterator it( rows, i ); it;
+                  ++it )
+            {
+                if ( uint( it.col() ) == packed.m_bones[i] ) { continue; }
+                if ( w1 > 0 && uint( it.col() ) == packed.m_bones[packed.m_size + i] ) { continue; }
+                REQUIRE( it.value() <= rows.coeff( i, packed.m_bones[i] ) );
+            }
+        }
+    }
+
+    SECTION( "Normals and tangents" ) {
+        // a rigid pose rotates the normals
+        Transform t = Transform::Identity();
+        t.translate( Vector3( 1_ra, 2_ra, 3_ra ) );
+        t.rotate( AngleAxis( 1_ra, Vector3( 1_ra, 1_ra, 0_ra ).normalized() ) );
+        const Pose pose( c.pose.size(), t );
+        PackedWeights packed;
+        packWeights( c.weights, 4, packed );
+        Vector3Array positions;
+        Vector3Array normals;
+        Vector3Array tangents;
+        linearBlendSkinning(
+            c.vertices, c.normals, c.normals, pose, packed, positions, normals, tangents );
+        REQUIRE( normals.size() == c.normals.size() );
+        REQUIRE( tangents.size() == c.normals.size() );
+        for ( size_t i = 0; i < positions.size(); ++i )
+        {
+            REQUIRE( positions[i].isApprox( t * c.vertices[i], 1e-4_ra ) );
+            REQUIRE( normals[i].isApprox( t.linear() * c.normals[i], 1e-4_ra ) );
+            REQUIRE( tangents[i].isApprox( normals[i] ) );
+        }
+
+        // without tangents
+        tangents.resize( 10 );
+        linearBlendSkinning(
+            c.vertices, c.normals, {}, c.pose, packed, positions, normals, tangents );
+        REQUIRE( tangents.empty() );
+        for ( size_t i = 0; i < positions.size(); ++i )
+        {
+            REQUIRE( positions[i].isApprox( reference[i], 1e-4_ra ) );
+            REQUIRE( normals[i].norm() == Approx( 1 ) );
+        }
+    }
+}
+
+TEST_CASE( "Core/Animation/LinearBlendSkinning/Benchmark", "[.][benchmark]" ) {
+    for ( int influences : {4, 8} )
+    {
+        const Character c = makeCharacter( 1000000, 64, influences );
+        PackedWeights packed;
+        packWeights( c.weights, uint( influences ), packed );
+        Vector3Array positions;
+        Vector3Array normals;
+        Vector3Array tangents;
+        std::cout << "Skinning of 1M vertices with up to " << influences << " influences\n";
+
+        auto start = Utils::Clock::now();
+        linearBlendSkinning( c.vertices, c.pose, c.weights, positions );
+        auto end = Utils::Clock::now();
+        std::cout << "  sparse weights: " << Utils::getIntervalMicro( start, end ) / 1000
+                  << " ms\n";
+        start = Utils::Clock::now();
+        linearBlendSkinning( c.vertices, c.pose, packed, positions );
+        end = Utils::Clock::now();
+        std::cout << "  packed weights: " << Utils::getIntervalMicro( start, end ) / 1000
+                  << " ms";
+        start = Utils::Clock::now();
+        linearBlendSkinning(
+            c.vertices, c.normals, c.normals, c.pose, packed, positions, normals, tangents );
+        end = Utils::Clock::now();
+        std::cout << ", with normals and tangents: "
+                  << Utils::getIntervalMicro( start, end ) / 1000 << " ms\n";
+    }
+}
+
+TEST_CASE( "Core/Animation/DualQuaternionSkinning",
+           "[Core][Core/Animation][DualQuaternionSkinning]" ) {
+    SECTION( "Packed weights" ) {
+        // with close rotations, all the dual quaternions are in the same hemisphere
+        const Character c = makeCharacter( 1000, 20, 4, 0.5_ra );
+        DQList DQ;
+        Vector3Array reference;
+        computeDQ_naive( c.pose, c.weights, DQ );
+        dualQuaternionSkinning( c.vertices, DQ, reference );
+        for ( uint k : {4u, 5u, 8u} )
+        {
+            PackedWeights packed;
+            packWeights( c.weights, k, packed );
+            Vector3Array skinned;
+            Vector3Array normals;
+            dualQuaternionSkinning( c.vertices, c.normals, c.pose, packed, skinned, normals );
+            REQUIRE( skinned.size() == reference.size() );
+            REQUIRE( normals.size() == c.normals.size() );
+            for ( size_t i = 0; i < skinned.size(); ++i )
+            {
+                REQUIRE( skinned[i].isApprox( reference[i], 1e-4_ra ) );
+                REQUIRE( normals[i].isApprox( DQ[i].rotate( c.normals[i] ), 1e-4_ra ) );
+            }
+        }
+    }
+
+    SECTION( "Hemisphere" ) {
+        // rotations of nearly +pi and -pi around z have opposite quaternions
+        Transform t0 = Transform::Identity();
+        Transform t1 = Transform::Identity();
+        t0.rotate( AngleAxis( Math::Pi - 0.1_ra, Vector3::UnitZ() ) );
+        t1.rotate( AngleAxis( 0.1_ra - Math::Pi, Vector3::UnitZ() ) );
+        const Pose pose {t0, t1};
+        WeightMatrix weights( 3, 2 );
+        weights.insert( 0, 0 ) = 0.5_ra;
+        weights.insert( 0, 1 ) = 0.5_ra;
+        weights.insert( 1, 1 ) = 1_ra;
+        // the last vertex has no weight
+        const Vector3Array vertices {Vector3::UnitX(), Vector3::UnitX(), Vector3::UnitX()};
+        PackedWeights packed;
+        packWeights( weights, 2, packed );
+        Vector3Array skinned;
+        dualQuaternionSkinning( vertices, pose, packed, skinned );
+        REQUIRE( skinned[0].isApprox( -Vector3::UnitX(), 1e-4_ra ) );
+        REQUIRE( skinned[1].isApprox( t1 * vertices[1], 1e-4_ra ) );
+        REQUIRE( skinned[2] == vertices[2] );
+    }
+}
+
+TEST_CASE( "Core/Animation/SkinningScheduler", "[Core][Core/Animation][SkinningScheduler]" ) {
+    using Method = SkinningScheduler::Method;
+    std::vector<Character> characters;
+    std::vector<PackedWeights> packed( 4 );
+    for ( int c = 0; c < 4; ++c )
+    {
+        characters.push_back( makeCharacter( 500 + 1000 * c, 10 + c, 4, 0.5_ra ) );
+        packWeights( characters[c].weights, 4 + uint( c ) % 2, packed[c] );
+    }
+    TaskQueue queue( 2 );
+    // small chunks, to split the meshes
+    SkinningScheduler scheduler( 16 * 1024 );
+    for ( int c = 0; c < 4; ++c )
+    {
+        SkinningScheduler::Job job;
+        job.vertices = &characters[c].vertices;
+        job.normals  = c < 2 ? &characters[c].normals : nullptr;
+        job.pose     = &characters[c].pose;
+        job.weights  = &packed[c];
+        job.method   = c % 2 == 0 ? Method::LinearBlend : Method::DualQuaternion;
+        REQUIRE( scheduler.addJob( job ) == size_t( c ) );
+    }
+    REQUIRE( scheduler.getJobCount() == 4 );
+
+    const Vector3Array none;
+    const auto check = [&]() {
+        for ( int c = 0; c < 4; ++c )
+        {
+            const Character& character  = characters[c];
+            const Vector3Array& normals = c < 2 ? character.normals : none;
+            Vector3Array positions;
+            Vector3Array skinnedNormals;
+            Vector3Array tangents;
+            if ( c % 2 == 0 )
+            {
+                linearBlendSkinning( character.vertices,
+                                     normals,
+                                     {},
+                                     character.pose,
+                                     packed[c],
+                                     positions,
+                                     skinnedNormals,
+                                     tangents );
+            }
+            else
+            {
+                dualQuaternionSkinning( character.vertices,
+                                        normals,
+                                        character.pose,
+                                        packed[c],
+                                        positions,
+                                        skinnedNormals );
+            }
+            REQUIRE( scheduler.getVertices( c ) == positions );
+            REQUIRE( scheduler.getNormals( c ) == skinnedNormals );
+        }
+    };
+
+    const auto& stats = scheduler.run( &queue );
+    REQUIRE( stats.jobs == 4 );
+    REQUIRE( stats.vertices == 500 + 1500 + 2500 + 3500 );
+    REQUIRE( stats.chunks > 4 );
+    check();
+
+    // the output buffers are reused by the next batch
+    const Vector3* buffer = scheduler.getVertices( 3 ).data();
+    for ( auto& character : characters )
+    {
+        for ( auto& t : character.pose )
+        {
+            t.rotate( AngleAxis( 0.1_ra, Vector3::UnitX() ) );
+        }
+    }
+    scheduler.run( &queue );
+    REQUIRE( scheduler.getVertices( 3 ).data() == buffer );
+    check();
+}
+
+TEST_CASE( "Core/Animation/Skeleton", "[Core][Core/Animation][Skeleton]" ) {
+    using SpaceType = HandleArray::SpaceType;
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dis( -1_ra, 1_ra );
+    const auto randomTransform = [&]() {
+        Transform t = Transform::Identity();
+        t.translate( Vector3( dis( gen ), dis( gen ), dis( gen ) ) );
+        const Vector3 axis = Vector3( dis( gen ), dis( gen ), 1_ra ).normalized();
+        t.rotate( AngleAxis( dis( gen ) * 3_ra, axis ) );
+        return t;
+    };
+    // random hierarchy of two trees
+    const auto makeSkeleton = [&]() {
+        Skeleton skeleton;
+        skeleton.addRoot( randomTransform() );
+        skeleton.addRoot( randomTransform() );
+        for ( uint i = 2; i < 50; ++i )
+        {
+            std::uniform_int_distribution<uint> parent( 0, i - 1 );
+            skeleton.addBone( parent( gen ), randomTransform() );
+        }
+        return skeleton;
+    };
+    // model space from the local one, without dirty flags
+    const auto checkModelSpace = []( const Skeleton& skeleton ) {
+        const auto& local = skeleton.getPose( SpaceType::LOCAL );
+        Pose model( local.size() );
+        for ( uint i = 0; i < skeleton.size(); ++i )
+        {
+            const int parent = skeleton.m_graph.parents()[i];
+            model[i]         = parent < 0 ? local[i] : model[parent] * local[i];
+            REQUIRE( skeleton.getTransform( i, SpaceType::MODEL )
+                         .matrix()
+                         .isApprox( model[i].matrix(), 1e-4_ra ) );
+        }
+    };
+
+    Skeleton skeleton = makeSkeleton();
+    checkModelSpace( skeleton );
+
+    SECTION( "Local transforms" ) {
+        // joints set one at a time, the model space being read in between or not
+        for ( int k = 0; k < 20; ++k )
+        {
+            std::uniform_int_distribution<uint> joint( 0, skeleton.size() - 1 );
+            skeleton.setTransform( joint( gen ), randomTransform(), SpaceType::LOCAL );
+            skeleton.setTransform( joint( gen ), randomTransform(), SpaceType::LOCAL );
+            if ( k % 2 == 0 ) { checkModelSpace( skeleton ); }
+        }
+        checkModelSpace( skeleton );
+
+        Pose pose( skeleton.size() );
+        for ( auto& t : pose )
+        {
+            t = randomTransform();
+        }
+        skeleton.setPose( pose, SpaceType::LOCAL );
+        checkModelSpace( skeleton );
+    }
+
+    SECTION( "Model transforms" ) {
+        const Pose model = skeleton.getPose( SpaceType::MODEL );
+        Pose pose( skeleton.size() );
+        for ( auto& t : pose )
+        {
+            t = randomTransform();
+        }
+        skeleton.setPose( pose, SpaceType::MODEL );
+        checkModelSpace( skeleton );
+        for ( uint i = 0; i < skeleton.size(); ++i )
+        {
+            REQUIRE( skeleton.getTransform( i, SpaceType::MODEL )
+                         .matrix()
+                         .isApprox( pose[i].matrix(), 1e-4_ra ) );
+        }
+
+        // the children keep their model space transform
+        const uint joint  = skeleton.m_graph.children()[0].empty() ? 1 : 0;
+        const Transform t = randomTransform();
+        skeleton.setTransform( joint, t, SpaceType::MODEL );
+        checkModelSpace( skeleton );
+        for ( uint i = 0; i < skeleton.size(); ++i )
+        {
+            const Transform& expected = i == joint ? t : pose[i];
+            REQUIRE( skeleton.getTransform( i, SpaceType::MODEL )
+                         .matrix()
+                         .isApprox( expected.matrix(), 1e-4_ra ) );
+        }
+    }
+
+    SECTION( "Batch update" ) {
+        std::vector<Skeleton> skeletons( 8, skeleton );
+        std::vector<Skeleton*> pointers;
+        for ( auto& s : skeletons )
+        {
+            for ( int k = 0; k < 5; ++k )
+            {
+                std::uniform_int_distribution<uint> joint( 0, s.size() - 1 );
+                s.setTransform( joint( gen ), randomTransform(), SpaceType::LOCAL );
+            }
+            pointers.push_back( &s );
+        }
+        Skeleton::updateModelSpaces( pointers );
+        for ( const auto& s : skeletons )
+        {
+            checkModelSpace( s );
+        }
+    }
+}
+
+TEST_CASE( "Core/Animation/BakedClip", "[Core][Core/Animation][BakedClip]" ) {
+    std::mt19937 gen( 0 );
+    std::vector<KeyTransform> tracks;
+    BakedClip clip;
+    for ( int k : {20, 1, 0, 7, 50} )
+    {
+        tracks.push_back( makeTrack( gen, k ) );
+        REQUIRE( clip.addTrack( tracks.back() ) == tracks.size() - 1 );
+    }
+    REQUIRE( clip.getTrackCount() == 5 );
+    REQUIRE( clip.getKeyCount( 0 ) == 20 );
+    REQUIRE( clip.getKeyCount( 2 ) == 1 );
+
+    const auto check = [&]( const Pose& pose, Scalar t ) {
+        REQUIRE( pose.size() == tracks.size() );
+        for ( size_t k = 0; k < tracks.size(); ++k )
+        {
+            const Transform expected =
+                tracks[k].empty() ? Transform::Identity() : tracks[k].at( t );
+            REQUIRE( pose[k].matrix().isApprox( expected.matrix(), 1e-4_ra ) );
+        }
+    };
+
+    SECTION( "Playback" ) {
+        // forward, with exact key times, then looping backward
+        BakedClip::ClipCursor cursor;
+        Pose pose;
+        for ( Scalar t = -1_ra; t < 11_ra; t += 0.05_ra )
+        {
+            clip.sample( t, cursor, pose );
+            check( pose, t );
+        }
+        for ( const Scalar t : tracks[0].timeSchedule() )
+        {
+            clip.sample( t, cursor, pose );
+            check( pose, t );
+        }
+        for ( Scalar t = 0_ra; t < 5_ra; t += 0.5_ra )
+        {
+            clip.sample( t, cursor, pose );
+            check( pose, t );
+        }
+    }
+
+    SECTION( "Random access" ) {
+        std::uniform_real_distribution<Scalar> time( -1_ra, 11_ra );
+        BakedClip::ClipCursor cursor;
+        Pose pose;
+        for ( int i = 0; i < 200; ++i )
+        {
+            const Scalar t = time( gen );
+            clip.sample( t, cursor, pose );
+            check( pose, t );
+        }
+    }
+}
+
+TEST_CASE( "Core/Animation/BakedClip/Benchmark", "[.][benchmark]" ) {
+    // 500 characters playing a clip of 200 bones with 300 keys, each at its own time
+    const int nbBones      = 200;
+    const int nbCharacters = 500;
+    std::mt19937 gen( 0 );
+    std::vector<KeyTransform> tracks;
+    BakedClip clip;
+    for ( int b = 0; b < nbBones; ++b )
+    {
+        tracks.push_back( makeTrack( gen, 300 ) );
+        clip.addTrack( tracks.back() );
+    }
+    std::vector<Scalar> offsets( nbCharacters );
+    std::uniform_real_distribution<Scalar> offset( 0_ra, 5_ra );
+    for ( auto& t : offsets )
+    {
+        t = offset( gen );
+    }
+    std::vector<Pose> poses( nbCharacters, Pose( nbBones ) );
+    std::vector<BakedClip::ClipCursor> cursors( nbCharacters );
+    const int nbFrames = 10;
+    std::cout << "Sampling " << nbBones << " bones of " << nbCharacters << " characters, "
+              << nbFrames << " frames\n";
+
+    auto start = Utils::Clock::now();
+    for ( int f = 0; f < nbFrames; ++f )
+    {
+        for ( int c = 0; c < nbCharacters; ++c )
+        {
+            for ( int b = 0; b < nbBones; ++b )
+            {
+                poses[c][b] = tracks[b].at( offsets[c] + f / 30_ra );
+            }
+        }
+    }
+    auto end = Utils::Clock::now();
+    std::cout << "  keyframes: " << Utils::getIntervalMicro( start, end ) / 1000 / nbFrames
+              << " ms per frame\n";
+
+    start = Utils::Clock::now();
+    for ( int f = 0; f < nbFrames; ++f )
+    {
+        for ( int c = 0; c < nbCharacters; ++c )
+        {
+            clip.sample( offsets[c] + f / 30_ra, cursors[c], poses[c] );
+        }
+    }
+    end = Utils::Clock::now();
+    std::cout << "  baked clip: " << Utils::getIntervalMicro( start, end ) / 1000 / nbFrames
+              << " ms per frame\n";
+}
+
+TEST_CASE( "Core/Animation/CompressedClip", "[Core][Core/Animation][CompressedClip]" ) {
+    const auto maxDifference = []( const Transform& a, const Transform& b ) {
+        return ( a.matrix() - b.matrix() ).cwiseAbs().maxCoeff();
+    };
+
+    SECTION( "Random tracks" ) {
+        // no key can be removed, the errors come from the quantization
+        std::mt19937 gen( 0 );
+        std::vector<KeyTransform> tracks;
+        CompressedClip clip;
+        for ( int k : {20, 1, 0, 50} )
+        {
+            tracks.push_back( makeTrack( gen, k ) );
+            REQUIRE( clip.addTrack( tracks.back() ) == tracks.size() - 1 );
+        }
+        const auto& report = clip.getReport();
+        REQUIRE( report.sourceKeys == 71 );
+        REQUIRE( report.translationError < 1e-4_ra );
+        REQUIRE( report.rotationError < 1e-3_ra );
+        REQUIRE( report.scaleError < 1e-4_ra );
+        REQUIRE( clip.getMemoryUsage() < report.sourceBytes / 2 );
+
+        CompressedClip::ClipCursor cursor;
+        Pose pose;
+        for ( Scalar t = -1_ra; t < 11_ra; t += 0.05_ra )
+        {
+            clip.sample( t, cursor, pose );
+            REQUIRE( pose.size() == tracks.size() );
+            for ( size_t k = 0; k < tracks.size(); ++k )
+            {
+                const Transform expected =
+                    tracks[k].empty() ? Transform::Identity() : tracks[k].at( t );
+                REQUIRE( maxDifference( pose[k], expected ) < 1e-3_ra );
+            }
+        }
+    }
+
+    SECTION( "Key reduction" ) {
+        // a linear motion and a rotation at constant speed, with a constant scale
+        std::vector<Time> times;
+        std::vector<Transform> frames;
+        for ( int k = 0; k <= 1000; ++k )
+        {
+            const Scalar t = k / 100_ra;
+            Transform frame;
+            frame.fromPositionOrientationScale( Vector3( t, 2 * t, 1_ra ),
+                                                Quaternion( AngleAxis( t / 4, Vector3::UnitZ() ) ),
+                                                Vector3( 2_ra, 2_ra, 2_ra ) );
+            times.push_back( t );
+            frames.push_back( frame );
+        }
+        // a small noise, under the tolerance
+        frames[500].translate( Vector3( 1e-4_ra, 0_ra, 0_ra ) );
+        CompressedClip clip;
+        clip.addTrack( times, frames );
+        clip.addTrack( {0_ra, 1_ra}, {Transform::Identity(), Transform::Identity()} );
+        const auto& report = clip.getReport();
+        REQUIRE( report.constantChannels == 4 );
+        REQUIRE( report.keptKeys < 30 );
+        REQUIRE( report.translationError <= 2e-3_ra );
+        REQUIRE( report.rotationError <= 2e-3_ra );
+        REQUIRE( report.scaleError <= 2e-3_ra );
+        REQUIRE( clip.getMemoryUsage() * 100 < report.sourceBytes );
+
+        // sampling backward
+        CompressedClip::ClipCursor cursor;
+        Pose pose;
+        for ( int k = 1000; k >= 0; k -= 7 )
+        {
+            clip.sample( times[k], cursor, pose );
+            REQUIRE( maxDifference( pose[0], frames[k] ) < 2e-3_ra );
+            REQUIRE( pose[1].isApprox( Transform::Identity() ) );
+        }
+    }
+}
+
+TEST_CASE( "Core/Animation/BlendTree", "[Core][Core/Animation][BlendTree]" ) {
+    const int nbBones = 20;
+    const Pose a      = makeCharacter( 1, nbBones, 1 ).pose;
+    Pose b            = a;
+    std::mt19937 gen( 1 );
+    std::uniform_real_distribution<Scalar> dis( -1_ra, 1_ra );
+    for ( auto& t : b )
+    {
+        t.translate( Vector3( dis( gen ), dis( gen ), dis( gen ) ) );
+        t.rotate( AngleAxis( dis( gen ) * 2_ra, Vector3( dis( gen ), 1_ra, 0_ra ).normalized() ) );
+    }
+    Pose result;
+
+    SECTION( "Blend" )
+    {
+        BlendTree tree( nbBones );
+        const auto inA = tree.addInput();
+        const auto inB = tree.addInput();
+        const uint w   = tree.addParameter();
+        tree.addBlend( inA, inB, w, BlendTree::Interpolation::Slerp );
+        BlendTree::Context context;
+        tree.initContext( context );
+        poseToBuffer( a, context.m_inputs[0] );
+        poseToBuffer( b, context.m_inputs[1] );
+        for ( Scalar t : {0_ra, 0.3_ra, 0.7_ra, 1_ra} )
+        {
+            context.m_parameters[w] = t;
+            bufferToPose( tree.evaluate( context ), result );
+            const Pose expected = interpolatePoses( a, b, t );
+            for ( int i = 0; i < nbBones; ++i )
+            {
+                REQUIRE( result[i].isApprox( expected[i], 1e-4_ra ) );
+            }
+        }
+    }
+
+    SECTION( "Masks and additive layers" )
+    {
+        BlendTree tree( nbBones );
+        const auto inA = tree.addInput();
+        const auto inB = tree.addInput();
+        const uint w   = tree.addParameter();
+        std::vector<Scalar> weights( nbBones, 1_ra );
+        std::fill( weights.begin(), weights.begin() + nbBones / 2, 0_ra );
+        const uint mask  = tree.addMask( weights );
+        const auto blend = tree.addBlend( inA, inB, w, BlendTree::Interpolation::Nlerp, mask );
+        const uint v     = tree.addParameter();
+        tree.addAdditive( blend, inB, v );
+        BlendTree::Context context;
+        tree.initContext( context );
+        poseToBuffer( a, context.m_inputs[0] );
+        poseToBuffer( b, context.m_inputs[1] );
+
+        // the masked bones keep the pose a, the other ones get b, and nothing is added
+        context.m_parameters[w] = 1_ra;
+        context.m_parameters[v] = 0_ra;
+        bufferToPose( tree.evaluate( context ), result );
+        for ( int i = 0; i < nbBones; ++i )
+        {
+            REQUIRE( result[i].isApprox( i < nbBones / 2 ? a[i] : b[i], 1e-4_ra ) );
+        }
+
+        // b is added to a
+        context.m_parameters[w] = 0_ra;
+        context.m_parameters[v] = 1_ra;
+        bufferToPose( tree.evaluate( context ), result );
+        const PoseBuffer& pb = context.m_inputs[1];
+        for ( int i = 0; i < nbBones; ++i )
+        {
+            Matrix3 rotation;
+            Matrix3 scale;
+            a[i].computeRotationScaling( &rotation, &scale );
+            Transform expected;
+            expected.fromPositionOrientationScale(
+                a[i].translation() + Vector3( pb.m_tx[i], pb.m_ty[i], pb.m_tz[i] ),
+                Quaternion( rotation ) *
+                    Quaternion( pb.m_qw[i], pb.m_qx[i], pb.m_qy[i], pb.m_qz[i] ),
+                scale.diagonal().cwiseProduct( Vector3( pb.m_sx[i], pb.m_sy[i], pb.m_sz[i] ) ) );
+            REQUIRE( result[i].isApprox( expected, 1e-4_ra ) );
+        }
+
+        // batch evaluation
+        std::vector<BlendTree::Context> contexts( 8, context );
+        for ( size_t c = 0; c < contexts.size(); ++c )
+        {
+            contexts[c].m_parameters[w] = c / 8_ra;
+            contexts[c].m_parameters[v] = 1_ra - c / 8_ra;
+        }
+        tree.evaluate( contexts );
+        for ( size_t c = 0; c < contexts.size(); ++c )
+        {
+            context.m_parameters = contexts[c].m_parameters;
+            tree.evaluate( context );
+            const auto& expected = tree.getOutput( context );
+            const auto& output   = tree.getOutput( contexts[c] );
+            REQUIRE( output.m_tx == expected.m_tx );
+            REQUIRE( output.m_qw == expected.m_qw );
+            REQUIRE( output.m_sz == expected.m_sz );
+        }
+    }
+}
+
+TEST_CASE( "Core/Animation/RotationCenterSkinning",
+           "[Core][Core/Animation][RotationCenterSkinning]" ) {
+    Skinning::RefData data;
+    data.m_referenceMesh = Geometry::makePlaneGrid( 12, 12 );
+    const auto& V        = data.m_referenceMesh.vertices();
+    const auto& T        = data.m_referenceMesh.m_indices;
+    const int nbBones    = 6;
+    data.m_weights       = makeCharacter( int( V.size() ), nbBones, 3 ).weights;
+
+    SECTION( "Integration" )
+    {
+        // without subdivision, the CoRs are integrated over the triangles of the mesh
+        computeCoR( data, 0.1_ra, 10_ra );
+        REQUIRE( data.m_CoR.size() == V.size() );
+        for ( size_t i = 0; i < V.size(); ++i )
+        {
+            const Eigen::SparseVector<Scalar> Wi = data.m_weights.row( int( i ) );
+            Vector3 cor                          = Vector3::Zero();
+            Scalar sum                           = 0;
+            for ( const auto& t : T )
+            {
+                const Eigen::SparseVector<Scalar> Wt =
+                    ( data.m_weights.row( int( t( 0 ) ) ) + data.m_weights.row( int( t( 1 ) ) ) +
+                      data.m_weights.row( int( t( 2 ) ) ) ) /
+                    3;
+                const Scalar s = weightSimilarity( Wi, Wt, 0.1_ra ) *
+                                 Geometry::triangleArea( V[t( 0 )], V[t( 1 )], V[t( 2 )] );
+                cor += s * ( V[t( 0 )] + V[t( 1 )] + V[t( 2 )] ) / 3;
+                sum += s;
+            }
+            if ( sum > 0 ) { cor /= sum; }
+            REQUIRE( data.m_CoR[i].isApprox( cor, 1e-4_ra ) );
+        }
+    }
+
+    SECTION( "Cache" )
+    {
+        const auto directory = std::filesystem::temp_directory_path() / "radium_cor_test";
+        std::filesystem::remove_all( directory );
+        std::filesystem::create_directories( directory );
+        REQUIRE( !computeCoR( data, directory.string(), 0.1_ra, 10_ra ) );
+        const Vector3Array cor = data.m_CoR;
+        data.m_CoR.clear();
+        REQUIRE( computeCoR( data, directory.string(), 0.1_ra, 10_ra ) );
+        REQUIRE( data.m_CoR == cor );
+
+        // other weights or parameters are not read from the cache
+        const std::uint64_t hash = corHash( data, 0.1_ra, 10_ra );
+        REQUIRE( corHash( data, 0.2_ra, 10_ra ) != hash );
+        REQUIRE( corHash( data ) != hash );
+        data.m_weights.coeffRef( 0, 0 ) += 0.1_ra;
+        REQUIRE( corHash( data, 0.1_ra, 10_ra ) != hash );
+        REQUIRE( !computeCoR( data, directory.string(), 0.1_ra, 10_ra ) );
+        std::filesystem::remove_all( directory );
+    }
+}
+
+TEST_CASE( "Core/Animation/CageDeformation", "[Core][Core/Animation][CageDeformation]" ) {
+    const auto box = Geometry::makeBox( Vector3( 1_ra, 1_ra, 1_ra ) );
+    const VectorArray<Vector3ui> triangles( box.m_indices.begin(), box.m_indices.end() );
+    const Vector3Array& cage = box.vertices();
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dis( -0.95_ra, 0.95_ra );
+    Vector3Array points;
+    for ( int i = 0; i < 200; ++i )
+    {
+        points.emplace_back( dis( gen ), dis( gen ), dis( gen ) );
+    }
+    // a vertex, a point on a face and a point on an edge of the cage
+    points.push_back( cage[0] );
+    points.emplace_back( 1_ra, 0.2_ra, -0.3_ra );
+    points.emplace_back( 1_ra, 1_ra, 0.3_ra );
+
+    SECTION( "Linear precision" )
+    {
+        const CageCoordinates coordinates =
+            computeMeanValueCoordinates( cage, triangles, points, 0_ra );
+        REQUIRE( coordinates.rows() == int( points.size() ) );
+        REQUIRE( coordinates.cols() == int( cage.size() ) );
+        Vector3Array result;
+        cageDeformation( cage, coordinates, result );
+        for ( size_t i = 0; i < points.size(); ++i )
+        {
+            REQUIRE( result[i].isApprox( points[i], 1e-4_ra ) );
+        }
+
+        Transform T = Transform::Identity();
+        T.translate( Vector3( 1_ra, -2_ra, 0.5_ra ) );
+        T.rotate( AngleAxis( 0.7_ra, Vector3( 1_ra, 2_ra, 0_ra ).normalized() ) );
+        T.scale( Vector3( 2_ra, 1_ra, 0.5_ra ) );
+        Cage handle( uint( cage.size() ) );
+        for ( uint j = 0; j < cage.size(); ++j )
+        {
+            Transform t = Transform::Identity();
+            t.translate( T * cage[j] );
+            handle.setTransform( j, t, HandleArray::SpaceType::MODEL );
+        }
+        handle.m_triangle = triangles;
+        cageDeformation( handle, coordinates, result );
+        for ( size_t i = 0; i < points.size(); ++i )
+        {
+            REQUIRE( result[i].isApprox( T * points[i], 1e-4_ra ) );
+        }
+    }
+
+    SECTION( "Threshold" )
+    {
+        auto sphere = Geometry::makeGeodesicSphere( 1.5_ra, 2 );
+        Geometry::cleanupTriangleMesh( sphere, 1e-4_ra, 1e6_ra );
+        const VectorArray<Vector3ui> sphereTriangles( sphere.m_indices.begin(),
+                                                      sphere.m_indices.end() );
+        // the coordinates of the points close to the cage are localized
+        Vector3Array surface;
+        for ( const auto& p : points )
+        {
+            surface.push_back( 1.45_ra * p.normalized() );
+        }
+        points = surface;
+        const auto dense =
+            computeMeanValueCoordinates( sphere.vertices(), sphereTriangles, points, 0_ra );
+        const auto sparse =
+            computeMeanValueCoordinates( sphere.vertices(), sphereTriangles, points, 1e-3_ra );
+        REQUIRE( sparse.nonZeros() < dense.nonZeros() / 4 );
+        Vector3Array result;
+        cageDeformation( sphere.vertices(), sparse, result );
+        for ( size_t i = 0; i < points.size(); ++i )
+        {
+            REQUIRE( std::abs( sparse.row( int( i ) ).sum() - 1_ra ) < 1e-4_ra );
+            REQUIRE( ( result[i] - points[i] ).norm() < 0.05_ra );
+        }
+    }
+}
+
+TEST_CASE( "Core/Animation/BulgeCorrection", "[Core][Core/Animation][BulgeCorrection]" ) {
+    const int nbBones  = 30;
+    const Character c  = makeCharacter( 10000, nbBones, 4, 1_ra );
+    const int size     = int( c.vertices.size() );
+    const Pose& pose   = c.pose;
+    PackedWeights packed;
+    packWeights( c.weights, 4, packed );
+    // a random skeleton, in its rest pose and in a pose moved by the skinning pose
+    std::mt19937 gen( 2 );
+    std::uniform_real_distribution<Scalar> dis( -1_ra, 1_ra );
+    AdjacencyList graph;
+    Pose restPose;
+    Pose modelPose;
+    for ( int j = 0; j < nbBones; ++j )
+    {
+        if ( j == 0 ) { graph.addRoot(); }
+        else
+        { graph.addNode( uint( std::uniform_int_distribution<int>( 0, j - 1 )( gen ) ) ); }
+        Transform t = Transform::Identity();
+        t.translate( Vector3( dis( gen ), dis( gen ), dis( gen ) ) );
+        restPose.push_back( t );
+        modelPose.push_back( pose[j] * t );
+    }
+    MaxWeightID wID( size );
+    for ( int i = 0; i < size; ++i )
+    {
+        wID[i] = packed.m_bones[i];
+    }
+    BulgeCorrectionData restData;
+    findCorrectionData( c.vertices, wID, graph, restPose, restData );
+
+    // current path: skinning, then correction data and correction
+    Vector3Array expected;
+    linearBlendSkinning( c.vertices, pose, packed, expected );
+    BulgeCorrectionData currData;
+    findCorrectionData( expected, wID, graph, modelPose, currData );
+    bulgeCorrection( c.vertices, restData, expected, currData );
+    Vector3Array skinned;
+    linearBlendSkinning( c.vertices, pose, packed, skinned );
+    int corrected = 0;
+    for ( int i = 0; i < size; ++i )
+    {
+        if ( !skinned[i].isApprox( expected[i] ) ) { ++corrected; }
+    }
+    REQUIRE( corrected > size / 10 );
+
+    SECTION( "Separate pass" )
+    {
+        BoneSegments segments;
+        segments.compute( graph, modelPose );
+        bulgeCorrection( restData.m_dv, wID, segments, skinned );
+        for ( int i = 0; i < size; ++i )
+        {
+            REQUIRE( skinned[i].isApprox( expected[i], 1e-5_ra ) );
+        }
+    }
+
+    SECTION( "Fused with skinning" )
+    {
+        Vector3Array result;
+        linearBlendSkinning(
+            c.vertices, pose, packed, restData.m_dv, wID, graph, modelPose, result );
+        REQUIRE( result.size() == expected.size() );
+        for ( int i = 0; i < size; ++i )
+        {
+            REQUIRE( result[i].isApprox( expected[i], 1e-5_ra ) );
+        }
+    }
+}
@@ -1,7 +1,20 @@
+#include <Core/Geometry/Area.hpp>
+#include <Core/Geometry/Laplacian.hpp>
+#include <Core/Geometry/MeshCleanup.hpp>
+#include <Core/Geometry/MeshOptimization.hpp>
 #include <Core/Geometry/MeshPrimitives.hpp>
+#include <Core/Geometry/Normal.hpp>
+#include <Core/Geometry/Quantization.hpp>
+#include <Core/Geometry/TriangleOperation.hpp>
 #include <Core/Geometry/TriangleMesh.hpp>
+#include <Core/Math/LinearAlgebra.hpp>
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <random>
+
 TEST_CASE( "Core/Geometry/TriangleMesh", "[Core][Core/Geometry][TriangleMesh]" ) {
     using Ra::Core::Vector3;
     using Ra::Core::Geometry::TriangleMesh;
@@ -101,3 +114,540 @@ TEST_CASE( "Core/Geometry/TriangleMesh", "[Core][Core/Geometry][TriangleMesh]" )
         m2.copyAttributes( m, handle1 );
     }
 }
+
+TEST_CASE( "Core/Geometry/Normal", "[Core][Core/Geometry][Normal]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    TriangleMesh mesh     = makeGeodesicSphere( 1_ra, 2 );
+    const auto& p         = mesh.vertices();
+    const auto& T         = mesh.m_indices;
+    const uint point_size = uint( p.size() );
+
+    SECTION( "Incidence" ) {
+        VertexTriangleIncidence incidence( point_size, T );
+        REQUIRE( incidence.size() == point_size );
+        REQUIRE( incidence.corners().size() == 3 * T.size() );
+        for ( uint v = 0; v < point_size; ++v )
+        {
+            for ( uint c = incidence.offset( v ); c < incidence.offset( v + 1 ); ++c )
+            {
+                const uint corner = incidence.corners()[c];
+                REQUIRE( T[VertexTriangleIncidence::triangle( corner )](
+                             VertexTriangleIncidence::local( corner ) ) == v );
+            }
+        }
+        REQUIRE( incidence.isValidFor( point_size, T ) );
+        REQUIRE( !incidence.update( point_size, T ) );
+
+        auto T2 = T;
+        std::swap( T2[0]( 0 ), T2[0]( 1 ) );
+        REQUIRE( !incidence.isValidFor( point_size, T2 ) );
+        REQUIRE( incidence.update( point_size, T2 ) );
+        REQUIRE( incidence.isValidFor( point_size, T2 ) );
+    }
+
+    SECTION( "Gather matches scatter" ) {
+        // reference: per-triangle scatter
+        Vector3Array ref( point_size, Vector3::Zero() );
+        for ( const auto& t : T )
+        {
+            const Vector3 triN = triangleNormal( p[t( 0 )], p[t( 1 )], p[t( 2 )] );
+            for ( uint k = 0; k < 3; ++k )
+            {
+                ref[t( k )] += triN;
+            }
+        }
+        for ( auto& n : ref )
+        {
+            n.normalize();
+        }
+
+        Vector3Array normal;
+        uniformNormal( p, T, normal );
+        REQUIRE( normal.size() == ref.size() );
+        for ( uint v = 0; v < point_size; ++v )
+        {
+            REQUIRE( normal[v].isApprox( ref[v] ) );
+        }
+
+        VertexTriangleIncidence incidence( point_size, T );
+        Vector3Array angleN, areaN;
+        angleWeightedNormal( p, T, incidence, angleN );
+        areaWeightedNormal( p, T, incidence, areaN );
+        for ( uint v = 0; v < point_size; ++v )
+        {
+            // on a sphere all the definitions agree with the position
+            REQUIRE( angleN[v].dot( p[v].normalized() ) > 0.99_ra );
+            REQUIRE( areaN[v].dot( p[v].normalized() ) > 0.99_ra );
+        }
+    }
+
+    SECTION( "Local update" ) {
+        VertexTriangleIncidence incidence( point_size, T );
+        Vector3Array areaN;
+        Vector3Array angleN;
+        areaWeightedNormal( p, T, incidence, areaN );
+        angleWeightedNormal( p, T, incidence, angleN );
+
+        // move one vertex, and only update its one ring
+        Vector3Array q = p;
+        q[0] *= 1.5_ra;
+        std::vector<uint> moved;
+        for ( const auto& t : T )
+        {
+            if ( t( 0 ) == 0 || t( 1 ) == 0 || t( 2 ) == 0 )
+            {
+                for ( uint k = 0; k < 3; ++k )
+                {
+                    moved.push_back( t( k ) );
+                }
+            }
+        }
+        std::sort( moved.begin(), moved.end() );
+        moved.erase( std::unique( moved.begin(), moved.end() ), moved.end() );
+
+        Vector3Array fullArea;
+        Vector3Array fullAngle;
+        areaWeightedNormal( q, T, incidence, fullArea );
+        angleWeightedNormal( q, T, incidence, fullAngle );
+        areaWeightedNormal( q, T, incidence, moved, areaN );
+        angleWeightedNormal( q, T, incidence, moved, angleN );
+        for ( uint v = 0; v < point_size; ++v )
+        {
+            REQUIRE( areaN[v].isApprox( fullArea[v] ) );
+            REQUIRE( angleN[v].isApprox( fullAngle[v] ) );
+        }
+    }
+}
+
+TEST_CASE( "Core/Geometry/MeshOptimization", "[Core][Core/Geometry][MeshOptimization]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    TriangleMesh mesh = makeGeodesicSphere( 1_ra, 3 );
+    // scramble the triangles, as a scan would give them
+    std::mt19937 gen( 0 );
+    std::shuffle( mesh.m_indices.begin(), mesh.m_indices.end(), gen );
+    const uint point_size = uint( mesh.vertices().size() );
+    const auto before     = computeVertexCacheStatistics( point_size, mesh.m_indices );
+
+    auto triangleCenters = []( const TriangleMesh& m ) {
+        std::vector<std::array<Scalar, 3>> centers;
+        for ( const auto& t : m.m_indices )
+        {
+            Vector3 c = m.vertices()[t( 0 )] + m.vertices()[t( 1 )] + m.vertices()[t( 2 )];
+            centers.push_back( {c.x(), c.y(), c.z()} );
+        }
+        std::sort( centers.begin(), centers.end() );
+        return centers;
+    };
+    const auto centers = triangleCenters( mesh );
+
+    SECTION( "Vertex cache" ) {
+        std::vector<uint> clusters;
+        optimizeVertexCache( point_size, mesh.m_indices, 16, &clusters );
+        const auto after = computeVertexCacheStatistics( point_size, mesh.m_indices );
+        REQUIRE( after.acmr < before.acmr );
+        REQUIRE( after.atvr < before.atvr );
+        REQUIRE( after.atvr >= 1_ra );
+        REQUIRE( !clusters.empty() );
+        REQUIRE( clusters[0] == 0 );
+
+        optimizeOverdraw( mesh.vertices(), mesh.m_indices, clusters );
+        REQUIRE( triangleCenters( mesh ) == centers );
+    }
+
+    SECTION( "Full pipeline" ) {
+        optimizeTriangleMesh( mesh );
+        const auto after = computeVertexCacheStatistics( point_size, mesh.m_indices );
+        REQUIRE( after.acmr < before.acmr );
+        REQUIRE( mesh.vertices().size() == point_size );
+        REQUIRE( triangleCenters( mesh ) == centers );
+
+        // vertices are fetched in order and attributes follow them
+        uint maxIndex = 0;
+        for ( const auto& t : mesh.m_indices )
+        {
+            for ( uint k = 0; k < 3; ++k )
+            {
+                REQUIRE( t( k ) <= maxIndex + 1 );
+                maxIndex = std::max( maxIndex, t( k ) );
+            }
+        }
+        for ( uint v = 0; v < point_size; ++v )
+        {
+            REQUIRE( mesh.normals()[v].isApprox( mesh.vertices()[v].normalized() ) );
+        }
+    }
+
+    SECTION( "Unsupported attributes" ) {
+        // the quantized positions could not follow the vertices
+        const Aabb aabb( Vector3::Constant( -1_ra ), Vector3::Constant( 1_ra ) );
+        const auto quantized = quantizePositions( mesh.vertices(), aabb );
+        mesh.addAttrib<QuantizedPosition>( "quantized", quantized );
+        const auto indices = mesh.m_indices;
+        const auto points  = mesh.vertices();
+        REQUIRE( optimizeVertexFetch( mesh ).empty() );
+        REQUIRE( mesh.m_indices == indices );
+        REQUIRE( mesh.vertices() == points );
+    }
+}
+
+TEST_CASE( "Core/Geometry/MeshCleanup", "[Core][Core/Geometry][MeshCleanup]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    // duplicate the vertices of each face corner, as importers do, moving
+    // them by at most noise, the original index of the vertices being kept
+    // as an attribute
+    auto splitCorners = []( const TriangleMesh& in, Scalar noise ) {
+        std::mt19937 gen( 0 );
+        std::uniform_real_distribution<Scalar> dis( -noise, noise );
+        Vector3Array vertices;
+        Vector3Array normals;
+        Vector1Array ids;
+        TriangleMesh out;
+        for ( const auto& t : in.m_indices )
+        {
+            for ( uint k = 0; k < 3; ++k )
+            {
+                vertices.push_back( in.vertices()[t( k )] +
+                                    Vector3( dis( gen ), dis( gen ), dis( gen ) ) );
+                normals.push_back( in.normals()[t( k )] );
+                ids.push_back( Scalar( t( k ) ) );
+            }
+            const uint v = uint( vertices.size() );
+            out.m_indices.emplace_back( v - 3, v - 2, v - 1 );
+        }
+        out.setVertices( std::move( vertices ) );
+        out.setNormals( std::move( normals ) );
+        out.addAttrib( "test_id", std::move( ids ) );
+        return out;
+    };
+    auto ids = []( const TriangleMesh& m ) {
+        return m.getAttrib( m.getAttribHandle<Scalar>( "test_id" ) ).data();
+    };
+
+    SECTION( "Welding" ) {
+        const TriangleMesh sphere = makeGeodesicSphere( 1_ra, 3 );
+        TriangleMesh mesh         = splitCorners( sphere, 1e-6_ra );
+        const auto stats          = cleanupTriangleMesh( mesh, 1e-4_ra );
+        REQUIRE( mesh.vertices().size() == sphere.vertices().size() );
+        REQUIRE( mesh.m_indices.size() == sphere.m_indices.size() );
+        REQUIRE( stats.weldedVertices == 3 * sphere.m_indices.size() - sphere.vertices().size() );
+        REQUIRE( stats.removedVertices == stats.weldedVertices );
+        REQUIRE( stats.degenerateTriangles == 0 );
+        // the attributes follow the vertices, and the triangles are the original ones
+        const auto& id = ids( mesh );
+        for ( uint v = 0; v < mesh.vertices().size(); ++v )
+        {
+            REQUIRE( mesh.vertices()[v].isApprox( sphere.vertices()[uint( id[v] )], 1e-5_ra ) );
+            REQUIRE( mesh.normals()[v] == sphere.normals()[uint( id[v] )] );
+        }
+        for ( uint t = 0; t < mesh.m_indices.size(); ++t )
+        {
+            for ( uint k = 0; k < 3; ++k )
+            {
+                REQUIRE( uint( id[mesh.m_indices[t]( k )] ) == sphere.m_indices[t]( k ) );
+            }
+        }
+
+        // exact welding keeps the moved vertices
+        TriangleMesh exact = splitCorners( sphere, 1e-6_ra );
+        cleanupTriangleMesh( exact, 0_ra );
+        REQUIRE( exact.vertices().size() == 3 * sphere.m_indices.size() );
+        exact = splitCorners( sphere, 0_ra );
+        cleanupTriangleMesh( exact, 0_ra );
+        REQUIRE( exact.vertices().size() == sphere.vertices().size() );
+    }
+
+    SECTION( "Attribute seams" ) {
+        // the normals of a sharp box are split at the corners
+        const TriangleMesh box = makeSharpBox();
+        TriangleMesh mesh      = splitCorners( box, 0_ra );
+        auto id                = mesh.getAttribHandle<Scalar>( "test_id" );
+        mesh.removeAttrib( id );
+        TriangleMesh merged = mesh;
+        cleanupTriangleMesh( mesh, 1e-4_ra );
+        REQUIRE( mesh.vertices().size() == 24 );
+        REQUIRE( mesh.m_indices.size() == 12 );
+        cleanupTriangleMesh( merged, 1e-4_ra, 2_ra );
+        REQUIRE( merged.vertices().size() == 8 );
+
+        // the float attributes split the vertices as well
+        TriangleMesh faces = splitCorners( box, 0_ra );
+        id                 = faces.getAttribHandle<Scalar>( "test_id" );
+        faces.removeAttrib( id );
+        VectorArray<float> face;
+        for ( const auto& n : faces.normals() )
+        {
+            face.push_back( float( n.dot( Vector3( 1_ra, 2_ra, 3_ra ) ) ) );
+        }
+        faces.setNormals( Vector3Array( faces.vertices().size(), Vector3::UnitZ() ) );
+        faces.addAttrib<float>( "test_face", std::move( face ) );
+        cleanupTriangleMesh( faces, 1e-4_ra, 0.5_ra );
+        REQUIRE( faces.vertices().size() == 24 );
+    }
+
+    SECTION( "Degenerate triangles and unused vertices" ) {
+        TriangleMesh mesh;
+        mesh.setVertices( {Vector3( 0_ra, 0_ra, 0_ra ),
+                           Vector3( 1_ra, 0_ra, 0_ra ),
+                           Vector3( 0_ra, 1_ra, 0_ra ),
+                           Vector3( 2_ra, 0_ra, 0_ra ),
+                           Vector3( 5_ra, 5_ra, 5_ra ),
+                           Vector3( 0_ra, 0_ra, 1_ra )} );
+        mesh.setNormals( Vector3Array( 6, Vector3::UnitZ() ) );
+        mesh.m_indices = {Vector3ui( 0, 1, 2 ),  // kept
+                          Vector3ui( 0, 0, 2 ),  // repeated vertex
+                          Vector3ui( 0, 1, 3 ),  // collinear
+                          Vector3ui( 5, 1, 2 )}; // kept
+        REQUIRE( removeDegenerateTriangles( mesh ) == 2 );
+        REQUIRE( mesh.m_indices.size() == 2 );
+        REQUIRE( mesh.m_indices[1] == Vector3ui( 5, 1, 2 ) );
+        const auto oldToNew = removeUnusedVertices( mesh );
+        REQUIRE( oldToNew == std::vector<uint>{0, 1, 2, InvalidVertex, InvalidVertex, 3} );
+        REQUIRE( mesh.vertices().size() == 4 );
+        REQUIRE( mesh.normals().size() == 4 );
+        REQUIRE( mesh.vertices()[3] == Vector3( 0_ra, 0_ra, 1_ra ) );
+        REQUIRE( mesh.m_indices[1] == Vector3ui( 3, 1, 2 ) );
+    }
+}
+
+TEST_CASE( "Core/Geometry/Quantization", "[Core][Core/Geometry][Quantization]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+    using Ra::Core::Utils::AttribBase;
+
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dis( -1_ra, 1_ra );
+    const int n = 10000;
+
+    SECTION( "Half floats" ) {
+        // exactly representable values, including the smallest normal and subnormal halves
+        const float minNormal    = std::ldexp( 1.f, -14 );
+        const float minSubnormal = std::ldexp( 1.f, -24 );
+        for ( const float f : {0.f, -0.f, 1.f, -2.f, 0.5f, 65504.f, minNormal, 3 * minSubnormal} )
+        {
+            REQUIRE( halfToFloat( floatToHalf( f ) ) == f );
+        }
+        REQUIRE( floatToHalf( 1.f ) == 0x3c00 );
+        REQUIRE( floatToHalf( 65520.f ) == 0x7c00 );
+        REQUIRE( std::isinf( halfToFloat( floatToHalf( 1e10f ) ) ) );
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        REQUIRE( std::isnan( halfToFloat( floatToHalf( nan ) ) ) );
+        // ties round to even
+        REQUIRE( floatToHalf( 1.f + 1.f / 2048 ) == 0x3c00 );
+        REQUIRE( floatToHalf( 1.f + 3.f / 2048 ) == 0x3c02 );
+
+        // relative error is at most 2^-11 on normal halves
+        Vector2Array uv( n );
+        for ( auto& x : uv )
+        {
+            x = Vector2( dis( gen ), dis( gen ) ) * 100_ra;
+        }
+        const auto decoded = decodeHalf( encodeHalf( uv ) );
+        for ( int i = 0; i < n; ++i )
+        {
+            for ( int k = 0; k < 2; ++k )
+            {
+                REQUIRE( std::abs( decoded[i]( k ) - uv[i]( k ) ) <=
+                         std::max( std::abs( uv[i]( k ) ) / 2048, 1_ra / ( 1 << 25 ) ) );
+            }
+        }
+    }
+
+    SECTION( "Octahedral vectors" ) {
+        Vector3Array normals( n );
+        for ( auto& x : normals )
+        {
+            x = Vector3( dis( gen ), dis( gen ), dis( gen ) ).normalized();
+        }
+        // axes and octahedron edges
+        normals[0] = Vector3::UnitZ();
+        normals[1] = -Vector3::UnitZ();
+        normals[2] = -Vector3::UnitX();
+        normals[3] = Vector3( 1_ra, -1_ra, 0_ra ).normalized();
+
+        const auto encoded = encodeOctahedral( normals );
+        const auto decoded = decodeOctahedral( encoded );
+        for ( int i = 0; i < n; ++i )
+        {
+            REQUIRE( decoded[i].norm() == Approx( 1_ra ) );
+            REQUIRE( ( decoded[i] - normals[i] ).norm() <= octahedralError() );
+        }
+        // decoding is stable
+        REQUIRE( encodeOctahedral( decoded ) == encoded );
+    }
+
+    SECTION( "Quantized positions" ) {
+        const Aabb aabb( Vector3( -1_ra, -2_ra, 0_ra ), Vector3( 3_ra, 2_ra, 0_ra ) );
+        Vector3Array points( n );
+        for ( auto& x : points )
+        {
+            x = aabb.sample();
+        }
+        points[0] = aabb.min();
+        points[1] = aabb.max();
+
+        const auto error   = positionQuantizationError( aabb );
+        const auto decoded = dequantizePositions( quantizePositions( points, aabb ), aabb );
+        REQUIRE( decoded[0] == aabb.min() );
+        REQUIRE( decoded[1].isApprox( aabb.max() ) );
+        for ( int i = 0; i < n; ++i )
+        {
+            const Vector3 diff = ( decoded[i] - points[i] ).cwiseAbs();
+            // flat axis is exact, allow float rounding on the other ones
+            REQUIRE( diff( 2 ) == 0_ra );
+            REQUIRE( ( diff.array() <= error.array() * 1.01_ra ).all() );
+        }
+        // out of the box positions are clamped
+        REQUIRE( quantizePosition( Vector3( 10_ra, -10_ra, 0_ra ), aabb ) ==
+                 QuantizedPosition( 65535, 0, 0 ) );
+    }
+
+    SECTION( "Attrib encoding" ) {
+        TriangleMesh mesh = makeBox();
+        REQUIRE( mesh.getAttribBase( "in_position" )->getEncoding() ==
+                 ( std::is_same<Scalar, float>::value ? AttribBase::Encoding::FLOAT
+                                                      : AttribBase::Encoding::DOUBLE ) );
+
+        const Aabb aabb = mesh.computeAabb();
+        auto hq         = mesh.addAttrib<QuantizedPosition>(
+            "in_position_q", quantizePositions( mesh.vertices(), aabb ) );
+        auto ho =
+            mesh.addAttrib<OctahedralVector>( "in_normal_o", encodeOctahedral( mesh.normals() ) );
+        auto hh = mesh.addAttrib<HalfVector2>( "in_texcoord_h" );
+        REQUIRE( mesh.getAttrib( hq ).getEncoding() == AttribBase::Encoding::UNORM16 );
+        REQUIRE( mesh.getAttrib( ho ).getEncoding() == AttribBase::Encoding::SNORM16 );
+        REQUIRE( mesh.getAttrib( hq ).getStride() == 6 );
+        REQUIRE( mesh.getAttrib( ho ).getStride() == 4 );
+        REQUIRE( mesh.getAttrib( hh ).getEncoding() == AttribBase::Encoding::HALF );
+        REQUIRE( mesh.getAttrib( hh ).getStride() == 4 );
+    }
+}
+
+TEST_CASE( "Core/Geometry/Operators", "[Core][Core/Geometry][Operators]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    // serial assembly with coeffRef, as reference
+    auto referenceLaplacian = []( const Vector3Array& p, const AlignedStdVector<Vector3ui>& T ) {
+        Sparse L( p.size(), p.size() );
+        for ( const auto& t : T )
+        {
+            for ( uint k = 0; k < 3; ++k )
+            {
+                const uint i = t( k );
+                const uint j = t( ( k + 1 ) % 3 );
+                const uint o = t( ( k + 2 ) % 3 );
+                const Scalar w =
+                    Scalar( 0.5 ) * Math::cotan( ( p[i] - p[o] ).eval(), ( p[j] - p[o] ).eval() );
+                L.coeffRef( i, j ) -= w;
+                L.coeffRef( j, i ) -= w;
+                L.coeffRef( i, i ) += w;
+                L.coeffRef( j, j ) += w;
+            }
+        }
+        return L;
+    };
+    auto referenceUniform = []( const uint n, const AlignedStdVector<Vector3ui>& T ) {
+        Sparse A( n, n );
+        for ( const auto& t : T )
+        {
+            A.coeffRef( t( 0 ), t( 1 ) ) = 1;
+            A.coeffRef( t( 1 ), t( 2 ) ) = 1;
+            A.coeffRef( t( 2 ), t( 0 ) ) = 1;
+        }
+        return A;
+    };
+    auto distance = []( const Sparse& a, const Sparse& b ) { return ( a - b ).norm(); };
+
+    // open mesh, with a deformed copy
+    TriangleMesh mesh = makePlaneGrid( 8, 6 );
+    const auto& T     = mesh.m_indices;
+    const uint n      = uint( mesh.vertices().size() );
+    Vector3Array p    = mesh.vertices();
+    Vector3Array q    = p;
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dis( -0.02_ra, 0.02_ra );
+    for ( auto& x : q )
+    {
+        x += Vector3( dis( gen ), dis( gen ), dis( gen ) );
+    }
+
+    OperatorPattern pattern( n, T );
+    REQUIRE( pattern.isValidFor( n, T ) );
+    REQUIRE( !pattern.update( n, T ) );
+    // each edge, in both directions
+    const Sparse edges = referenceUniform( n, T );
+    REQUIRE( pattern.nonZeros() == Sparse( edges + Sparse( edges.transpose() ) ).nonZeros() );
+
+    SECTION( "Adjacency" ) {
+        const Sparse A = uniformAdjacency( n, T );
+        REQUIRE( distance( A, edges ) == 0_ra );
+        // the boundary edges are oriented
+        REQUIRE( distance( A, Sparse( A.transpose() ) ) > 0_ra );
+
+        const Sparse C = cotangentWeightAdjacency( p, T );
+        REQUIRE( distance( C, Sparse( C.transpose() ) ) < 1e-5_ra );
+        const Sparse L = cotangentWeightLaplacian( p, T );
+        REQUIRE( distance( L, standardLaplacian( adjacencyDegree( C ), C ) ) < 1e-4_ra );
+
+        const Sparse TV = triangleUniformAdjacency( p, T );
+        REQUIRE( TV.rows() == Eigen::Index( T.size() ) );
+        REQUIRE( TV.nonZeros() == Eigen::Index( 3 * T.size() ) );
+        for ( uint t = 0; t < T.size(); ++t )
+        {
+            REQUIRE( TV.row( t ).sum() == 3_ra );
+            REQUIRE( TV.coeff( t, T[t]( 0 ) ) == 1_ra );
+        }
+    }
+
+    SECTION( "Laplacian" ) {
+        Sparse L;
+        cotangentWeightLaplacian( p, T, pattern, L );
+        REQUIRE( distance( L, referenceLaplacian( p, T ) ) < 1e-4_ra );
+        REQUIRE( distance( L, cotangentWeightLaplacian( p, T ) ) == 0_ra );
+        // rows sum to zero
+        REQUIRE( ( L * VectorN::Ones( n ) ).norm() < 1e-4_ra );
+
+        // refill for the deformed pose, in place
+        const Scalar* values = L.valuePtr();
+        const int* inner     = L.innerIndexPtr();
+        cotangentWeightLaplacian( q, T, pattern, L );
+        REQUIRE( L.valuePtr() == values );
+        REQUIRE( L.innerIndexPtr() == inner );
+        REQUIRE( distance( L, referenceLaplacian( q, T ) ) < 1e-4_ra );
+    }
+
+    SECTION( "Area" ) {
+        const Scalar total = 1_ra; // makePlaneGrid spans [-0.5,0.5]^2
+        Sparse A;
+        oneRingArea( p, T, pattern, A );
+        REQUIRE( A.diagonal().sum() == Approx( 3 * total ) );
+        barycentricArea( p, T, pattern, A );
+        REQUIRE( A.diagonal().sum() == Approx( total ) );
+        mixedArea( p, T, pattern, A );
+        REQUIRE( A.diagonal().sum() == Approx( total ) );
+        REQUIRE( distance( A, mixedArea( p, T ) ) == 0_ra );
+
+        const Scalar* values = A.valuePtr();
+        mixedArea( q, T, pattern, A );
+        REQUIRE( A.valuePtr() == values );
+        REQUIRE( distance( A, mixedArea( q, T ) ) == 0_ra );
+        voronoiArea( q, T, pattern, A );
+        REQUIRE( A.valuePtr() == values );
+        REQUIRE( distance( A, voronoiArea( q, T ) ) == 0_ra );
+    }
+
+    SECTION( "Topology change" ) {
+        AlignedStdVector<Vector3ui> T2( T.begin(), T.end() - 2 );
+        REQUIRE( !pattern.isValidFor( n, T2 ) );
+        REQUIRE( pattern.update( n, T2 ) );
+        Sparse L;
+        cotangentWeightLaplacian( p, T2, pattern, L );
+        REQUIRE( distance( L, referenceLaplacian( p, T2 ) ) < 1e-4_ra );
+    }
+}
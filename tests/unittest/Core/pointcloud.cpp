@@ -0,0 +1,414 @@
+#include <Core/Geometry/MeshPrimitives.hpp>
+#include <Core/Geometry/MeshSampling.hpp>
+#include <Core/Geometry/PointCloudOctree.hpp>
+#include <Core/Geometry/PointCloudProcessing.hpp>
+#include <Core/Geometry/PointGrid.hpp>
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+#include <random>
+
+TEST_CASE( "Core/Geometry/PointGrid", "[Core][Core/Geometry][PointGrid]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dis( -1_ra, 1_ra );
+    Vector3Array cube( 2000 );
+    Vector3Array sphere( 2000 );
+    for ( size_t i = 0; i < cube.size(); ++i )
+    {
+        cube[i]   = Vector3( dis( gen ), dis( gen ), dis( gen ) );
+        sphere[i] = Vector3( dis( gen ), dis( gen ), dis( gen ) ).normalized();
+    }
+
+    // brute force k nearest neighbours distances
+    auto bruteForce = []( const Vector3Array& points, const Vector3& q, uint k, uint skip ) {
+        std::vector<Scalar> d;
+        for ( uint i = 0; i < points.size(); ++i )
+        {
+            if ( i != skip ) { d.push_back( ( points[i] - q ).squaredNorm() ); }
+        }
+        std::sort( d.begin(), d.end() );
+        d.resize( std::min( size_t( k ), d.size() ) );
+        return d;
+    };
+
+    for ( const auto* points : {&cube, &sphere} )
+    {
+        const PointGrid grid( *points );
+        REQUIRE( grid.size() == points->size() );
+        std::vector<uint> indices;
+        std::vector<Scalar> sqDistances;
+        for ( uint i = 0; i < 200; ++i )
+        {
+            // points of the cloud, and queries outside of the grid
+            const bool inside = i < 100;
+            const Vector3 q   = inside ? ( *points )[i] : Vector3( 3_ra * ( *points )[i] );
+            const uint skip   = inside ? i : uint( -1 );
+            grid.kNearest( q, 10, indices, sqDistances, skip );
+            REQUIRE( sqDistances == bruteForce( *points, q, 10, skip ) );
+            for ( size_t j = 0; j < indices.size(); ++j )
+            {
+                REQUIRE( indices[j] != skip );
+                REQUIRE( ( ( *points )[indices[j]] - q ).squaredNorm() == sqDistances[j] );
+            }
+
+            size_t count = 0;
+            grid.forEachInRadius( q, 0.2_ra, [&]( uint j, Scalar d ) {
+                REQUIRE( ( ( *points )[j] - q ).squaredNorm() == d );
+                ++count;
+            } );
+            const auto inRadius =
+                std::count_if( points->begin(), points->end(), [&]( const auto& p ) {
+                    return ( p - q ).squaredNorm() < 0.04_ra;
+                } );
+            REQUIRE( count == size_t( inRadius ) );
+        }
+    }
+
+    // fewer points than neighbours
+    const PointGrid small( Vector3Array{{0, 0, 0}, {1, 0, 0}, {0, 2, 0}} );
+    std::vector<uint> indices;
+    std::vector<Scalar> sqDistances;
+    small.kNearest( Vector3::Zero(), 5, indices, sqDistances );
+    REQUIRE( indices == std::vector<uint>{0, 1, 2} );
+    REQUIRE( sqDistances == std::vector<Scalar>{0, 1, 4} );
+}
+
+TEST_CASE( "Core/Geometry/PointCloudProcessing", "[Core][Core/Geometry][PointCloudProcessing]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    SECTION( "Voxel grid downsampling" ) {
+        // clusters of 4 points in a 5^3 grid of unit voxels, offsets are exact
+        // in binary so that the points do not move across voxel boundaries
+        const Vector3 offsets[4] = {{0, 0, 0}, {0.125_ra, 0, 0}, {0, 0.375_ra, 0}, {0, 0, 0.5_ra}};
+        Vector3Array points;
+        Vector3Array normals;
+        Vector4Array colors;
+        for ( int i = 0; i < 125; ++i )
+        {
+            const Vector3 c( Scalar( i % 5 ), Scalar( ( i / 5 ) % 5 ), Scalar( i / 25 ) );
+            for ( int j = 0; j < 4; ++j )
+            {
+                points.push_back( c + offsets[j] );
+                normals.push_back( Vector3::Unit( j % 3 ) );
+                colors.push_back( Vector4( Scalar( j ), Scalar( i ), 0, 1 ) );
+            }
+        }
+        const Vector3 meanOffset = ( offsets[0] + offsets[1] + offsets[2] + offsets[3] ) / 4;
+        const Vector3 meanNormal = Vector3( 2, 1, 1 ).normalized();
+
+        // shuffle the points, the result is ordered by voxel anyway
+        std::vector<uint> order( points.size() );
+        std::iota( order.begin(), order.end(), 0 );
+        std::shuffle( order.begin(), order.end(), std::mt19937( 0 ) );
+        Vector3Array shuffledPoints;
+        Vector3Array shuffledNormals;
+        Vector4Array shuffledColors;
+        for ( uint i : order )
+        {
+            shuffledPoints.push_back( points[i] );
+            shuffledNormals.push_back( normals[i] );
+            shuffledColors.push_back( colors[i] );
+        }
+
+        downsampleVoxelGrid( 1_ra, shuffledPoints, shuffledNormals, shuffledColors );
+        REQUIRE( shuffledPoints.size() == 125 );
+        REQUIRE( shuffledNormals.size() == 125 );
+        REQUIRE( shuffledColors.size() == 125 );
+        for ( int i = 0; i < 125; ++i )
+        {
+            const Vector3 c( Scalar( i % 5 ), Scalar( ( i / 5 ) % 5 ), Scalar( i / 25 ) );
+            REQUIRE( shuffledPoints[i].isApprox( c + meanOffset ) );
+            REQUIRE( shuffledNormals[i].isApprox( meanNormal ) );
+            REQUIRE( shuffledColors[i].isApprox( Vector4( 1.5_ra, Scalar( i ), 0, 1 ) ) );
+        }
+
+        // attributes are optional, and large voxels merge all the points
+        Vector3Array noNormals;
+        Vector4Array noColors;
+        downsampleVoxelGrid( 100_ra, points, noNormals, noColors );
+        REQUIRE( points.size() == 1 );
+        REQUIRE( points[0].isApprox( Vector3::Constant( 2_ra ) + meanOffset ) );
+        REQUIRE( noNormals.empty() );
+        REQUIRE( noColors.empty() );
+    }
+
+    SECTION( "Statistical outlier removal" ) {
+        std::mt19937 gen( 0 );
+        std::uniform_real_distribution<Scalar> dis( 0_ra, 1_ra );
+        Vector3Array points;
+        Vector3Array normals;
+        Vector4Array colors;
+        for ( int i = 0; i < 2010; ++i )
+        {
+            Vector3 p( dis( gen ), dis( gen ), dis( gen ) );
+            // isolated points
+            if ( i % 201 == 200 ) { p = Vector3::Constant( 10_ra ) + 10_ra * p; }
+            points.push_back( p );
+            normals.push_back( p );
+            colors.push_back( Vector4( Scalar( i ), 0, 0, 1 ) );
+        }
+
+        removeStatisticalOutliers( 8, 3_ra, points, normals, colors );
+        REQUIRE( points.size() <= 2000 );
+        REQUIRE( points.size() > 1950 );
+        REQUIRE( normals.size() == points.size() );
+        REQUIRE( colors.size() == points.size() );
+        for ( size_t i = 0; i < points.size(); ++i )
+        {
+            REQUIRE( ( points[i].array() <= 1_ra ).all() );
+            REQUIRE( normals[i] == points[i] );
+            if ( i > 0 ) { REQUIRE( colors[i]( 0 ) > colors[i - 1]( 0 ) ); }
+        }
+    }
+
+    SECTION( "Normal estimation" ) {
+        // two spheres, the orientation is propagated in each of them
+        std::mt19937 gen( 0 );
+        std::normal_distribution<Scalar> dis( 0_ra, 1_ra );
+        const Vector3 centers[2] = {{0, 0, 0}, {5, 0, 1}};
+        Vector3Array points;
+        for ( int i = 0; i < 4000; ++i )
+        {
+            const Vector3 d = Vector3( dis( gen ), dis( gen ), dis( gen ) ).normalized();
+            points.push_back( centers[i % 2] + d );
+        }
+
+        Vector3Array normals;
+        estimateNormals( 10, points, normals );
+        REQUIRE( normals.size() == points.size() );
+        for ( size_t i = 0; i < points.size(); ++i )
+        {
+            const Vector3 expected = points[i] - centers[i % 2];
+            REQUIRE( normals[i].norm() == Approx( 1 ) );
+            REQUIRE( normals[i].dot( expected ) > 0.95_ra );
+        }
+
+        // without orientation, the normals are only parallel to the expected
+        // ones, and the point cloud is updated in place
+        PointCloud cloud;
+        cloud.setVertices( points );
+        estimateNormals( 10, cloud, false );
+        REQUIRE( cloud.normals().size() == points.size() );
+        for ( size_t i = 0; i < points.size(); ++i )
+        {
+            const Vector3 expected = points[i] - centers[i % 2];
+            REQUIRE( std::abs( cloud.normals()[i].dot( expected ) ) > 0.95_ra );
+        }
+    }
+}
+
+TEST_CASE( "Core/Geometry/PointCloudOctree", "[Core][Core/Geometry][PointCloudOctree]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    const auto directory = std::filesystem::temp_directory_path() / "radium_octree_test";
+    std::filesystem::create_directories( directory );
+
+    // a dense cluster, so that the octree is deep there, and sparse points
+    std::mt19937 gen( 0 );
+    std::uniform_real_distribution<Scalar> dis( 0_ra, 1_ra );
+    Vector3Array points;
+    Vector3Array normals;
+    Vector4Array colors;
+    for ( int i = 0; i < 50000; ++i )
+    {
+        const Vector3 p( dis( gen ), dis( gen ), dis( gen ) );
+        points.push_back( i % 5 == 0 ? Vector3( 10_ra * p ) : Vector3( 0.1_ra * p ) );
+        normals.push_back( Vector3::Unit( i % 3 ) );
+        colors.push_back( Vector4( Scalar( i % 256 ) / 255_ra, 0, 1, 1 ) );
+    }
+
+    PointCloudOctreeOptions options;
+    options.maxLeafPoints = 1000;
+    options.samplingGrid  = 16;
+    options.chunkSize     = 4096;
+    ArrayPointSource source( points, normals, colors );
+    REQUIRE( buildPointCloudOctree( source, directory.string(), options ) );
+
+    PointCloudOctree octree;
+    REQUIRE( octree.open( directory.string() ) );
+    REQUIRE( octree.hasNormals() );
+    REQUIRE( octree.hasColors() );
+    REQUIRE( octree.pointCount() == points.size() );
+    const auto& nodes = octree.nodes();
+    REQUIRE( nodes.size() > 9 );
+    Aabb aabb;
+    for ( const auto& p : points )
+    {
+        aabb.extend( p );
+    }
+    REQUIRE( nodes[0].aabb.contains( aabb ) );
+    REQUIRE( nodes[0].aabb.sizes().isApprox( Vector3::Constant( aabb.sizes().maxCoeff() ) ) );
+
+    // all the points are stored once, with their attributes, the samples of
+    // the inner nodes being on distinct cells of their grid
+    std::vector<std::array<Scalar, 3>> loaded;
+    Vector3Array nodePoints;
+    Vector3Array nodeNormals;
+    Vector4Array nodeColors;
+    for ( int i = 0; i < int( nodes.size() ); ++i )
+    {
+        const auto& node = nodes[i];
+        REQUIRE( octree.loadNode( i, nodePoints, nodeNormals, nodeColors ) );
+        REQUIRE( nodePoints.size() == node.count );
+        REQUIRE( nodeNormals.size() == node.count );
+        REQUIRE( nodeColors.size() == node.count );
+        if ( node.parent >= 0 )
+        {
+            const auto& parent = nodes[size_t( node.parent )];
+            REQUIRE( parent.aabb.contains( node.aabb ) );
+            REQUIRE( node.depth == parent.depth + 1 );
+            REQUIRE( node.spacing == parent.spacing / 2 );
+        }
+        if ( node.isLeaf() ) { REQUIRE( node.count <= options.maxLeafPoints ); }
+        else
+        { REQUIRE( node.count <= 16 * 16 * 16 ); }
+
+        const Scalar epsilon = node.aabb.sizes()( 0 ) * 1e-5_ra;
+        const Aabb bounds( node.aabb.min().array() - epsilon, node.aabb.max().array() + epsilon );
+        for ( size_t j = 0; j < nodePoints.size(); ++j )
+        {
+            REQUIRE( bounds.contains( nodePoints[j] ) );
+            REQUIRE( nodeNormals[j].squaredNorm() == 1 );
+            loaded.push_back( {nodePoints[j]( 0 ), nodePoints[j]( 1 ), nodePoints[j]( 2 )} );
+        }
+    }
+    std::vector<std::array<Scalar, 3>> expected;
+    for ( const auto& p : points )
+    {
+        expected.push_back( {p( 0 ), p( 1 ), p( 2 )} );
+    }
+    std::sort( loaded.begin(), loaded.end() );
+    std::sort( expected.begin(), expected.end() );
+    REQUIRE( loaded == expected );
+
+    // a small cloud is a single leaf
+    const Vector3Array few{{0, 0, 0}, {1, 2, 3}};
+    const Vector3Array noNormals;
+    const Vector4Array noColors;
+    ArrayPointSource small( few, noNormals, noColors );
+    REQUIRE( buildPointCloudOctree( small, directory.string(), options ) );
+    REQUIRE( octree.open( directory.string() ) );
+    REQUIRE( octree.nodes().size() == 1 );
+    REQUIRE( octree.nodes()[0].isLeaf() );
+    REQUIRE( !octree.hasNormals() );
+    REQUIRE( octree.loadNode( 0, nodePoints, nodeNormals, nodeColors ) );
+    REQUIRE( nodePoints.size() == 2 );
+    REQUIRE( nodeNormals.empty() );
+    REQUIRE( nodeColors.empty() );
+
+    std::filesystem::remove_all( directory );
+}
+
+TEST_CASE( "Core/Geometry/MeshSampling", "[Core][Core/Geometry][MeshSampling]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    SECTION( "Alias table" ) {
+        const AliasTable table( {1, 0, 3, 4} );
+        REQUIRE( table.size() == 4 );
+        // a regular grid of uniform numbers gives the exact frequencies
+        std::vector<int> counts( 4, 0 );
+        const int m = 100;
+        for ( int i = 0; i < 4 * m; ++i )
+        {
+            for ( int j = 0; j < m; ++j )
+            {
+                ++counts[table.sample( ( i + 0.5_ra ) / ( 4 * m ), ( j + 0.5_ra ) / m )];
+            }
+        }
+        REQUIRE( counts == std::vector<int>{m * m / 2, 0, 3 * m * m / 2, 2 * m * m} );
+    }
+
+    // a sharp box, with attributes linear in the positions
+    const Vector3 halfExts( 1, 2, 3 );
+    TriangleMesh box = makeSharpBox( halfExts );
+    Vector1Array xs;
+    Vector2Array yzs;
+    for ( const auto& v : box.vertices() )
+    {
+        xs.push_back( v( 0 ) );
+        yzs.push_back( Vector2( v( 1 ), v( 2 ) ) );
+    }
+    box.addAttrib<Scalar>( "test_x", xs );
+    box.addAttrib<Vector2>( "test_yz", yzs );
+
+    const auto checkCloud = [&]( const PointCloud& cloud ) {
+        const auto& x  = cloud.getAttrib( cloud.getAttribHandle<Scalar>( "test_x" ) ).data();
+        const auto& yz = cloud.getAttrib( cloud.getAttribHandle<Vector2>( "test_yz" ) ).data();
+        REQUIRE( cloud.normals().size() == cloud.vertices().size() );
+        REQUIRE( x.size() == cloud.vertices().size() );
+        REQUIRE( yz.size() == cloud.vertices().size() );
+        for ( size_t i = 0; i < cloud.vertices().size(); ++i )
+        {
+            // on a face, with the normal of the face
+            const Vector3& p     = cloud.vertices()[i];
+            const Vector3 ratios = p.cwiseQuotient( halfExts ).cwiseAbs();
+            REQUIRE( ratios.maxCoeff() == Approx( 1 ) );
+            int axis;
+            ratios.maxCoeff( &axis );
+            const Scalar side = p( axis ) > 0 ? 1_ra : -1_ra;
+            REQUIRE( cloud.normals()[i].isApprox( side * Vector3::Unit( axis ) ) );
+            REQUIRE( x[i] == Approx( p( 0 ) ).margin( 1e-5 ) );
+            REQUIRE( yz[i].isApprox( Vector2( p( 1 ), p( 2 ) ), 1e-5_ra ) );
+        }
+    };
+
+    SECTION( "Uniform sampling" ) {
+        const PointCloud cloud = sampleSurface( box, 88000, 3 );
+        REQUIRE( cloud.vertices().size() == 88000 );
+        checkCloud( cloud );
+
+        // the number of points of a face is proportional to its area, the
+        // faces of normal x, y and z having areas 48, 24 and 16 (out of 88)
+        std::array<int, 3> counts{{0, 0, 0}};
+        for ( const auto& n : cloud.normals() )
+        {
+            int axis;
+            n.cwiseAbs().maxCoeff( &axis );
+            ++counts[axis];
+        }
+        REQUIRE( counts[0] == Approx( 48000 ).epsilon( 0.02 ) );
+        REQUIRE( counts[1] == Approx( 24000 ).epsilon( 0.02 ) );
+        REQUIRE( counts[2] == Approx( 16000 ).epsilon( 0.02 ) );
+
+        // deterministic for a given seed
+        REQUIRE( sampleSurface( box, 88000, 3 ).vertices() == cloud.vertices() );
+        REQUIRE( sampleSurface( box, 88000, 4 ).vertices() != cloud.vertices() );
+    }
+
+    SECTION( "Poisson disk sampling" ) {
+        const Scalar radius    = 0.2_ra;
+        const PointCloud cloud = sampleSurfacePoissonDisk( box, radius, 5 );
+        const auto& points     = cloud.vertices();
+        checkCloud( cloud );
+        // the surface is 88, a maximal sampling has about 0.7 * 88 / 0.04 points
+        REQUIRE( points.size() > 1200 );
+        REQUIRE( points.size() < 2000 );
+        for ( size_t i = 0; i < points.size(); ++i )
+        {
+            for ( size_t j = i + 1; j < points.size(); ++j )
+            {
+                REQUIRE( ( points[i] - points[j] ).squaredNorm() >= radius * radius );
+            }
+        }
+
+        // the surface is covered
+        const PointCloud probes = sampleSurface( box, 1000, 6 );
+        for ( const auto& q : probes.vertices() )
+        {
+            const Scalar d = std::accumulate(
+                points.begin(), points.end(), 10_ra, [&q]( Scalar m, const Vector3& p ) {
+                    return std::min( m, ( p - q ).norm() );
+                } );
+            REQUIRE( d < 2 * radius );
+        }
+        REQUIRE( sampleSurfacePoissonDisk( box, radius, 5 ).vertices() == points );
+    }
+}
@@ -1,6 +1,11 @@
+#include <Core/Geometry/Curve2D.hpp>
 #include <Core/Geometry/PolyLine.hpp>
+#include <Core/Geometry/Spline.hpp>
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <random>
+
 TEST_CASE( "Core/Geometry/Polyline", "[Core][Core/Geometry][Polyline]" ) {
     using namespace Ra::Core;
     SECTION( "2 points polyline" ) {
@@ -32,4 +37,182 @@ TEST_CASE( "Core/Geometry/Polyline", "[Core][Core/Geometry][Polyline]" ) {
             REQUIRE( Math::areApproxEqual( p.distance( x ), 0_ra ) );
         }
     }
+    SECTION( "Long polyline" ) {
+        // random walk, folding over itself
+        std::mt19937 gen( 0 );
+        std::uniform_real_distribution<Scalar> dis( -1_ra, 1_ra );
+        Vector3Array pts( 1000 );
+        pts[0] = Vector3::Zero();
+        for ( uint i = 1; i < pts.size(); ++i )
+        {
+            pts[i] = pts[i - 1] + Vector3( dis( gen ), dis( gen ), dis( gen ) );
+        }
+        Geometry::PolyLine line( pts );
+        const Aabb aabb = line.aabb();
+
+        Vector3Array queries( 2000 );
+        for ( auto& q : queries )
+        {
+            q = aabb.sample();
+        }
+        // points of the line
+        queries[0] = pts[0];
+        queries[1] = pts[500];
+
+        std::vector<Scalar> sqDist;
+        std::vector<Scalar> ts;
+        std::vector<uint> segments;
+        line.squaredDistance( queries, sqDist );
+        line.project( queries, ts );
+        line.getNearestSegment( queries, segments );
+        for ( uint i = 0; i < queries.size(); ++i )
+        {
+            // compare with a linear scan
+            Scalar best  = std::numeric_limits<Scalar>::max();
+            uint segment = 0;
+            for ( uint s = 0; s + 1 < pts.size(); ++s )
+            {
+                const Scalar d =
+                    Geometry::pointToSegmentSq( queries[i], pts[s], pts[s + 1] - pts[s] );
+                if ( d < best )
+                {
+                    best    = d;
+                    segment = s;
+                }
+            }
+            REQUIRE( segments[i] == segment );
+            REQUIRE( sqDist[i] == best );
+            REQUIRE( ts[i] == line.project( queries[i] ) );
+        }
+        REQUIRE( sqDist[0] == 0_ra );
+        REQUIRE( sqDist[1] == 0_ra );
+
+        // the hierarchy follows the points
+        for ( auto& x : pts )
+        {
+            x *= 2_ra;
+        }
+        line.setPoints( pts );
+        REQUIRE( line.squaredDistance( pts[500] ) == 0_ra );
+        REQUIRE( line.distance( 2_ra * queries[10] ) == Approx( 2_ra * std::sqrt( sqDist[10] ) ) );
+    }
+}
+
+TEST_CASE( "Core/Geometry/Spline", "[Core][Core/Geometry][Spline]" ) {
+    using namespace Ra::Core;
+    std::mt19937 gen( 7 );
+    std::uniform_real_distribution<Scalar> dist( -1_ra, 1_ra );
+
+    // sorted parameters, with the ends, repeated values and values outside [0; 1]
+    std::vector<Scalar> params{-0.5_ra, 0_ra};
+    for ( int i = 0; i <= 200; ++i )
+    {
+        params.push_back( Scalar( i ) / 200_ra );
+    }
+    params.push_back( 0.5_ra );
+    std::sort( params.begin(), params.end() );
+    params.push_back( 1.5_ra );
+
+    auto check = []( const auto& spline, const std::vector<Scalar>& u ) {
+        using Vector = typename std::decay_t<decltype( spline )>::Vector;
+        VectorArray<Vector> pos;
+        VectorArray<Vector> speed;
+        spline.f( u, pos );
+        spline.df( u, speed );
+        REQUIRE( pos.size() == u.size() );
+        REQUIRE( speed.size() == u.size() );
+        for ( size_t i = 0; i < u.size(); ++i )
+        {
+            REQUIRE( ( pos[i] - spline.f( u[i] ) ).norm() < 1e-5_ra );
+            REQUIRE( ( speed[i] - spline.df( u[i] ) ).norm() < 1e-4_ra );
+        }
+    };
+
+    SECTION( "Batch evaluation" ) {
+        Vector3Array points( 12 );
+        for ( auto& p : points )
+        {
+            p = Vector3( dist( gen ), dist( gen ), dist( gen ) );
+        }
+        Geometry::Spline<3, 2> linear;
+        Geometry::Spline<3, 3> quadratic;
+        Geometry::Spline<3, 4> cubic( Geometry::Spline<3, 4>::UNIFORM );
+        linear.setCtrlPoints( points );
+        quadratic.setCtrlPoints( points );
+        cubic.setCtrlPoints( points );
+        check( linear, params );
+        check( quadratic, params );
+        check( cubic, params );
+
+        // unsorted parameters
+        std::vector<Scalar> shuffled = params;
+        std::shuffle( shuffled.begin(), shuffled.end(), gen );
+        check( quadratic, shuffled );
+        check( cubic, shuffled );
+
+        // open uniform splines interpolate their end points
+        REQUIRE( quadratic.f( 0_ra ).isApprox( points.front() ) );
+        REQUIRE( quadratic.f( 1_ra ).isApprox( points.back() ) );
+
+        // the basis table can be reused while the control points move
+        Geometry::Spline<3, 3>::BasisTable table;
+        quadratic.computeBasis( params, table );
+        for ( auto& p : points )
+        {
+            p *= 2_ra;
+        }
+        quadratic.setCtrlPoints( points );
+        Vector3Array pos;
+        quadratic.f( table, pos );
+        for ( size_t i = 0; i < params.size(); ++i )
+        {
+            REQUIRE( ( pos[i] - quadratic.f( params[i] ) ).norm() < 1e-5_ra );
+        }
+    }
+
+    SECTION( "Curves 2D" ) {
+        using Vector = Geometry::Curve2D::Vector;
+        const Vector p0( 0_ra, 0_ra );
+        const Vector p1( 1_ra, 2_ra );
+        const Vector p2( 3_ra, -1_ra );
+        const Vector p3( 4_ra, 1_ra );
+        std::vector<Scalar> u;
+        for ( int i = 0; i <= 100; ++i )
+        {
+            u.push_back( Scalar( i ) / 100_ra );
+        }
+
+        Geometry::CubicBezier bezier( p0, p1, p2, p3 );
+        Geometry::QuadraSpline quadra( p0, p1, p2 );
+        Geometry::SplineCurve spline( VectorArray<Vector>{p0, p1, p2, p3} );
+        Geometry::Line line( p0, p3 );
+        // a cubic open uniform spline with four control points is a Bezier curve
+        Geometry::Spline<2, 4> cubic;
+        cubic.setCtrlPoints( VectorArray<Vector>{p0, p1, p2, p3} );
+
+        for ( const Geometry::Curve2D* curve :
+              std::vector<const Geometry::Curve2D*>{&bezier, &quadra, &spline, &line} )
+        {
+            VectorArray<Vector> pos;
+            VectorArray<Vector> grad;
+            curve->fdf( u, pos, grad );
+            REQUIRE( pos.size() == u.size() );
+            for ( size_t i = 0; i < u.size(); ++i )
+            {
+                Vector g;
+                const Vector p = curve->fdf( u[i], g );
+                REQUIRE( ( pos[i] - p ).norm() < 1e-5_ra );
+                REQUIRE( ( grad[i] - g ).norm() < 1e-4_ra );
+            }
+        }
+
+        VectorArray<Vector> pos;
+        VectorArray<Vector> grad;
+        bezier.fdf( u, pos, grad );
+        for ( size_t i = 0; i < u.size(); ++i )
+        {
+            REQUIRE( ( pos[i] - cubic.f( u[i] ) ).norm() < 1e-5_ra );
+            REQUIRE( ( grad[i] - cubic.df( u[i] ) ).norm() < 1e-4_ra );
+        }
+    }
 }
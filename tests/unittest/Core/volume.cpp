@@ -0,0 +1,352 @@
+#include <Core/Geometry/IsoSurface.hpp>
+#include <Core/Geometry/MeshPrimitives.hpp>
+#include <Core/Geometry/SignedDistance.hpp>
+#include <Core/Geometry/Volume.hpp>
+#include <Core/Geometry/Voxelization.hpp>
+#include <Core/Utils/Timer.hpp>
+#include <catch2/catch.hpp>
+
+#include <iostream>
+#include <map>
+#include <utility>
+
+namespace {
+// Signed distance to a sphere, sampled at the center of the bins of a grid.
+Ra::Core::Geometry::VolumeGrid
+sphereGrid( int n, Scalar binSize, const Ra::Core::Vector3& c, Scalar r ) {
+    using namespace Ra::Core;
+    Geometry::VolumeGrid grid;
+    grid.setSize( Vector3i( n, n, n ) );
+    grid.setBinSize( Vector3::Constant( binSize ) );
+    auto& data = grid.data();
+    for ( int z = 0; z < n; ++z )
+    {
+        for ( int y = 0; y < n; ++y )
+        {
+            for ( int x = 0; x < n; ++x )
+            {
+                const Vector3 p = ( Vector3( x, y, z ) + Vector3::Constant( 0.5_ra ) ) * binSize;
+                data[size_t( x + n * ( y + n * z ) )] = ( p - c ).norm() - r;
+            }
+        }
+    }
+    return grid;
+}
+} // namespace
+
+TEST_CASE( "Core/Geometry/IsoSurface", "[Core][Core/Geometry][IsoSurface]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    const Scalar binSize = 0.1_ra;
+    const Vector3 center( 2.3_ra, 2.4_ra, 2.5_ra );
+    const Scalar radius = 1.5_ra;
+    const VolumeGrid grid = sphereGrid( 48, binSize, center, radius );
+
+    SECTION( "Sphere" ) {
+        const TriangleMesh mesh = extractIsoSurface( grid );
+        const auto& p           = mesh.vertices();
+        const auto& n           = mesh.normals();
+        REQUIRE( !mesh.m_indices.empty() );
+        REQUIRE( n.size() == p.size() );
+
+        for ( size_t i = 0; i < p.size(); ++i )
+        {
+            REQUIRE( std::abs( ( p[i] - center ).norm() - radius ) < 0.5_ra * binSize );
+            REQUIRE( n[i].dot( ( p[i] - center ).normalized() ) > 0.95_ra );
+        }
+
+        // closed, consistently oriented, genus 0 and outward facing
+        std::map<std::pair<uint, uint>, int> edges;
+        Scalar volume = 0;
+        for ( const auto& t : mesh.m_indices )
+        {
+            for ( int k = 0; k < 3; ++k )
+            {
+                ++edges[{t( k ), t( ( k + 1 ) % 3 )}];
+            }
+            volume += p[t( 0 )].dot( p[t( 1 )].cross( p[t( 2 )] ) ) / 6_ra;
+        }
+        for ( const auto& e : edges )
+        {
+            REQUIRE( e.second == 1 );
+            REQUIRE( edges.count( {e.first.second, e.first.first} ) == 1 );
+        }
+        REQUIRE( int( p.size() ) - int( edges.size() / 2 ) + int( mesh.m_indices.size() ) == 2 );
+        const Scalar sphereVolume = 4_ra / 3_ra * Math::Pi * radius * radius * radius;
+        REQUIRE( std::abs( volume - sphereVolume ) < 0.02_ra * sphereVolume );
+    }
+
+    SECTION( "Empty space skipping" ) {
+        const TriangleMesh mesh = extractIsoSurface( grid );
+        for ( int brickSize : {1, 5, 8, 64} )
+        {
+            const VolumeBrickRanges bricks( grid, brickSize );
+            REQUIRE( bricks.isValidFor( grid ) );
+            const TriangleMesh skipped = extractIsoSurface( grid, 0_ra, &bricks );
+            REQUIRE( skipped.vertices() == mesh.vertices() );
+            REQUIRE( skipped.m_indices == mesh.m_indices );
+        }
+
+        // the ranges do not depend on the iso-value
+        const VolumeBrickRanges bricks( grid );
+        const TriangleMesh inner = extractIsoSurface( grid, -0.5_ra, &bricks );
+        REQUIRE( inner.m_indices == extractIsoSurface( grid, -0.5_ra ).m_indices );
+        REQUIRE( !inner.m_indices.empty() );
+        REQUIRE( inner.m_indices.size() < mesh.m_indices.size() );
+        REQUIRE( extractIsoSurface( grid, -2_ra, &bricks ).m_indices.empty() );
+        REQUIRE( extractIsoSurface( grid, 10_ra, &bricks ).m_indices.empty() );
+    }
+
+    SECTION( "Surface leaving the grid" ) {
+        const VolumeGrid cut = sphereGrid( 20, binSize, Vector3::Zero(), radius );
+        const TriangleMesh mesh = extractIsoSurface( cut );
+        REQUIRE( !mesh.m_indices.empty() );
+        for ( const auto& x : mesh.vertices() )
+        {
+            REQUIRE( std::abs( x.norm() - radius ) < 0.5_ra * binSize );
+        }
+        REQUIRE( extractIsoSurface( VolumeGrid() ).m_indices.empty() );
+    }
+}
+
+TEST_CASE( "Core/Geometry/SignedDistance", "[Core][Core/Geometry][SignedDistance]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    // unit sphere centered in a grid of side 3.2
+    const TriangleMesh sphere = makeGeodesicSphere( 1_ra, 4 );
+    const Vector3 origin      = Vector3::Constant( -1.6_ra );
+    const int n               = 32;
+    const Scalar binSize      = 0.1_ra;
+    auto makeGrid             = [&]() {
+        VolumeGrid grid;
+        grid.setSize( Vector3i( n, n, n ) );
+        grid.setBinSize( Vector3::Constant( binSize ) );
+        return grid;
+    };
+    auto position = [&]( int i ) -> Vector3 {
+        const Vector3 s( Scalar( i % n ), Scalar( ( i / n ) % n ), Scalar( i / ( n * n ) ) );
+        return origin + ( s + Vector3::Constant( 0.5_ra ) ) * binSize;
+    };
+
+    VolumeGrid winding = makeGrid();
+    VolumeGrid parity  = makeGrid();
+    bakeSignedDistance( sphere, winding, SignMethod::WINDING_NUMBER, 0_ra, origin );
+    bakeSignedDistance( sphere, parity, SignMethod::RAY_PARITY, 0_ra, origin );
+
+    SECTION( "Dense" ) {
+        for ( int i = 0; i < n * n * n; ++i )
+        {
+            const Scalar d = position( i ).norm() - 1_ra;
+            REQUIRE( std::abs( winding.data()[i] - d ) < 0.01_ra );
+            REQUIRE( parity.data()[i] == winding.data()[i] );
+        }
+    }
+
+    SECTION( "Narrow band" ) {
+        const Scalar band = 0.25_ra;
+        VolumeGrid clamped = makeGrid();
+        bakeSignedDistance( sphere, clamped, SignMethod::RAY_PARITY, band, origin );
+        VolumeSparse sparse;
+        sparse.setSize( Vector3i( n, n, n ) );
+        sparse.setBinSize( Vector3::Constant( binSize ) );
+        bakeSignedDistance( sphere, sparse, band, SignMethod::WINDING_NUMBER, origin );
+
+        size_t inBand = 0;
+        for ( int i = 0; i < n * n * n; ++i )
+        {
+            const Scalar d = winding.data()[i];
+            REQUIRE( clamped.data()[i] == std::clamp( d, -band, band ) );
+            if ( std::abs( d ) < band ) { ++inBand; }
+        }
+        REQUIRE( sparse.data().size() == inBand );
+        for ( size_t i = 0; i < sparse.data().size(); ++i )
+        {
+            const auto& sample = sparse.data()[i];
+            if ( i > 0 ) { REQUIRE( sparse.data()[i - 1].index < sample.index ); }
+            REQUIRE( sample.value == winding.data()[sample.index] );
+        }
+    }
+
+    SECTION( "Open mesh" ) {
+        // the winding number still classifies the samples with a hole in the mesh
+        TriangleMesh open;
+        open.copy( sphere );
+        open.m_indices.erase( open.m_indices.begin(), open.m_indices.begin() + 4 );
+        VolumeGrid grid = makeGrid();
+        bakeSignedDistance( open, grid, SignMethod::WINDING_NUMBER, 0_ra, origin );
+        for ( int i = 0; i < n * n * n; ++i )
+        {
+            if ( std::abs( winding.data()[i] ) > 0.2_ra )
+            { REQUIRE( ( grid.data()[i] < 0 ) == ( winding.data()[i] < 0 ) ); }
+        }
+    }
+
+    SECTION( "Iso-surface" ) {
+        const TriangleMesh mesh = extractIsoSurface( winding );
+        REQUIRE( !mesh.m_indices.empty() );
+        for ( const auto& p : mesh.vertices() )
+        {
+            REQUIRE( std::abs( ( p + origin ).norm() - 1_ra ) < 0.02_ra );
+        }
+    }
+}
+
+TEST_CASE( "Core/Geometry/SignedDistance/Benchmark", "[.][benchmark]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    const TriangleMesh sphere = makeGeodesicSphere( 1_ra, 5 );
+    std::cout << "SDF baking of a sphere with " << sphere.m_indices.size() << " triangles\n";
+    for ( int n : {32, 64, 128} )
+    {
+        for ( auto method : {SignMethod::WINDING_NUMBER, SignMethod::RAY_PARITY} )
+        {
+            for ( Scalar band : {0_ra, 4_ra / Scalar( n )} )
+            {
+                VolumeGrid grid;
+                grid.setSize( Vector3i( n, n, n ) );
+                grid.setBinSize( Vector3::Constant( 3_ra / Scalar( n ) ) );
+                const auto start = Utils::Clock::now();
+                bakeSignedDistance( sphere, grid, method, band, Vector3::Constant( -1.5_ra ) );
+                const auto end = Utils::Clock::now();
+                std::cout << "  " << n << "^3, "
+                          << ( method == SignMethod::WINDING_NUMBER ? "winding number" : "parity" )
+                          << ( band > 0 ? ", narrow band" : "" ) << ": "
+                          << Utils::getIntervalMicro( start, end ) / 1000 << " ms\n";
+            }
+        }
+    }
+}
+
+TEST_CASE( "Core/Geometry/Voxelization", "[Core][Core/Geometry][Voxelization]" ) {
+    using namespace Ra::Core;
+    using namespace Ra::Core::Geometry;
+
+    auto makeGrid = []( int n, Scalar binSize ) {
+        VolumeGrid grid;
+        grid.setSize( Vector3i( n, n, n ) );
+        grid.setBinSize( Vector3::Constant( binSize ) );
+        return grid;
+    };
+    auto makeSparse = []( int n, Scalar binSize ) {
+        VolumeSparse volume;
+        volume.setSize( Vector3i( n, n, n ) );
+        volume.setBinSize( Vector3::Constant( binSize ) );
+        return volume;
+    };
+    // the sparse samples are sorted, and are the non zero samples of grid
+    auto sameSamples = []( const VolumeSparse& sparse, const VolumeGrid& grid ) {
+        size_t count = 0;
+        for ( const auto& v : grid.data() )
+        {
+            if ( v != 0 ) { ++count; }
+        }
+        REQUIRE( sparse.data().size() == count );
+        for ( size_t i = 0; i < sparse.data().size(); ++i )
+        {
+            const auto& sample = sparse.data()[i];
+            if ( i > 0 ) { REQUIRE( sparse.data()[i - 1].index < sample.index ); }
+            REQUIRE( sample.value == grid.data()[sample.index] );
+        }
+    };
+
+    SECTION( "Box on voxel faces" ) {
+        // box [ 2; 6 ]^3 in voxel coordinates: the voxels on both sides of its
+        // faces overlap it, all but the 2^3 voxels strictly inside
+        const TriangleMesh box =
+            makeBox( Aabb( Vector3::Constant( 1_ra ), Vector3::Constant( 3_ra ) ) );
+        VolumeGrid surface = makeGrid( 10, 0.5_ra );
+        voxelizeSurface( box, surface );
+        int count = 0;
+        for ( int i = 0; i < 1000; ++i )
+        {
+            const Vector3i v( i % 10, ( i / 10 ) % 10, i / 100 );
+            const bool overlaps = ( v.array() >= 1 ).all() && ( v.array() <= 6 ).all() &&
+                                  !( ( v.array() >= 3 ).all() && ( v.array() <= 4 ).all() );
+            REQUIRE( ( surface.data()[i] == 1_ra ) == overlaps );
+            if ( overlaps ) { ++count; }
+        }
+        REQUIRE( count == 208 );
+        VolumeSparse sparse = makeSparse( 10, 0.5_ra );
+        voxelizeSurface( box, sparse );
+        sameSamples( sparse, surface );
+    }
+
+    SECTION( "Box through sample centers" ) {
+        // box [ 2.5; 6.5 ]^3 in voxel coordinates: the columns through its
+        // edges cross each face once, which gives 4 inside samples per axis
+        const TriangleMesh box =
+            makeBox( Aabb( Vector3::Constant( 1.25_ra ), Vector3::Constant( 3.25_ra ) ) );
+        VolumeGrid solid = makeGrid( 10, 0.5_ra );
+        voxelizeSolid( box, solid, 2_ra );
+        int count = 0;
+        for ( const auto& v : solid.data() )
+        {
+            if ( v == 0 ) { continue; }
+            REQUIRE( v == 2_ra );
+            ++count;
+        }
+        REQUIRE( count == 64 );
+        VolumeSparse sparse = makeSparse( 10, 0.5_ra );
+        voxelizeSolid( box, sparse, 2_ra );
+        sameSamples( sparse, solid );
+    }
+
+    SECTION( "Sphere" ) {
+        // unit sphere centered in a grid of side 3.2
+        const TriangleMesh sphere = makeGeodesicSphere( 1_ra, 4 );
+        const Vector3 origin      = Vector3::Constant( -1.6_ra );
+        const int n               = 32;
+        const Scalar binSize      = 0.1_ra;
+        auto center               = [&]( int i ) -> Vector3 {
+            const Vector3 s( Scalar( i % n ), Scalar( ( i / n ) % n ), Scalar( i / ( n * n ) ) );
+            return origin + ( s + Vector3::Constant( 0.5_ra ) ) * binSize;
+        };
+
+        VolumeGrid surface = makeGrid( n, binSize );
+        VolumeGrid solid   = makeGrid( n, binSize );
+        voxelizeSurface( sphere, surface, 1_ra, origin );
+        voxelizeSolid( sphere, solid, 1_ra, origin );
+        for ( int i = 0; i < n * n * n; ++i )
+        {
+            const Scalar d = center( i ).norm() - 1_ra;
+            // marked voxels hold the surface, and voxels whose inscribed ball
+            // crosses the surface are marked
+            if ( surface.data()[i] != 0 ) { REQUIRE( std::abs( d ) < 0.09_ra ); }
+            if ( std::abs( d ) < 0.045_ra ) { REQUIRE( surface.data()[i] == 1_ra ); }
+            if ( std::abs( d ) > 0.01_ra ) { REQUIRE( ( solid.data()[i] != 0 ) == ( d < 0 ) ); }
+        }
+        for ( const auto& p : sphere.vertices() )
+        {
+            const Vector3i v = ( ( p - origin ) / binSize ).cast<int>();
+            REQUIRE( surface.data()[size_t( v( 0 ) + n * ( v( 1 ) + n * v( 2 ) ) )] == 1_ra );
+        }
+
+        VolumeSparse sparse = makeSparse( n, binSize );
+        voxelizeSurface( sphere, sparse, 1_ra, origin );
+        sameSamples( sparse, surface );
+        voxelizeSolid( sphere, sparse, 1_ra, origin );
+        sameSamples( sparse, solid );
+    }
+
+    SECTION( "Mesh leaving the grid" ) {
+        // only the samples of the grid are written, and the crossings outside
+        // of the grid still count for the parity
+        const TriangleMesh sphere = makeGeodesicSphere( 1_ra, 3 );
+        const Vector3 origin( -0.4_ra, -0.4_ra, -0.4_ra );
+        VolumeGrid solid = makeGrid( 8, 0.1_ra );
+        voxelizeSolid( sphere, solid, 1_ra, origin );
+        for ( const auto& v : solid.data() )
+        {
+            REQUIRE( v == 1_ra );
+        }
+        VolumeGrid surface = makeGrid( 8, 0.1_ra );
+        voxelizeSurface( sphere, surface, 1_ra, origin );
+        for ( const auto& v : surface.data() )
+        {
+            REQUIRE( v == 0_ra );
+        }
+    }
+}